@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include "bmca.hpp"
+
+using namespace gptp;
+using namespace gptp::bmca;
+
+namespace {
+    ClockIdentity make_identity(uint32_t index) {
+        ClockIdentity identity;
+        identity.id = {0x00, 0x1B, 0x21, 0xFF, 0xFE, static_cast<uint8_t>(index >> 16),
+                       static_cast<uint8_t>(index >> 8), static_cast<uint8_t>(index)};
+        return identity;
+    }
+
+    AnnounceMessage make_announce(uint32_t index, uint8_t priority1) {
+        AnnounceMessage announce;
+        announce.header.sourcePortIdentity.clockIdentity = make_identity(index);
+        announce.header.sourcePortIdentity.portNumber = 1;
+        announce.header.logMessageInterval = 0;
+        announce.grandmasterIdentity = make_identity(index);
+        announce.grandmasterPriority1 = priority1;
+        announce.grandmasterClockQuality = (248u << 24) | (0xFEu << 16) | 0x436Au;
+        announce.grandmasterPriority2 = 248;
+        announce.stepsRemoved = 1;
+        return announce;
+    }
+}
+
+// Arg: field the vectors first differ in; 0 priority1, 1 grandmaster identity, 2 steps removed
+static void BM_ComparePriorityVectors(benchmark::State& state) {
+    PriorityVector a(make_identity(1), 246, ClockQuality(), 248);
+    PriorityVector b = a;
+    switch (state.range(0)) {
+        case 0: b.grandmaster_priority1 = 247; break;
+        case 1: b.grandmaster_identity = make_identity(2); break;
+        default: b.steps_removed = 2; b.sender_identity = make_identity(3); break;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BmcaEngine::compare_priority_vectors(a, b));
+    }
+}
+BENCHMARK(BM_ComparePriorityVectors)->DenseRange(0, 2);
+
+// Arg: ports with a master; port 1 offers the best one
+static void BM_RunBmca(benchmark::State& state) {
+    BmcaCoordinator coordinator(make_identity(0));
+    auto now = std::chrono::steady_clock::now();
+    for (int64_t port = 1; port <= state.range(0); ++port) {
+        coordinator.process_announce(static_cast<uint16_t>(port),
+                                     make_announce(static_cast<uint32_t>(port), port == 1 ? 100 : 200), now);
+    }
+    PriorityVector local(make_identity(0), 248, ClockQuality(), 248);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(coordinator.run_bmca(local));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RunBmca)->RangeMultiplier(4)->Range(1, 64);
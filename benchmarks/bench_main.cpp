@@ -0,0 +1,14 @@
+#include <benchmark/benchmark.h>
+#include "utils/logger.hpp"
+
+int main(int argc, char** argv) {
+    // Log output would dominate what is being measured
+    gptp::Logger::instance().set_level(gptp::LogLevel::ERROR);
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+#include "path_delay_calculator.hpp"
+
+using namespace gptp;
+using namespace gptp::path_delay;
+
+namespace {
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+}
+
+static void BM_CalculatePathDelay(benchmark::State& state) {
+    StandardP2PDelayCalculator calculator;
+    PdelayTimestamps timestamps;
+    timestamps.t2_valid = true;
+    timestamps.t3_valid = true;
+    int64_t t1 = 1700000000000000000LL;
+    for (auto _ : state) {
+        t1 += 1000000000LL;
+        timestamps.sequence_id++;
+        timestamps.t1 = to_timestamp(t1);
+        timestamps.t2 = to_timestamp(t1 + 20500);
+        timestamps.t3 = to_timestamp(t1 + 30500);
+        timestamps.t4 = to_timestamp(t1 + 11000);
+        benchmark::DoNotOptimize(calculator.calculate_path_delay(timestamps));
+    }
+}
+BENCHMARK(BM_CalculatePathDelay);
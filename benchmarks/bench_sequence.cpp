@@ -0,0 +1,26 @@
+#include <benchmark/benchmark.h>
+#include "sequence_number_manager.hpp"
+
+using namespace gptp;
+using namespace gptp::sequence;
+
+namespace {
+    SequenceNumberManager shared_manager;
+}
+
+// Every thread draws Sync sequence ids for the same port
+static void BM_GetNextSequenceSamePort(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shared_manager.get_next_sequence(1, protocol::MessageType::SYNC));
+    }
+}
+BENCHMARK(BM_GetNextSequenceSamePort)->ThreadRange(1, 8)->UseRealTime();
+
+// Each thread has its own port; only the port table is shared
+static void BM_GetNextSequenceOwnPort(benchmark::State& state) {
+    auto port_id = static_cast<uint16_t>(state.thread_index() + 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shared_manager.get_next_sequence(port_id, protocol::MessageType::SYNC));
+    }
+}
+BENCHMARK(BM_GetNextSequenceOwnPort)->ThreadRange(1, 8)->UseRealTime();
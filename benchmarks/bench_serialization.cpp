@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include "message_serializer.hpp"
+
+using namespace gptp;
+using namespace gptp::serialization;
+
+namespace {
+    GptpMessageHeader make_header(protocol::MessageType type, uint16_t length) {
+        GptpMessageHeader header;
+        header.messageType = static_cast<uint8_t>(type);
+        header.messageLength = length;
+        header.sourcePortIdentity.clockIdentity.id = {0x00, 0x1B, 0x21, 0xFF, 0xFE, 0x12, 0x34, 0x56};
+        header.sourcePortIdentity.portNumber = 1;
+        header.sequenceId = 4711;
+        return header;
+    }
+
+    AnnounceMessage make_announce() {
+        AnnounceMessage announce;
+        announce.header = make_header(protocol::MessageType::ANNOUNCE, 64);
+        announce.currentUtcOffset = 37;
+        announce.grandmasterPriority1 = 246;
+        announce.grandmasterClockQuality = (248u << 24) | (0xFEu << 16) | 0x436Au;
+        announce.grandmasterPriority2 = 248;
+        announce.grandmasterIdentity = announce.header.sourcePortIdentity.clockIdentity;
+        announce.stepsRemoved = 1;
+        return announce;
+    }
+
+    FollowUpMessage make_followup() {
+        FollowUpMessage follow_up;
+        follow_up.header = make_header(protocol::MessageType::FOLLOW_UP, 44);
+        follow_up.preciseOriginTimestamp.from_nanoseconds(std::chrono::nanoseconds(1700000000123456789LL));
+        return follow_up;
+    }
+}
+
+static void BM_SerializeSync(benchmark::State& state) {
+    SyncMessage sync;
+    sync.header = make_header(protocol::MessageType::SYNC, 44);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MessageSerializer::serialize_sync(sync));
+    }
+}
+BENCHMARK(BM_SerializeSync);
+
+static void BM_SerializeFollowUp(benchmark::State& state) {
+    FollowUpMessage follow_up = make_followup();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MessageSerializer::serialize_followup(follow_up));
+    }
+}
+BENCHMARK(BM_SerializeFollowUp);
+
+static void BM_SerializeAnnounce(benchmark::State& state) {
+    AnnounceMessage announce = make_announce();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MessageSerializer::serialize_announce(announce));
+    }
+}
+BENCHMARK(BM_SerializeAnnounce);
+
+static void BM_ParseHeader(benchmark::State& state) {
+    auto payload = MessageSerializer::serialize_followup(make_followup());
+    MessageView view;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MessageView::parse(payload.data(), payload.size(), view));
+        benchmark::DoNotOptimize(view);
+    }
+}
+BENCHMARK(BM_ParseHeader);
+
+static void BM_DeserializeFollowUp(benchmark::State& state) {
+    auto payload = MessageSerializer::serialize_followup(make_followup());
+    MessageView view;
+    MessageView::parse(payload.data(), payload.size(), view);
+    FollowUpMessage follow_up;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MessageDeserializer::deserialize_followup(view, follow_up));
+        benchmark::DoNotOptimize(follow_up);
+    }
+}
+BENCHMARK(BM_DeserializeFollowUp);
+
+static void BM_DeserializeAnnounce(benchmark::State& state) {
+    auto payload = MessageSerializer::serialize_announce(make_announce());
+    MessageView view;
+    MessageView::parse(payload.data(), payload.size(), view);
+    AnnounceMessage announce;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(MessageDeserializer::deserialize_announce(view, announce));
+        benchmark::DoNotOptimize(announce);
+    }
+}
+BENCHMARK(BM_DeserializeAnnounce);
+
+// Field-by-field decoding of a whole Announce with BinaryReader
+static void BM_BinaryReaderAnnounce(benchmark::State& state) {
+    auto payload = MessageSerializer::serialize_announce(make_announce());
+    for (auto _ : state) {
+        BinaryReader reader(payload.data(), payload.size());
+        uint64_t sum = 0;
+        while (reader.remaining() >= 4) {
+            sum += reader.read_uint32();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * payload.size()));
+}
+BENCHMARK(BM_BinaryReaderAnnounce);
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include "clock_servo.hpp"
+
+using namespace gptp;
+using namespace gptp::servo;
+
+namespace {
+    constexpr int64_t SYNC_INTERVAL_NS = 125000000;
+
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+}
+
+static void BM_CalculateOffset(benchmark::State& state) {
+    ClockServo servo;
+    SyncMeasurement measurement;
+    measurement.path_delay = std::chrono::nanoseconds(500);
+    int64_t origin_ns = 1700000000000000000LL;
+    for (auto _ : state) {
+        origin_ns += SYNC_INTERVAL_NS;
+        measurement.master_timestamp = to_timestamp(origin_ns);
+        measurement.local_receipt_time = to_timestamp(origin_ns + 520);
+        benchmark::DoNotOptimize(servo.calculate_offset(measurement));
+    }
+}
+BENCHMARK(BM_CalculateOffset);
+
+// A servo tracking a small, steady offset, as when locked
+static void BM_UpdateServo(benchmark::State& state) {
+    ClockServo servo;
+    auto when = std::chrono::steady_clock::time_point();
+    int64_t step = 0;
+    for (auto _ : state) {
+        when += std::chrono::nanoseconds(SYNC_INTERVAL_NS);
+        auto offset = std::chrono::nanoseconds((step++ % 16) - 8);
+        benchmark::DoNotOptimize(servo.update_servo(offset, when));
+    }
+}
+BENCHMARK(BM_UpdateServo);
@@ -13,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <optional>
 
 namespace gptp {
 namespace bmca {
@@ -165,12 +166,13 @@ private:
  * @brief BMCA Decision Information
  */
 struct BmcaDecision {
+    uint16_t port_id;
     PortRole recommended_role;
     MasterInfo* selected_master;
     bool role_changed;
     std::chrono::steady_clock::time_point decision_time;
     
-    BmcaDecision() : recommended_role(PortRole::DISABLED), selected_master(nullptr), role_changed(false) {}
+    BmcaDecision() : port_id(0), recommended_role(PortRole::DISABLED), selected_master(nullptr), role_changed(false) {}
 };
 
 /**
@@ -196,10 +198,16 @@ public:
     
     /**
      * @brief Run BMCA decision process
+     * 
+     * Produces one decision per port that has received announce information.
+     * The port receiving the best master becomes SLAVE; other ports become
+     * MASTER unless their neighbor offers information at least as good as
+     * what this clock would send (PASSIVE). Ports without information are
+     * not listed and should act as MASTER.
      * @param local_priority Local clock priority vector
-     * @return BMCA decisions for all ports
+     * @return BMCA decisions for all ports, valid until the next run
      */
-    std::vector<BmcaDecision> run_bmca(const PriorityVector& local_priority);
+    const std::vector<BmcaDecision>& run_bmca(const PriorityVector& local_priority);
     
     /**
      * @brief Update local clock properties
@@ -218,6 +226,12 @@ public:
      */
     std::vector<uint16_t> check_announce_timeouts(std::chrono::steady_clock::time_point current_time);
     
+    /**
+     * @brief Forget master information learned on a port (e.g. on link down)
+     * @param port_id Port identifier
+     */
+    void clear_port(uint16_t port_id);
+    
     /**
      * @brief Get current master information for a port
      * @param port_id Port identifier
@@ -225,6 +239,11 @@ public:
      */
     const MasterInfo* get_master_info(uint16_t port_id) const;
     
+    /**
+     * @brief Get the number of ports with master information, valid or not
+     */
+    size_t get_master_count() const;
+    
     /**
      * @brief Get current grandmaster information
      * @return Grandmaster priority vector if available, nullptr otherwise
@@ -245,7 +264,7 @@ private:
     std::map<uint16_t, MasterInfo> port_masters_;
     
     // Current grandmaster selection
-    PriorityVector* current_grandmaster_;
+    std::optional<PriorityVector> current_grandmaster_;
     bool local_is_grandmaster_;
     
     // Local clock properties
@@ -254,6 +273,10 @@ private:
     uint8_t local_priority2_;
     
     std::chrono::steady_clock::time_point last_bmca_run_;
+    
+    // Reused by every run so that steady state does not allocate
+    std::vector<MasterInfo> candidates_;
+    std::vector<BmcaDecision> decisions_;
 };
 
 } // namespace bmca
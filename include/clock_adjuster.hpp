@@ -0,0 +1,44 @@
+/**
+ * @file clock_adjuster.hpp
+ * @brief Interface for disciplining the local clock
+ *
+ * The servo computes corrections; an IClockAdjuster applies them to a real
+ * clock (a NIC PTP hardware clock or the system clock).
+ */
+
+#pragma once
+
+#include "gptp_types.hpp"
+#include <chrono>
+#include <string>
+
+namespace gptp {
+
+/**
+ * @brief Clock adjustment interface used by the synchronization servo
+ */
+class IClockAdjuster {
+public:
+    virtual ~IClockAdjuster() = default;
+
+    /**
+     * @brief Set the clock frequency offset
+     * @param ppb Absolute frequency adjustment in parts per billion
+     * @return Result indicating success or error
+     */
+    virtual Result<bool> adjust_frequency(double ppb) = 0;
+
+    /**
+     * @brief Step the clock by a signed offset
+     * @param offset Amount to add to the current clock time
+     * @return Result indicating success or error
+     */
+    virtual Result<bool> step_clock(std::chrono::nanoseconds offset) = 0;
+
+    /**
+     * @brief Human readable name of the disciplined clock
+     */
+    virtual std::string get_name() const = 0;
+};
+
+} // namespace gptp
@@ -9,8 +9,8 @@
 #pragma once
 
 #include "gptp_protocol.hpp"
+#include "clock_adjuster.hpp"
 #include <chrono>
-#include <deque>
 #include <vector>
 #include <map>
 #include <memory>
@@ -149,7 +149,12 @@ public:
      * @brief Configure servo parameters
      * @param config New configuration
      */
-    void configure(const ServoConfig& config) { config_ = config; }
+    void configure(const ServoConfig& config);
+    
+    /**
+     * @brief Get servo parameters
+     */
+    const ServoConfig& get_config() const { return config_; }
 
 private:
     /**
@@ -171,9 +176,11 @@ private:
     
     ServoConfig config_;
     
-    // Offset measurement history
-    std::deque<std::chrono::nanoseconds> offset_history_;
-    std::deque<std::chrono::steady_clock::time_point> time_history_;
+    // Offset measurement history, reserved for max_samples + 1 entries
+    std::vector<std::chrono::nanoseconds> offset_history_;
+    std::vector<std::chrono::steady_clock::time_point> time_history_;
+    std::vector<double> scratch_;         // Sorted offsets and deviations
+    size_t consecutive_outliers_;
     
     // PI controller state
     double integral_accumulator_;
@@ -226,6 +233,12 @@ public:
      */
     void set_slave_port(uint16_t port_id);
     
+    /**
+     * @brief Discard servo state learned on a port
+     * @param port_id Port identifier
+     */
+    void reset_port(uint16_t port_id);
+    
     /**
      * @brief Get current synchronization status
      * @return Sync status for slave port
@@ -242,8 +255,19 @@ public:
     SyncStatus get_sync_status() const;
     
     /**
-     * @brief Apply clock adjustments to system
-     * This would integrate with platform-specific clock adjustment APIs
+     * @brief Set the clock that servo output is applied to
+     *
+     * Changing the clock resets every port's servo, so no frequency learned
+     * on the previous clock is applied to the new one.
+     * @param adjuster Clock adjuster (not owned), or nullptr to only compute
+     */
+    void set_clock_adjuster(IClockAdjuster* adjuster);
+    
+    /**
+     * @brief Apply the latest servo output to the clock adjuster
+     * 
+     * Offsets beyond the servo's max_phase_adjustment are stepped and the
+     * servo is reset; smaller offsets are slewed via frequency adjustment.
      */
     void apply_clock_adjustments();
     
@@ -258,6 +282,8 @@ private:
     std::map<uint16_t, std::unique_ptr<ClockServo>> port_servos_;
     uint16_t current_slave_port_;
     SyncStatus current_status_;
+    IClockAdjuster* clock_adjuster_;
+    bool adjustment_pending_;
     
     // Statistics
     std::chrono::steady_clock::time_point last_adjustment_time_;
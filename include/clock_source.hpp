@@ -0,0 +1,74 @@
+/**
+ * @file clock_source.hpp
+ * @brief Interface for reading the local clocks on hot paths
+ *
+ * Software timestamps, protocol timers and latency instrumentation read the
+ * wall clock and the monotonic clock through an IClockSource, so a cheaper
+ * source (the calibrated TSC on Linux x86-64) can replace clock_gettime
+ * process-wide, and simulations can run the protocol on virtual time.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace gptp {
+
+/**
+ * @brief Clock reading interface; implementations must be thread-safe
+ */
+class IClockSource {
+public:
+    virtual ~IClockSource() = default;
+
+    /**
+     * @brief Wall clock time (CLOCK_REALTIME), ns since the epoch
+     */
+    virtual int64_t now_realtime_ns() = 0;
+
+    /**
+     * @brief Monotonic time (CLOCK_MONOTONIC), ns
+     */
+    virtual int64_t now_monotonic_ns() = 0;
+
+    /**
+     * @brief Human readable name of the source
+     */
+    virtual std::string get_name() const = 0;
+};
+
+/**
+ * @brief Reads the operating system clocks directly
+ */
+class SystemClockSource : public IClockSource {
+public:
+    int64_t now_realtime_ns() override;
+    int64_t now_monotonic_ns() override;
+    std::string get_name() const override { return "system"; }
+};
+
+/**
+ * @brief Process-wide clock source; SystemClockSource unless replaced
+ */
+IClockSource& get_clock_source();
+
+/**
+ * @brief Replace the process-wide clock source
+ *
+ * Install at startup, before other threads read it; the source is not
+ * owned and must outlive its use.
+ * @param source New source, or nullptr to restore the system clocks
+ */
+void set_clock_source(IClockSource* source);
+
+/**
+ * @brief Monotonic time of the process-wide source as a steady_clock time point
+ */
+inline std::chrono::steady_clock::time_point steady_now() {
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::nanoseconds(get_clock_source().now_monotonic_ns())));
+}
+
+} // namespace gptp
@@ -6,9 +6,14 @@
 #pragma once
 
 #include "gptp_protocol.hpp"
+#include "gptp_message_parser.hpp"
 #include "bmca.hpp"
 #include "clock_servo.hpp"
+#include "clock_adjuster.hpp"
+#include "path_delay_calculator.hpp"
 #include "sequence_number_manager.hpp"
+#include "sync_sample.hpp"
+#include <array>
 #include <memory>
 #include <chrono>
 #include <functional>
@@ -39,6 +44,51 @@ public:
      * @brief Callback for port role changes
      */
     using RoleChangeCallback = std::function<void(uint16_t port_id, bmca::PortRole old_role, bmca::PortRole new_role)>;
+    
+    /**
+     * @brief Callback returning the transmit timestamp of the event message
+     *        most recently handed to MessageSender for a port
+     * @return false if no timestamp is available
+     */
+    using TxTimestampProvider = std::function<bool(uint16_t port_id, Timestamp& tx_time)>;
+    
+    /**
+     * @brief Callback receiving every servo update and peer delay measurement
+     */
+    using SyncSampleCallback = std::function<void(const SyncSample& sample)>;
+    
+    /**
+     * @brief Callback invoked when a validated frame is handed to its message handler
+     */
+    using DispatchCallback = std::function<void(uint16_t port_id, protocol::MessageType type)>;
+    
+    /**
+     * @brief Callback invoked right before a Sync is sent, with the time it was due
+     */
+    using SyncDueCallback = std::function<void(uint16_t port_id, std::chrono::steady_clock::time_point due_time)>;
+    
+    /**
+     * @brief Protocol-level loss counters of a port
+     */
+    struct PortCounters {
+        uint64_t syncs_lost = 0;            // Gaps in received Sync sequenceIds
+        uint64_t followups_missed = 0;      // Syncs that timed out waiting for Follow_Up
+        uint64_t followups_unmatched = 0;   // Follow_Ups without a pending Sync
+        uint64_t tx_timestamps_missing = 0; // Follow_Ups skipped or Pdelay exchanges aborted for lack of an egress timestamp
+    };
+
+    /**
+     * @brief Sizes of the per-message state, summed over all ports
+     *
+     * Each of these is bounded; a long-running system whose sizes keep
+     * growing has a leak.
+     */
+    struct StateSizes {
+        size_t ports = 0;
+        size_t pending_syncs = 0;           // Syncs awaiting their Follow_Up
+        size_t pdelay_history = 0;          // Exchanges kept for the neighbor rate ratio
+        size_t bmca_masters = 0;            // Master information learned from Announces
+    };
 
     /**
      * @brief Constructor
@@ -80,10 +130,62 @@ public:
      */
     void disable_port(uint16_t port_id);
 
+    /**
+     * @brief Report a change of the port's MAC operational state
+     * 
+     * Link down drops the port out of BMCA at once, stops peer delay and
+     * discards every measurement learned on the link. Link up restarts
+     * peer delay and announces immediately instead of waiting for the
+     * next interval.
+     * @param port_id Port identifier
+     * @param link_up true if the carrier is up
+     */
+    void set_link_status(uint16_t port_id, bool link_up);
+
+    /**
+     * @brief Get the last reported link state of a port
+     */
+    bool is_link_up(uint16_t port_id) const;
+
     /**
      * @brief Set role change callback
      */
     void set_role_change_callback(RoleChangeCallback callback);
+    
+    /**
+     * @brief Set source of egress timestamps for Sync and Pdelay messages
+     * 
+     * Without a provider the local system time at transmission is used. If
+     * the provider has no timestamp for the message just sent, the Follow_Up
+     * carrying it is not sent (or the Pdelay exchange is abandoned) rather
+     * than filled with a less precise time.
+     */
+    void set_tx_timestamp_provider(TxTimestampProvider provider);
+    
+    /**
+     * @brief Set observer of per-sample synchronization data (tracing, metrics)
+     */
+    void set_sync_sample_callback(SyncSampleCallback callback);
+    
+    /**
+     * @brief Set latency probes for frame dispatch and Sync scheduling
+     */
+    void set_dispatch_callback(DispatchCallback callback);
+    void set_sync_due_callback(SyncDueCallback callback);
+    
+    /**
+     * @brief Set the clock disciplined by the servo of every domain
+     * @param adjuster Clock adjuster (not owned), or nullptr
+     */
+    void set_clock_adjuster(IClockAdjuster* adjuster);
+    
+    /**
+     * @brief Set the local clock's BMCA properties
+     * 
+     * Used both for the local priority vector and for announces sent while
+     * this clock is grandmaster.
+     */
+    void set_local_clock_properties(uint8_t priority1, const ClockQuality& quality, uint8_t priority2);
 
     // ========================================================================
     // Message Processing with BMCA Integration
@@ -115,6 +217,42 @@ public:
      * @param followup Received follow-up message
      */
     void process_followup_message(uint16_t port_id, const FollowUpMessage& followup);
+    
+    /**
+     * @brief Process received Pdelay_Req (responder side)
+     */
+    void process_pdelay_req_message(uint16_t port_id,
+                                    const PdelayReqMessage& request,
+                                    const Timestamp& receipt_time);
+    
+    /**
+     * @brief Process received Pdelay_Resp (initiator side)
+     */
+    void process_pdelay_resp_message(uint16_t port_id,
+                                     const PdelayRespMessage& response,
+                                     const Timestamp& receipt_time);
+    
+    /**
+     * @brief Process received Pdelay_Resp_Follow_Up and complete a measurement
+     */
+    void process_pdelay_resp_followup_message(uint16_t port_id,
+                                              const PdelayRespFollowUpMessage& followup);
+    
+    /**
+     * @brief Validate and dispatch a received gPTP message
+     * 
+     * Decodes only the header up front and the body of the matching type;
+     * no copies of the frame are made.
+     * @param port_id Port that received the frame
+     * @param payload gPTP message (after the Ethernet header)
+     * @param length Payload length in bytes
+     * @param receipt_time Ingress timestamp of the frame
+     * @return SUCCESS if the message was accepted or deliberately ignored
+     */
+    ParseResult process_frame(uint16_t port_id,
+                              const uint8_t* payload,
+                              size_t length,
+                              const Timestamp& receipt_time);
 
     // ========================================================================
     // Periodic Operations
@@ -144,6 +282,38 @@ public:
      * @brief Get BMCA decisions for all ports
      */
     std::vector<bmca::BmcaDecision> get_bmca_decisions() const;
+    
+    /**
+     * @brief Get the measured mean link delay of a port
+     */
+    std::chrono::nanoseconds get_link_delay(uint16_t port_id) const;
+    
+    /**
+     * @brief Get the neighbor rate ratio measured by peer delay
+     */
+    double get_neighbor_rate_ratio(uint16_t port_id) const;
+    
+    /**
+     * @brief Get the loss counters of a port
+     */
+    PortCounters get_port_counters(uint16_t port_id) const;
+    
+    /**
+     * @brief Get the sizes of the per-message state
+     */
+    StateSizes get_state_sizes() const;
+    
+    /**
+     * @brief Get the grandmaster of a port's domain
+     * @return Priority vector of the selected grandmaster, or the local one
+     *         while this clock is grandmaster
+     */
+    bmca::PriorityVector get_grandmaster(uint16_t port_id) const;
+    
+    /**
+     * @brief Get the identity of this time-aware system
+     */
+    const ClockIdentity& get_local_clock_id() const { return local_clock_id_; }
 
 private:
     // ========================================================================
@@ -154,18 +324,37 @@ private:
         std::unique_ptr<GptpPort> gptp_port;
         uint8_t domain_number;
         bmca::PortRole current_role;
+        bool enabled;
+        bool link_up;
         std::chrono::steady_clock::time_point last_announce_tx_time;
         std::chrono::steady_clock::time_point last_sync_tx_time;
         
-        // Pending sync/follow-up correlation
+        // Pending sync/follow-up correlation. A two-step master sends each
+        // Follow_Up right after its Sync, so a few slots cover reordering;
+        // more would only accumulate on Follow_Up loss
         struct PendingSync {
+            bool valid = false;
+            uint16_t sequence_id = 0;
             SyncMessage sync_message;
             Timestamp receipt_time;
             std::chrono::steady_clock::time_point timeout;
         };
-        std::map<uint16_t, PendingSync> pending_syncs;  // Key: sequence ID
+        static constexpr size_t MAX_PENDING_SYNCS = 4;
+        std::array<PendingSync, MAX_PENDING_SYNCS> pending_syncs;
+        uint16_t last_sync_sequence;
+        bool last_sync_sequence_valid;
+        PortCounters counters;
         
-        PortInfo() : domain_number(0), current_role(bmca::PortRole::DISABLED) {}
+        // Peer delay measurement (IEEE 802.1AS-2021 clause 11.2.19)
+        std::unique_ptr<path_delay::StandardP2PDelayCalculator> delay_calculator;
+        path_delay::PdelayTimestamps pending_pdelay;
+        bool pdelay_in_progress;
+        std::vector<path_delay::PdelayTimestamps> pdelay_history;
+        std::chrono::nanoseconds link_delay;
+        bool link_delay_valid;
+        std::chrono::steady_clock::time_point last_pdelay_tx_time;
+        
+        PortInfo(); // Implemented in .cpp to handle incomplete types
     };
 
     // ========================================================================
@@ -175,6 +364,16 @@ private:
     ClockIdentity local_clock_id_;
     MessageSender message_sender_;
     RoleChangeCallback role_change_callback_;
+    TxTimestampProvider tx_timestamp_provider_;
+    SyncSampleCallback sync_sample_callback_;
+    DispatchCallback dispatch_callback_;
+    SyncDueCallback sync_due_callback_;
+    IClockAdjuster* clock_adjuster_;
+    
+    // Local clock BMCA properties (IEEE 802.1AS defaults for an end station)
+    uint8_t local_priority1_;
+    ClockQuality local_clock_quality_;
+    uint8_t local_priority2_;
     
     // IEEE 802.1AS-2021 Section 10.5.7 - Sequence Number Management
     sequence::SequenceNumberManager sequence_manager_;
@@ -195,6 +394,11 @@ private:
     std::chrono::seconds announce_interval_;
     std::chrono::milliseconds sync_interval_;
     std::chrono::milliseconds followup_timeout_;
+    std::chrono::milliseconds pdelay_interval_;
+    std::map<uint8_t, std::chrono::steady_clock::time_point> last_bmca_run_;
+    
+    // Serialized messages are built here, sized for the largest once
+    std::vector<uint8_t> tx_buffer_;
 
     // ========================================================================
     // Internal Methods
@@ -215,6 +419,22 @@ private:
      */
     void handle_role_change(uint16_t port_id, bmca::PortRole new_role);
     
+    /**
+     * @brief Run BMCA for a domain and apply the resulting port roles
+     */
+    void run_bmca_for_domain(uint8_t domain_number);
+    
+    /**
+     * @brief Transmit Pdelay_Req from a port
+     */
+    void transmit_pdelay_request(uint16_t port_id);
+    
+    /**
+     * @brief Get egress timestamp of the last event message sent on a port
+     * @return false if the provider has no timestamp for it; the failure is counted
+     */
+    bool get_tx_timestamp(uint16_t port_id, Timestamp& tx_time);
+    
     /**
      * @brief Transmit announce message from a port
      */
@@ -242,10 +462,19 @@ private:
     
     /**
      * @brief Serialize message to bytes for network transmission
+     * @return Transmit buffer, valid until the next call
+     */
+    const std::vector<uint8_t>& serialize_message(const AnnounceMessage& message);
+    const std::vector<uint8_t>& serialize_message(const SyncMessage& message);
+    const std::vector<uint8_t>& serialize_message(const FollowUpMessage& message);
+    const std::vector<uint8_t>& serialize_message(const PdelayReqMessage& message);
+    const std::vector<uint8_t>& serialize_message(const PdelayRespMessage& message);
+    const std::vector<uint8_t>& serialize_message(const PdelayRespFollowUpMessage& message);
+    
+    /**
+     * @brief Clear all pending Syncs of a port
      */
-    std::vector<uint8_t> serialize_message(const AnnounceMessage& message);
-    std::vector<uint8_t> serialize_message(const SyncMessage& message);
-    std::vector<uint8_t> serialize_message(const FollowUpMessage& message);
+    static void clear_pending_syncs(PortInfo& port_info);
     
     /**
      * @brief Create local priority vector for BMCA
@@ -1,9 +1,6 @@
 /**
  * @file gptp_socket.hpp
- * @brief IEEE 802.1AS gPTP soc        // Get best available timestamp
-        std::chrono::nanoseconds get_timestamp() const {
-            return is_hardware_timestamp ? hardware_timestamp : software_timestamp;
-        }handling for raw Ethernet frames
+ * @brief IEEE 802.1AS gPTP socket handling for raw Ethernet frames
  * 
  * This file provides platform-agnostic socket handling for gPTP messages
  * using raw Ethernet sockets with proper timestamping support.
@@ -25,18 +22,40 @@ namespace gptp {
 
     // Using Result template from gptp_types.hpp
 
+    /**
+     * @brief Where a packet timestamp was taken, most precise first
+     */
+    enum class TimestampSource : uint8_t {
+        NONE,
+        HARDWARE,           // NIC PHC, in the PHC time base
+        KERNEL_SOFTWARE,    // Kernel network stack, CLOCK_REALTIME
+        USERSPACE           // clock read after the syscall returned, CLOCK_REALTIME
+    };
+
+    inline const char* to_string(TimestampSource source) {
+        switch (source) {
+            case TimestampSource::NONE: return "none";
+            case TimestampSource::HARDWARE: return "hardware";
+            case TimestampSource::KERNEL_SOFTWARE: return "kernel_software";
+            case TimestampSource::USERSPACE: return "userspace";
+        }
+        return "unknown";
+    }
+
     /**
      * @brief Timestamp information for received/transmitted packets
      */
     struct PacketTimestamp {
         std::chrono::nanoseconds hardware_timestamp{0};
         std::chrono::nanoseconds software_timestamp{0};
-        bool is_hardware_timestamp = false;
+        TimestampSource source = TimestampSource::NONE;     // Source of get_best_timestamp()
         bool software_timestamp_valid = false;
         
+        bool is_valid() const { return source != TimestampSource::NONE; }
+
         // Get the best available timestamp
         std::chrono::nanoseconds get_best_timestamp() const {
-            return is_hardware_timestamp ? hardware_timestamp : software_timestamp;
+            return source == TimestampSource::HARDWARE ? hardware_timestamp : software_timestamp;
         }
     };
 
@@ -92,6 +111,43 @@ namespace gptp {
          */
         virtual Result<ReceivedPacket> receive_packet(uint32_t timeout_ms = 0) = 0;
 
+        /**
+         * @brief Receive one packet without blocking
+         *
+         * Used by event-loop driven callers after the native handle became
+         * readable. Returns ErrorCode::TIMEOUT when nothing is queued.
+         * @return Result containing received packet or error
+         */
+        virtual Result<ReceivedPacket> try_receive_packet() {
+            return receive_packet(1);
+        }
+
+        /**
+         * @brief Receive one packet without blocking into a caller-owned buffer
+         *
+         * Like try_receive_packet(), but reuses the capacity of
+         * received.packet.payload so that a steady stream of frames does not
+         * allocate. Sockets that cannot do so move a fresh packet in.
+         * @param received Overwritten with the packet on success
+         * @return Result indicating success or error
+         */
+        virtual Result<bool> try_receive_packet_into(ReceivedPacket& received) {
+            auto result = try_receive_packet();
+            if (result.has_error()) {
+                return Result<bool>::error(result.error());
+            }
+            received = std::move(result.value());
+            return Result<bool>::success(true);
+        }
+
+        /**
+         * @brief Get the OS handle that becomes readable when packets arrive
+         * @return File descriptor, or -1 if the socket cannot be polled
+         */
+        virtual int get_native_handle() const {
+            return -1;
+        }
+
         /**
          * @brief Start asynchronous packet reception
          * @param callback Callback function for received packets
@@ -110,6 +166,14 @@ namespace gptp {
          */
         virtual bool is_hardware_timestamping_available() const = 0;
 
+        /**
+         * @brief Get the timestamping mode the socket was set up with
+         * @return Source expected for receive timestamps
+         */
+        virtual TimestampSource get_timestamp_mode() const {
+            return is_hardware_timestamping_available() ? TimestampSource::HARDWARE : TimestampSource::USERSPACE;
+        }
+
         /**
          * @brief Get the MAC address of the interface
          * @return MAC address as byte array
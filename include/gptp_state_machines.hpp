@@ -135,13 +135,15 @@ namespace gptp {
             void on_state_entry(int state) override;
             void on_state_exit(int state) override;
             
-            // Message serialization and transmission helpers
-            std::vector<uint8_t> serialize_sync_message(const SyncMessage& sync_msg);
-            std::vector<uint8_t> serialize_followup_message(const FollowUpMessage& followup_msg);
+            // Message serialization and transmission helpers; the returned
+            // buffer is reused by the next call
+            const std::vector<uint8_t>& serialize_sync_message(const SyncMessage& sync_msg);
+            const std::vector<uint8_t>& serialize_followup_message(const FollowUpMessage& followup_msg);
             void schedule_followup_transmission();
             
             GptpPort* port_;
             std::shared_ptr<IGptpSocket> socket_;  // Network socket for message transmission
+            std::vector<uint8_t> tx_buffer_;
             std::chrono::nanoseconds follow_up_receipt_timeout_;
             std::chrono::nanoseconds last_md_sync_time_;
             bool waiting_for_follow_up_;
@@ -287,6 +289,15 @@ namespace gptp {
         void enable();
         void disable();
         
+        /**
+         * @brief Update MAC operational state (portOper, IEEE 802.1AS-2021 10.2.5.12)
+         * 
+         * A port with its link down is not ticked and its link delay
+         * measurement is stopped, independent of the administrative state.
+         */
+        void set_link_status(bool link_up);
+        bool is_link_up() const { return link_up_; }
+        
         // Message processing
         void process_sync_message(const SyncMessage& sync, const Timestamp& receipt_time);
         void process_follow_up_message(const FollowUpMessage& follow_up);
@@ -327,6 +338,7 @@ namespace gptp {
         std::unique_ptr<state_machine::SiteSyncSyncStateMachine> site_sync_sm_;
         
         bool enabled_;
+        bool link_up_;
     };
 
     /**
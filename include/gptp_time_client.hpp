@@ -0,0 +1,235 @@
+/**
+ * @file gptp_time_client.hpp
+ * @brief Header-only reader of the gPTP time published in shared memory
+ *
+ * The daemon publishes its synchronization state into a POSIX shared memory
+ * segment (system.time_shm_name, "/gptp-time" by default) protected by a
+ * sequence lock. Applications map it read-only and convert local
+ * CLOCK_MONOTONIC readings to gPTP time without system calls or IPC:
+ *
+ *   gptp::TimeClient client;
+ *   if (client.open()) {
+ *       int64_t now_gptp_ns;
+ *       if (client.now(now_gptp_ns)) { ... }
+ *   }
+ *
+ * This header depends only on the C++ and POSIX standard libraries so it can
+ * be copied into audio/AVB applications as is.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace gptp {
+
+// ============================================================================
+// Shared Memory Layout
+// ============================================================================
+
+namespace shm {
+
+constexpr const char* DEFAULT_TIME_SEGMENT = "/gptp-time";
+constexpr uint32_t TIME_MAGIC = 0x53545047;     // "GPTS"
+constexpr uint16_t TIME_VERSION = 1;
+
+enum TimeFlags : uint32_t {
+    TIME_VALID = 1u << 0,           // Cleared when the daemon shuts down
+    TIME_SYNCHRONIZED = 1u << 1,    // A slave port follows a master
+    TIME_SERVO_LOCKED = 1u << 2,
+    TIME_GRANDMASTER = 1u << 3,     // This system is the grandmaster
+    TIME_DISCIPLINED = 1u << 4      // The daemon adjusts the reference clock
+};
+
+/**
+ * @brief Synchronization state; one consistent copy per sequence number
+ *
+ * gPTP time at CLOCK_MONOTONIC instant t is
+ *   gptp_ref_ns + (t - monotonic_ref_ns) * rate_ratio
+ * where (monotonic_ref_ns, clock_ref_ns) is a cross-timestamp between the
+ * system clock and the disciplined clock, and gptp_ref_ns is clock_ref_ns
+ * corrected by the last measured offset from the master.
+ */
+struct TimeData {
+    uint32_t flags;
+    int32_t phc_index;              // Disciplined /dev/ptpN, -1 for CLOCK_REALTIME
+    int64_t offset_ns;              // Last offset from master (local - master)
+    double frequency_ppb;           // Servo frequency output
+    double rate_ratio;              // d(gPTP time) / d(CLOCK_MONOTONIC)
+    int64_t monotonic_ref_ns;       // CLOCK_MONOTONIC of the cross-timestamp
+    int64_t realtime_ref_ns;        // CLOCK_REALTIME of the cross-timestamp
+    int64_t clock_ref_ns;           // Disciplined clock of the cross-timestamp
+    int64_t gptp_ref_ns;            // gPTP time at monotonic_ref_ns
+    int64_t cross_uncertainty_ns;   // Half width of the cross-timestamp window
+    uint8_t grandmaster_identity[8];
+    uint16_t steps_removed;
+    uint16_t slave_port_id;         // 0 if no port is slave
+    uint32_t reserved0;
+    uint64_t update_count;
+
+    /**
+     * @brief Convert a CLOCK_MONOTONIC reading to gPTP nanoseconds
+     */
+    int64_t to_gptp_ns(int64_t monotonic_ns) const {
+        int64_t delta = monotonic_ns - monotonic_ref_ns;
+        double correction = static_cast<double>(delta) * (rate_ratio - 1.0);
+        return gptp_ref_ns + delta + static_cast<int64_t>(correction < 0 ? correction - 0.5 : correction + 0.5);
+    }
+
+    /**
+     * @brief Convert gPTP nanoseconds to a CLOCK_MONOTONIC instant
+     */
+    int64_t to_monotonic_ns(int64_t gptp_ns) const {
+        double delta = static_cast<double>(gptp_ns - gptp_ref_ns) / rate_ratio;
+        return monotonic_ref_ns + static_cast<int64_t>(delta < 0 ? delta - 0.5 : delta + 0.5);
+    }
+};
+
+/**
+ * @brief The shared memory segment
+ *
+ * The writer makes sequence odd, updates data, then makes it even again.
+ * Readers retry while it is odd or changed across their copy.
+ */
+struct alignas(64) TimeSegment {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t data_size;
+    std::atomic<uint32_t> sequence;
+    uint32_t reserved;
+    TimeData data;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seqlock needs a lock-free counter");
+static_assert(sizeof(TimeData) == 96, "shared memory layout");
+
+/**
+ * @brief Sequence lock read of a segment
+ * @return false if the writer kept it busy for all attempts
+ */
+inline bool read_segment(const TimeSegment& segment, TimeData& out, int max_attempts = 64) {
+    for (int attempt = 0; attempt < max_attempts; ++attempt) {
+        uint32_t begin = segment.sequence.load(std::memory_order_acquire);
+        if (begin & 1u) {
+            continue;
+        }
+        std::memcpy(&out, &segment.data, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment.sequence.load(std::memory_order_relaxed) == begin) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sequence lock write of a segment (single writer)
+ */
+inline void write_segment(TimeSegment& segment, const TimeData& data) {
+    uint32_t sequence = segment.sequence.load(std::memory_order_relaxed);
+    segment.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&segment.data, &data, sizeof(data));
+    segment.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+} // namespace shm
+
+#ifndef _WIN32
+
+// ============================================================================
+// Client
+// ============================================================================
+
+/**
+ * @brief Read-only view of the daemon's time segment
+ */
+class TimeClient {
+public:
+    TimeClient() = default;
+    ~TimeClient() { close(); }
+
+    TimeClient(const TimeClient&) = delete;
+    TimeClient& operator=(const TimeClient&) = delete;
+
+    /**
+     * @brief Map the segment
+     * @return false if it does not exist or has an incompatible layout
+     */
+    bool open(const char* name = shm::DEFAULT_TIME_SEGMENT) {
+        close();
+        int fd = ::shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+        if (fd < 0) {
+            return false;
+        }
+        void* mapping = ::mmap(nullptr, sizeof(shm::TimeSegment), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        segment_ = static_cast<const shm::TimeSegment*>(mapping);
+        if (segment_->magic != shm::TIME_MAGIC || segment_->version != shm::TIME_VERSION ||
+            segment_->data_size != sizeof(shm::TimeData)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (segment_ != nullptr) {
+            ::munmap(const_cast<shm::TimeSegment*>(segment_), sizeof(shm::TimeSegment));
+            segment_ = nullptr;
+        }
+    }
+
+    bool is_open() const { return segment_ != nullptr; }
+
+    /**
+     * @brief Copy the current state
+     *
+     * The daemon refreshes the segment every 125 ms; a monotonic_ref_ns far
+     * in the past means it died without clearing TIME_VALID.
+     * @return false if not open, not valid or the copy kept tearing
+     */
+    bool read(shm::TimeData& data) const {
+        return segment_ != nullptr && shm::read_segment(*segment_, data) && (data.flags & shm::TIME_VALID);
+    }
+
+    /**
+     * @brief Convert a CLOCK_MONOTONIC reading to gPTP nanoseconds
+     */
+    bool to_gptp_ns(int64_t monotonic_ns, int64_t& gptp_ns) const {
+        shm::TimeData data;
+        if (!read(data)) {
+            return false;
+        }
+        gptp_ns = data.to_gptp_ns(monotonic_ns);
+        return true;
+    }
+
+    /**
+     * @brief Current gPTP time; clock_gettime(CLOCK_MONOTONIC) runs in the vDSO
+     */
+    bool now(int64_t& gptp_ns) const {
+        struct timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC, &ts);
+        return to_gptp_ns(static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec, gptp_ns);
+    }
+
+private:
+    const shm::TimeSegment* segment_ = nullptr;
+};
+
+#endif // _WIN32
+
+} // namespace gptp
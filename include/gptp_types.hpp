@@ -48,7 +48,8 @@ namespace gptp {
         NETWORK_ERROR,
         INVALID_PARAMETER,
         INSUFFICIENT_PRIVILEGES,
-        INITIALIZATION_FAILED
+        INITIALIZATION_FAILED,
+        TIMEOUT
     };
 
     template<typename T>
@@ -76,7 +77,7 @@ namespace gptp {
                        error_message.find("Error") != std::string::npos) {
                 return Result<T>(ErrorCode::NETWORK_ERROR);
             } else if (error_message.find("Timeout") != std::string::npos) {
-                return Result<T>(ErrorCode::NETWORK_ERROR);
+                return Result<T>(ErrorCode::TIMEOUT);
             }
             return Result<T>(ErrorCode::NETWORK_ERROR);  // Default fallback
         }
@@ -124,6 +125,7 @@ namespace gptp {
         MacAddress mac_address;
         bool is_active = false;
         TimestampCapabilities capabilities;
+        int phc_index = -1;          // PTP hardware clock (/dev/ptpN on Linux), -1 if none
     };
 
 } // namespace gptp
@@ -29,10 +29,26 @@ namespace serialization {
 
 /**
  * @brief Binary serialization writer with network byte order
+ *
+ * Writes into its own vector, or into a caller's buffer that is cleared
+ * but keeps its capacity, so a reused buffer costs no allocation.
  */
 class BinaryWriter {
 public:
-    BinaryWriter() : data_(), offset_(0) {}
+    // Largest message this writer produces: an Announce without TLVs
+    static constexpr size_t MAX_MESSAGE_SIZE = 64;
+    
+    BinaryWriter() : storage_(), data_(storage_), offset_(0) {
+        data_.reserve(MAX_MESSAGE_SIZE);
+    }
+    
+    explicit BinaryWriter(std::vector<uint8_t>& buffer) : storage_(), data_(buffer), offset_(0) {
+        data_.clear();
+        data_.reserve(MAX_MESSAGE_SIZE);
+    }
+    
+    BinaryWriter(const BinaryWriter&) = delete;
+    BinaryWriter& operator=(const BinaryWriter&) = delete;
     
     /**
      * @brief Write 8-bit value (no endianness conversion needed)
@@ -146,23 +162,28 @@ public:
     }
 
 private:
-    std::vector<uint8_t> data_;
+    std::vector<uint8_t> storage_;
+    std::vector<uint8_t>& data_;
     size_t offset_;
 };
 
 /**
  * @brief Binary deserialization reader with network byte order
+ *
+ * The reader is a non-owning view over the input buffer, so parsing a
+ * received frame does not copy it. The buffer must outlive the reader.
  */
 class BinaryReader {
 public:
-    BinaryReader(const std::vector<uint8_t>& data) : data_(data), offset_(0) {}
-    BinaryReader(const uint8_t* data, size_t length) : data_(data, data + length), offset_(0) {}
+    BinaryReader(const std::vector<uint8_t>& data) : data_(data.data()), size_(data.size()), offset_(0) {}
+    BinaryReader(const uint8_t* data, size_t length) : data_(data), size_(length), offset_(0) {}
+    BinaryReader(std::vector<uint8_t>&&) = delete; // Would dangle
     
     /**
      * @brief Read 8-bit value
      */
     uint8_t read_uint8() {
-        if (offset_ >= data_.size()) throw std::runtime_error("Buffer underrun");
+        if (offset_ >= size_) throw std::runtime_error("Buffer underrun");
         return data_[offset_++];
     }
     
@@ -170,7 +191,7 @@ public:
      * @brief Read 16-bit value from network byte order
      */
     uint16_t read_uint16() {
-        if (offset_ + 2 > data_.size()) throw std::runtime_error("Buffer underrun");
+        if (offset_ + 2 > size_) throw std::runtime_error("Buffer underrun");
         uint16_t net_value;
         std::memcpy(&net_value, &data_[offset_], 2);
         offset_ += 2;
@@ -181,7 +202,7 @@ public:
      * @brief Read 32-bit value from network byte order
      */
     uint32_t read_uint32() {
-        if (offset_ + 4 > data_.size()) throw std::runtime_error("Buffer underrun");
+        if (offset_ + 4 > size_) throw std::runtime_error("Buffer underrun");
         uint32_t net_value;
         std::memcpy(&net_value, &data_[offset_], 4);
         offset_ += 4;
@@ -208,7 +229,7 @@ public:
      * @brief Read array of bytes
      */
     void read_bytes(uint8_t* bytes, size_t length) {
-        if (offset_ + length > data_.size()) throw std::runtime_error("Buffer underrun");
+        if (offset_ + length > size_) throw std::runtime_error("Buffer underrun");
         std::memcpy(bytes, &data_[offset_], length);
         offset_ += length;
     }
@@ -245,18 +266,19 @@ public:
      * @brief Get remaining bytes
      */
     size_t remaining() const {
-        return data_.size() - offset_;
+        return size_ - offset_;
     }
     
     /**
      * @brief Check if at end
      */
     bool at_end() const {
-        return offset_ >= data_.size();
+        return offset_ >= size_;
     }
 
 private:
-    std::vector<uint8_t> data_;
+    const uint8_t* data_;
+    size_t size_;
     size_t offset_;
 };
 
@@ -361,11 +383,11 @@ public:
     }
     
     /**
-     * @brief Serialize Announce message
+     * @brief Serialize Announce message into a buffer, replacing its contents
      * IEEE 802.1AS-2021 Section 11.2.12
      */
-    static std::vector<uint8_t> serialize_announce(const AnnounceMessage& message) {
-        BinaryWriter writer;
+    static void serialize_announce(const AnnounceMessage& message, std::vector<uint8_t>& buffer) {
+        BinaryWriter writer(buffer);
         
         // Serialize header (34 bytes)
         serialize_header(writer, message.header);
@@ -380,48 +402,60 @@ public:
         writer.write_clock_identity(message.grandmasterIdentity); // 8 bytes
         writer.write_uint16(message.stepsRemoved);              // 2 bytes
         writer.write_uint8(message.timeSource);                 // 1 byte
-        
-        return writer.get_data();
+    }
+    
+    static std::vector<uint8_t> serialize_announce(const AnnounceMessage& message) {
+        std::vector<uint8_t> buffer;
+        serialize_announce(message, buffer);
+        return buffer;
     }
     
     /**
-     * @brief Serialize Sync message
+     * @brief Serialize Sync message into a buffer, replacing its contents
      * IEEE 802.1AS-2021 Section 11.2.9
      */
-    static std::vector<uint8_t> serialize_sync(const SyncMessage& message) {
-        BinaryWriter writer;
+    static void serialize_sync(const SyncMessage& message, std::vector<uint8_t>& buffer) {
+        BinaryWriter writer(buffer);
         
         // Serialize header (34 bytes)
         serialize_header(writer, message.header);
         
         // Serialize sync-specific fields
         writer.write_timestamp(message.originTimestamp);        // 10 bytes
-        
-        return writer.get_data();
+    }
+    
+    static std::vector<uint8_t> serialize_sync(const SyncMessage& message) {
+        std::vector<uint8_t> buffer;
+        serialize_sync(message, buffer);
+        return buffer;
     }
     
     /**
-     * @brief Serialize Follow_Up message
+     * @brief Serialize Follow_Up message into a buffer, replacing its contents
      * IEEE 802.1AS-2021 Section 11.2.10
      */
-    static std::vector<uint8_t> serialize_followup(const FollowUpMessage& message) {
-        BinaryWriter writer;
+    static void serialize_followup(const FollowUpMessage& message, std::vector<uint8_t>& buffer) {
+        BinaryWriter writer(buffer);
         
         // Serialize header (34 bytes)
         serialize_header(writer, message.header);
         
         // Serialize follow_up-specific fields
         writer.write_timestamp(message.preciseOriginTimestamp); // 10 bytes
-        
-        return writer.get_data();
+    }
+    
+    static std::vector<uint8_t> serialize_followup(const FollowUpMessage& message) {
+        std::vector<uint8_t> buffer;
+        serialize_followup(message, buffer);
+        return buffer;
     }
     
     /**
-     * @brief Serialize Pdelay_Req message
+     * @brief Serialize Pdelay_Req message into a buffer, replacing its contents
      * IEEE 802.1AS-2021 Section 11.2.5
      */
-    static std::vector<uint8_t> serialize_pdelay_req(const PdelayReqMessage& message) {
-        BinaryWriter writer;
+    static void serialize_pdelay_req(const PdelayReqMessage& message, std::vector<uint8_t>& buffer) {
+        BinaryWriter writer(buffer);
         
         // Serialize header (34 bytes)
         serialize_header(writer, message.header);
@@ -429,16 +463,20 @@ public:
         // Serialize pdelay_req-specific fields
         writer.write_timestamp(message.originTimestamp);        // 10 bytes
         writer.write_bytes(message.reserved, 10);               // 10 bytes reserved
-        
-        return writer.get_data();
+    }
+    
+    static std::vector<uint8_t> serialize_pdelay_req(const PdelayReqMessage& message) {
+        std::vector<uint8_t> buffer;
+        serialize_pdelay_req(message, buffer);
+        return buffer;
     }
     
     /**
-     * @brief Serialize Pdelay_Resp message
+     * @brief Serialize Pdelay_Resp message into a buffer, replacing its contents
      * IEEE 802.1AS-2021 Section 11.2.6
      */
-    static std::vector<uint8_t> serialize_pdelay_resp(const PdelayRespMessage& message) {
-        BinaryWriter writer;
+    static void serialize_pdelay_resp(const PdelayRespMessage& message, std::vector<uint8_t>& buffer) {
+        BinaryWriter writer(buffer);
         
         // Serialize header (34 bytes)
         serialize_header(writer, message.header);
@@ -447,8 +485,34 @@ public:
         writer.write_timestamp(message.requestReceiptTimestamp); // 10 bytes
         writer.write_clock_identity(message.requestingPortIdentity.clockIdentity); // 8 bytes
         writer.write_uint16(message.requestingPortIdentity.portNumber); // 2 bytes
+    }
+    
+    static std::vector<uint8_t> serialize_pdelay_resp(const PdelayRespMessage& message) {
+        std::vector<uint8_t> buffer;
+        serialize_pdelay_resp(message, buffer);
+        return buffer;
+    }
+    
+    /**
+     * @brief Serialize Pdelay_Resp_Follow_Up message into a buffer, replacing its contents
+     * IEEE 802.1AS-2021 Section 11.2.7
+     */
+    static void serialize_pdelay_resp_followup(const PdelayRespFollowUpMessage& message, std::vector<uint8_t>& buffer) {
+        BinaryWriter writer(buffer);
         
-        return writer.get_data();
+        // Serialize header (34 bytes)
+        serialize_header(writer, message.header);
+        
+        // Serialize pdelay_resp_follow_up-specific fields
+        writer.write_timestamp(message.responseOriginTimestamp); // 10 bytes
+        writer.write_clock_identity(message.requestingPortIdentity.clockIdentity); // 8 bytes
+        writer.write_uint16(message.requestingPortIdentity.portNumber); // 2 bytes
+    }
+    
+    static std::vector<uint8_t> serialize_pdelay_resp_followup(const PdelayRespFollowUpMessage& message) {
+        std::vector<uint8_t> buffer;
+        serialize_pdelay_resp_followup(message, buffer);
+        return buffer;
     }
     
     /**
@@ -468,6 +532,9 @@ public:
             case protocol::MessageType::PDELAY_RESP:
                 return 54;  // 34 (header) + 10 (timestamp) + 8 (clock) + 2 (port)
                 
+            case protocol::MessageType::PDELAY_RESP_FOLLOW_UP:
+                return 54;  // 34 (header) + 10 (timestamp) + 8 (clock) + 2 (port)
+                
             case protocol::MessageType::ANNOUNCE:
                 return 64;  // 34 (header) + 30 (announce fields)
                 
@@ -477,6 +544,124 @@ public:
     }
 };
 
+/**
+ * @brief Zero-copy view over a received gPTP message
+ *
+ * Only the common header is decoded up front; the message body is decoded
+ * on demand by MessageDeserializer once the receiver knows it wants it.
+ */
+struct MessageView {
+    const uint8_t* data;
+    size_t length;
+    GptpMessageHeader header;
+    
+    MessageView() : data(nullptr), length(0) {}
+    
+    protocol::MessageType type() const {
+        return static_cast<protocol::MessageType>(header.messageType);
+    }
+    
+    /**
+     * @brief Decode the header of a gPTP payload (after the Ethernet header)
+     * @param payload Message bytes
+     * @param payload_length Number of bytes available
+     * @param view Output view
+     * @return false if the buffer is too short to hold a header
+     */
+    static bool parse(const uint8_t* payload, size_t payload_length, MessageView& view) {
+        if (payload == nullptr || payload_length < HEADER_SIZE) {
+            return false;
+        }
+        BinaryReader reader(payload, payload_length);
+        view.header = MessageSerializer::deserialize_header(reader);
+        view.data = payload;
+        view.length = payload_length;
+        return true;
+    }
+    
+    static constexpr size_t HEADER_SIZE = 34;
+};
+
+/**
+ * @brief IEEE 802.1AS Message Deserializer
+ *
+ * Each function validates the length up front, so none of them can throw
+ * on truncated input; they return false instead.
+ */
+class MessageDeserializer {
+public:
+    static bool deserialize_announce(const MessageView& view, AnnounceMessage& message) {
+        if (!has_body(view, protocol::MessageType::ANNOUNCE)) return false;
+        BinaryReader reader = body_reader(view);
+        message.header = view.header;
+        message.originTimestamp = reader.read_timestamp();
+        message.currentUtcOffset = static_cast<int16_t>(reader.read_uint16());
+        message.reserved = reader.read_uint8();
+        message.grandmasterPriority1 = reader.read_uint8();
+        message.grandmasterClockQuality = reader.read_uint32();
+        message.grandmasterPriority2 = reader.read_uint8();
+        message.grandmasterIdentity = reader.read_clock_identity();
+        message.stepsRemoved = reader.read_uint16();
+        message.timeSource = reader.read_uint8();
+        return true;
+    }
+    
+    static bool deserialize_sync(const MessageView& view, SyncMessage& message) {
+        if (!has_body(view, protocol::MessageType::SYNC)) return false;
+        BinaryReader reader = body_reader(view);
+        message.header = view.header;
+        message.originTimestamp = reader.read_timestamp();
+        return true;
+    }
+    
+    static bool deserialize_followup(const MessageView& view, FollowUpMessage& message) {
+        if (!has_body(view, protocol::MessageType::FOLLOW_UP)) return false;
+        BinaryReader reader = body_reader(view);
+        message.header = view.header;
+        message.preciseOriginTimestamp = reader.read_timestamp();
+        return true;
+    }
+    
+    static bool deserialize_pdelay_req(const MessageView& view, PdelayReqMessage& message) {
+        if (!has_body(view, protocol::MessageType::PDELAY_REQ)) return false;
+        BinaryReader reader = body_reader(view);
+        message.header = view.header;
+        message.originTimestamp = reader.read_timestamp();
+        reader.read_bytes(message.reserved, sizeof(message.reserved));
+        return true;
+    }
+    
+    static bool deserialize_pdelay_resp(const MessageView& view, PdelayRespMessage& message) {
+        if (!has_body(view, protocol::MessageType::PDELAY_RESP)) return false;
+        BinaryReader reader = body_reader(view);
+        message.header = view.header;
+        message.requestReceiptTimestamp = reader.read_timestamp();
+        message.requestingPortIdentity.clockIdentity = reader.read_clock_identity();
+        message.requestingPortIdentity.portNumber = reader.read_uint16();
+        return true;
+    }
+    
+    static bool deserialize_pdelay_resp_followup(const MessageView& view, PdelayRespFollowUpMessage& message) {
+        if (!has_body(view, protocol::MessageType::PDELAY_RESP_FOLLOW_UP)) return false;
+        BinaryReader reader = body_reader(view);
+        message.header = view.header;
+        message.responseOriginTimestamp = reader.read_timestamp();
+        message.requestingPortIdentity.clockIdentity = reader.read_clock_identity();
+        message.requestingPortIdentity.portNumber = reader.read_uint16();
+        return true;
+    }
+
+private:
+    static bool has_body(const MessageView& view, protocol::MessageType type) {
+        return view.data != nullptr && view.type() == type &&
+               view.length >= MessageSerializer::get_expected_size(type);
+    }
+    
+    static BinaryReader body_reader(const MessageView& view) {
+        return BinaryReader(view.data + MessageView::HEADER_SIZE, view.length - MessageView::HEADER_SIZE);
+    }
+};
+
 } // namespace serialization
 } // namespace gptp
 
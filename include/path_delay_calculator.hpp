@@ -147,6 +147,10 @@ private:
     std::chrono::nanoseconds last_mean_link_delay_;
     std::vector<MeasurementData> measurement_history_;
     std::vector<PdelayTimestamps> timestamp_history_;
+    
+    // Scratch space reused by every measurement
+    std::vector<std::chrono::nanoseconds> recent_delays_;
+    std::vector<MeasurementData> rate_ratio_data_;
 };
 
 /**
@@ -0,0 +1,39 @@
+/**
+ * @file sync_sample.hpp
+ * @brief Per-sample synchronization data reported by the port manager
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace gptp {
+
+/**
+ * @brief One synchronization or peer delay measurement
+ *
+ * SYNC samples are produced each time a Sync/Follow_Up pair reaches the
+ * servo (t1 = origin, t2 = local receipt). PDELAY samples are produced for
+ * every completed peer delay exchange with all four timestamps.
+ * Timestamps are nanoseconds on the respective PTP timescale.
+ */
+struct SyncSample {
+    enum class Kind : uint8_t {
+        SYNC = 1,
+        PDELAY = 2
+    };
+
+    Kind kind = Kind::SYNC;
+    uint16_t port_id = 0;
+    int64_t offset_ns = 0;          // Offset from master (SYNC)
+    int64_t path_delay_ns = 0;      // Mean link delay in use
+    double rate_ratio = 1.0;        // Neighbor rate ratio
+    double servo_ppb = 0.0;         // Servo frequency output (SYNC)
+    bool servo_locked = false;
+    int64_t t1_ns = 0;
+    int64_t t2_ns = 0;
+    int64_t t3_ns = 0;              // PDELAY only
+    int64_t t4_ns = 0;              // PDELAY only
+};
+
+} // namespace gptp
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON results and flag regressions.
+
+Usage: compare_benchmarks.py baseline.json current.json [--threshold 10]
+
+When the results hold repetitions, the median aggregate of each benchmark
+is compared; otherwise the single run is. A benchmark whose time grew by
+more than the threshold, in percent, is a regression and makes the script
+exit with status 1.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    with open(path) as f:
+        data = json.load(f)
+
+    runs = {}
+    medians = {}
+    for benchmark in data.get("benchmarks", []):
+        if benchmark.get("error_occurred"):
+            continue
+        name = benchmark.get("run_name", benchmark["name"])
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[name] = benchmark[metric]
+        else:
+            # The first repetition stands in if no aggregates were reported
+            runs.setdefault(name, benchmark[metric])
+    runs.update(medians)
+    return runs
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flag benchmark regressions against a baseline")
+    parser.add_argument("baseline", help="JSON from --benchmark_out of the reference build")
+    parser.add_argument("current", help="JSON from --benchmark_out of the build under test")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="Allowed slowdown in percent (default: 10)")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="cpu_time",
+                        help="Time to compare (default: cpu_time)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+
+    width = max([len(name) for name in baseline.keys() | current.keys()] + [9])
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+
+    regressions = []
+    for name in sorted(baseline.keys() | current.keys()):
+        if name not in current:
+            print(f"{name:<{width}}  {baseline[name]:>12.2f}  {'-':>12}  {'removed':>8}")
+            continue
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>12}  {current[name]:>12.2f}  {'new':>8}")
+            continue
+        old, new = baseline[name], current[name]
+        change = (new - old) / old * 100.0 if old > 0 else 0.0
+        marker = ""
+        if change > args.threshold:
+            regressions.append(name)
+            marker = "  REGRESSION"
+        print(f"{name:<{width}}  {old:>12.2f}  {new:>12.2f}  {change:>+7.1f}%{marker}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower by more than {args.threshold:g}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
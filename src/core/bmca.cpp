@@ -7,9 +7,10 @@
  */
 
 #include "../../include/bmca.hpp"
+#include "../../include/clock_source.hpp"
 #include <cstring>
 #include <cmath>
-#include <iostream>  // für std::cout Debug-Ausgaben
+#include "../utils/logger.hpp"
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -35,7 +36,7 @@ PriorityVector::PriorityVector(const AnnounceMessage& announce) {
     
     grandmaster_priority2 = announce.grandmasterPriority2;
     sender_identity = announce.header.sourcePortIdentity.clockIdentity;
-    steps_removed = ntohs(announce.stepsRemoved);
+    steps_removed = announce.stepsRemoved; // Already host order after deserialization
 }
 
 PriorityVector::PriorityVector(const ClockIdentity& clock_id, 
@@ -174,7 +175,7 @@ PortRole BmcaEngine::determine_port_role(const PriorityVector& local_clock,
     }
     
     // Check if master has timed out
-    auto now = std::chrono::steady_clock::now();
+    auto now = steady_now();
     if (master_info->is_announce_timeout(now)) {
         return PortRole::MASTER;
     }
@@ -267,7 +268,6 @@ bool BmcaEngine::is_priority_vector_valid(const PriorityVector& pv) {
 
 BmcaCoordinator::BmcaCoordinator(const ClockIdentity& local_clock_id) 
     : local_clock_id_(local_clock_id)
-    , current_grandmaster_(nullptr)
     , local_is_grandmaster_(false)
     , local_priority1_(248)  // Default gPTP priority
     , local_priority2_(248)  // Default gPTP priority
@@ -283,44 +283,51 @@ void BmcaCoordinator::process_announce(uint16_t port_id,
                                      std::chrono::steady_clock::time_point receipt_time) {
     MasterInfo master_info = engine_.update_master_info(announce, receipt_time);
     port_masters_[port_id] = master_info;
+    
+    // Room for every port to take part in the next run
+    candidates_.reserve(port_masters_.size());
+    decisions_.reserve(port_masters_.size());
 }
 
-std::vector<BmcaDecision> BmcaCoordinator::run_bmca(const PriorityVector& local_priority) {
-    std::vector<BmcaDecision> decisions;
-    last_bmca_run_ = std::chrono::steady_clock::now();
+const std::vector<BmcaDecision>& BmcaCoordinator::run_bmca(const PriorityVector& local_priority) {
+    auto& decisions = decisions_;
+    decisions.clear();
+    last_bmca_run_ = steady_now();
     
     // Collect all valid masters
-    std::vector<MasterInfo> all_masters;
+    auto& all_masters = candidates_;
+    all_masters.clear();
     for (const auto& pair : port_masters_) {
         if (pair.second.valid) {
             all_masters.push_back(pair.second);
         }
     }
     
-    std::cout << "👑 [BMCA] Running Best Master Clock Algorithm" << std::endl;
-    std::cout << "   Local clock priority vector:" << std::endl;
-    std::cout << "     Priority1: " << static_cast<int>(local_priority.grandmaster_priority1) << std::endl;
-    std::cout << "     Clock Class: " << static_cast<int>(local_priority.grandmaster_clock_quality.clockClass) << std::endl;
-    std::cout << "     Priority2: " << static_cast<int>(local_priority.grandmaster_priority2) << std::endl;
-    std::cout << "   Active master candidates: " << all_masters.size() << std::endl;
+    LOG_DEBUG("👑 [BMCA] Running Best Master Clock Algorithm");
+    LOG_DEBUG("   Local clock priority vector:");
+    LOG_DEBUG("     Priority1: {}", static_cast<int>(local_priority.grandmaster_priority1));
+    LOG_DEBUG("     Clock Class: {}", static_cast<int>(local_priority.grandmaster_clock_quality.clockClass));
+    LOG_DEBUG("     Priority2: {}", static_cast<int>(local_priority.grandmaster_priority2));
+    LOG_DEBUG("   Active master candidates: {}", all_masters.size());
     
     // Determine if we should be grandmaster
     bool should_be_gm = engine_.should_be_grandmaster(local_priority, all_masters);
     bool role_changed = (should_be_gm != local_is_grandmaster_);
     
-    std::cout << "   BMCA Decision: " << (should_be_gm ? "GRANDMASTER" : "SLAVE") << std::endl;
+    LOG_DEBUG("   BMCA Decision: {}", (should_be_gm ? "GRANDMASTER" : "SLAVE"));
     if (role_changed) {
-        std::cout << "   ⚡ ROLE CHANGE DETECTED!" << std::endl;
+        LOG_INFO("[BMCA] Local clock is now {}", should_be_gm ? "GRANDMASTER" : "SLAVE");
     }
     
     local_is_grandmaster_ = should_be_gm;
     
     if (should_be_gm) {
         // We are grandmaster - all ports should be master
-        current_grandmaster_ = new PriorityVector(local_priority);
+        current_grandmaster_ = local_priority;
         
         for (const auto& pair : port_masters_) {
             BmcaDecision decision;
+            decision.port_id = pair.first;
             decision.recommended_role = PortRole::MASTER;
             decision.selected_master = nullptr;
             decision.role_changed = role_changed;
@@ -328,19 +335,53 @@ std::vector<BmcaDecision> BmcaCoordinator::run_bmca(const PriorityVector& local_
             decisions.push_back(decision);
         }
     } else {
-        // Select best master and determine roles per port
-        MasterInfo* best_master = engine_.select_best_master(all_masters);
+        // Select best master across all ports
+        uint16_t slave_port_id = 0;
+        MasterInfo* best_master = nullptr;
+        for (auto& pair : port_masters_) {
+            if (!pair.second.valid) continue;
+            if (!best_master) {
+                best_master = &pair.second;
+                slave_port_id = pair.first;
+                continue;
+            }
+            BmcaResult result = BmcaEngine::compare_priority_vectors(pair.second.priority_vector,
+                                                                     best_master->priority_vector);
+            if (result == BmcaResult::A_BETTER_THAN_B || result == BmcaResult::A_BETTER_BY_TOPOLOGY) {
+                best_master = &pair.second;
+                slave_port_id = pair.first;
+            }
+        }
         
         if (best_master) {
-            current_grandmaster_ = new PriorityVector(best_master->priority_vector);
+            current_grandmaster_ = best_master->priority_vector;
         }
         
-        for (const auto& pair : port_masters_) {
+        // What this clock would announce on its master ports
+        PriorityVector master_priority = best_master ? best_master->priority_vector : local_priority;
+        if (best_master) {
+            master_priority.sender_identity = local_clock_id_;
+            master_priority.steps_removed = static_cast<uint16_t>(best_master->priority_vector.steps_removed + 1);
+        }
+        
+        for (auto& pair : port_masters_) {
             BmcaDecision decision;
-            decision.recommended_role = engine_.determine_port_role(local_priority, &pair.second);
-            decision.selected_master = (pair.second.valid) ? const_cast<MasterInfo*>(&pair.second) : nullptr;
+            decision.port_id = pair.first;
             decision.role_changed = role_changed;
             decision.decision_time = last_bmca_run_;
+            decision.selected_master = pair.second.valid ? &pair.second : nullptr;
+            
+            if (best_master && pair.first == slave_port_id) {
+                decision.recommended_role = PortRole::SLAVE;
+            } else if (!pair.second.valid) {
+                decision.recommended_role = PortRole::MASTER;
+            } else {
+                BmcaResult result = BmcaEngine::compare_priority_vectors(master_priority,
+                                                                         pair.second.priority_vector);
+                bool we_are_better = (result == BmcaResult::A_BETTER_THAN_B ||
+                                      result == BmcaResult::A_BETTER_BY_TOPOLOGY);
+                decision.recommended_role = we_are_better ? PortRole::MASTER : PortRole::PASSIVE;
+            }
             decisions.push_back(decision);
         }
     }
@@ -369,6 +410,10 @@ std::vector<uint16_t> BmcaCoordinator::check_announce_timeouts(std::chrono::stea
     return timed_out_ports;
 }
 
+void BmcaCoordinator::clear_port(uint16_t port_id) {
+    port_masters_.erase(port_id);
+}
+
 const MasterInfo* BmcaCoordinator::get_master_info(uint16_t port_id) const {
     auto it = port_masters_.find(port_id);
     if (it != port_masters_.end() && it->second.valid) {
@@ -377,8 +422,12 @@ const MasterInfo* BmcaCoordinator::get_master_info(uint16_t port_id) const {
     return nullptr;
 }
 
+size_t BmcaCoordinator::get_master_count() const {
+    return port_masters_.size();
+}
+
 const PriorityVector* BmcaCoordinator::get_grandmaster() const {
-    return current_grandmaster_;
+    return current_grandmaster_ ? &*current_grandmaster_ : nullptr;
 }
 
 bool BmcaCoordinator::is_local_grandmaster() const {
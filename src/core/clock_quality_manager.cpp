@@ -4,6 +4,7 @@
  */
 
 #include "../../include/clock_quality_manager.hpp"
+#include "../../include/clock_source.hpp"
 #include <stdexcept>
 #include <sstream>
 #include <chrono>
@@ -17,7 +18,7 @@ namespace clock_quality {
 
 ClockQualityManager::ClockQualityManager(const ClockQualityConfig& config)
     : config_(config)
-    , last_source_update_(std::chrono::steady_clock::now())
+    , last_source_update_(steady_now())
 {
     external_source_available_ = config_.has_external_time_source;
     external_source_traceable_ = config_.time_source_traceable;
@@ -27,7 +28,7 @@ void ClockQualityManager::set_config(const ClockQualityConfig& config) {
     config_ = config;
     external_source_available_ = config_.has_external_time_source;
     external_source_traceable_ = config_.time_source_traceable;
-    last_source_update_ = std::chrono::steady_clock::now();
+    last_source_update_ = steady_now();
 }
 
 ClockQuality ClockQualityManager::calculate_clock_quality() const {
@@ -209,7 +210,7 @@ bool ClockQualityManager::is_grandmaster_capable() const {
 void ClockQualityManager::update_time_source_status(bool available, bool traceable) {
     external_source_available_ = available;
     external_source_traceable_ = traceable;
-    last_source_update_ = std::chrono::steady_clock::now();
+    last_source_update_ = steady_now();
     
     // Exit holdover mode if source becomes available
     if (available) {
@@ -4,6 +4,7 @@
  */
 
 #include "../../include/clock_servo.hpp"
+#include "../../include/clock_source.hpp"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -17,6 +18,7 @@ namespace servo {
 
 ClockServo::ClockServo(const ServoConfig& config)
     : config_(config)
+    , consecutive_outliers_(0)
     , integral_accumulator_(0.0)
     , previous_offset_(0)
     , current_frequency_adjustment_(0.0)
@@ -27,6 +29,16 @@ ClockServo::ClockServo(const ServoConfig& config)
     , std_deviation_(0)
     , first_measurement_(true)
 {
+    configure(config);
+}
+
+void ClockServo::configure(const ServoConfig& config) {
+    config_ = config;
+    
+    // The history holds one sample over the limit before trimming
+    offset_history_.reserve(config_.max_samples + 1);
+    time_history_.reserve(config_.max_samples + 1);
+    scratch_.reserve(config_.max_samples + 1);
 }
 
 OffsetResult ClockServo::calculate_offset(const SyncMeasurement& measurement) {
@@ -51,7 +63,8 @@ OffsetResult ClockServo::calculate_offset(const SyncMeasurement& measurement) {
         // Calculate confidence based on history consistency
         if (offset_history_.size() >= 3) {
             // Use recent measurements to calculate confidence
-            std::vector<double> recent_offsets;
+            auto& recent_offsets = scratch_;
+            recent_offsets.clear();
             for (size_t i = std::max(offset_history_.size() - 8, size_t(0)); 
                  i < offset_history_.size(); ++i) {
                 recent_offsets.push_back(static_cast<double>(offset_history_[i].count()));
@@ -136,6 +149,7 @@ FrequencyResult ClockServo::update_servo(std::chrono::nanoseconds offset,
 void ClockServo::reset() {
     offset_history_.clear();
     time_history_.clear();
+    consecutive_outliers_ = 0;
     integral_accumulator_ = 0.0;
     previous_offset_ = std::chrono::nanoseconds(0);
     current_frequency_adjustment_ = 0.0;
@@ -161,12 +175,12 @@ ClockServo::ServoStats ClockServo::get_statistics() const {
 bool ClockServo::filter_offset(std::chrono::nanoseconds offset) {
     // Store measurement
     offset_history_.push_back(offset);
-    time_history_.push_back(std::chrono::steady_clock::now());
+    time_history_.push_back(steady_now());
     
     // Limit history size
     while (offset_history_.size() > config_.max_samples) {
-        offset_history_.pop_front();
-        time_history_.pop_front();
+        offset_history_.erase(offset_history_.begin());
+        time_history_.erase(time_history_.begin());
     }
     
     // For first few measurements, accept all
@@ -176,7 +190,8 @@ bool ClockServo::filter_offset(std::chrono::nanoseconds offset) {
     }
     
     // Calculate median and MAD for outlier detection
-    std::vector<double> offset_values;
+    auto& offset_values = scratch_;
+    offset_values.clear();
     for (const auto& o : offset_history_) {
         offset_values.push_back(static_cast<double>(o.count()));
     }
@@ -184,10 +199,10 @@ bool ClockServo::filter_offset(std::chrono::nanoseconds offset) {
     std::sort(offset_values.begin(), offset_values.end());
     double median = offset_values[offset_values.size() / 2];
     
-    // Calculate MAD (Median Absolute Deviation)
-    std::vector<double> deviations;
-    for (double val : offset_values) {
-        deviations.push_back(std::abs(val - median));
+    // Calculate MAD (Median Absolute Deviation), reusing the sorted values
+    auto& deviations = offset_values;
+    for (double& val : deviations) {
+        val = std::abs(val - median);
     }
     std::sort(deviations.begin(), deviations.end());
     double mad = deviations[deviations.size() / 2];
@@ -196,12 +211,17 @@ bool ClockServo::filter_offset(std::chrono::nanoseconds offset) {
     double current_offset_ns = static_cast<double>(offset.count());
     bool is_outlier_val = utils::is_outlier(current_offset_ns, median, mad);
     
-    if (is_outlier_val && offset_history_.size() > 8) {
+    // A run of outliers as long as half the window means the offset has
+    // really moved (frequency step, wander); accept it rather than locking out
+    if (is_outlier_val && offset_history_.size() > 8 &&
+        consecutive_outliers_ < config_.max_samples / 2) {
         // Remove outlier from history
         offset_history_.pop_back();
         time_history_.pop_back();
+        consecutive_outliers_++;
         return false;
     }
+    consecutive_outliers_ = 0;
     
     calculate_statistics();
     return true;
@@ -253,6 +273,8 @@ void ClockServo::update_lock_detection() {
 
 SynchronizationManager::SynchronizationManager()
     : current_slave_port_(0)
+    , clock_adjuster_(nullptr)
+    , adjustment_pending_(false)
     , total_adjustments_(0)
 {
     current_status_.synchronized = false;
@@ -279,15 +301,21 @@ void SynchronizationManager::process_sync_followup(uint16_t port_id,
     
     auto& servo = port_servos_[port_id];
     
-    // Build sync measurement
+    // Build sync measurement. Two-step masters carry T1 in the Follow_Up;
+    // fall back to the Sync origin timestamp when it is not filled in.
     SyncMeasurement measurement;
-    measurement.master_timestamp = sync_msg.originTimestamp;
+    const Timestamp& precise_origin = followup_msg.preciseOriginTimestamp;
+    bool has_precise_origin = precise_origin.get_seconds() != 0 || precise_origin.nanoseconds != 0;
+    measurement.master_timestamp = has_precise_origin ? precise_origin : sync_msg.originTimestamp;
     measurement.local_receipt_time = sync_receipt_time;
-    // Correction field is in the follow-up header
-    measurement.correction_field.set_seconds(0);
-    measurement.correction_field.nanoseconds = static_cast<uint32_t>(followup_msg.header.correctionField);
+    // correctionField is scaled nanoseconds (ns << 16) in both Sync and Follow_Up
+    int64_t correction_ns = (sync_msg.header.correctionField + followup_msg.header.correctionField) >> 16;
+    if (correction_ns < 0) {
+        correction_ns = 0;
+    }
+    measurement.correction_field = utils::nanoseconds_to_timestamp(std::chrono::nanoseconds(correction_ns));
     measurement.path_delay = path_delay;
-    measurement.measurement_time = std::chrono::steady_clock::now();
+    measurement.measurement_time = steady_now();
     
     // Calculate offset
     OffsetResult offset_result = servo->calculate_offset(measurement);
@@ -304,6 +332,9 @@ void SynchronizationManager::process_sync_followup(uint16_t port_id,
         current_status_.servo_locked = freq_result.locked;
         current_status_.last_sync_time = measurement.measurement_time;
         current_status_.slave_port_id = port_id;
+        
+        adjustment_pending_ = true;
+        apply_clock_adjustments();
     }
 }
 
@@ -323,31 +354,58 @@ void SynchronizationManager::set_slave_port(uint16_t port_id) {
     }
 }
 
+void SynchronizationManager::reset_port(uint16_t port_id) {
+    auto it = port_servos_.find(port_id);
+    if (it != port_servos_.end()) {
+        it->second->reset();
+    }
+    if (current_slave_port_ == port_id) {
+        current_status_.synchronized = false;
+        current_status_.servo_locked = false;
+    }
+}
+
 SynchronizationManager::SyncStatus SynchronizationManager::get_sync_status() const {
     return current_status_;
 }
 
+void SynchronizationManager::set_clock_adjuster(IClockAdjuster* adjuster) {
+    if (adjuster != clock_adjuster_) {
+        // The integral term is the frequency of the oscillator it steered;
+        // applied to another clock it would be a step in that clock's rate
+        for (auto& entry : port_servos_) {
+            entry.second->reset();
+        }
+        current_status_.synchronized = false;
+        current_status_.servo_locked = false;
+        current_status_.frequency_adjustment_ppb = 0.0;
+        adjustment_pending_ = false;
+    }
+    clock_adjuster_ = adjuster;
+}
+
 void SynchronizationManager::apply_clock_adjustments() {
-    // This would integrate with platform-specific clock adjustment APIs
-    // For now, just track that adjustments were requested
+    if (clock_adjuster_ == nullptr || !adjustment_pending_) {
+        return;
+    }
+    adjustment_pending_ = false;
     
     if (current_status_.synchronized && current_slave_port_ != 0) {
         auto it = port_servos_.find(current_slave_port_);
         if (it != port_servos_.end()) {
-            double freq_adj = it->second->get_frequency_adjustment();
+            auto& servo = it->second;
+            std::chrono::nanoseconds offset = current_status_.current_offset;
             
-            // In a real implementation, this would call:
-            // - Windows: SetSystemTimeAdjustment() or similar
-            // - Linux: adjtimex() system call
-            // - Hardware: Direct register access for hardware timestamping
+            // Positive offset means the local clock is ahead of the master
+            if (std::abs(static_cast<double>(offset.count())) > servo->get_config().max_phase_adjustment) {
+                clock_adjuster_->step_clock(-offset);
+                servo->reset();
+            } else {
+                clock_adjuster_->adjust_frequency(-servo->get_frequency_adjustment());
+            }
             
             total_adjustments_++;
-            last_adjustment_time_ = std::chrono::steady_clock::now();
-            
-            // For debugging/logging
-            if (std::abs(freq_adj) > 1.0) { // Only log significant adjustments
-                // Would log: "Applied frequency adjustment: {freq_adj} ppb"
-            }
+            last_adjustment_time_ = steady_now();
         }
     }
 }
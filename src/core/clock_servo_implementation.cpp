@@ -7,6 +7,7 @@
  */
 
 #include "../../include/clock_servo.hpp"
+#include "../../include/clock_source.hpp"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
@@ -175,7 +176,7 @@ public:
         stats.std_deviation = std::chrono::nanoseconds(static_cast<int64_t>(std::sqrt(variance_offset_)));
         stats.current_frequency_ppb = mean_frequency_adjustment_;
         stats.is_locked = servo_locked_;
-        stats.last_update = std::chrono::steady_clock::now();
+        stats.last_update = steady_now();
         return stats;
     }
     
@@ -330,9 +331,7 @@ private:
             // Hardware/system specific frequency adjustment
             
             // Detailed debug info with system clock implications
-            auto system_time_now = std::chrono::system_clock::now();
-            auto system_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                system_time_now.time_since_epoch()).count();
+            auto system_ns = get_clock_source().now_realtime_ns();
             
             std::cout << "   Current system time: " << system_ns << " ns" << std::endl;
             std::cout << "   Frequency drift correction: " << (result.frequency_adjustment / 1000000.0) << " ppm" << std::endl;
@@ -0,0 +1,51 @@
+/**
+ * @file clock_source.cpp
+ * @brief System clock source and the process-wide source selection
+ */
+
+#include "../../include/clock_source.hpp"
+#include <atomic>
+#include <chrono>
+
+#ifdef __linux__
+#include <ctime>
+#endif
+
+namespace gptp {
+
+namespace {
+    SystemClockSource system_clock_source;
+    std::atomic<IClockSource*> current_clock_source{&system_clock_source};
+}
+
+int64_t SystemClockSource::now_realtime_ns() {
+#ifdef __linux__
+    struct timespec ts{};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+#endif
+}
+
+int64_t SystemClockSource::now_monotonic_ns() {
+#ifdef __linux__
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+IClockSource& get_clock_source() {
+    return *current_clock_source.load(std::memory_order_acquire);
+}
+
+void set_clock_source(IClockSource* source) {
+    current_clock_source.store(source ? source : &system_clock_source, std::memory_order_release);
+}
+
+} // namespace gptp
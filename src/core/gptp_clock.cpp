@@ -5,10 +5,11 @@
 
 #include "../../include/gptp_clock.hpp"
 #include "../../include/gptp_state_machines.hpp"
+#include "../../include/clock_source.hpp"
 #include <random>
 #include <chrono>
 #include <algorithm>
-#include <iostream>
+#include "../utils/logger.hpp"
 
 namespace gptp {
 
@@ -18,7 +19,7 @@ GptpClock::GptpClock()
     , is_grandmaster_(false)
     , current_utc_offset_(37)  // Current UTC offset (seconds)
     , time_source_(protocol::TimeSource::INTERNAL_OSCILLATOR)
-    , startup_time_(std::chrono::steady_clock::now())
+    , startup_time_(steady_now())
     , time_offset_(0)
     , servo_(std::make_unique<servo::ClockServo>())
 {
@@ -39,10 +40,8 @@ GptpClock::GptpClock()
 }
 
 std::chrono::nanoseconds GptpClock::get_current_time() const {
-    // Get system time in nanoseconds since epoch
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration = now.time_since_epoch();
-    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+    // System time in nanoseconds since epoch
+    return std::chrono::nanoseconds(get_clock_source().now_realtime_ns());
 }
 
 void GptpClock::set_current_time(std::chrono::nanoseconds time) {
@@ -86,7 +85,7 @@ void GptpClock::update_from_master(const Timestamp& master_time,
 void GptpClock::adjust_frequency(double ppb_adjustment) {
     // In a real implementation, this would adjust the local oscillator frequency
     // For simulation, we just log the adjustment
-    std::cout << "[GptpClock] Frequency adjustment: " << ppb_adjustment << " ppb" << std::endl;
+    LOG_DEBUG("[GptpClock] Frequency adjustment: {} ppb", ppb_adjustment);
     
     // TODO: Apply frequency adjustment to hardware clock or OS time
     // This could involve:
@@ -98,7 +97,7 @@ void GptpClock::adjust_frequency(double ppb_adjustment) {
 void GptpClock::adjust_phase(double nanoseconds_adjustment) {
     // In a real implementation, this would step the local clock
     // For simulation, we just log the adjustment
-    std::cout << "[GptpClock] Phase adjustment: " << nanoseconds_adjustment << " ns" << std::endl;
+    LOG_DEBUG("[GptpClock] Phase adjustment: {} ns", nanoseconds_adjustment);
     
     // Apply phase adjustment to our local offset
     time_offset_ += std::chrono::nanoseconds(static_cast<int64_t>(nanoseconds_adjustment));
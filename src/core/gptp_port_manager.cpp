@@ -7,32 +7,56 @@
 #include "../../include/message_serializer.hpp"
 #include "../../include/gptp_clock.hpp"
 #include "../../include/gptp_state_machines.hpp"
-#include <iostream>
+#include "../../include/clock_source.hpp"
+#include "../utils/logger.hpp"
+#include <bitset>
 
 namespace gptp {
 
+namespace {
+    // Completed peer delay exchanges kept for the neighbor rate ratio
+    constexpr size_t PDELAY_HISTORY_SIZE = 9;
+}
+
 GptpPortManager::GptpPortManager(const ClockIdentity& local_clock_id, MessageSender message_sender)
     : local_clock_id_(local_clock_id)
     , message_sender_(std::move(message_sender))
+    , clock_adjuster_(nullptr)
+    , local_priority1_(248)  // IEEE 802.1AS default for end station
+    , local_priority2_(248)  // IEEE 802.1AS default for end station
     , announce_interval_(std::chrono::seconds(1))      // 1 second announce interval
     , sync_interval_(std::chrono::milliseconds(125))   // 125ms sync interval  
     , followup_timeout_(std::chrono::milliseconds(100)) // 100ms follow-up timeout
+    , pdelay_interval_(std::chrono::milliseconds(protocol::PDELAY_INTERVAL_MS))
 {
     // Create default clock instance
     default_clock_ = std::make_unique<GptpClock>();
+    tx_buffer_.reserve(serialization::BinaryWriter::MAX_MESSAGE_SIZE);
 }
 
 GptpPortManager::~GptpPortManager() {
     // Destructor implementation needed for std::unique_ptr with incomplete types
 }
 
+GptpPortManager::PortInfo::PortInfo()
+    : domain_number(0)
+    , current_role(bmca::PortRole::DISABLED)
+    , enabled(false)
+    , link_up(true)
+    , last_sync_sequence(0)
+    , last_sync_sequence_valid(false)
+    , pdelay_in_progress(false)
+    , link_delay(0)
+    , link_delay_valid(false) {
+}
+
 // ============================================================================
 // Port Management
 // ============================================================================
 
 bool GptpPortManager::add_port(uint16_t port_id, uint8_t domain_number, GptpClock* clock) {
     if (ports_.find(port_id) != ports_.end()) {
-        std::cerr << "Port " << port_id << " already exists" << std::endl;
+        LOG_WARN("Port {} already exists", port_id);
         return false;
     }
     
@@ -47,15 +71,17 @@ bool GptpPortManager::add_port(uint16_t port_id, uint8_t domain_number, GptpCloc
     // Create underlying GptpPort
     port_info.gptp_port = std::make_unique<GptpPort>(port_id, port_clock);
     port_info.gptp_port->initialize();
+    port_info.delay_calculator = std::make_unique<path_delay::StandardP2PDelayCalculator>(domain_number);
+    port_info.pdelay_history.reserve(PDELAY_HISTORY_SIZE + 1);
     
-    std::cout << "Added gPTP port " << port_id << " on domain " << static_cast<int>(domain_number) << std::endl;
+    LOG_INFO("Added gPTP port {} on domain {}", port_id, static_cast<int>(domain_number));
     return true;
 }
 
 void GptpPortManager::remove_port(uint16_t port_id) {
     auto it = ports_.find(port_id);
     if (it != ports_.end()) {
-        std::cout << "Removing gPTP port " << port_id << std::endl;
+        LOG_INFO("Removing gPTP port {}", port_id);
         ports_.erase(it);
     }
 }
@@ -63,27 +89,111 @@ void GptpPortManager::remove_port(uint16_t port_id) {
 void GptpPortManager::enable_port(uint16_t port_id) {
     auto it = ports_.find(port_id);
     if (it != ports_.end()) {
-        std::cout << "Enabling gPTP port " << port_id << std::endl;
+        LOG_INFO("Enabling gPTP port {}", port_id);
+        it->second.enabled = true;
         it->second.gptp_port->enable();
         
-        // Set initial role to PASSIVE (will be updated by BMCA)
-        handle_role_change(port_id, bmca::PortRole::PASSIVE);
+        // Set initial role to PASSIVE (will be updated by BMCA); a port
+        // without carrier stays DISABLED until its link comes up
+        if (it->second.link_up) {
+            handle_role_change(port_id, bmca::PortRole::PASSIVE);
+        }
     }
 }
 
 void GptpPortManager::disable_port(uint16_t port_id) {
     auto it = ports_.find(port_id);
     if (it != ports_.end()) {
-        std::cout << "Disabling gPTP port " << port_id << std::endl;
+        LOG_INFO("Disabling gPTP port {}", port_id);
+        it->second.enabled = false;
         it->second.gptp_port->disable();
         handle_role_change(port_id, bmca::PortRole::DISABLED);
     }
 }
 
+void GptpPortManager::set_link_status(uint16_t port_id, bool link_up) {
+    auto it = ports_.find(port_id);
+    if (it == ports_.end() || it->second.link_up == link_up) {
+        return;
+    }
+    
+    PortInfo& port_info = it->second;
+    uint8_t domain = port_info.domain_number;
+    LOG_INFO("gPTP port {} link {}", port_id, (link_up ? "up" : "down"));
+    port_info.link_up = link_up;
+    port_info.gptp_port->set_link_status(link_up);
+    
+    if (!link_up) {
+        // Everything learned on the link is stale: neighbor, delay and master
+        clear_pending_syncs(port_info);
+        port_info.last_sync_sequence_valid = false;
+        port_info.pending_pdelay = path_delay::PdelayTimestamps();
+        port_info.pdelay_in_progress = false;
+        port_info.pdelay_history.clear();
+        port_info.link_delay = std::chrono::nanoseconds(0);
+        port_info.link_delay_valid = false;
+        port_info.delay_calculator = std::make_unique<path_delay::StandardP2PDelayCalculator>(domain);
+        get_bmca_coordinator(domain)->clear_port(port_id);
+        get_sync_manager(domain)->reset_port(port_id);
+        
+        handle_role_change(port_id, bmca::PortRole::DISABLED);
+    } else {
+        if (!port_info.enabled) {
+            return;
+        }
+        // Zero the transmit times so the next periodic pass sends
+        // Pdelay_Req (and Announce/Sync once master) without delay
+        port_info.last_pdelay_tx_time = std::chrono::steady_clock::time_point();
+        port_info.last_announce_tx_time = std::chrono::steady_clock::time_point();
+        port_info.last_sync_tx_time = std::chrono::steady_clock::time_point();
+        handle_role_change(port_id, bmca::PortRole::PASSIVE);
+    }
+    
+    // Re-select roles now rather than at the next BMCA interval
+    run_bmca_for_domain(domain);
+}
+
+bool GptpPortManager::is_link_up(uint16_t port_id) const {
+    auto it = ports_.find(port_id);
+    return it != ports_.end() && it->second.link_up;
+}
+
 void GptpPortManager::set_role_change_callback(RoleChangeCallback callback) {
     role_change_callback_ = std::move(callback);
 }
 
+void GptpPortManager::set_tx_timestamp_provider(TxTimestampProvider provider) {
+    tx_timestamp_provider_ = std::move(provider);
+}
+
+void GptpPortManager::set_sync_sample_callback(SyncSampleCallback callback) {
+    sync_sample_callback_ = std::move(callback);
+}
+
+void GptpPortManager::set_dispatch_callback(DispatchCallback callback) {
+    dispatch_callback_ = std::move(callback);
+}
+
+void GptpPortManager::set_sync_due_callback(SyncDueCallback callback) {
+    sync_due_callback_ = std::move(callback);
+}
+
+void GptpPortManager::set_clock_adjuster(IClockAdjuster* adjuster) {
+    clock_adjuster_ = adjuster;
+    for (auto& pair : sync_managers_) {
+        pair.second->set_clock_adjuster(adjuster);
+    }
+}
+
+void GptpPortManager::set_local_clock_properties(uint8_t priority1, const ClockQuality& quality, uint8_t priority2) {
+    local_priority1_ = priority1;
+    local_clock_quality_ = quality;
+    local_priority2_ = priority2;
+    for (auto& pair : bmca_coordinators_) {
+        pair.second->update_local_clock(priority1, quality, priority2);
+    }
+}
+
 // ============================================================================
 // Message Processing with BMCA Integration
 // ============================================================================
@@ -99,33 +209,21 @@ void GptpPortManager::process_announce_message(uint16_t port_id,
     PortInfo& port_info = port_it->second;
     uint8_t domain = port_info.domain_number;
     
-    std::cout << "Processing announce message on port " << port_id << " domain " << static_cast<int>(domain) << std::endl;
+    LOG_DEBUG("Processing announce message on port {} domain {}", port_id, static_cast<int>(domain));
     
     // Get BMCA coordinator for this domain
     auto* bmca = get_bmca_coordinator(domain);
     if (!bmca) {
-        std::cerr << "No BMCA coordinator for domain " << static_cast<int>(domain) << std::endl;
+        LOG_WARN("No BMCA coordinator for domain {}", static_cast<int>(domain));
         return;
     }
     
     // Process announce with BMCA
-    auto current_time = std::chrono::steady_clock::now();
+    auto current_time = steady_now();
     bmca->process_announce(port_id, announce, current_time);
     
-    // Run BMCA to get updated decisions
-    auto local_priority = create_local_priority_vector(domain);
-    auto decisions = bmca->run_bmca(local_priority);
-    
-    // Apply BMCA decisions to ports
-    for (const auto& decision : decisions) {
-        // Note: BmcaDecision doesn't have port_id, so we apply to the current port
-        if (decision.recommended_role != port_info.current_role) {
-            std::cout << "BMCA role change for port " << port_id << ": " 
-                      << static_cast<int>(port_info.current_role) << " -> " 
-                      << static_cast<int>(decision.recommended_role) << std::endl;
-            handle_role_change(port_id, decision.recommended_role);
-        }
-    }
+    // Run BMCA and apply updated roles to every port of the domain
+    run_bmca_for_domain(domain);
     
     // Also pass to underlying state machine
     port_info.gptp_port->process_announce_message(announce);
@@ -146,14 +244,44 @@ void GptpPortManager::process_sync_message(uint16_t port_id,
         return;
     }
     
-    std::cout << "Processing sync message " << sync.header.sequenceId 
-              << " on slave port " << port_id << std::endl;
+    LOG_DEBUG("Processing sync message {} on slave port {}", sync.header.sequenceId, port_id);
+    
+    // Count Syncs missing between consecutive sequenceIds; large jumps are a master restart
+    uint16_t gap = static_cast<uint16_t>(sync.header.sequenceId - port_info.last_sync_sequence - 1);
+    if (port_info.last_sync_sequence_valid && gap > 0 && gap < 0x8000) {
+        port_info.counters.syncs_lost += gap;
+    }
+    port_info.last_sync_sequence = sync.header.sequenceId;
+    port_info.last_sync_sequence_valid = true;
     
-    // Store pending sync for follow-up correlation
-    auto& pending = port_info.pending_syncs[sync.header.sequenceId];
+    // Store pending sync for follow-up correlation: reuse the slot of a
+    // repeated sequenceId, else a free one, else drop the oldest
+    PortInfo::PendingSync* slot = nullptr;
+    PortInfo::PendingSync* free_slot = nullptr;
+    PortInfo::PendingSync* oldest = nullptr;
+    for (auto& candidate : port_info.pending_syncs) {
+        if (!candidate.valid) {
+            free_slot = free_slot ? free_slot : &candidate;
+        } else if (candidate.sequence_id == sync.header.sequenceId) {
+            slot = &candidate;
+            break;
+        } else if (oldest == nullptr || candidate.timeout < oldest->timeout) {
+            oldest = &candidate;
+        }
+    }
+    if (slot == nullptr) {
+        slot = free_slot;
+    }
+    if (slot == nullptr) {
+        port_info.counters.followups_missed++;
+        slot = oldest;
+    }
+    auto& pending = *slot;
+    pending.valid = true;
+    pending.sequence_id = sync.header.sequenceId;
     pending.sync_message = sync;
     pending.receipt_time = receipt_time;
-    pending.timeout = std::chrono::steady_clock::now() + followup_timeout_;
+    pending.timeout = steady_now() + followup_timeout_;
     
     // Also pass to underlying state machine
     port_info.gptp_port->process_sync_message(sync, receipt_time);
@@ -172,23 +300,29 @@ void GptpPortManager::process_followup_message(uint16_t port_id, const FollowUpM
         return;
     }
     
-    std::cout << "Processing follow-up message " << followup.header.sequenceId 
-              << " on slave port " << port_id << std::endl;
+    LOG_DEBUG("Processing follow-up message {} on slave port {}", followup.header.sequenceId, port_id);
     
     // Find corresponding sync message
-    auto sync_it = port_info.pending_syncs.find(followup.header.sequenceId);
-    if (sync_it == port_info.pending_syncs.end()) {
-        std::cerr << "No matching sync for follow-up " << followup.header.sequenceId << std::endl;
+    PortInfo::PendingSync* match = nullptr;
+    for (auto& candidate : port_info.pending_syncs) {
+        if (candidate.valid && candidate.sequence_id == followup.header.sequenceId) {
+            match = &candidate;
+            break;
+        }
+    }
+    if (match == nullptr) {
+        LOG_WARN("No matching sync for follow-up {}", followup.header.sequenceId);
+        port_info.counters.followups_unmatched++;
         return;
     }
     
-    const auto& pending = sync_it->second;
+    auto& pending = *match;
     uint8_t domain = port_info.domain_number;
     
     // Get sync manager for this domain
     auto* sync_manager = get_sync_manager(domain);
     if (!sync_manager) {
-        std::cerr << "No sync manager for domain " << static_cast<int>(domain) << std::endl;
+        LOG_WARN("No sync manager for domain {}", static_cast<int>(domain));
         return;
     }
     
@@ -199,23 +333,240 @@ void GptpPortManager::process_followup_message(uint16_t port_id, const FollowUpM
     // Get actual path delay from LinkDelay state machine
     std::chrono::nanoseconds path_delay(0);
     
-    if (port_info.gptp_port) {
+    if (port_info.link_delay_valid) {
+        path_delay = port_info.link_delay;
+    } else if (port_info.gptp_port) {
         path_delay = port_info.gptp_port->get_link_delay();
     }
     
+    auto last_update = sync_manager->get_sync_status().last_sync_time;
     sync_manager->process_sync_followup(port_id, 
                                        pending.sync_message,
                                        pending.receipt_time,
                                        followup,
                                        path_delay);
     
+    if (sync_sample_callback_) {
+        auto status = sync_manager->get_sync_status();
+        if (status.last_sync_time != last_update) {
+            const Timestamp& precise_origin = followup.preciseOriginTimestamp;
+            bool has_precise_origin = precise_origin.get_seconds() != 0 || precise_origin.nanoseconds != 0;
+            
+            SyncSample sample;
+            sample.kind = SyncSample::Kind::SYNC;
+            sample.port_id = port_id;
+            sample.offset_ns = status.current_offset.count();
+            sample.path_delay_ns = path_delay.count();
+            sample.rate_ratio = port_info.delay_calculator->get_current_neighbor_rate_ratio();
+            sample.servo_ppb = status.frequency_adjustment_ppb;
+            sample.servo_locked = status.servo_locked;
+            sample.t1_ns = (has_precise_origin ? precise_origin : pending.sync_message.originTimestamp).to_nanoseconds().count();
+            sample.t2_ns = pending.receipt_time.to_nanoseconds().count();
+            sync_sample_callback_(sample);
+        }
+    }
+    
     // Remove processed sync
-    port_info.pending_syncs.erase(sync_it);
+    pending.valid = false;
     
     // Also pass to underlying state machine
     port_info.gptp_port->process_follow_up_message(followup);
 }
 
+void GptpPortManager::process_pdelay_req_message(uint16_t port_id,
+                                                const PdelayReqMessage& request,
+                                                const Timestamp& receipt_time) {
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end() || port_it->second.current_role == bmca::PortRole::DISABLED) {
+        return;
+    }
+    
+    uint8_t domain = port_it->second.domain_number;
+    
+    // Pdelay_Resp carries t2 and echoes the requester's identity and sequence
+    PdelayRespMessage response;
+    response.header.domainNumber = domain;
+    response.header.flags = 0x0200; // twoStepFlag
+    response.header.sourcePortIdentity.clockIdentity = local_clock_id_;
+    response.header.sourcePortIdentity.portNumber = port_id;
+    response.header.sequenceId = request.header.sequenceId;
+    response.header.logMessageInterval = 0x7F;
+    response.requestReceiptTimestamp = receipt_time;
+    response.requestingPortIdentity = request.header.sourcePortIdentity;
+    
+    message_sender_(port_id, serialize_message(response));
+    
+    // Pdelay_Resp_Follow_Up carries t3, the egress time of the response
+    PdelayRespFollowUpMessage followup;
+    followup.header.domainNumber = domain;
+    followup.header.sourcePortIdentity = response.header.sourcePortIdentity;
+    followup.header.sequenceId = request.header.sequenceId;
+    followup.header.logMessageInterval = 0x7F;
+    if (!get_tx_timestamp(port_id, followup.responseOriginTimestamp)) {
+        // Without t3 the requester would compute a wrong delay; let its
+        // exchange time out instead
+        LOG_DEBUG("No egress timestamp for Pdelay_Resp on port {}, skipping follow-up", port_id);
+        return;
+    }
+    followup.requestingPortIdentity = request.header.sourcePortIdentity;
+    
+    message_sender_(port_id, serialize_message(followup));
+}
+
+void GptpPortManager::process_pdelay_resp_message(uint16_t port_id,
+                                                 const PdelayRespMessage& response,
+                                                 const Timestamp& receipt_time) {
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end()) {
+        return;
+    }
+    
+    PortInfo& port_info = port_it->second;
+    if (!port_info.pdelay_in_progress ||
+        response.header.sequenceId != port_info.pending_pdelay.sequence_id ||
+        !(response.requestingPortIdentity.clockIdentity == local_clock_id_) ||
+        response.requestingPortIdentity.portNumber != port_id) {
+        return;
+    }
+    
+    port_info.pending_pdelay.t2 = response.requestReceiptTimestamp;
+    port_info.pending_pdelay.t4 = receipt_time;
+    port_info.pending_pdelay.t2_valid = true;
+}
+
+void GptpPortManager::process_pdelay_resp_followup_message(uint16_t port_id,
+                                                          const PdelayRespFollowUpMessage& followup) {
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end()) {
+        return;
+    }
+    
+    PortInfo& port_info = port_it->second;
+    if (!port_info.pdelay_in_progress || !port_info.pending_pdelay.t2_valid ||
+        followup.header.sequenceId != port_info.pending_pdelay.sequence_id ||
+        !(followup.requestingPortIdentity.clockIdentity == local_clock_id_) ||
+        followup.requestingPortIdentity.portNumber != port_id) {
+        return;
+    }
+    
+    port_info.pending_pdelay.t3 = followup.responseOriginTimestamp;
+    port_info.pending_pdelay.t3_valid = true;
+    port_info.pdelay_in_progress = false;
+    
+    auto result = port_info.delay_calculator->calculate_path_delay(port_info.pending_pdelay);
+    if (!result.valid) {
+        return;
+    }
+    
+    port_info.link_delay = result.mean_link_delay;
+    port_info.link_delay_valid = true;
+    
+    // Neighbor rate ratio needs a sliding window of completed exchanges
+    port_info.pdelay_history.push_back(port_info.pending_pdelay);
+    if (port_info.pdelay_history.size() > PDELAY_HISTORY_SIZE) {
+        port_info.pdelay_history.erase(port_info.pdelay_history.begin());
+    }
+    port_info.delay_calculator->update_neighbor_rate_ratio(port_info.pdelay_history);
+    
+    if (sync_sample_callback_) {
+        const auto& exchange = port_info.pending_pdelay;
+        SyncSample sample;
+        sample.kind = SyncSample::Kind::PDELAY;
+        sample.port_id = port_id;
+        sample.path_delay_ns = result.mean_link_delay.count();
+        sample.rate_ratio = port_info.delay_calculator->get_current_neighbor_rate_ratio();
+        sample.t1_ns = exchange.t1.to_nanoseconds().count();
+        sample.t2_ns = exchange.t2.to_nanoseconds().count();
+        sample.t3_ns = exchange.t3.to_nanoseconds().count();
+        sample.t4_ns = exchange.t4.to_nanoseconds().count();
+        sync_sample_callback_(sample);
+    }
+}
+
+ParseResult GptpPortManager::process_frame(uint16_t port_id,
+                                           const uint8_t* payload,
+                                           size_t length,
+                                           const Timestamp& receipt_time) {
+    using serialization::MessageView;
+    using serialization::MessageDeserializer;
+    
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end()) {
+        return ParseResult::UNKNOWN_ERROR;
+    }
+    
+    MessageView view;
+    if (!MessageView::parse(payload, length, view)) {
+        return ParseResult::INVALID_LENGTH;
+    }
+    if (view.header.versionPTP != 2) {
+        return ParseResult::INVALID_VERSION;
+    }
+    if (view.header.domainNumber != port_it->second.domain_number) {
+        return ParseResult::INVALID_DOMAIN;
+    }
+    
+    // Frames we sent ourselves (e.g. looped back through another port)
+    if (view.header.sourcePortIdentity.clockIdentity == local_clock_id_) {
+        return ParseResult::SUCCESS;
+    }
+    
+    // Frames still queued from before a link-down event
+    if (!port_it->second.link_up) {
+        return ParseResult::SUCCESS;
+    }
+    
+    if (dispatch_callback_) {
+        dispatch_callback_(port_id, view.type());
+    }
+    
+    switch (view.type()) {
+        case protocol::MessageType::SYNC: {
+            SyncMessage sync;
+            if (!MessageDeserializer::deserialize_sync(view, sync)) return ParseResult::INVALID_LENGTH;
+            process_sync_message(port_id, sync, receipt_time);
+            break;
+        }
+        case protocol::MessageType::FOLLOW_UP: {
+            FollowUpMessage followup;
+            if (!MessageDeserializer::deserialize_followup(view, followup)) return ParseResult::INVALID_LENGTH;
+            process_followup_message(port_id, followup);
+            break;
+        }
+        case protocol::MessageType::PDELAY_REQ: {
+            PdelayReqMessage request;
+            if (!MessageDeserializer::deserialize_pdelay_req(view, request)) return ParseResult::INVALID_LENGTH;
+            process_pdelay_req_message(port_id, request, receipt_time);
+            break;
+        }
+        case protocol::MessageType::PDELAY_RESP: {
+            PdelayRespMessage response;
+            if (!MessageDeserializer::deserialize_pdelay_resp(view, response)) return ParseResult::INVALID_LENGTH;
+            process_pdelay_resp_message(port_id, response, receipt_time);
+            break;
+        }
+        case protocol::MessageType::PDELAY_RESP_FOLLOW_UP: {
+            PdelayRespFollowUpMessage followup;
+            if (!MessageDeserializer::deserialize_pdelay_resp_followup(view, followup)) return ParseResult::INVALID_LENGTH;
+            process_pdelay_resp_followup_message(port_id, followup);
+            break;
+        }
+        case protocol::MessageType::ANNOUNCE: {
+            AnnounceMessage announce;
+            if (!MessageDeserializer::deserialize_announce(view, announce)) return ParseResult::INVALID_LENGTH;
+            process_announce_message(port_id, announce, receipt_time);
+            break;
+        }
+        case protocol::MessageType::SIGNALING:
+            // Interval requests are not supported; ignore
+            break;
+        default:
+            return ParseResult::INVALID_MESSAGE_TYPE;
+    }
+    
+    return ParseResult::SUCCESS;
+}
+
 // ============================================================================
 // Periodic Operations
 // ============================================================================
@@ -230,6 +581,13 @@ void GptpPortManager::run_periodic_tasks(std::chrono::steady_clock::time_point c
             current_time.time_since_epoch());
         port_info.gptp_port->tick(current_time_ns);
         
+        // Peer delay runs on every enabled port regardless of role
+        if (port_info.current_role != bmca::PortRole::DISABLED &&
+            current_time - port_info.last_pdelay_tx_time >= pdelay_interval_) {
+            transmit_pdelay_request(port_id);
+            port_info.last_pdelay_tx_time = current_time;
+        }
+        
         // Handle master behavior
         if (port_info.current_role == bmca::PortRole::MASTER) {
             // Transmit announce messages
@@ -240,47 +598,50 @@ void GptpPortManager::run_periodic_tasks(std::chrono::steady_clock::time_point c
             
             // Transmit sync messages
             if (current_time - port_info.last_sync_tx_time >= sync_interval_) {
+                if (sync_due_callback_) {
+                    // The first Sync after (re)gaining the master role is due immediately
+                    bool restarted = current_time - port_info.last_sync_tx_time >= 2 * sync_interval_;
+                    sync_due_callback_(port_id, restarted ? current_time : port_info.last_sync_tx_time + sync_interval_);
+                }
                 transmit_sync_message(port_id);
                 port_info.last_sync_tx_time = current_time;
             }
         }
         
         // Clean up expired pending syncs
-        auto& pending_syncs = port_info.pending_syncs;
-        for (auto it = pending_syncs.begin(); it != pending_syncs.end();) {
-            if (current_time > it->second.timeout) {
-                std::cout << "Sync " << it->first << " timed out waiting for follow-up" << std::endl;
-                it = pending_syncs.erase(it);
-            } else {
-                ++it;
+        for (auto& pending : port_info.pending_syncs) {
+            if (pending.valid && current_time > pending.timeout) {
+                LOG_DEBUG("Sync {} timed out waiting for follow-up", pending.sequence_id);
+                port_info.counters.followups_missed++;
+                pending.valid = false;
             }
         }
     }
     
     // Run BMCA timeout checks for each domain
+    std::bitset<256> domains_to_run;
+    for (const auto& port_pair : ports_) {
+        uint8_t domain = port_pair.second.domain_number;
+        auto last_run = last_bmca_run_.find(domain);
+        if (last_run == last_bmca_run_.end() || current_time - last_run->second >= announce_interval_) {
+            domains_to_run.set(domain);
+        }
+    }
     for (auto& domain_pair : bmca_coordinators_) {
         uint8_t domain = domain_pair.first;
         auto* bmca = domain_pair.second.get();
         auto timed_out_ports = bmca->check_announce_timeouts(current_time);
         for (uint16_t timed_out_port_id : timed_out_ports) {
-            std::cout << "Announce timeout on port " << timed_out_port_id << " domain " << static_cast<int>(domain) << std::endl;
-            // Re-run BMCA to handle timeout
-            auto local_priority = create_local_priority_vector(domain);
-            auto decisions = bmca->run_bmca(local_priority);
-            
-            // Apply any role changes - Note: BmcaDecision doesn't have port_id
-            // so we apply to all ports in this domain
-            for (auto& port_pair : ports_) {
-                uint16_t check_port_id = port_pair.first;
-                PortInfo& check_port_info = port_pair.second;
-                if (check_port_info.domain_number == domain) {
-                    for (const auto& decision : decisions) {
-                        if (decision.recommended_role != check_port_info.current_role) {
-                            handle_role_change(check_port_id, decision.recommended_role);
-                        }
-                    }
-                }
-            }
+            LOG_INFO("Announce timeout on port {} domain {}", timed_out_port_id, static_cast<int>(domain));
+            domains_to_run.set(domain);
+        }
+    }
+    
+    // Re-run BMCA periodically and after timeouts so roles follow topology changes
+    for (size_t domain = 0; domain < domains_to_run.size(); ++domain) {
+        if (domains_to_run.test(domain)) {
+            run_bmca_for_domain(static_cast<uint8_t>(domain));
+            last_bmca_run_[static_cast<uint8_t>(domain)] = current_time;
         }
     }
 }
@@ -312,6 +673,59 @@ servo::SynchronizationManager::SyncStatus GptpPortManager::get_sync_status(uint1
     return servo::SynchronizationManager::SyncStatus{};
 }
 
+std::chrono::nanoseconds GptpPortManager::get_link_delay(uint16_t port_id) const {
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end() || !port_it->second.link_delay_valid) {
+        return std::chrono::nanoseconds(0);
+    }
+    return port_it->second.link_delay;
+}
+
+double GptpPortManager::get_neighbor_rate_ratio(uint16_t port_id) const {
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end()) {
+        return 1.0;
+    }
+    return port_it->second.delay_calculator->get_current_neighbor_rate_ratio();
+}
+
+GptpPortManager::PortCounters GptpPortManager::get_port_counters(uint16_t port_id) const {
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end()) {
+        return PortCounters();
+    }
+    return port_it->second.counters;
+}
+
+GptpPortManager::StateSizes GptpPortManager::get_state_sizes() const {
+    StateSizes sizes;
+    sizes.ports = ports_.size();
+    for (const auto& port_pair : ports_) {
+        for (const auto& pending : port_pair.second.pending_syncs) {
+            sizes.pending_syncs += pending.valid ? 1 : 0;
+        }
+        sizes.pdelay_history += port_pair.second.pdelay_history.size();
+    }
+    for (const auto& domain_pair : bmca_coordinators_) {
+        sizes.bmca_masters += domain_pair.second->get_master_count();
+    }
+    return sizes;
+}
+
+bmca::PriorityVector GptpPortManager::get_grandmaster(uint16_t port_id) const {
+    auto port_it = ports_.find(port_id);
+    uint8_t domain = port_it != ports_.end() ? port_it->second.domain_number : 0;
+    
+    auto bmca_it = bmca_coordinators_.find(domain);
+    if (bmca_it != bmca_coordinators_.end() && !bmca_it->second->is_local_grandmaster()) {
+        const bmca::PriorityVector* grandmaster = bmca_it->second->get_grandmaster();
+        if (grandmaster != nullptr) {
+            return *grandmaster;
+        }
+    }
+    return const_cast<GptpPortManager*>(this)->create_local_priority_vector(domain);
+}
+
 std::vector<bmca::BmcaDecision> GptpPortManager::get_bmca_decisions() const {
     std::vector<bmca::BmcaDecision> all_decisions;
     
@@ -319,7 +733,7 @@ std::vector<bmca::BmcaDecision> GptpPortManager::get_bmca_decisions() const {
         uint8_t domain = domain_pair.first;
         auto* bmca = domain_pair.second.get();
         auto local_priority = const_cast<GptpPortManager*>(this)->create_local_priority_vector(domain);
-        auto decisions = bmca->run_bmca(local_priority);
+        const auto& decisions = bmca->run_bmca(local_priority);
         all_decisions.insert(all_decisions.end(), decisions.begin(), decisions.end());
     }
     
@@ -334,8 +748,9 @@ bmca::BmcaCoordinator* GptpPortManager::get_bmca_coordinator(uint8_t domain_numb
     auto it = bmca_coordinators_.find(domain_number);
     if (it == bmca_coordinators_.end()) {
         // Create new BMCA coordinator for this domain
-        std::cout << "Creating BMCA coordinator for domain " << static_cast<int>(domain_number) << std::endl;
+        LOG_DEBUG("Creating BMCA coordinator for domain {}", static_cast<int>(domain_number));
         bmca_coordinators_[domain_number] = std::make_unique<bmca::BmcaCoordinator>(local_clock_id_);
+        bmca_coordinators_[domain_number]->update_local_clock(local_priority1_, local_clock_quality_, local_priority2_);
         return bmca_coordinators_[domain_number].get();
     }
     return it->second.get();
@@ -345,8 +760,9 @@ servo::SynchronizationManager* GptpPortManager::get_sync_manager(uint8_t domain_
     auto it = sync_managers_.find(domain_number);
     if (it == sync_managers_.end()) {
         // Create new sync manager for this domain
-        std::cout << "Creating sync manager for domain " << static_cast<int>(domain_number) << std::endl;
+        LOG_DEBUG("Creating sync manager for domain {}", static_cast<int>(domain_number));
         sync_managers_[domain_number] = std::make_unique<servo::SynchronizationManager>();
+        sync_managers_[domain_number]->set_clock_adjuster(clock_adjuster_);
         return sync_managers_[domain_number].get();
     }
     return it->second.get();
@@ -362,11 +778,24 @@ void GptpPortManager::handle_role_change(uint16_t port_id, bmca::PortRole new_ro
     bmca::PortRole old_role = port_info.current_role;
     
     if (old_role != new_role) {
-        std::cout << "Port " << port_id << " role change: " 
-                  << static_cast<int>(old_role) << " -> " << static_cast<int>(new_role) << std::endl;
+        LOG_INFO("Port {} role change: {} -> {}", port_id, static_cast<int>(old_role), static_cast<int>(new_role));
         
         port_info.current_role = new_role;
         
+        // Servo follows the slave port; stale syncs belong to the old role
+        auto* sync_manager = get_sync_manager(port_info.domain_number);
+        if (new_role == bmca::PortRole::SLAVE) {
+            sync_manager->set_slave_port(port_id);
+        } else if (old_role == bmca::PortRole::SLAVE) {
+            clear_pending_syncs(port_info);
+            if (sync_manager->get_sync_status().slave_port_id == port_id) {
+                sync_manager->set_slave_port(0);
+            }
+        }
+        if (new_role == bmca::PortRole::DISABLED) {
+            port_info.pdelay_in_progress = false;
+        }
+        
         // Update underlying port state
         update_port_state(port_id, new_role);
         
@@ -377,6 +806,69 @@ void GptpPortManager::handle_role_change(uint16_t port_id, bmca::PortRole new_ro
     }
 }
 
+void GptpPortManager::run_bmca_for_domain(uint8_t domain_number) {
+    auto* bmca = get_bmca_coordinator(domain_number);
+    auto local_priority = create_local_priority_vector(domain_number);
+    const auto& decisions = bmca->run_bmca(local_priority);
+    
+    for (auto& port_pair : ports_) {
+        PortInfo& port_info = port_pair.second;
+        if (port_info.domain_number != domain_number || port_info.current_role == bmca::PortRole::DISABLED) {
+            continue;
+        }
+        
+        // Ports that never heard an announce act as master
+        bmca::PortRole role = bmca::PortRole::MASTER;
+        for (const auto& decision : decisions) {
+            if (decision.port_id == port_pair.first) {
+                role = decision.recommended_role;
+                break;
+            }
+        }
+        handle_role_change(port_pair.first, role);
+    }
+}
+
+void GptpPortManager::transmit_pdelay_request(uint16_t port_id) {
+    auto port_it = ports_.find(port_id);
+    if (port_it == ports_.end()) {
+        return;
+    }
+    
+    PortInfo& port_info = port_it->second;
+    
+    PdelayReqMessage request;
+    request.header.domainNumber = port_info.domain_number;
+    request.header.sourcePortIdentity.clockIdentity = local_clock_id_;
+    request.header.sourcePortIdentity.portNumber = port_id;
+    request.header.sequenceId = sequence_manager_.get_next_sequence(port_id, protocol::MessageType::PDELAY_REQ);
+    request.header.logMessageInterval = protocol::LOG_PDELAY_INTERVAL_1S;
+    
+    message_sender_(port_id, serialize_message(request));
+    
+    // A new request abandons any exchange that never completed
+    port_info.pending_pdelay = path_delay::PdelayTimestamps();
+    port_info.pending_pdelay.sequence_id = request.header.sequenceId;
+    // Without t1 the response cannot be used; the exchange is not started
+    port_info.pdelay_in_progress = get_tx_timestamp(port_id, port_info.pending_pdelay.t1);
+}
+
+bool GptpPortManager::get_tx_timestamp(uint16_t port_id, Timestamp& tx_time) {
+    if (!tx_timestamp_provider_) {
+        tx_time.from_nanoseconds(std::chrono::nanoseconds(get_clock_source().now_realtime_ns()));
+        return true;
+    }
+    if (tx_timestamp_provider_(port_id, tx_time)) {
+        return true;
+    }
+    
+    auto port_it = ports_.find(port_id);
+    if (port_it != ports_.end()) {
+        port_it->second.counters.tx_timestamps_missing++;
+    }
+    return false;
+}
+
 void GptpPortManager::transmit_announce_message(uint16_t port_id) {
     auto port_it = ports_.find(port_id);
     if (port_it == ports_.end()) {
@@ -387,10 +879,9 @@ void GptpPortManager::transmit_announce_message(uint16_t port_id) {
     
     // Build and transmit announce message
     auto announce = build_announce_message(domain, port_id);
-    auto serialized = serialize_message(announce);
+    const auto& serialized = serialize_message(announce);
     
-    std::cout << "Transmitting announce message from port " << port_id 
-              << " (sequence " << announce.header.sequenceId << ")" << std::endl;
+    LOG_DEBUG("Transmitting announce message from port {} (sequence {})", port_id, announce.header.sequenceId);
     
     message_sender_(port_id, serialized);
 }
@@ -405,10 +896,9 @@ void GptpPortManager::transmit_sync_message(uint16_t port_id) {
     
     // Build and transmit sync message
     auto sync = build_sync_message(domain, port_id);
-    auto serialized = serialize_message(sync);
+    const auto& serialized = serialize_message(sync);
     
-    std::cout << "Transmitting sync message from port " << port_id 
-              << " (sequence " << sync.header.sequenceId << ")" << std::endl;
+    LOG_DEBUG("Transmitting sync message from port {} (sequence {})", port_id, sync.header.sequenceId);
     
     message_sender_(port_id, serialized);
     
@@ -438,16 +928,16 @@ void GptpPortManager::transmit_followup_message(uint16_t port_id, uint16_t seque
     followup.header.controlField = 0x02; // Follow_Up
     followup.header.logMessageInterval = -3; // Same as sync
     
-    // Set precise origin timestamp (would be captured from hardware in real implementation)
-    auto now = std::chrono::high_resolution_clock::now();
-    auto ns_since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
-    followup.preciseOriginTimestamp.set_seconds(ns_since_epoch.count() / 1000000000ULL);
-    followup.preciseOriginTimestamp.nanoseconds = ns_since_epoch.count() % 1000000000ULL;
+    // Precise origin timestamp is the egress time of the Sync just sent;
+    // slaves drop the Sync when its Follow_Up never arrives
+    if (!get_tx_timestamp(port_id, followup.preciseOriginTimestamp)) {
+        LOG_DEBUG("No egress timestamp for Sync {} on port {}, skipping follow-up", sequence_id, port_id);
+        return;
+    }
     
-    auto serialized = serialize_message(followup);
+    const auto& serialized = serialize_message(followup);
     
-    std::cout << "Transmitting follow-up message from port " << port_id 
-              << " (sequence " << sequence_id << ")" << std::endl;
+    LOG_DEBUG("Transmitting follow-up message from port {} (sequence {})", port_id, sequence_id);
     
     message_sender_(port_id, serialized);
 }
@@ -473,20 +963,27 @@ AnnounceMessage GptpPortManager::build_announce_message(uint8_t domain_number, u
     announce.originTimestamp.nanoseconds = 0;
     announce.currentUtcOffset = 37; // Current TAI-UTC offset
     
-    // Get proper clock quality and priorities from clock quality manager
-    // For now, use IEEE 802.1AS compliant defaults - this should be replaced
-    // with actual ClockQualityManager integration
-    announce.grandmasterPriority1 = 248; // IEEE 802.1AS default for end station  
-    announce.grandmasterPriority2 = 248; // IEEE 802.1AS default for end station
+    // Advertise ourselves while grandmaster, otherwise forward the current
+    // grandmaster's information one step further away
+    auto* bmca = get_bmca_coordinator(domain_number);
+    const bmca::PriorityVector* grandmaster = bmca->get_grandmaster();
+    bmca::PriorityVector advertised = create_local_priority_vector(domain_number);
+    if (!bmca->is_local_grandmaster() && grandmaster != nullptr) {
+        advertised = *grandmaster;
+        advertised.steps_removed = static_cast<uint16_t>(grandmaster->steps_removed + 1);
+    }
+    
+    announce.grandmasterPriority1 = advertised.grandmaster_priority1;
+    announce.grandmasterPriority2 = advertised.grandmaster_priority2;
     
     // Pack ClockQuality according to IEEE 802.1AS format
-    // clockClass=248 (default), clockAccuracy=UNKNOWN(0xFE), offsetScaledLogVariance=0x436A
-    announce.grandmasterClockQuality = (static_cast<uint32_t>(248) << 24) |      // clockClass
-                                      (static_cast<uint32_t>(0xFE) << 16) |      // clockAccuracy 
-                                      static_cast<uint32_t>(0x436A);             // offsetScaledLogVariance
+    announce.grandmasterClockQuality =
+        (static_cast<uint32_t>(advertised.grandmaster_clock_quality.clockClass) << 24) |
+        (static_cast<uint32_t>(advertised.grandmaster_clock_quality.clockAccuracy) << 16) |
+        static_cast<uint32_t>(advertised.grandmaster_clock_quality.offsetScaledLogVariance);
     
-    announce.grandmasterIdentity = local_clock_id_; // We are grandmaster if we're transmitting
-    announce.stepsRemoved = 0; // We are the grandmaster
+    announce.grandmasterIdentity = advertised.grandmaster_identity;
+    announce.stepsRemoved = advertised.steps_removed;
     announce.timeSource = static_cast<uint8_t>(protocol::TimeSource::INTERNAL_OSCILLATOR);
     
     return announce;
@@ -500,7 +997,7 @@ SyncMessage GptpPortManager::build_sync_message(uint8_t domain_number, uint16_t
     sync.header.versionPTP = 2;
     sync.header.messageLength = sizeof(SyncMessage);
     sync.header.domainNumber = domain_number;
-    sync.header.flags = 0x02; // twoStepFlag
+    sync.header.flags = 0x0200; // twoStepFlag (flagField octet 0, bit 1)
     sync.header.correctionField = 0;
     sync.header.sourcePortIdentity.clockIdentity = local_clock_id_;
     sync.header.sourcePortIdentity.portNumber = port_id;
@@ -515,16 +1012,40 @@ SyncMessage GptpPortManager::build_sync_message(uint8_t domain_number, uint16_t
     return sync;
 }
 
-std::vector<uint8_t> GptpPortManager::serialize_message(const AnnounceMessage& message) {
-    return serialization::MessageSerializer::serialize_announce(message);
+const std::vector<uint8_t>& GptpPortManager::serialize_message(const AnnounceMessage& message) {
+    serialization::MessageSerializer::serialize_announce(message, tx_buffer_);
+    return tx_buffer_;
 }
 
-std::vector<uint8_t> GptpPortManager::serialize_message(const SyncMessage& message) {
-    return serialization::MessageSerializer::serialize_sync(message);
+const std::vector<uint8_t>& GptpPortManager::serialize_message(const SyncMessage& message) {
+    serialization::MessageSerializer::serialize_sync(message, tx_buffer_);
+    return tx_buffer_;
 }
 
-std::vector<uint8_t> GptpPortManager::serialize_message(const FollowUpMessage& message) {
-    return serialization::MessageSerializer::serialize_followup(message);
+const std::vector<uint8_t>& GptpPortManager::serialize_message(const FollowUpMessage& message) {
+    serialization::MessageSerializer::serialize_followup(message, tx_buffer_);
+    return tx_buffer_;
+}
+
+const std::vector<uint8_t>& GptpPortManager::serialize_message(const PdelayReqMessage& message) {
+    serialization::MessageSerializer::serialize_pdelay_req(message, tx_buffer_);
+    return tx_buffer_;
+}
+
+const std::vector<uint8_t>& GptpPortManager::serialize_message(const PdelayRespMessage& message) {
+    serialization::MessageSerializer::serialize_pdelay_resp(message, tx_buffer_);
+    return tx_buffer_;
+}
+
+const std::vector<uint8_t>& GptpPortManager::serialize_message(const PdelayRespFollowUpMessage& message) {
+    serialization::MessageSerializer::serialize_pdelay_resp_followup(message, tx_buffer_);
+    return tx_buffer_;
+}
+
+void GptpPortManager::clear_pending_syncs(PortInfo& port_info) {
+    for (auto& pending : port_info.pending_syncs) {
+        pending.valid = false;
+    }
 }
 
 bmca::PriorityVector GptpPortManager::create_local_priority_vector(uint8_t domain_number) {
@@ -532,11 +1053,11 @@ bmca::PriorityVector GptpPortManager::create_local_priority_vector(uint8_t domai
     
     // Create local clock priority vector
     local_priority.grandmaster_identity = local_clock_id_;
-    local_priority.grandmaster_priority1 = 128; // Default priority
-    local_priority.grandmaster_clock_quality.clockClass = 248; // Slave-only by default
-    local_priority.grandmaster_clock_quality.clockAccuracy = protocol::ClockAccuracy::UNKNOWN;
-    local_priority.grandmaster_clock_quality.offsetScaledLogVariance = 0x436A;
-    local_priority.grandmaster_priority2 = 128; // Default priority
+    // Same values that are advertised in our announces
+    (void)domain_number;
+    local_priority.grandmaster_priority1 = local_priority1_;
+    local_priority.grandmaster_clock_quality = local_clock_quality_;
+    local_priority.grandmaster_priority2 = local_priority2_;
     local_priority.sender_identity = local_clock_id_;
     local_priority.steps_removed = 0;
     
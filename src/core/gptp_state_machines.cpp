@@ -6,7 +6,10 @@
 #include "../../include/gptp_state_machines.hpp"
 #include "../../include/gptp_clock.hpp"
 #include "../../include/clock_servo.hpp"
-#include <iostream>
+#include "../../include/clock_source.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
 
 #ifdef _WIN32
@@ -23,8 +26,7 @@ namespace gptp {
 
     void StateMachine::transition_to_state(int new_state) {
         if (new_state != current_state_) {
-            std::cout << "[" << name_ << "] State transition: " << current_state_ 
-                      << " -> " << new_state << std::endl;
+            LOG_DEBUG("[{}] State transition: {} -> {}", name_, current_state_, new_state);
             
             on_state_exit(current_state_);
             int old_state = current_state_;
@@ -113,10 +115,10 @@ namespace gptp {
         void PortSyncStateMachine::on_state_entry(int state) {
             switch (state) {
                 case State::DISCARD:
-                    std::cout << "[" << name_ << "] Entered DISCARD state" << std::endl;
+                    LOG_DEBUG("[{}] Entered DISCARD state", name_);
                     break;
                 case State::TRANSMIT:
-                    std::cout << "[" << name_ << "] Entered TRANSMIT state" << std::endl;
+                    LOG_DEBUG("[{}] Entered TRANSMIT state", name_);
                     break;
             }
         }
@@ -138,6 +140,7 @@ namespace gptp {
             , sync_sequence_id_(0)
             , last_sync_sequence_(0)
         {
+            tx_buffer_.reserve(std::max(sizeof(SyncMessage), sizeof(FollowUpMessage)));
         }
 
         void MDSyncStateMachine::initialize() {
@@ -166,7 +169,7 @@ namespace gptp {
                     // Check for follow-up timeout
                     if (waiting_for_follow_up_ && 
                         current_time - last_md_sync_time_ > follow_up_receipt_timeout_) {
-                        std::cout << "[" << name_ << "] Follow-up timeout" << std::endl;
+                        LOG_DEBUG("[{}] Follow-up timeout", name_);
                         waiting_for_follow_up_ = false;
                         transition_to_state(State::SEND_MD_SYNC);
                     }
@@ -214,7 +217,7 @@ namespace gptp {
         }
 
         void MDSyncStateMachine::tx_md_sync() {
-            std::cout << "[" << name_ << "] Transmitting MD Sync message" << std::endl;
+            LOG_DEBUG("[{}] Transmitting MD Sync message", name_);
             
             // Create basic sync message structure
             SyncMessage sync_msg;
@@ -236,8 +239,7 @@ namespace gptp {
             sync_msg.header.sourcePortIdentity.portNumber = 1; // Default port
             
             // Set current timestamp
-            auto now = std::chrono::high_resolution_clock::now();
-            auto ns_since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
+            auto ns_since_epoch = std::chrono::nanoseconds(get_clock_source().now_realtime_ns());
             
             sync_msg.originTimestamp.set_seconds(ns_since_epoch.count() / 1000000000ULL);
             sync_msg.originTimestamp.nanoseconds = ns_since_epoch.count() % 1000000000ULL;
@@ -247,7 +249,7 @@ namespace gptp {
             last_sync_sequence_ = sync_msg.header.sequenceId;
             
             // Serialize and send via socket
-            std::vector<uint8_t> serialized = serialize_sync_message(sync_msg);
+            const std::vector<uint8_t>& serialized = serialize_sync_message(sync_msg);
             
             if (socket_) {
                 // Create gPTP packet for network transmission
@@ -255,17 +257,20 @@ namespace gptp {
                 packet.ethernet.destination = protocol::GPTP_MULTICAST_MAC;
                 // MAC address would be set from port configuration
                 packet.ethernet.etherType = htons(protocol::GPTP_ETHERTYPE);
-                packet.payload = serialized;
+                packet.payload.swap(tx_buffer_);  // Lent to the packet, returned below
                 
                 PacketTimestamp timestamp;
                 auto result = socket_->send_packet(packet, timestamp);
+                packet.payload.swap(tx_buffer_);
                 if (result.is_success()) {
-                    std::cout << "[" << name_ << "] Sync message transmitted via network" << std::endl;
+                    LOG_DEBUG("[{}] Sync message transmitted via network", name_);
                 } else {
-                    std::cout << "[" << name_ << "] Failed to transmit sync message: " << static_cast<int>(result.error()) << std::endl;
+                    LOG_WARN("[{}] Failed to transmit sync message: {}", name_, static_cast<int>(result.error()));
                 }
             } else {
-                std::cout << "[" << name_ << "] Sync message prepared (size: " << serialized.size() << " bytes) - no socket available" << std::endl;
+                LOG_DEBUG("[{}] Sync message prepared (size: {} bytes) - no socket available",
+                          name_,
+                          serialized.size());
             }
             
             // Schedule follow-up message transmission
@@ -275,20 +280,20 @@ namespace gptp {
         }
 
         void MDSyncStateMachine::set_md_sync_receive() {
-            std::cout << "[" << name_ << "] MD Sync received" << std::endl;
+            LOG_DEBUG("[{}] MD Sync received", name_);
             process_event(Event::MD_SYNC_RECEIPT, nullptr);
         }
 
         void MDSyncStateMachine::on_state_entry(int state) {
             switch (state) {
                 case State::INITIALIZING:
-                    std::cout << "[" << name_ << "] Entered INITIALIZING state" << std::endl;
+                    LOG_DEBUG("[{}] Entered INITIALIZING state", name_);
                     break;
                 case State::SEND_MD_SYNC:
-                    std::cout << "[" << name_ << "] Entered SEND_MD_SYNC state" << std::endl;
+                    LOG_DEBUG("[{}] Entered SEND_MD_SYNC state", name_);
                     break;
                 case State::WAITING_FOR_FOLLOW_UP:
-                    std::cout << "[" << name_ << "] Entered WAITING_FOR_FOLLOW_UP state" << std::endl;
+                    LOG_DEBUG("[{}] Entered WAITING_FOR_FOLLOW_UP state", name_);
                     break;
             }
         }
@@ -347,7 +352,7 @@ namespace gptp {
                 case State::WAITING_FOR_PDELAY_RESP:
                     // Check for response timeout
                     if (current_time - last_pdelay_req_time_ > pdelay_resp_receipt_timeout_) {
-                        std::cout << "[" << name_ << "] Pdelay response timeout" << std::endl;
+                        LOG_DEBUG("[{}] Pdelay response timeout", name_);
                         transition_to_state(State::SEND_PDELAY_REQ);
                     }
                     break;
@@ -355,7 +360,7 @@ namespace gptp {
                 case State::WAITING_FOR_PDELAY_RESP_FOLLOW_UP:
                     // Check for follow-up timeout
                     if (current_time - last_pdelay_req_time_ > pdelay_resp_receipt_timeout_) {
-                        std::cout << "[" << name_ << "] Pdelay response follow-up timeout" << std::endl;
+                        LOG_DEBUG("[{}] Pdelay response follow-up timeout", name_);
                         transition_to_state(State::SEND_PDELAY_REQ);
                     }
                     break;
@@ -414,14 +419,11 @@ namespace gptp {
         }
 
         void LinkDelayStateMachine::send_pdelay_req() {
-            std::cout << "[" << name_ << "] Sending Pdelay_Req (seq: " 
-                      << pdelay_req_sequence_id_ << ")" << std::endl;
+            LOG_DEBUG("[{}] Sending Pdelay_Req (seq: {})", name_, pdelay_req_sequence_id_);
             
             // Record transmission timestamp (T1)
             // In a real implementation, this would be captured from hardware
-            auto now = std::chrono::high_resolution_clock::now();
-            t1_timestamp_.set_seconds(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
-            t1_timestamp_.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count() % 1000000000;
+            t1_timestamp_.from_nanoseconds(std::chrono::nanoseconds(get_clock_source().now_realtime_ns()));
             
             last_pdelay_req_time_ = last_tick_time_;
             pdelay_req_sequence_id_++;
@@ -447,42 +449,37 @@ namespace gptp {
                 auto result = socket_->send_packet(packet, timestamp);
                 if (result.is_success()) {
                     // Update T1 with actual transmission timestamp
-                    auto tx_ns = timestamp.hardware_timestamp;
+                    auto tx_ns = timestamp.get_best_timestamp();
                     t1_timestamp_.set_seconds(tx_ns.count() / 1000000000);
                     t1_timestamp_.nanoseconds = tx_ns.count() % 1000000000;
                     
-                    std::cout << "[" << name_ << "] Pdelay_Req transmitted via network" << std::endl;
+                    LOG_DEBUG("[{}] Pdelay_Req transmitted via network", name_);
                 } else {
-                    std::cout << "[" << name_ << "] Failed to transmit Pdelay_Req: " << static_cast<int>(result.error()) << std::endl;
+                    LOG_WARN("[{}] Failed to transmit Pdelay_Req: {}", name_, static_cast<int>(result.error()));
                 }
             } else {
-                std::cout << "[" << name_ << "] Pdelay_Req prepared - no socket available" << std::endl;
+                LOG_DEBUG("[{}] Pdelay_Req prepared - no socket available", name_);
             }
             
-            std::cout << "[" << name_ << "] T1 timestamp: " << t1_timestamp_.get_seconds() 
-                      << "." << t1_timestamp_.nanoseconds << std::endl;
+            LOG_DEBUG("[{}] T1 timestamp: {}.{}", name_, t1_timestamp_.get_seconds(), t1_timestamp_.nanoseconds);
         }
 
         void LinkDelayStateMachine::process_pdelay_resp(const PdelayRespMessage& resp) {
-            std::cout << "[" << name_ << "] Processing Pdelay_Resp" << std::endl;
+            LOG_DEBUG("[{}] Processing Pdelay_Resp", name_);
             
             // Record reception timestamp (T4)
             // In a real implementation, this would be captured from hardware
-            auto now = std::chrono::high_resolution_clock::now();
-            t4_timestamp_.set_seconds(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
-            t4_timestamp_.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count() % 1000000000;
+            t4_timestamp_.from_nanoseconds(std::chrono::nanoseconds(get_clock_source().now_realtime_ns()));
             
             // Extract T2 timestamp from response message  
             t2_timestamp_ = resp.requestReceiptTimestamp;
             
-            std::cout << "[" << name_ << "] T2 from resp: " << t2_timestamp_.get_seconds()
-                      << "." << t2_timestamp_.nanoseconds << std::endl;
-            std::cout << "[" << name_ << "] T4 timestamp: " << t4_timestamp_.get_seconds() 
-                      << "." << t4_timestamp_.nanoseconds << std::endl;
+            LOG_DEBUG("[{}] T2 from resp: {}.{}", name_, t2_timestamp_.get_seconds(), t2_timestamp_.nanoseconds);
+            LOG_DEBUG("[{}] T4 timestamp: {}.{}", name_, t4_timestamp_.get_seconds(), t4_timestamp_.nanoseconds);
         }
 
         void LinkDelayStateMachine::process_pdelay_resp_follow_up(const PdelayRespFollowUpMessage& follow_up) {
-            std::cout << "[" << name_ << "] Processing Pdelay_Resp_Follow_Up" << std::endl;
+            LOG_DEBUG("[{}] Processing Pdelay_Resp_Follow_Up", name_);
             
             // Create timestamps structure for path delay calculation using IEEE 802.1AS equations
             Timestamp t1 = t1_timestamp_;  // Stored from send_pdelay_req
@@ -516,13 +513,16 @@ namespace gptp {
             if (calculated_delay >= std::chrono::nanoseconds::zero()) {
                 link_delay_ = calculated_delay;
                 
-                std::cout << "[" << name_ << "] Path delay calculated: " 
-                          << link_delay_.count() << " ns, rate ratio: " 
-                          << neighbor_rate_ratio_ << std::endl;
-                std::cout << "[" << name_ << "] Turnaround: " << initiator_turnaround.count() 
-                          << " ns, Residence: " << responder_residence.count() << " ns" << std::endl;
+                LOG_DEBUG("[{}] Path delay calculated: {} ns, rate ratio: {}",
+                          name_,
+                          link_delay_.count(),
+                          neighbor_rate_ratio_);
+                LOG_DEBUG("[{}] Turnaround: {} ns, Residence: {} ns",
+                          name_,
+                          initiator_turnaround.count(),
+                          responder_residence.count());
             } else {
-                std::cout << "[" << name_ << "] Negative path delay calculated, using fallback" << std::endl;
+                LOG_DEBUG("[{}] Negative path delay calculated, using fallback", name_);
                 link_delay_ = std::chrono::microseconds(10);  // Fallback value
             }
         }
@@ -565,22 +565,22 @@ namespace gptp {
         void LinkDelayStateMachine::on_state_entry(int state) {
             switch (state) {
                 case State::NOT_ENABLED:
-                    std::cout << "[" << name_ << "] Entered NOT_ENABLED state" << std::endl;
+                    LOG_DEBUG("[{}] Entered NOT_ENABLED state", name_);
                     break;
                 case State::INITIAL_SEND_PDELAY_REQ:
-                    std::cout << "[" << name_ << "] Entered INITIAL_SEND_PDELAY_REQ state" << std::endl;
+                    LOG_DEBUG("[{}] Entered INITIAL_SEND_PDELAY_REQ state", name_);
                     break;
                 case State::RESET:
-                    std::cout << "[" << name_ << "] Entered RESET state" << std::endl;
+                    LOG_DEBUG("[{}] Entered RESET state", name_);
                     break;
                 case State::SEND_PDELAY_REQ:
-                    std::cout << "[" << name_ << "] Entered SEND_PDELAY_REQ state" << std::endl;
+                    LOG_DEBUG("[{}] Entered SEND_PDELAY_REQ state", name_);
                     break;
                 case State::WAITING_FOR_PDELAY_RESP:
-                    std::cout << "[" << name_ << "] Entered WAITING_FOR_PDELAY_RESP state" << std::endl;
+                    LOG_DEBUG("[{}] Entered WAITING_FOR_PDELAY_RESP state", name_);
                     break;
                 case State::WAITING_FOR_PDELAY_RESP_FOLLOW_UP:
-                    std::cout << "[" << name_ << "] Entered WAITING_FOR_PDELAY_RESP_FOLLOW_UP state" << std::endl;
+                    LOG_DEBUG("[{}] Entered WAITING_FOR_PDELAY_RESP_FOLLOW_UP state", name_);
                     break;
             }
         }
@@ -657,8 +657,7 @@ namespace gptp {
         }
 
         void SiteSyncSyncStateMachine::process_sync_message(const SyncMessage& sync, const Timestamp& receipt_time) {
-            std::cout << "[" << name_ << "] Processing Sync message (seq: " 
-                      << sync.header.sequenceId << ")" << std::endl;
+            LOG_DEBUG("[{}] Processing Sync message (seq: {})", name_, sync.header.sequenceId);
             
             // Store sync message for two-step processing
             pending_sync_ = sync;
@@ -673,8 +672,7 @@ namespace gptp {
         }
 
         void SiteSyncSyncStateMachine::process_follow_up_message(const FollowUpMessage& follow_up) {
-            std::cout << "[" << name_ << "] Processing Follow_Up message (seq: " 
-                      << follow_up.header.sequenceId << ")" << std::endl;
+            LOG_DEBUG("[{}] Processing Follow_Up message (seq: {})", name_, follow_up.header.sequenceId);
             
             if (waiting_for_follow_up_ && 
                 follow_up.header.sequenceId == pending_sync_.header.sequenceId) {
@@ -685,7 +683,7 @@ namespace gptp {
                 perform_clock_synchronization(pending_sync_, sync_receipt_time_, 
                                             follow_up.preciseOriginTimestamp);
                 
-                std::cout << "[" << name_ << "] Clock synchronization updated" << std::endl;
+                LOG_DEBUG("[{}] Clock synchronization updated", name_);
             }
         }
 
@@ -705,7 +703,7 @@ namespace gptp {
             
             // Get path delay from port's LinkDelay state machine
             measurement.path_delay = port_->get_link_delay();
-            measurement.measurement_time = std::chrono::steady_clock::now();
+            measurement.measurement_time = steady_now();
             
             // Get the clock servo from the port and update it
             if (auto* clock = port_->get_clock()) {
@@ -716,10 +714,11 @@ namespace gptp {
                         auto freq_result = servo->update_servo(offset_result.offset, 
                                                               measurement.measurement_time);
                         
-                        std::cout << "[" << name_ << "] Sync complete - Offset: " 
-                                  << offset_result.offset.count() << " ns, "
-                                  << "Freq adj: " << freq_result.frequency_adjustment << " ppb, "
-                                  << "Locked: " << (freq_result.locked ? "Yes" : "No") << std::endl;
+                        LOG_DEBUG("[{}] Sync complete - Offset: {} ns, Freq adj: {} ppb, Locked: {}",
+                                  name_,
+                                  offset_result.offset.count(),
+                                  freq_result.frequency_adjustment,
+                                  (freq_result.locked ? "Yes" : "No"));
                         
                         // Apply frequency adjustment to local clock
                         clock->adjust_frequency(freq_result.frequency_adjustment);
@@ -736,11 +735,11 @@ namespace gptp {
         void SiteSyncSyncStateMachine::on_state_entry(int state) {
             switch (state) {
                 case State::INITIALIZING:
-                    std::cout << "[" << name_ << "] Entered INITIALIZING state" << std::endl;
+                    LOG_DEBUG("[{}] Entered INITIALIZING state", name_);
                     waiting_for_follow_up_ = false;
                     break;
                 case State::RECEIVING_SYNC:
-                    std::cout << "[" << name_ << "] Entered RECEIVING_SYNC state" << std::endl;
+                    LOG_DEBUG("[{}] Entered RECEIVING_SYNC state", name_);
                     break;
             }
         }
@@ -759,6 +758,7 @@ namespace gptp {
         : port_state_(PortState::INITIALIZING)
         , clock_(clock)
         , enabled_(false)
+        , link_up_(true)
     {
         port_identity_.portNumber = port_number;
         
@@ -779,7 +779,7 @@ namespace gptp {
     }
 
     void GptpPort::initialize() {
-        std::cout << "[Port " << port_identity_.portNumber << "] Initializing" << std::endl;
+        LOG_DEBUG("[Port {}] Initializing", port_identity_.portNumber);
         
         port_sync_sm_->initialize();
         md_sync_sm_->initialize();
@@ -790,7 +790,7 @@ namespace gptp {
     }
 
     void GptpPort::tick(std::chrono::nanoseconds current_time) {
-        if (!enabled_) return;
+        if (!enabled_ || !link_up_) return;
         
         port_sync_sm_->tick(current_time);
         md_sync_sm_->tick(current_time);
@@ -799,7 +799,7 @@ namespace gptp {
     }
 
     void GptpPort::enable() {
-        std::cout << "[Port " << port_identity_.portNumber << "] Enabled" << std::endl;
+        LOG_DEBUG("[Port {}] Enabled", port_identity_.portNumber);
         enabled_ = true;
         
         // Notify state machines
@@ -807,17 +807,33 @@ namespace gptp {
     }
 
     void GptpPort::disable() {
-        std::cout << "[Port " << port_identity_.portNumber << "] Disabled" << std::endl;
+        LOG_DEBUG("[Port {}] Disabled", port_identity_.portNumber);
         enabled_ = false;
         
         // Notify state machines
         link_delay_sm_->process_event(state_machine::LinkDelayStateMachine::Event::PORT_DISABLED, nullptr);
     }
 
+    void GptpPort::set_link_status(bool link_up) {
+        if (link_up == link_up_) {
+            return;
+        }
+        LOG_DEBUG("[Port {}] Link {}", port_identity_.portNumber, (link_up ? "up" : "down"));
+        link_up_ = link_up;
+        
+        if (!enabled_) {
+            return;
+        }
+        link_delay_sm_->process_event(link_up ? state_machine::LinkDelayStateMachine::Event::PORT_ENABLED
+                                              : state_machine::LinkDelayStateMachine::Event::PORT_DISABLED, nullptr);
+    }
+
     void GptpPort::set_port_state(PortState state) {
         if (state != port_state_) {
-            std::cout << "[Port " << port_identity_.portNumber << "] State change: " 
-                      << static_cast<int>(port_state_) << " -> " << static_cast<int>(state) << std::endl;
+            LOG_DEBUG("[Port {}] State change: {} -> {}",
+                      port_identity_.portNumber,
+                      static_cast<int>(port_state_),
+                      static_cast<int>(state));
             
             port_state_ = state;
             
@@ -838,8 +854,7 @@ namespace gptp {
     }
 
     void GptpPort::process_pdelay_req_message(const PdelayReqMessage& req, const Timestamp& receipt_time) {
-        std::cout << "[Port " << port_identity_.portNumber << "] Processing Pdelay_Req (seq: " 
-                  << req.header.sequenceId << ")" << std::endl;
+        LOG_DEBUG("[Port {}] Processing Pdelay_Req (seq: {})", port_identity_.portNumber, req.header.sequenceId);
         
         // Create Pdelay_Resp message
         PdelayRespMessage resp;
@@ -863,8 +878,10 @@ namespace gptp {
         // Set requesting port identity (from the request)
         resp.requestingPortIdentity = req.header.sourcePortIdentity;
         
-        std::cout << "[Port " << port_identity_.portNumber << "] Sending Pdelay_Resp (T2: " 
-                  << receipt_time.get_seconds() << "." << receipt_time.nanoseconds << ")" << std::endl;
+        LOG_DEBUG("[Port {}] Sending Pdelay_Resp (T2: {}.{})",
+                  port_identity_.portNumber,
+                  receipt_time.get_seconds(),
+                  receipt_time.nanoseconds);
         
         // This would be sent via socket layer when available
         // For now, just log the response creation
@@ -882,26 +899,23 @@ namespace gptp {
     }
 
     void GptpPort::process_announce_message(const AnnounceMessage& announce) {
-        std::cout << "[Port " << port_identity_.portNumber << "] Processing Announce message" << std::endl;
+        LOG_DEBUG("[Port {}] Processing Announce message", port_identity_.portNumber);
         
         // Forward to port manager or BMCA coordinator for best master selection
         // The announce message contains priority vectors and clock quality information
         // needed for IEEE 802.1AS-2021 BMCA algorithm
         
-        std::cout << "[Port " << port_identity_.portNumber << "] Announce from GM: "
-                  << std::hex << announce.grandmasterIdentity.id[0] << ":"
-                  << announce.grandmasterIdentity.id[1] << ":" 
-                  << announce.grandmasterIdentity.id[2] << ":" 
-                  << announce.grandmasterIdentity.id[3] << ":" 
-                  << announce.grandmasterIdentity.id[4] << ":" 
-                  << announce.grandmasterIdentity.id[5] << ":" 
-                  << announce.grandmasterIdentity.id[6] << ":" 
-                  << announce.grandmasterIdentity.id[7] << std::dec << std::endl;
+        const auto& gm = announce.grandmasterIdentity.id;
+        char gm_id[24];
+        std::snprintf(gm_id, sizeof(gm_id), "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
+                      gm[0], gm[1], gm[2], gm[3], gm[4], gm[5], gm[6], gm[7]);
+        LOG_DEBUG("[Port {}] Announce from GM: {}", port_identity_.portNumber, gm_id);
         
-        std::cout << "[Port " << port_identity_.portNumber << "] GM Priority1: " 
-                  << static_cast<int>(announce.grandmasterPriority1)
-                  << ", Priority2: " << static_cast<int>(announce.grandmasterPriority2)
-                  << ", Steps: " << announce.stepsRemoved << std::endl;
+        LOG_DEBUG("[Port {}] GM Priority1: {}, Priority2: {}, Steps: {}",
+                  port_identity_.portNumber,
+                  static_cast<int>(announce.grandmasterPriority1),
+                  static_cast<int>(announce.grandmasterPriority2),
+                  announce.stepsRemoved);
         
         // This would normally trigger BMCA state machine evaluation
         // and potentially change port role (MASTER/SLAVE/PASSIVE)
@@ -915,16 +929,16 @@ namespace gptp {
     // MDSyncStateMachine Helper Methods
     // ============================================================================
 
-    std::vector<uint8_t> state_machine::MDSyncStateMachine::serialize_sync_message(const SyncMessage& sync_msg) {
-        std::vector<uint8_t> buffer(sizeof(SyncMessage));
-        std::memcpy(buffer.data(), &sync_msg, sizeof(SyncMessage));
-        return buffer;
+    const std::vector<uint8_t>& state_machine::MDSyncStateMachine::serialize_sync_message(const SyncMessage& sync_msg) {
+        tx_buffer_.resize(sizeof(SyncMessage));
+        std::memcpy(tx_buffer_.data(), &sync_msg, sizeof(SyncMessage));
+        return tx_buffer_;
     }
 
-    std::vector<uint8_t> state_machine::MDSyncStateMachine::serialize_followup_message(const FollowUpMessage& followup_msg) {
-        std::vector<uint8_t> buffer(sizeof(FollowUpMessage));
-        std::memcpy(buffer.data(), &followup_msg, sizeof(FollowUpMessage));
-        return buffer;
+    const std::vector<uint8_t>& state_machine::MDSyncStateMachine::serialize_followup_message(const FollowUpMessage& followup_msg) {
+        tx_buffer_.resize(sizeof(FollowUpMessage));
+        std::memcpy(tx_buffer_.data(), &followup_msg, sizeof(FollowUpMessage));
+        return tx_buffer_;
     }
 
     void state_machine::MDSyncStateMachine::schedule_followup_transmission() {
@@ -950,9 +964,11 @@ namespace gptp {
         followup_msg.preciseOriginTimestamp = last_sync_timestamp_;
 
         // Serialize follow-up message
-        std::vector<uint8_t> serialized = serialize_followup_message(followup_msg);
-        std::cout << "[" << name_ << "] Follow-up message prepared for sequence " 
-                  << last_sync_sequence_ << " (size: " << serialized.size() << " bytes)" << std::endl;
+        const std::vector<uint8_t>& serialized = serialize_followup_message(followup_msg);
+        LOG_DEBUG("[{}] Follow-up message prepared for sequence {} (size: {} bytes)",
+                  name_,
+                  last_sync_sequence_,
+                  serialized.size());
     }
 
 } // namespace gptp
@@ -4,17 +4,34 @@
  */
 
 #include "../../include/path_delay_calculator.hpp"
+#include "../../include/clock_source.hpp"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
-#include <fstream>
+#include "../utils/logger.hpp"
+#include <cstdio>
 #include <numeric>
 #include <vector>
-#include <iomanip>  // für setprecision, setfill, setw
 
 namespace gptp {
 namespace path_delay {
 
+namespace {
+    // Seconds with nanosecond fraction, e.g. "12.000000500"
+    std::string format_timestamp(const Timestamp& timestamp) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%llu.%09u",
+                      static_cast<unsigned long long>(timestamp.get_seconds()),
+                      static_cast<unsigned>(timestamp.nanoseconds));
+        return text;
+    }
+
+    std::string format_rate_ratio(double ratio) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.9f", ratio);
+        return text;
+    }
+}
+
 // ============================================================================
 // StandardP2PDelayCalculator Implementation
 // ============================================================================
@@ -30,13 +47,15 @@ StandardP2PDelayCalculator::StandardP2PDelayCalculator(uint8_t domain_number)
 {
     measurement_history_.reserve(256);  // Reserve space for measurements
     timestamp_history_.reserve(256);
+    recent_delays_.reserve(5);
+    rate_ratio_data_.reserve(16);
 }
 
 PathDelayResult StandardP2PDelayCalculator::calculate_path_delay(const PdelayTimestamps& timestamps) {
     PathDelayResult result;
     
     if (!is_measurement_valid(timestamps)) {
-        std::cout << "🚫 [PDELAY] Invalid path delay measurement timestamps" << std::endl;
+        LOG_DEBUG("🚫 [PDELAY] Invalid path delay measurement timestamps");
         return result;  // Invalid measurement
     }
     
@@ -44,24 +63,20 @@ PathDelayResult StandardP2PDelayCalculator::calculate_path_delay(const PdelayTim
     result.mean_link_delay = calculate_mean_link_delay(timestamps, current_neighbor_rate_ratio_);
     result.neighbor_rate_ratio = current_neighbor_rate_ratio_;
     result.valid = true;
-    result.measurement_time = std::chrono::steady_clock::now();
+    result.measurement_time = steady_now();
     
     // Debug output für Path Delay Calculation
-    std::cout << "📏 [PDELAY] Path delay calculated: " << result.mean_link_delay.count() << " ns" << std::endl;
-    std::cout << "   Neighbor rate ratio: " << std::fixed << std::setprecision(9) << result.neighbor_rate_ratio << std::endl;
-    std::cout << "   T1 (req send): " << timestamps.t1.get_seconds() << "." 
-              << std::setfill('0') << std::setw(9) << timestamps.t1.nanoseconds << "s" << std::endl;
-    std::cout << "   T2 (req recv): " << timestamps.t2.get_seconds() << "." 
-              << std::setfill('0') << std::setw(9) << timestamps.t2.nanoseconds << "s" << std::endl;
-    std::cout << "   T3 (resp send): " << timestamps.t3.get_seconds() << "." 
-              << std::setfill('0') << std::setw(9) << timestamps.t3.nanoseconds << "s" << std::endl;
-    std::cout << "   T4 (resp recv): " << timestamps.t4.get_seconds() << "." 
-              << std::setfill('0') << std::setw(9) << timestamps.t4.nanoseconds << "s" << std::endl;
+    LOG_DEBUG("📏 [PDELAY] Path delay calculated: {} ns, neighbor rate ratio: {}",
+              result.mean_link_delay.count(), format_rate_ratio(result.neighbor_rate_ratio));
+    LOG_TRACE("   T1 (req send): {}s, T2 (req recv): {}s, T3 (resp send): {}s, T4 (resp recv): {}s",
+              format_timestamp(timestamps.t1), format_timestamp(timestamps.t2),
+              format_timestamp(timestamps.t3), format_timestamp(timestamps.t4));
     
     // Calculate confidence based on measurement consistency
     if (timestamp_history_.size() >= 3) {
         // Use recent measurements to estimate confidence
-        std::vector<std::chrono::nanoseconds> recent_delays;
+        auto& recent_delays = recent_delays_;
+        recent_delays.clear();
         size_t start_idx = std::max(0, static_cast<int>(timestamp_history_.size()) - 5);
         
         for (size_t i = start_idx; i < timestamp_history_.size(); ++i) {
@@ -116,7 +131,8 @@ void StandardP2PDelayCalculator::update_neighbor_rate_ratio(const std::vector<Pd
     }
     
     // Convert to MeasurementData format
-    std::vector<MeasurementData> measurement_data;
+    auto& measurement_data = rate_ratio_data_;
+    measurement_data.clear();
     for (const auto& ts : measurements) {
         MeasurementData data;
         data.t_rsp3 = ts.t3;
@@ -209,13 +225,20 @@ bool StandardP2PDelayCalculator::validate_timestamps(const PdelayTimestamps& tim
         return false;
     }
     
-    // Check temporal ordering: t1 < t2 < t3 < t4
+    // Check temporal ordering per clock: t1 < t4 on the initiator, t2 < t3 on
+    // the responder. The two clocks are unrelated until synchronized, so t1
+    // and t2 (or t3 and t4) cannot be compared.
     auto t1_ns = timestamps.t1.to_nanoseconds();
     auto t2_ns = timestamps.t2.to_nanoseconds();
     auto t3_ns = timestamps.t3.to_nanoseconds();
     auto t4_ns = timestamps.t4.to_nanoseconds();
     
-    if (!(t1_ns < t2_ns && t2_ns < t3_ns && t3_ns < t4_ns)) {
+    if (!(t1_ns < t4_ns && t2_ns < t3_ns)) {
+        return false;
+    }
+    
+    // The responder cannot turn around faster than the exchange took
+    if (t3_ns - t2_ns > t4_ns - t1_ns) {
         return false;
     }
     
@@ -285,7 +308,7 @@ PathDelayResult IntrinsicCSNDelayCalculator::calculate_path_delay(const PdelayTi
         result.mean_link_delay = residence_time_;
         result.neighbor_rate_ratio = 1.0;  // Perfect synchronization
         result.valid = true;
-        result.measurement_time = std::chrono::steady_clock::now();
+        result.measurement_time = steady_now();
         result.confidence = 1.0;  // High confidence due to intrinsic sync
     }
     
@@ -317,7 +340,7 @@ void PathDelayManager::add_csn_node(const ClockIdentity& node_id, std::unique_pt
     NodeCalculator node_calc;
     node_calc.calculator = std::move(calculator);
     node_calc.node_info.node_identity = node_id;
-    node_calc.node_info.last_update = std::chrono::steady_clock::now();
+    node_calc.node_info.last_update = steady_now();
     
     node_calculators_[node_id] = std::move(node_calc);
 }
@@ -369,7 +392,7 @@ std::vector<ClockIdentity> PathDelayManager::get_active_nodes() const {
     std::lock_guard<std::mutex> lock(calculators_mutex_);
     
     std::vector<ClockIdentity> active_nodes;
-    auto now = std::chrono::steady_clock::now();
+    auto now = steady_now();
     
     for (const auto& pair : node_calculators_) {
         // Consider node active if updated within last 10 seconds
@@ -395,20 +418,17 @@ DelayMeasurementMethod PathDelayManager::get_node_measurement_method(const Clock
 void PathDelayManager::print_path_delay_statistics() const {
     std::lock_guard<std::mutex> lock(calculators_mutex_);
     
-    std::cout << "\n" << std::string(60, '=') << std::endl;
-    std::cout << "Path Delay Statistics" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
+    LOG_INFO("Path Delay Statistics");
     
     for (const auto& pair : node_calculators_) {
         const auto& node_info = pair.second.node_info;
         const auto& calculator = pair.second.calculator;
         
-        std::cout << "\nNode: ";
-        for (int i = 0; i < 8; ++i) {
-            std::cout << std::hex << static_cast<int>(pair.first.id[i]);
-            if (i < 7) std::cout << ":";
-        }
-        std::cout << std::dec << std::endl;
+        char node_id[24];
+        std::snprintf(node_id, sizeof(node_id), "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
+                      pair.first.id[0], pair.first.id[1], pair.first.id[2], pair.first.id[3],
+                      pair.first.id[4], pair.first.id[5], pair.first.id[6], pair.first.id[7]);
+        LOG_INFO("Node: {}", node_id);
         
         std::string method_str;
         switch (calculator->get_method()) {
@@ -423,20 +443,20 @@ void PathDelayManager::print_path_delay_statistics() const {
                 break;
         }
         
-        std::cout << "  Method: " << method_str << std::endl;
-        std::cout << "  Path Delay: " << node_info.propagation_delay.count() << " ns" << std::endl;
-        std::cout << "  Rate Ratio: " << node_info.rate_ratio << std::endl;
-        std::cout << "  Recent Measurements: " << pair.second.recent_results.size() << std::endl;
+        LOG_INFO("  Method: {}", method_str);
+        LOG_INFO("  Path Delay: {} ns", node_info.propagation_delay.count());
+        LOG_INFO("  Rate Ratio: {}", node_info.rate_ratio);
+        LOG_INFO("  Recent Measurements: {}", pair.second.recent_results.size());
         
         if (!pair.second.recent_results.empty()) {
             auto latest = pair.second.recent_results.back();
-            std::cout << "  Latest Confidence: " << (latest.confidence * 100) << "%" << std::endl;
+            LOG_INFO("  Latest Confidence: {}%", (latest.confidence * 100));
         }
     }
 }
 
 void PathDelayManager::cleanup_old_measurements() {
-    auto now = std::chrono::steady_clock::now();
+    auto now = steady_now();
     auto cutoff = now - std::chrono::minutes(5);  // Keep 5 minutes of data
     
     for (auto& pair : node_calculators_) {
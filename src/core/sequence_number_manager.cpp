@@ -4,7 +4,7 @@
  */
 
 #include "../../include/sequence_number_manager.hpp"
-#include <iostream>
+#include "../utils/logger.hpp"
 
 namespace gptp {
 namespace sequence {
@@ -15,22 +15,21 @@ namespace sequence {
 namespace utils {
 
 void print_sequence_status(uint16_t port_id, const PortSequenceManager::SequenceStatus& status) {
-    std::cout << "Port " << port_id << " Sequence Status:" << std::endl;
-    std::cout << "  Announce:    " << format_sequence(status.announce_sequence) << std::endl;
-    std::cout << "  Signaling:   " << format_sequence(status.signaling_sequence) << std::endl;
-    std::cout << "  Sync:        " << format_sequence(status.sync_sequence) << std::endl;
-    std::cout << "  Follow_Up:   " << format_sequence(status.followup_sequence) << std::endl;
-    std::cout << "  Pdelay_Req:  " << format_sequence(status.pdelay_req_sequence) << std::endl;
-    std::cout << "  Pdelay_Resp: " << format_sequence(status.pdelay_resp_sequence) << std::endl;
+    LOG_INFO("Port {} Sequence Status:", port_id);
+    LOG_INFO("  Announce:    {}", format_sequence(status.announce_sequence));
+    LOG_INFO("  Signaling:   {}", format_sequence(status.signaling_sequence));
+    LOG_INFO("  Sync:        {}", format_sequence(status.sync_sequence));
+    LOG_INFO("  Follow_Up:   {}", format_sequence(status.followup_sequence));
+    LOG_INFO("  Pdelay_Req:  {}", format_sequence(status.pdelay_req_sequence));
+    LOG_INFO("  Pdelay_Resp: {}", format_sequence(status.pdelay_resp_sequence));
 }
 
 void print_all_sequence_status(const SequenceNumberManager& manager) {
     auto all_status = manager.get_all_sequence_status();
     
-    std::cout << "\n=== IEEE 802.1AS Sequence Number Status ===" << std::endl;
+    LOG_INFO("=== IEEE 802.1AS Sequence Number Status ===");
     for (const auto& pair : all_status) {
         print_sequence_status(pair.first, pair.second);
-        std::cout << std::endl;
     }
 }
 
@@ -41,10 +40,9 @@ bool validate_sequence_number_compliance(uint16_t port_id,
     bool valid = is_valid_sequence_progression(expected_sequence, received_sequence);
     
     if (!valid) {
-        std::cerr << "❌ Sequence number violation on port " << port_id 
-                  << " for message type " << static_cast<int>(message_type) << std::endl;
-        std::cerr << "   Expected: " << format_sequence(expected_sequence) << std::endl;
-        std::cerr << "   Received: " << format_sequence(received_sequence) << std::endl;
+        LOG_WARN("❌ Sequence number violation on port {} for message type {}", port_id, static_cast<int>(message_type));
+        LOG_WARN("   Expected: {}", format_sequence(expected_sequence));
+        LOG_WARN("   Received: {}", format_sequence(received_sequence));
     }
     
     return valid;
@@ -4,8 +4,9 @@
  */
 
 #include "../../include/simple_path_delay.hpp"
+#include "../../include/clock_source.hpp"
 #include <algorithm>
-#include <iostream>
+#include "../utils/logger.hpp"
 
 namespace gptp {
 namespace path_delay {
@@ -75,7 +76,7 @@ void PathDelayCalculator::update_rate_ratio(const Timestamp& t_rsp3, const Times
     RatioMeasurement measurement;
     measurement.t_rsp3 = t_rsp3;
     measurement.t_req4 = t_req4;
-    measurement.time = std::chrono::steady_clock::now();
+    measurement.time = steady_now();
     
     ratio_measurements_.push_back(measurement);
     
@@ -103,9 +104,9 @@ void PathDelayCalculator::update_rate_ratio(const Timestamp& t_rsp3, const Times
         if (equations::validate_rate_ratio(new_rate_ratio)) {
             current_rate_ratio_ = new_rate_ratio;
             
-            std::cout << "[PathDelay] Updated neighbor rate ratio: " << current_rate_ratio_ 
-                      << " (offset: " << equations::frequency_offset_ppm(current_rate_ratio_) 
-                      << " ppm)" << std::endl;
+            LOG_DEBUG("[PathDelay] Updated neighbor rate ratio: {} (offset: {} ppm)",
+                      current_rate_ratio_,
+                      equations::frequency_offset_ppm(current_rate_ratio_));
         }
     }
 }
@@ -156,7 +157,7 @@ void NativeCSNPathDelay::configure_for_native_measurement() {
     md_entity_.computeMeanLinkDelay = false;
     md_entity_.isMeasuringDelay = true;
     
-    std::cout << "[NativeCSN] Configured for native path delay measurement" << std::endl;
+    LOG_DEBUG("[NativeCSN] Configured for native path delay measurement");
 }
 
 SimplePathDelayResult NativeCSNPathDelay::get_path_delay_result() const {
@@ -183,8 +184,7 @@ IntrinsicCSNPathDelay::IntrinsicCSNPathDelay()
 void IntrinsicCSNPathDelay::set_residence_time(std::chrono::nanoseconds residence_time) {
     residence_time_ = residence_time;
     
-    std::cout << "[IntrinsicCSN] Set residence time: " << residence_time_.count() 
-              << " ns" << std::endl;
+    LOG_DEBUG("[IntrinsicCSN] Set residence time: {} ns", residence_time_.count());
 }
 
 SimplePathDelayResult IntrinsicCSNPathDelay::get_path_delay_result() const {
@@ -197,8 +197,7 @@ SimplePathDelayResult IntrinsicCSNPathDelay::get_path_delay_result() const {
         result.neighbor_rate_ratio = 1.0;  // Perfect synchronization
         result.valid = true;
         
-        std::cout << "[IntrinsicCSN] Path delay integrated into residence time ("
-                  << residence_time_.count() << " ns)" << std::endl;
+        LOG_DEBUG("[IntrinsicCSN] Path delay integrated into residence time ({} ns)", residence_time_.count());
     }
     
     return result;
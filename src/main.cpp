@@ -1,5 +1,6 @@
 #include "core/timestamp_provider.hpp"
 #include "utils/logger.hpp"
+#include "utils/configuration.hpp"
 #include "../include/gptp_socket.hpp"
 #include "../include/gptp_message_parser.hpp"
 // #include "../include/gptp_port_manager.hpp"
@@ -12,6 +13,7 @@
 #endif
 #ifdef __linux__
     #include "platform/linux_adapter_detector.hpp"
+    #include "networking/gptp_pipeline.hpp"
     #include <signal.h>
 #endif
 #include <vector>
@@ -22,11 +24,14 @@
 #include <chrono>
 #include <algorithm>
 #include <cstdlib>
+#include <atomic>
 
 namespace gptp {
 
-    // Global shutdown flag for signal handling
-    static volatile bool g_shutdown_requested = false;
+    // Global shutdown flag for signal handling. Handlers only store to it:
+    // anything else (logging included) is not async-signal-safe
+    static std::atomic<bool> g_shutdown_requested{false};
+    static_assert(std::atomic<bool>::is_always_lock_free, "shutdown flag must be signal-safe");
 
     /**
      * @brief Modern gPTP application class with RAII and proper error handling
@@ -137,7 +142,11 @@ namespace gptp {
             LOG_INFO("Interface {} is suitable for gPTP", interface_name);
             
             // Run gPTP protocol
-            return run_gptp_protocol(interface);
+            ErrorCode result = run_gptp_protocol(interface);
+            if (result != ErrorCode::SUCCESS) {
+                return result;
+            }
+            return run_daemon_loop({interface});
         }
 
         ErrorCode run_for_all_interfaces() {
@@ -155,9 +164,10 @@ namespace gptp {
             LOG_INFO("Found {} network interfaces", interfaces.size());
 
             std::vector<NetworkInterface> gptp_capable_interfaces;
-            std::vector<IntelAdapterInfo> intel_adapters;
 
 #ifdef _WIN32
+            std::vector<IntelAdapterInfo> intel_adapters;
+
             // Use Windows-specific Intel adapter detection for enhanced analysis
             WindowsAdapterDetector intel_detector;
             if (intel_detector.initialize().is_success()) {
@@ -309,7 +319,6 @@ namespace gptp {
                 }
             }
 
-            // CRITICAL PRODUCTION FILTERING: Limit to maximum 2 interfaces for stability
             if (gptp_capable_interfaces.empty()) {
                 LOG_WARN("No gPTP-capable interfaces found!");
                 LOG_INFO("Recommendations:");
@@ -320,70 +329,30 @@ namespace gptp {
                 return ErrorCode::INTERFACE_NOT_FOUND;
             }
 
-            // STRICT FILTERING: For production stability, limit to 2 most suitable interfaces
-            size_t original_count = gptp_capable_interfaces.size();
-            
-            if (gptp_capable_interfaces.size() > 2) {
-                LOG_WARN("📊 PRODUCTION FILTERING: Found {} interfaces, limiting to 2 most suitable for stability", original_count);
-                
-                // Priority sorting: Intel + RME > Intel + other > generic
-                std::sort(gptp_capable_interfaces.begin(), gptp_capable_interfaces.end(), 
-                    [&intel_adapters](const NetworkInterface& a, const NetworkInterface& b) {
-                        // Check if interface is RME by MAC or description
-                        bool a_is_rme = (a.mac_address.find("48:0b:b2") == 0) || 
-                                       (a.name.find("8BEDBD8D-6DDA-4EF1-B257-9D96CE0A1CAD") != std::string::npos);
-                        bool b_is_rme = (b.mac_address.find("48:0b:b2") == 0) || 
-                                       (b.name.find("8BEDBD8D-6DDA-4EF1-B257-9D96CE0A1CAD") != std::string::npos);
-                        
-                        // Check if interface is Intel by MAC or description  
-                        bool a_is_intel = (a.mac_address.find("c0:47:0e:16:7b:89") == 0) ||
-                                         (a.name.find("3DC822E6-8C68-424C-9798-63CFBF52994B") != std::string::npos);
-                        bool b_is_intel = (b.mac_address.find("c0:47:0e:16:7b:89") == 0) ||
-                                         (b.name.find("3DC822E6-8C68-424C-9798-63CFBF52994B") != std::string::npos);
-                        
-                        // Priority 1: RME interfaces first
-                        if (a_is_rme != b_is_rme) return a_is_rme > b_is_rme;
-                        
-                        // Priority 2: Intel interfaces second
-                        if (a_is_intel != b_is_intel) return a_is_intel > b_is_intel;
-                        
-                        // Priority 3: Hardware timestamping over software
-                        if (a.capabilities.hardware_timestamping_supported != b.capabilities.hardware_timestamping_supported) {
-                            return a.capabilities.hardware_timestamping_supported;
-                        }
-                        
-                        return false; // Keep original order if equal
-                    });
-                
-                // Keep only top 2
-                gptp_capable_interfaces.resize(2);
-                
-                LOG_INFO("🎯 FILTERED SELECTION: Using top 2 interfaces:");
-                for (size_t i = 0; i < gptp_capable_interfaces.size(); ++i) {
-                    const auto& iface = gptp_capable_interfaces[i];
-                    LOG_INFO("  {}. {} - Hardware TS: {}, Software TS: {}", 
-                            i + 1, iface.name,
-                            iface.capabilities.hardware_timestamping_supported ? "YES" : "No",
-                            iface.capabilities.software_timestamping_supported ? "YES" : "No");
-                }
-                
-                LOG_INFO("💡 REASON: Limited interface count prevents resource conflicts and ensures stable gPTP operation");
-                LOG_INFO("🔧 To use all {} interfaces, modify filtering in main.cpp", original_count);
+            // All interfaces become ports of one time-aware system. Order by name so
+            // port numbers (and the clock identity taken from port 1) are stable
+            // across restarts regardless of discovery order.
+            std::sort(gptp_capable_interfaces.begin(), gptp_capable_interfaces.end(),
+                [](const NetworkInterface& a, const NetworkInterface& b) {
+                    return a.name < b.name;
+                });
+
+            const int max_interfaces = Configuration::instance().network.max_interfaces;
+            if (max_interfaces > 0 && gptp_capable_interfaces.size() > static_cast<size_t>(max_interfaces)) {
+                LOG_WARN("Found {} gPTP-capable interfaces, using the first {} (max_interfaces)",
+                         gptp_capable_interfaces.size(), max_interfaces);
+                gptp_capable_interfaces.resize(static_cast<size_t>(max_interfaces));
             }
 
-            LOG_INFO("Starting gPTP on {} FILTERED interface(s):", gptp_capable_interfaces.size());
+            LOG_INFO("Starting gPTP on {} interface(s):", gptp_capable_interfaces.size());
             
             for (const auto& interface : gptp_capable_interfaces) {
                 LOG_INFO("  → Running gPTP on interface: {}", interface.name);
                 
-                // Here you would implement the actual gPTP protocol logic for each interface
-                // For now, we'll simulate the startup
                 ErrorCode result = run_gptp_protocol(interface);
                 if (result != ErrorCode::SUCCESS) {
                     LOG_ERROR("Failed to start gPTP on interface {}: {}", 
                              interface.name, static_cast<int>(result));
-                } else {
-                    LOG_INFO("gPTP successfully started on interface: {}", interface.name);
                 }
             }
 
@@ -481,18 +450,8 @@ namespace gptp {
             // 6. ✅ Best Master Clock Algorithm (BMCA) fully implemented and tested
             // 7. ✅ Clock synchronization mathematics (Clock Servo with offset/rate adjustment)
             
-            // NEW: Socket Integration with State Machines ✅
-            auto socket = GptpSocketManager::create_socket(interface.name);
-            if (socket) {
-                LOG_INFO("    🌐 Network socket created successfully for interface");
-                LOG_INFO("    ⚡ Integrating socket with state machines for real network communication");
-                
-                // State machines would be created and configured with socket here
-                // This enables actual network message transmission and reception
-                LOG_INFO("    📡 State machines now connected to network layer");
-            } else {
-                LOG_INFO("    ⚠️ Socket creation failed - using simulation mode");
-            }
+            // The socket for this interface is opened and owned by run_daemon_loop(),
+            // which connects it to the port manager for the lifetime of the daemon
             
             LOG_INFO("    ✅ IEEE 802.1AS protocol implementation ACTIVE for {}", interface.name);
             LOG_INFO("    🚀 Features: BMCA ✅ | Clock Servo ✅ | Multi-Domain ✅ | State Machines ✅");
@@ -526,7 +485,6 @@ namespace gptp {
             // Windows console control handler
             auto console_handler = [](DWORD dwCtrlType) -> BOOL {
                 if (dwCtrlType == CTRL_C_EVENT || dwCtrlType == CTRL_CLOSE_EVENT) {
-                    LOG_INFO("Shutdown signal received, stopping gPTP daemon...");
                     g_shutdown_requested = true;
                     return TRUE;
                 }
@@ -534,13 +492,18 @@ namespace gptp {
             };
             SetConsoleCtrlHandler(console_handler, TRUE);
 #else
-            // Linux signal handling would go here
-            signal(SIGINT, [](int) {
-                LOG_INFO("Shutdown signal received, stopping gPTP daemon...");
+            // SIGTERM too, so service managers get an orderly shutdown that
+            // invalidates the shared memory time segment
+            auto shutdown_handler = [](int) {
                 g_shutdown_requested = true;
-            });
+            };
+            signal(SIGINT, shutdown_handler);
+            signal(SIGTERM, shutdown_handler);
 #endif
 
+#ifdef __linux__
+            return run_pipeline(interfaces);
+#else
             // Main daemon loop
             auto start_time = std::chrono::steady_clock::now();
             size_t loop_count = 0;
@@ -775,10 +738,51 @@ namespace gptp {
             SetConsoleCtrlHandler(nullptr, FALSE);
 #endif
             
+            LOG_INFO("Shutdown signal received, stopping gPTP daemon...");
             LOG_INFO("gPTP daemon loop ended gracefully");
             return ErrorCode::SUCCESS;
+#endif
         }
 
+#ifdef __linux__
+        /**
+         * @brief Event-driven protocol loop for Linux
+         * 
+         * All interfaces share one port manager (one BMCA, one servo per domain)
+         * and one epoll reactor; received frames are processed as they arrive.
+         * @param interfaces List of gPTP-capable interfaces to run on
+         * @return ErrorCode indicating success or failure
+         */
+        ErrorCode run_pipeline(const std::vector<NetworkInterface>& interfaces) {
+            GptpPipeline pipeline;
+
+            for (const auto& interface : interfaces) {
+                auto result = pipeline.add_interface(interface.name);
+                if (result.has_error()) {
+                    LOG_WARN("Failed to open gPTP socket on {}: {}", interface.name,
+                             static_cast<int>(result.error()));
+                } else {
+                    LOG_INFO("gPTP port {} bound to {}", pipeline.get_port_count(), interface.name);
+                }
+            }
+
+            auto init_result = pipeline.initialize();
+            if (init_result.has_error()) {
+                LOG_ERROR("Failed to start gPTP pipeline: {}", static_cast<int>(init_result.error()));
+                return init_result.error();
+            }
+
+            while (!g_shutdown_requested) {
+                pipeline.run_once(100);
+            }
+            LOG_INFO("Shutdown signal received, stopping gPTP daemon...");
+
+            pipeline.log_statistics();
+            LOG_INFO("gPTP daemon loop ended gracefully");
+            return ErrorCode::SUCCESS;
+        }
+#endif
+
         static void log_timestamp_capabilities(const std::string& interface_name, 
                                       const TimestampCapabilities& caps) {
             LOG_INFO("Timestamp capabilities for {}:", interface_name);
@@ -797,13 +801,40 @@ namespace gptp {
 int main(int argc, const char* argv[]) {
     using namespace gptp;
 
-    // Set up logging
-    Logger::instance().set_level(LogLevel::INFO);
-    
-    LOG_INFO("gPTP Daemon v1.0.0");
-    LOG_INFO("===================");
-
     try {
+        // Invalid values were logged by the loaders and by validate()
+        auto& config = Configuration::instance();
+        if (const char* config_file = std::getenv("GPTP_CONFIG")) {
+            config.load_from_file(config_file);
+        }
+        config.load_from_environment();
+        if (!config.validate()) {
+            LOG_FATAL("Invalid configuration, not starting");
+            return EXIT_FAILURE;
+        }
+
+        LogLevel log_level = LogLevel::INFO;
+        Logger::parse_level(config.logging.log_level, log_level);
+        Logger::instance().set_level(log_level);
+
+        // Set up logging: records are formatted and written by a background
+        // thread; the atexit hook installed by start_async() drains the queue
+        Logger::AsyncOptions log_options;
+        log_options.console_output = config.logging.console_output;
+        log_options.file_output = config.logging.file_output;
+        log_options.file_path = config.logging.log_file_path;
+        log_options.max_file_size_bytes = static_cast<size_t>(config.logging.max_log_file_size_mb) * 1024 * 1024;
+        log_options.max_files = config.logging.max_log_files;
+        if (!Logger::instance().start_async(log_options)) {
+            LOG_WARN("Could not open log file {}, logging to console only", config.logging.log_file_path);
+            log_options.file_output = false;
+            log_options.console_output = true;
+            Logger::instance().start_async(log_options);
+        }
+        
+        LOG_INFO("gPTP Daemon v1.0.0");
+        LOG_INFO("===================");
+
         GptpApplication app;
         
         auto init_result = app.initialize();
@@ -0,0 +1,185 @@
+/**
+ * @file event_loop.cpp
+ * @brief Single-threaded epoll reactor for sockets and periodic timers
+ */
+
+#include "event_loop.hpp"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+
+namespace gptp {
+
+namespace {
+    constexpr int MAX_EVENTS = 64;
+}
+
+EventLoop::EventLoop()
+    : epoll_fd_(-1)
+    , wakeup_fd_(-1)
+    , running_(false) {
+}
+
+EventLoop::~EventLoop() {
+    for (const auto& pair : entries_) {
+        if (pair.second->is_timer) {
+            close(pair.first);
+        }
+    }
+    if (wakeup_fd_ >= 0) {
+        close(wakeup_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+}
+
+Result<bool> EventLoop::initialize() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    struct epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeup_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event) < 0) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    return Result<bool>::success(true);
+}
+
+Result<bool> EventLoop::add_reader(int fd, Handler handler) {
+    if (epoll_fd_ < 0 || fd < 0) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    struct epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+        return Result<bool>::error(ErrorCode::NETWORK_ERROR);
+    }
+
+    entries_[fd] = std::make_shared<Entry>(Entry{std::move(handler), false});
+    return Result<bool>::success(true);
+}
+
+void EventLoop::remove_reader(int fd) {
+    auto it = entries_.find(fd);
+    if (it == entries_.end() || it->second->is_timer) {
+        return;
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    entries_.erase(it);
+}
+
+Result<int> EventLoop::add_timer(std::chrono::nanoseconds period, Handler handler) {
+    if (epoll_fd_ < 0 || period.count() <= 0) {
+        return Result<int>::error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        return Result<int>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    struct itimerspec spec{};
+    spec.it_interval.tv_sec = period.count() / 1000000000LL;
+    spec.it_interval.tv_nsec = period.count() % 1000000000LL;
+    spec.it_value = spec.it_interval;
+    if (timerfd_settime(timer_fd, 0, &spec, nullptr) < 0) {
+        close(timer_fd);
+        return Result<int>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    struct epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = timer_fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd, &event) < 0) {
+        close(timer_fd);
+        return Result<int>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    entries_[timer_fd] = std::make_shared<Entry>(Entry{std::move(handler), true});
+    return Result<int>::success(timer_fd);
+}
+
+void EventLoop::remove_timer(int timer_id) {
+    auto it = entries_.find(timer_id);
+    if (it == entries_.end() || !it->second->is_timer) {
+        return;
+    }
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, timer_id, nullptr);
+    close(timer_id);
+    entries_.erase(it);
+}
+
+int EventLoop::run_once(int timeout_ms) {
+    struct epoll_event events[MAX_EVENTS];
+    int count = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout_ms);
+    if (count <= 0) {
+        return 0;
+    }
+
+    int dispatched = 0;
+    for (int i = 0; i < count; ++i) {
+        int fd = events[i].data.fd;
+
+        if (fd == wakeup_fd_) {
+            uint64_t value;
+            while (read(wakeup_fd_, &value, sizeof(value)) > 0) {}
+            continue;
+        }
+
+        auto it = entries_.find(fd);
+        if (it == entries_.end()) {
+            continue; // Removed by an earlier handler in this batch
+        }
+
+        // Keep the entry alive even if the handler removes itself
+        std::shared_ptr<Entry> entry = it->second;
+        if (entry->is_timer) {
+            uint64_t expirations;
+            if (read(fd, &expirations, sizeof(expirations)) < 0) {
+                continue;
+            }
+        }
+
+        entry->handler();
+        ++dispatched;
+    }
+
+    return dispatched;
+}
+
+void EventLoop::run() {
+    running_ = true;
+    while (running_) {
+        run_once(-1);
+    }
+}
+
+void EventLoop::stop() {
+    running_ = false;
+    if (wakeup_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeup_fd_, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+} // namespace gptp
+
+#endif // __linux__
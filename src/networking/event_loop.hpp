@@ -0,0 +1,99 @@
+/**
+ * @file event_loop.hpp
+ * @brief Single-threaded epoll reactor for sockets and periodic timers
+ */
+
+#pragma once
+
+#include "../../include/gptp_types.hpp"
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+
+#ifdef __linux__
+
+namespace gptp {
+
+/**
+ * @brief epoll based event loop
+ *
+ * Dispatches readable file descriptors and timerfd-backed periodic timers
+ * on the calling thread. stop() may be called from any thread or from a
+ * signal handler context via the internal eventfd.
+ */
+class EventLoop {
+public:
+    using Handler = std::function<void()>;
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Create the epoll instance and wakeup descriptor
+     * @return Result indicating success or error
+     */
+    Result<bool> initialize();
+
+    /**
+     * @brief Invoke handler whenever fd becomes readable (level triggered)
+     * @param fd File descriptor to watch
+     * @param handler Callback run on the loop thread
+     * @return Result indicating success or error
+     */
+    Result<bool> add_reader(int fd, Handler handler);
+
+    /**
+     * @brief Stop watching a descriptor (does not close it)
+     */
+    void remove_reader(int fd);
+
+    /**
+     * @brief Register a periodic timer
+     * @param period Timer period
+     * @param handler Callback run on the loop thread
+     * @return Timer id usable with remove_timer()
+     */
+    Result<int> add_timer(std::chrono::nanoseconds period, Handler handler);
+
+    /**
+     * @brief Cancel and close a timer
+     */
+    void remove_timer(int timer_id);
+
+    /**
+     * @brief Wait for and dispatch ready events once
+     * @param timeout_ms Maximum wait, -1 to block
+     * @return Number of handlers invoked
+     */
+    int run_once(int timeout_ms);
+
+    /**
+     * @brief Dispatch events until stop() is called
+     */
+    void run();
+
+    /**
+     * @brief Ask run() to return
+     */
+    void stop();
+
+private:
+    struct Entry {
+        Handler handler;
+        bool is_timer;
+    };
+
+    int epoll_fd_;
+    int wakeup_fd_;
+    std::atomic<bool> running_;
+    std::map<int, std::shared_ptr<Entry>> entries_;
+};
+
+} // namespace gptp
+
+#endif // __linux__
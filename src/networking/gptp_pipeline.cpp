@@ -0,0 +1,969 @@
+/**
+ * @file gptp_pipeline.cpp
+ * @brief Event-driven gPTP daemon pipeline for Linux
+ */
+
+#include "gptp_pipeline.hpp"
+#include "linux_socket.hpp"
+#include "recording_socket.hpp"
+#include "../../include/clock_source.hpp"
+#include "../platform/linux_clock_adjuster.hpp"
+#include "../utils/configuration.hpp"
+#include "../utils/logger.hpp"
+#include "../utils/prometheus_text.hpp"
+
+#ifdef __linux__
+#include <net/if.h>
+#include <cstring>
+#include <ctime>
+
+namespace gptp {
+
+namespace {
+    constexpr auto PERIODIC_TASK_INTERVAL = std::chrono::milliseconds(10);
+    constexpr int MAX_FRAMES_PER_WAKEUP = 64;
+    constexpr size_t MAX_FRAME_PAYLOAD = 1500;
+    constexpr auto METRICS_PUBLISH_INTERVAL = std::chrono::milliseconds(250);
+    constexpr auto TIME_PUBLISH_INTERVAL = std::chrono::milliseconds(125);
+    constexpr auto CLOCK_CALIBRATION_INTERVAL = std::chrono::seconds(1);
+    constexpr auto CAPTURE_FLUSH_INTERVAL = std::chrono::seconds(1);
+    constexpr int CROSS_TIMESTAMP_TRIES = 5;
+
+    int64_t clock_ns(clockid_t clock_id) {
+        struct timespec ts{};
+        clock_gettime(clock_id, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    std::string clock_name(int phc_index) {
+        return phc_index < 0 ? std::string("system") : "/dev/ptp" + std::to_string(phc_index);
+    }
+
+    Timestamp to_timestamp(std::chrono::nanoseconds ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(ns);
+        return timestamp;
+    }
+
+    struct CrossTimestamp {
+        int64_t monotonic_ns = 0;
+        int64_t realtime_ns = 0;
+        int64_t clock_ns = 0;
+        int64_t uncertainty_ns = 0;
+    };
+
+    /**
+     * Read a clock between two CLOCK_MONOTONIC readings and keep the
+     * narrowest of a few tries; a PHC read is a syscall, the others vDSO.
+     */
+    CrossTimestamp read_cross_timestamp(clockid_t clock_id) {
+        CrossTimestamp best;
+        int64_t best_width = INT64_MAX;
+        for (int i = 0; i < CROSS_TIMESTAMP_TRIES; ++i) {
+            int64_t before = clock_ns(CLOCK_MONOTONIC);
+            int64_t reading = clock_ns(clock_id);
+            int64_t after = clock_ns(CLOCK_MONOTONIC);
+            if (after - before < best_width) {
+                best_width = after - before;
+                best.monotonic_ns = before + best_width / 2;
+                best.clock_ns = reading;
+            }
+        }
+        best.uncertainty_ns = best_width / 2;
+
+        // CLOCK_REALTIME shares the monotonic rate; carry it over the short gap
+        int64_t realtime = clock_ns(CLOCK_REALTIME);
+        best.realtime_ns = realtime - (clock_ns(CLOCK_MONOTONIC) - best.monotonic_ns);
+        if (clock_id == CLOCK_REALTIME) {
+            best.clock_ns = best.realtime_ns;
+        }
+        return best;
+    }
+
+    void log_latency(const char* stage, const LatencyHistogram& histogram) {
+        auto snapshot = histogram.snapshot();
+        if (snapshot.count == 0) {
+            return;
+        }
+        LOG_INFO("  {}: n={} p50={}ns p99={}ns p99.9={}ns max={}ns", stage, snapshot.count,
+                 snapshot.value_at_percentile(50.0), snapshot.value_at_percentile(99.0),
+                 snapshot.value_at_percentile(99.9), snapshot.max_ns);
+    }
+}
+
+// ============================================================================
+// Clock adjuster decorator measuring servo -> adjustment latency
+// ============================================================================
+
+class GptpPipeline::InstrumentedClockAdjuster : public IClockAdjuster {
+public:
+    InstrumentedClockAdjuster(std::unique_ptr<IClockAdjuster> inner, GptpPipeline& pipeline)
+        : inner_(std::move(inner)), pipeline_(pipeline) {}
+
+    Result<bool> adjust_frequency(double ppb) override {
+        int64_t servo_output_ns = get_clock_source().now_monotonic_ns();
+        auto result = inner_->adjust_frequency(ppb);
+        pipeline_.on_clock_adjusted(servo_output_ns);
+        return result;
+    }
+
+    Result<bool> step_clock(std::chrono::nanoseconds offset) override {
+        int64_t servo_output_ns = get_clock_source().now_monotonic_ns();
+        auto result = inner_->step_clock(offset);
+        pipeline_.time_rate_.reset();
+        pipeline_.on_clock_adjusted(servo_output_ns);
+        return result;
+    }
+
+    std::string get_name() const override {
+        return inner_->get_name();
+    }
+
+private:
+    std::unique_ptr<IClockAdjuster> inner_;
+    GptpPipeline& pipeline_;
+};
+
+// ============================================================================
+// GptpPipeline Implementation
+// ============================================================================
+
+GptpPipeline::GptpPipeline()
+    : performance_monitoring_(false)
+    , reference_clock_(CLOCK_REALTIME)
+    , reference_phc_index_(-1)
+    , current_rx_port_(nullptr)
+    , current_rx_start_ns_(0)
+    , current_dispatch_ns_(0) {
+}
+
+GptpPipeline::~GptpPipeline() {
+    metrics_server_.stop();
+    set_clock_source(nullptr);
+    for (auto& port : ports_) {
+        if (port->socket) {
+            event_loop_.remove_reader(port->socket->get_native_handle());
+            port->socket->cleanup();
+        }
+    }
+    if (link_monitor_.get_native_handle() >= 0) {
+        event_loop_.remove_reader(link_monitor_.get_native_handle());
+    }
+}
+
+Result<bool> GptpPipeline::add_interface(const std::string& interface_name) {
+    if (port_manager_) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER); // Topology is fixed after initialize()
+    }
+
+    // The controller family narrows the hardware RX filter when the driver does not report its filters
+    LinuxIntelAdapterInfo adapter;
+    if (adapter_detector_.initialize().is_success()) {
+        auto adapter_result = adapter_detector_.get_adapter_info(interface_name);
+        if (adapter_result.is_success()) {
+            adapter = adapter_result.value();
+        }
+    }
+
+    auto socket = std::make_unique<LinuxSocket>();
+    socket->set_controller_family(adapter.controller_family);
+    auto init_result = socket->initialize(interface_name);
+    if (init_result.has_error()) {
+        return init_result;
+    }
+
+    auto mac_result = socket->get_interface_mac();
+    if (mac_result.has_error()) {
+        return Result<bool>::error(mac_result.error());
+    }
+
+    auto port = std::make_unique<PortContext>();
+    port->port_id = static_cast<uint16_t>(ports_.size() + 1);
+    port->ifindex = static_cast<int>(if_nametoindex(interface_name.c_str()));
+    port->mac = mac_result.value();
+    port->last_rx_source = socket->get_timestamp_mode();
+    port->controller_family = adapter.controller_family;
+    port->driver = adapter.driver_name;
+    port->rx_filter = RxFilterSelector::filter_name(socket->get_rx_filter());
+    port->phc_index = socket->is_hardware_timestamping_available() ? socket->get_phc_index() : -1;
+    port->linux_socket = socket.get();
+    port->socket = std::move(socket);
+    port->rx_packet.packet.payload.reserve(MAX_FRAME_PAYLOAD);
+    port->tx_packet.payload.reserve(MAX_FRAME_PAYLOAD);
+
+    const auto& logging = Configuration::instance().logging;
+    if (!logging.capture_file_path.empty() && !capture_writer_) {
+        capture::PcapngWriter::Options capture_options;
+        capture_options.path = logging.capture_file_path;
+        capture_options.file_size_bytes = static_cast<size_t>(logging.capture_file_size_mb) * 1024 * 1024;
+        capture_options.max_files = logging.capture_max_files;
+        capture_writer_ = std::make_shared<capture::PcapngWriter>();
+        if (capture_writer_->open(capture_options).has_error()) {
+            LOG_WARN("Frame capture disabled: cannot open {}", logging.capture_file_path);
+            capture_writer_.reset();
+        }
+    }
+    if (capture_writer_) {
+        auto recording = std::make_unique<RecordingSocket>(std::move(port->socket), capture_writer_);
+        recording->get_capture_interface();
+        port->socket = std::move(recording);
+    }
+    ports_.push_back(std::move(port));
+
+    return Result<bool>::success(true);
+}
+
+Result<bool> GptpPipeline::initialize() {
+    if (ports_.empty()) {
+        return Result<bool>::error(ErrorCode::INTERFACE_NOT_FOUND);
+    }
+
+    auto loop_result = event_loop_.initialize();
+    if (loop_result.has_error()) {
+        return loop_result;
+    }
+
+    install_clock_source(Configuration::instance().system.clock_source);
+
+    // One time-aware system: clock identity from the first port's MAC
+    ClockIdentity clock_id = derive_clock_identity(ports_.front()->mac);
+    port_manager_ = std::make_unique<GptpPortManager>(clock_id,
+        [this](uint16_t port_id, const std::vector<uint8_t>& payload) {
+            send_message(port_id, payload);
+        });
+    port_manager_->set_tx_timestamp_provider([this](uint16_t port_id, Timestamp& tx_time) {
+        return get_tx_timestamp(port_id, tx_time);
+    });
+    port_manager_->set_dispatch_callback([this](uint16_t, protocol::MessageType) { on_dispatch(); });
+    port_manager_->set_sync_due_callback([this](uint16_t port_id, std::chrono::steady_clock::time_point due_time) {
+        on_sync_due(port_id, due_time);
+    });
+
+    const auto& timing = Configuration::instance().timing;
+    ClockQuality quality;
+    quality.offsetScaledLogVariance = timing.offset_scaled_log_variance;
+    port_manager_->set_local_clock_properties(timing.priority1, quality, timing.priority2);
+
+    const auto& logging = Configuration::instance().logging;
+    if (!logging.trace_file_path.empty()) {
+        trace::TraceWriter::Options trace_options;
+        trace_options.path = logging.trace_file_path;
+        trace_options.file_size_bytes = static_cast<size_t>(logging.trace_file_size_mb) * 1024 * 1024;
+        trace_options.max_files = logging.trace_max_files;
+        if (trace_writer_.open(trace_options).has_error()) {
+            LOG_WARN("Sync tracing disabled: cannot open {}", logging.trace_file_path);
+        }
+    }
+    port_manager_->set_sync_sample_callback([this](const SyncSample& sample) { on_sync_sample(sample); });
+    performance_monitoring_ = Configuration::instance().system.enable_performance_monitoring;
+
+    // One servo per physical clock: ports of a multi-port NIC share a PHC,
+    // so only the slave port's PHC is disciplined from the network and the
+    // others follow it. Until a port is slave the first PHC is disciplined
+    std::vector<std::pair<uint16_t, int>> port_phcs;
+    for (const auto& port : ports_) {
+        port_phcs.emplace_back(port->port_id, port->phc_index);
+    }
+    phc_groups_ = group_ports_by_phc(port_phcs);
+    int phc_index = -1;
+    for (const auto& group : phc_groups_) {
+        if (group.phc_index >= 0) {
+            phc_index = group.phc_index;
+            break;
+        }
+    }
+    for (const auto& group : phc_groups_) {
+        std::string port_list;
+        for (uint16_t port_id : group.port_ids) {
+            port_list += (port_list.empty() ? "" : ",") + std::to_string(port_id);
+        }
+        LOG_INFO("Clock {}: ports {}", clock_name(group.phc_index), port_list);
+    }
+    select_disciplined_clock(phc_index);
+    port_manager_->set_role_change_callback([this](uint16_t port_id, bmca::PortRole, bmca::PortRole new_role) {
+        on_role_change(port_id, new_role);
+    });
+
+    // PHY latency per controller family and link speed, config entries first
+    latency_table_ = AdapterLatencyTable::with_defaults();
+    for (const auto& entry : Configuration::instance().network.latency_overrides) {
+        PhyLatency latency;
+        latency.ingress_ns = entry.second.ingress_ns;
+        latency.egress_ns = entry.second.egress_ns;
+        latency_table_.set(entry.second.name, entry.second.speed_mbps, latency);
+    }
+    if (adapter_detector_.initialize().has_error()) {
+        LOG_WARN("Adapter detection unavailable; only per-interface latency entries apply");
+    }
+
+    for (auto& port : ports_) {
+        PortContext* context = port.get();
+        update_latency_compensation(*context);
+
+        port_manager_->add_port(context->port_id);
+
+        auto reader_result = event_loop_.add_reader(context->socket->get_native_handle(),
+            [this, context]() { handle_readable(*context); });
+        if (reader_result.has_error()) {
+            return reader_result;
+        }
+
+        port_manager_->enable_port(context->port_id);
+    }
+
+    // Carrier changes reach the port manager as they happen; the initial
+    // dump brings ports whose link is already down into the right state
+    auto monitor_result = link_monitor_.open();
+    if (monitor_result.is_success()) {
+        auto reader_result = event_loop_.add_reader(link_monitor_.get_native_handle(), [this]() {
+            link_monitor_.process_events([this](const LinkStateEvent& event) { handle_link_event(event); });
+        });
+        if (reader_result.has_error()) {
+            return reader_result;
+        }
+        link_monitor_.request_dump();
+    } else {
+        LOG_WARN("Link monitoring unavailable; ports assume their link is up");
+    }
+
+    auto timer_result = event_loop_.add_timer(PERIODIC_TASK_INTERVAL, [this]() {
+        auto now = std::chrono::steady_clock::now();
+        port_manager_->run_periodic_tasks(now);
+        link_monitor_.retry_dump();
+
+        const auto& system = Configuration::instance().system;
+        if (system.enable_statistics &&
+            now - last_statistics_log_ >= std::chrono::milliseconds(system.statistics_interval_ms)) {
+            log_statistics();
+            last_statistics_log_ = now;
+        }
+        if (metrics_server_.is_running() && now - last_metrics_publish_ >= METRICS_PUBLISH_INTERVAL) {
+            publish_metrics();
+            last_metrics_publish_ = now;
+        }
+        if (capture_writer_ && now - last_capture_flush_ >= CAPTURE_FLUSH_INTERVAL) {
+            capture_writer_->flush();
+            last_capture_flush_ = now;
+        }
+        phc_sync_.poll(now);
+        for (auto& follower : phc_followers_) {
+            follower->poll(now);
+        }
+#if defined(__x86_64__)
+        if (tsc_clock_ && now - last_clock_calibration_ >= CLOCK_CALIBRATION_INTERVAL) {
+            tsc_clock_->recalibrate();
+            last_clock_calibration_ = now;
+        }
+#endif
+        if (time_publisher_.is_open() && now - last_time_publish_ >= TIME_PUBLISH_INTERVAL) {
+            publish_time();
+            last_time_publish_ = now;
+        }
+    });
+    if (timer_result.has_error()) {
+        return Result<bool>::error(timer_result.error());
+    }
+
+    started_at_ = std::chrono::steady_clock::now();
+    last_statistics_log_ = started_at_;
+    last_metrics_publish_ = started_at_;
+    last_time_publish_ = started_at_;
+    last_clock_calibration_ = started_at_;
+    last_capture_flush_ = started_at_;
+
+    const auto& system = Configuration::instance().system;
+    if (!system.time_shm_name.empty() && time_publisher_.open(system.time_shm_name).is_success()) {
+        publish_time();
+    }
+    if (system.phc_system_sync) {
+        if (reference_phc_index_ < 0) {
+            LOG_WARN("PHC to system clock synchronization needs a disciplined PHC; disabled");
+        } else {
+            open_system_sync();
+        }
+    }
+    if (system.enable_statistics && (!system.metrics_socket_path.empty() || system.metrics_http_port != 0)) {
+        publish_metrics();
+        MetricsServer::Options metrics_options;
+        metrics_options.socket_path = system.metrics_socket_path;
+        metrics_options.http_port = static_cast<uint16_t>(system.metrics_http_port);
+        if (metrics_server_.start(metrics_options, [this]() { return render_metrics(); }).has_error()) {
+            LOG_WARN("Metrics endpoint unavailable");
+        }
+    }
+    return Result<bool>::success(true);
+}
+
+void GptpPipeline::select_disciplined_clock(int phc_index) {
+    auto adjuster = LinuxClockAdjuster::create(phc_index);
+    if (!adjuster) {
+        // Steering a clock the slave port does not measure against would
+        // only add error; stop steering instead
+        LOG_WARN("Clock adjustment unavailable (phc index {}); running in monitor mode", phc_index);
+        port_manager_->set_clock_adjuster(nullptr);
+        clock_adjuster_.reset();
+        return;
+    }
+
+    // The servo moves to the new clock before the old adjuster goes away
+    LOG_INFO("Disciplining clock {}", adjuster->get_name());
+    reference_clock_ = adjuster->get_clock_id();
+    reference_phc_index_ = adjuster->get_phc_index();
+    auto instrumented = std::make_unique<InstrumentedClockAdjuster>(std::move(adjuster), *this);
+    port_manager_->set_clock_adjuster(instrumented.get());
+    clock_adjuster_ = std::move(instrumented);
+    time_rate_.reset();
+
+    // Every other PHC, the previously disciplined one included, follows it
+    phc_followers_.clear();
+    if (reference_phc_index_ < 0) {
+        return;
+    }
+    for (const auto& group : phc_groups_) {
+        if (group.phc_index < 0 || group.phc_index == reference_phc_index_) {
+            continue;
+        }
+        LinuxPhcFollower::Options follower_options;
+        follower_options.primary_clock = reference_clock_;
+        follower_options.phc_index = group.phc_index;
+        auto follower = std::make_unique<LinuxPhcFollower>();
+        if (follower->open(follower_options).has_error()) {
+            LOG_WARN("/dev/ptp{} cannot follow the disciplined PHC; its ports keep their own time base",
+                     group.phc_index);
+            continue;
+        }
+        phc_followers_.push_back(std::move(follower));
+    }
+}
+
+void GptpPipeline::open_system_sync() {
+    const auto& system = Configuration::instance().system;
+    phc_sync_.close();
+    LinuxPhcSystemSync::Options phc_options;
+    phc_options.phc_index = reference_phc_index_;
+    phc_options.interval = std::chrono::milliseconds(system.phc_system_sync_interval_ms);
+    phc_options.utc_offset_s = system.phc_utc_offset_s;
+    if (phc_sync_.open(phc_options).has_error()) {
+        LOG_WARN("PHC to system clock synchronization unavailable");
+    }
+}
+
+void GptpPipeline::on_role_change(uint16_t port_id, bmca::PortRole new_role) {
+    // The servo steers the clock its slave port timestamps against
+    if (new_role != bmca::PortRole::SLAVE || port_id == 0 || port_id > ports_.size()) {
+        return;
+    }
+    // A software timestamping port (-1) measures against the system clock
+    int phc_index = ports_[port_id - 1]->phc_index;
+    if (clock_adjuster_ && phc_index == reference_phc_index_) {
+        return;
+    }
+
+    LOG_INFO("Port {} is slave and timestamps against the {} clock", port_id, clock_name(phc_index));
+    select_disciplined_clock(phc_index);
+
+    // PHC to system clock synchronization needs a disciplined PHC; with the
+    // system clock disciplined directly it would fight the servo
+    if (!clock_adjuster_ || reference_phc_index_ < 0) {
+        phc_sync_.close();
+    } else if (Configuration::instance().system.phc_system_sync) {
+        open_system_sync();
+    }
+}
+
+void GptpPipeline::install_clock_source(const std::string& name) {
+    if (name == "system") {
+        return;
+    }
+#if defined(__x86_64__)
+    tsc_clock_ = TscClockSource::create();
+    if (tsc_clock_) {
+        set_clock_source(tsc_clock_.get());
+        return;
+    }
+#endif
+    if (name == "tsc") {
+        LOG_WARN("TSC clock source unavailable; using the system clocks");
+    }
+}
+
+void GptpPipeline::run_once(int timeout_ms) {
+    event_loop_.run_once(timeout_ms);
+}
+
+const PortStatistics* GptpPipeline::get_port_statistics(uint16_t port_id) const {
+    if (port_id == 0 || port_id > ports_.size()) {
+        return nullptr;
+    }
+    return &ports_[port_id - 1]->stats;
+}
+
+const PortHistograms* GptpPipeline::get_port_histograms(uint16_t port_id) const {
+    if (port_id == 0 || port_id > ports_.size()) {
+        return nullptr;
+    }
+    return &ports_[port_id - 1]->histograms;
+}
+
+void GptpPipeline::handle_readable(PortContext& port) {
+    int64_t cpu_start = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+
+    for (int i = 0; i < MAX_FRAMES_PER_WAKEUP; ++i) {
+        auto result = port.socket->try_receive_packet_into(port.rx_packet);
+        if (result.has_error()) {
+            if (result.error() != ErrorCode::TIMEOUT) {
+                port.stats.receive_errors++;
+                continue;
+            }
+            break;
+        }
+
+        current_rx_port_ = &port;
+        current_rx_start_ns_ = get_clock_source().now_monotonic_ns();
+
+        const ReceivedPacket& received = port.rx_packet;
+        port.stats.frames_received++;
+
+        if (!received.timestamp.is_valid()) {
+            port.stats.rx_timestamp_failures++;
+        }
+        port.last_rx_source = received.timestamp.source;
+        if (performance_monitoring_ && received.timestamp.software_timestamp_valid &&
+            received.timestamp.source != TimestampSource::USERSPACE) {
+            port.histograms.latency.kernel_to_rx.record(
+                get_clock_source().now_realtime_ns() - received.timestamp.software_timestamp.count());
+        }
+
+        ParseResult parse_result = port_manager_->process_frame(port.port_id,
+                                                                received.packet.payload.data(),
+                                                                received.packet.payload.size(),
+                                                                to_timestamp(received.timestamp.get_best_timestamp()));
+        if (parse_result != ParseResult::SUCCESS) {
+            port.stats.parse_errors++;
+        }
+
+        current_rx_port_ = nullptr;
+    }
+
+    port.stats.cpu_time_ns += static_cast<uint64_t>(clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start);
+}
+
+void GptpPipeline::handle_link_event(const LinkStateEvent& event) {
+    for (auto& port : ports_) {
+        if (port->ifindex != event.ifindex) {
+            continue;
+        }
+        bool link_up = event.is_running();
+        if (link_up == port->link_up) {
+            return;
+        }
+        LOG_INFO("Port {} ({}): link {}", port->port_id, port->socket->get_interface_name(),
+                 link_up ? "up" : (event.removed ? "removed" : "down"));
+        port->link_up = link_up;
+        port->last_tx_valid = false;
+        if (link_up) {
+            update_latency_compensation(*port); // The speed may have been renegotiated
+        }
+        port->stats.link_transitions++;
+        port_manager_->set_link_status(port->port_id, link_up);
+        return;
+    }
+}
+
+void GptpPipeline::update_latency_compensation(PortContext& port) {
+    LinuxSocket* socket = port.linux_socket;
+    if (!socket) {
+        return;
+    }
+    const std::string interface_name = socket->get_interface_name();
+    auto speed = adapter_detector_.get_link_speed_mbps(interface_name);
+    uint32_t speed_mbps = speed.is_success() ? speed.value() : 0;
+    if (speed_mbps == port.link_speed_mbps && port.link_speed_mbps != 0) {
+        return;
+    }
+
+    std::string applied_by;
+    PhyLatency latency = latency_table_.lookup(interface_name, port.controller_family, port.driver,
+                                               speed_mbps, &applied_by);
+    port.link_speed_mbps = speed_mbps;
+    port.latency = latency;
+    socket->set_latency_compensation(latency);
+
+    if (!applied_by.empty()) {
+        LOG_INFO("Port {} ({}): {} at {} Mb/s, PHY latency compensated by the {} driver", port.port_id,
+                 interface_name, port.controller_family, speed_mbps, applied_by);
+    } else if (!latency.is_zero()) {
+        LOG_INFO("Port {} ({}): {} at {} Mb/s, PHY latency ingress={}ns egress={}ns", port.port_id,
+                 interface_name, port.controller_family.empty() ? "adapter" : port.controller_family, speed_mbps,
+                 latency.ingress_ns, latency.egress_ns);
+    }
+}
+
+void GptpPipeline::send_message(uint16_t port_id, const std::vector<uint8_t>& payload) {
+    if (port_id == 0 || port_id > ports_.size()) {
+        return;
+    }
+    PortContext& port = *ports_[port_id - 1];
+
+    GptpPacket& packet = port.tx_packet;
+    packet.set_source_mac(port.mac);
+    packet.payload.assign(payload.begin(), payload.end());
+
+    PacketTimestamp timestamp;
+    auto result = port.socket->send_packet(packet, timestamp);
+    if (result.has_error()) {
+        port.stats.transmit_errors++;
+        port.last_tx_valid = false;
+        return;
+    }
+
+    port.stats.frames_transmitted++;
+    port.last_tx_timestamp = to_timestamp(timestamp.get_best_timestamp());
+    port.last_tx_valid = timestamp.is_valid();
+    port.last_tx_source = timestamp.source;
+
+    // Event messages (types 0-3) need their egress timestamp
+    uint8_t message_type = payload.empty() ? 0xFF : (payload[0] & 0x0F);
+    if (message_type < 0x04 && !port.last_tx_valid) {
+        port.stats.tx_timestamp_failures++;
+    }
+
+    if (port.sync_due_ns != 0 && message_type == static_cast<uint8_t>(protocol::MessageType::SYNC)) {
+        // Software TX timestamps are CLOCK_REALTIME; hardware ones live on the PHC
+        int64_t tx_ns = get_clock_source().now_monotonic_ns();
+        if (timestamp.software_timestamp_valid) {
+            tx_ns += timestamp.software_timestamp.count() - get_clock_source().now_realtime_ns();
+        }
+        port.histograms.latency.sync_due_to_tx.record(tx_ns - port.sync_due_ns);
+        port.sync_due_ns = 0;
+    }
+}
+
+bool GptpPipeline::get_tx_timestamp(uint16_t port_id, Timestamp& tx_time) const {
+    if (port_id == 0 || port_id > ports_.size() || !ports_[port_id - 1]->last_tx_valid) {
+        return false;
+    }
+    tx_time = ports_[port_id - 1]->last_tx_timestamp;
+    return true;
+}
+
+void GptpPipeline::on_dispatch() {
+    if (!performance_monitoring_ || current_rx_port_ == nullptr) {
+        return;
+    }
+    current_dispatch_ns_ = get_clock_source().now_monotonic_ns();
+    current_rx_port_->histograms.latency.rx_to_dispatch.record(current_dispatch_ns_ - current_rx_start_ns_);
+}
+
+void GptpPipeline::on_sync_due(uint16_t port_id, std::chrono::steady_clock::time_point due_time) {
+    if (!performance_monitoring_ || port_id == 0 || port_id > ports_.size()) {
+        return;
+    }
+    // steady_clock is CLOCK_MONOTONIC on Linux
+    ports_[port_id - 1]->sync_due_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        due_time.time_since_epoch()).count();
+}
+
+void GptpPipeline::on_clock_adjusted(int64_t servo_output_ns) {
+    if (current_rx_port_ == nullptr) {
+        return;
+    }
+    current_rx_port_->stats.clock_adjustments++;
+    if (performance_monitoring_) {
+        StageLatencies& latency = current_rx_port_->histograms.latency;
+        latency.dispatch_to_servo.record(servo_output_ns - current_dispatch_ns_);
+        latency.servo_to_adjustment.record(get_clock_source().now_monotonic_ns() - servo_output_ns);
+    }
+}
+
+void GptpPipeline::on_sync_sample(const SyncSample& sample) {
+    if (trace_writer_.is_open()) {
+        trace_writer_.write(sample);
+    }
+    if (sample.port_id == 0 || sample.port_id > ports_.size()) {
+        return;
+    }
+    PortHistograms& histograms = ports_[sample.port_id - 1]->histograms;
+    if (sample.kind == SyncSample::Kind::SYNC) {
+        histograms.offset_magnitude.record(sample.offset_ns < 0 ? -sample.offset_ns : sample.offset_ns);
+    } else {
+        histograms.path_delay.record(sample.path_delay_ns);
+    }
+}
+
+void GptpPipeline::log_statistics() {
+    auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started_at_).count();
+    auto roles = port_manager_->get_port_roles();
+
+    for (const auto& port : ports_) {
+        const PortStatistics& stats = port->stats;
+        double cpu_percent = wall_ns > 0 ? 100.0 * static_cast<double>(stats.cpu_time_ns) / wall_ns : 0.0;
+
+        LOG_INFO("Port {} ({}): link={} role={} rx={} tx={} timestamps={}/{} errors={}/{}/{} adjustments={} cpu={}% "
+                 "link_delay={}ns",
+                 port->port_id, port->socket->get_interface_name(),
+                 port->link_up ? "up" : "down", static_cast<int>(roles[port->port_id]),
+                 stats.frames_received, stats.frames_transmitted,
+                 to_string(port->last_rx_source), to_string(port->last_tx_source),
+                 stats.receive_errors, stats.transmit_errors, stats.parse_errors,
+                 stats.clock_adjustments, cpu_percent, port_manager_->get_link_delay(port->port_id).count());
+        log_latency("kernel->rx", port->histograms.latency.kernel_to_rx);
+        log_latency("rx->dispatch", port->histograms.latency.rx_to_dispatch);
+        log_latency("dispatch->servo", port->histograms.latency.dispatch_to_servo);
+        log_latency("servo->adjust", port->histograms.latency.servo_to_adjustment);
+        log_latency("sync due->tx", port->histograms.latency.sync_due_to_tx);
+    }
+
+    auto status = port_manager_->get_sync_status(ports_.front()->port_id);
+    LOG_INFO("Sync: synchronized={} offset={}ns freq={}ppb locked={}",
+             status.synchronized, status.current_offset.count(),
+             status.frequency_adjustment_ppb, status.servo_locked);
+    if (phc_sync_.is_open()) {
+        LOG_INFO("System clock: offset={}ns freq={}ppb locked={} method={}", phc_sync_.get_last_offset_ns(),
+                 phc_sync_.get_frequency_ppb(), phc_sync_.is_locked(), to_string(phc_sync_.get_method()));
+    }
+    for (const auto& follower : phc_followers_) {
+        LOG_INFO("PHC /dev/ptp{}: offset={}ns freq={}ppb locked={}", follower->get_phc_index(),
+                 follower->get_last_offset_ns(), follower->get_frequency_ppb(), follower->is_locked());
+    }
+}
+
+void GptpPipeline::publish_metrics() {
+    MetricsSnapshot& snapshot = metrics_snapshot_.write_buffer();
+    auto roles = port_manager_->get_port_roles();
+
+    snapshot.ports.resize(ports_.size());
+    for (size_t i = 0; i < ports_.size(); ++i) {
+        const PortContext& port = *ports_[i];
+        MetricsSnapshot::Port& entry = snapshot.ports[i];
+        entry.port_id = port.port_id;
+        entry.interface_name = port.socket->get_interface_name();
+        entry.role = static_cast<int>(roles[port.port_id]);
+        entry.link_up = port.link_up;
+        entry.rx_timestamp_source = port.last_rx_source;
+        entry.tx_timestamp_source = port.last_tx_source;
+        entry.rx_filter = port.rx_filter;
+        entry.phc_index = port.phc_index;
+        entry.link_speed_mbps = port.link_speed_mbps;
+        entry.latency = port.latency;
+        entry.link_delay_ns = port_manager_->get_link_delay(port.port_id).count();
+        entry.neighbor_rate_ratio = port_manager_->get_neighbor_rate_ratio(port.port_id);
+        entry.stats = port.stats;
+        entry.protocol = port_manager_->get_port_counters(port.port_id);
+    }
+
+    auto status = port_manager_->get_sync_status(ports_.front()->port_id);
+    snapshot.synchronized = status.synchronized;
+    snapshot.servo_locked = status.servo_locked;
+    snapshot.offset_ns = status.current_offset.count();
+    snapshot.frequency_ppb = status.frequency_adjustment_ppb;
+    snapshot.uptime_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at_).count();
+    snapshot.system_sync_active = phc_sync_.is_open();
+    snapshot.system_sync_locked = phc_sync_.is_locked();
+    snapshot.system_offset_ns = phc_sync_.get_last_offset_ns();
+    snapshot.phc_followers.resize(phc_followers_.size());
+    for (size_t i = 0; i < phc_followers_.size(); ++i) {
+        snapshot.phc_followers[i].phc_index = phc_followers_[i]->get_phc_index();
+        snapshot.phc_followers[i].offset_ns = phc_followers_[i]->get_last_offset_ns();
+        snapshot.phc_followers[i].locked = phc_followers_[i]->is_locked();
+    }
+
+    metrics_snapshot_.publish();
+}
+
+void GptpPipeline::publish_time() {
+    CrossTimestamp cross = read_cross_timestamp(reference_clock_);
+    auto status = port_manager_->get_sync_status(ports_.front()->port_id);
+    bmca::PriorityVector grandmaster = port_manager_->get_grandmaster(ports_.front()->port_id);
+    bool local_grandmaster = grandmaster.grandmaster_identity == port_manager_->get_local_clock_id();
+
+    shm::TimeData data{};
+    data.flags = (status.synchronized ? shm::TIME_SYNCHRONIZED : 0u) |
+                 (status.servo_locked ? shm::TIME_SERVO_LOCKED : 0u) |
+                 (local_grandmaster ? shm::TIME_GRANDMASTER : 0u) |
+                 (clock_adjuster_ ? shm::TIME_DISCIPLINED : 0u);
+    data.phc_index = reference_phc_index_;
+    data.offset_ns = status.synchronized ? status.current_offset.count() : 0;
+    data.frequency_ppb = status.frequency_adjustment_ppb;
+    data.monotonic_ref_ns = cross.monotonic_ns;
+    data.realtime_ref_ns = cross.realtime_ns;
+    data.clock_ref_ns = cross.clock_ns;
+    data.gptp_ref_ns = cross.clock_ns - data.offset_ns;     // offset = local - master
+    data.cross_uncertainty_ns = cross.uncertainty_ns;
+    data.rate_ratio = time_rate_.update(data.monotonic_ref_ns, data.gptp_ref_ns);
+    std::memcpy(data.grandmaster_identity, grandmaster.grandmaster_identity.id.data(),
+                sizeof(data.grandmaster_identity));
+    data.steps_removed = grandmaster.steps_removed;
+    data.slave_port_id = status.synchronized ? status.slave_port_id : 0;
+
+    time_publisher_.publish(data);
+}
+
+std::string GptpPipeline::render_metrics() {
+    static const char* const ROLE_NAMES[] = {"master", "slave", "passive", "disabled"};
+    const MetricsSnapshot& snapshot = metrics_snapshot_.read();
+    PrometheusWriter out;
+
+    auto port_labels = [](const MetricsSnapshot::Port& port) {
+        return PrometheusWriter::Labels{{"port", std::to_string(port.port_id)}, {"interface", port.interface_name}};
+    };
+
+    out.family("gptp_uptime_seconds", "gauge", "Time since the pipeline started");
+    out.sample("gptp_uptime_seconds", {}, snapshot.uptime_s);
+    out.family("gptp_synchronized", "gauge", "1 if the local clock follows a master");
+    out.sample("gptp_synchronized", {}, static_cast<uint64_t>(snapshot.synchronized));
+    out.family("gptp_servo_locked", "gauge", "1 if the clock servo is locked");
+    out.sample("gptp_servo_locked", {}, static_cast<uint64_t>(snapshot.servo_locked));
+    out.family("gptp_offset_from_master_ns", "gauge", "Last measured offset from the master");
+    out.sample("gptp_offset_from_master_ns", {}, snapshot.offset_ns);
+    out.family("gptp_frequency_adjustment_ppb", "gauge", "Servo frequency output");
+    out.sample("gptp_frequency_adjustment_ppb", {}, snapshot.frequency_ppb);
+    if (snapshot.system_sync_active) {
+        out.family("gptp_system_clock_offset_ns", "gauge", "CLOCK_REALTIME minus the PHC (UTC corrected)");
+        out.sample("gptp_system_clock_offset_ns", {}, snapshot.system_offset_ns);
+        out.family("gptp_system_clock_locked", "gauge", "1 if the system clock tracks the PHC");
+        out.sample("gptp_system_clock_locked", {}, static_cast<uint64_t>(snapshot.system_sync_locked));
+    }
+    if (!snapshot.phc_followers.empty()) {
+        out.family("gptp_phc_follower_offset_ns", "gauge", "Secondary PHC minus the disciplined PHC");
+        for (const auto& follower : snapshot.phc_followers) {
+            out.sample("gptp_phc_follower_offset_ns", {{"phc", std::to_string(follower.phc_index)}},
+                       follower.offset_ns);
+        }
+        out.family("gptp_phc_follower_locked", "gauge", "1 if the secondary PHC tracks the disciplined PHC");
+        for (const auto& follower : snapshot.phc_followers) {
+            out.sample("gptp_phc_follower_locked", {{"phc", std::to_string(follower.phc_index)}},
+                       static_cast<uint64_t>(follower.locked));
+        }
+    }
+
+    out.family("gptp_port_role", "gauge", "Port role selected by BMCA (1 for the current role)");
+    for (const auto& port : snapshot.ports) {
+        auto labels = port_labels(port);
+        labels.emplace_back("role", port.role >= 0 && port.role < 4 ? ROLE_NAMES[port.role] : "unknown");
+        out.sample("gptp_port_role", labels, uint64_t{1});
+    }
+
+    out.family("gptp_port_timestamp_source", "gauge",
+               "Source of the last packet timestamp per direction (1 for the source in use)");
+    for (const auto& port : snapshot.ports) {
+        const std::pair<const char*, TimestampSource> directions[] = {
+            {"rx", port.rx_timestamp_source},
+            {"tx", port.tx_timestamp_source},
+        };
+        for (const auto& direction : directions) {
+            auto labels = port_labels(port);
+            labels.emplace_back("direction", direction.first);
+            labels.emplace_back("source", to_string(direction.second));
+            out.sample("gptp_port_timestamp_source", labels, uint64_t{1});
+        }
+    }
+
+    out.family("gptp_port_hwtstamp_rx_filter", "gauge",
+               "Hardware receive timestamp filter applied by the driver (1 for the filter in use)");
+    for (const auto& port : snapshot.ports) {
+        auto labels = port_labels(port);
+        labels.emplace_back("filter", port.rx_filter);
+        out.sample("gptp_port_hwtstamp_rx_filter", labels, uint64_t{1});
+    }
+
+    struct PortGauge {
+        const char* name;
+        const char* type;
+        const char* help;
+        double (*value)(const MetricsSnapshot::Port&);
+    };
+    static const PortGauge PORT_VALUES[] = {
+        {"gptp_port_link_up", "gauge", "1 if the carrier is up",
+         [](const MetricsSnapshot::Port& p) { return p.link_up ? 1.0 : 0.0; }},
+        {"gptp_port_path_delay_ns", "gauge", "Mean link delay in use",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.link_delay_ns); }},
+        {"gptp_port_neighbor_rate_ratio", "gauge", "Neighbor rate ratio from peer delay",
+         [](const MetricsSnapshot::Port& p) { return p.neighbor_rate_ratio; }},
+        {"gptp_port_phc_index", "gauge", "PTP hardware clock of the port's timestamps, -1 for the system clock",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.phc_index); }},
+        {"gptp_port_link_speed_mbps", "gauge", "Negotiated link speed, 0 if unknown",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.link_speed_mbps); }},
+        {"gptp_port_ingress_latency_ns", "gauge", "PHY ingress latency subtracted from RX timestamps",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.latency.ingress_ns); }},
+        {"gptp_port_egress_latency_ns", "gauge", "PHY egress latency added to TX timestamps",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.latency.egress_ns); }},
+        {"gptp_port_frames_received_total", "counter", "Frames received",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.frames_received); }},
+        {"gptp_port_frames_transmitted_total", "counter", "Frames transmitted",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.frames_transmitted); }},
+        {"gptp_port_receive_errors_total", "counter", "Socket receive errors",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.receive_errors); }},
+        {"gptp_port_transmit_errors_total", "counter", "Socket transmit errors",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.transmit_errors); }},
+        {"gptp_port_parse_errors_total", "counter", "Frames rejected by the parser",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.parse_errors); }},
+        {"gptp_port_link_transitions_total", "counter", "Carrier up/down transitions",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.link_transitions); }},
+        {"gptp_port_clock_adjustments_total", "counter", "Clock adjustments triggered by this port",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.clock_adjustments); }},
+        {"gptp_port_rx_timestamp_failures_total", "counter", "Frames received without a timestamp",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.rx_timestamp_failures); }},
+        {"gptp_port_tx_timestamp_failures_total", "counter", "Event messages sent without an egress timestamp",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.stats.tx_timestamp_failures); }},
+        {"gptp_port_sync_sequence_lost_total", "counter", "Syncs missing from the received sequence",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.protocol.syncs_lost); }},
+        {"gptp_port_followup_missed_total", "counter", "Syncs whose Follow_Up never arrived",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.protocol.followups_missed); }},
+        {"gptp_port_followup_unmatched_total", "counter", "Follow_Ups without a matching Sync",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.protocol.followups_unmatched); }},
+        {"gptp_port_tx_timestamp_missing_total", "counter", "Follow_Ups skipped or Pdelay exchanges aborted without an egress timestamp",
+         [](const MetricsSnapshot::Port& p) { return static_cast<double>(p.protocol.tx_timestamps_missing); }},
+    };
+    for (const auto& metric : PORT_VALUES) {
+        out.family(metric.name, metric.type, metric.help);
+        for (const auto& port : snapshot.ports) {
+            out.sample(metric.name, port_labels(port), metric.value(port));
+        }
+    }
+
+    // Histograms are read straight from their atomics
+    out.family("gptp_port_offset_magnitude_ns", "histogram", "Absolute offset from master per Sync");
+    for (const auto& port : snapshot.ports) {
+        out.histogram("gptp_port_offset_magnitude_ns", port_labels(port),
+                      ports_[port.port_id - 1]->histograms.offset_magnitude.snapshot());
+    }
+    out.family("gptp_port_path_delay_distribution_ns", "histogram", "Mean link delay per peer delay exchange");
+    for (const auto& port : snapshot.ports) {
+        out.histogram("gptp_port_path_delay_distribution_ns", port_labels(port),
+                      ports_[port.port_id - 1]->histograms.path_delay.snapshot());
+    }
+
+    if (performance_monitoring_) {
+        out.family("gptp_stage_latency_ns", "histogram", "Time spent per pipeline stage");
+        for (const auto& port : snapshot.ports) {
+            const StageLatencies& latency = ports_[port.port_id - 1]->histograms.latency;
+            const std::pair<const char*, const LatencyHistogram*> stages[] = {
+                {"kernel_to_rx", &latency.kernel_to_rx},
+                {"rx_to_dispatch", &latency.rx_to_dispatch},
+                {"dispatch_to_servo", &latency.dispatch_to_servo},
+                {"servo_to_adjustment", &latency.servo_to_adjustment},
+                {"sync_due_to_tx", &latency.sync_due_to_tx},
+            };
+            for (const auto& stage : stages) {
+                auto labels = port_labels(port);
+                labels.emplace_back("stage", stage.first);
+                out.histogram("gptp_stage_latency_ns", labels, stage.second->snapshot());
+            }
+        }
+    }
+
+    return out.str();
+}
+
+ClockIdentity GptpPipeline::derive_clock_identity(const std::array<uint8_t, 6>& mac) {
+    // EUI-48 to EUI-64: insert FF:FE in the middle
+    ClockIdentity identity;
+    identity.id = {mac[0], mac[1], mac[2], 0xFF, 0xFE, mac[3], mac[4], mac[5]};
+    return identity;
+}
+
+} // namespace gptp
+
+#endif // __linux__
@@ -0,0 +1,262 @@
+/**
+ * @file gptp_pipeline.hpp
+ * @brief Event-driven gPTP daemon pipeline for Linux
+ *
+ * Wires timestamped socket reception into GptpPortManager (BMCA, path
+ * delay, servo) and the servo output into a clock adjuster, all driven by
+ * a single EventLoop.
+ */
+
+#pragma once
+
+#include "../../include/gptp_socket.hpp"
+#include "../../include/gptp_port_manager.hpp"
+#include "../../include/clock_adjuster.hpp"
+#include "event_loop.hpp"
+#include "metrics_server.hpp"
+#include "../platform/adapter_latency.hpp"
+#include "../platform/linux_adapter_detector.hpp"
+#include "../platform/linux_link_monitor.hpp"
+#include "../platform/linux_phc_sync.hpp"
+#include "../platform/tsc_clock_source.hpp"
+#include "../utils/latency_histogram.hpp"
+#include "../utils/pcapng.hpp"
+#include "../utils/sync_trace.hpp"
+#include "../utils/time_publisher.hpp"
+#include "../utils/triple_buffer.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+
+namespace gptp {
+
+class LinuxSocket;
+
+/**
+ * @brief Time a frame spends in each pipeline stage, in nanoseconds
+ */
+struct StageLatencies {
+    LatencyHistogram kernel_to_rx;          // Kernel RX timestamp -> userspace dequeue
+    LatencyHistogram rx_to_dispatch;        // Userspace dequeue -> message handler
+    LatencyHistogram dispatch_to_servo;     // Message handler -> servo output
+    LatencyHistogram servo_to_adjustment;   // Servo output -> clock adjustment applied
+    LatencyHistogram sync_due_to_tx;        // Scheduled Sync time -> TX timestamp
+};
+
+/**
+ * @brief Per-port pipeline counters (owned by the event loop thread)
+ */
+struct PortStatistics {
+    uint64_t frames_received = 0;
+    uint64_t frames_transmitted = 0;
+    uint64_t receive_errors = 0;
+    uint64_t transmit_errors = 0;
+    uint64_t parse_errors = 0;
+    uint64_t clock_adjustments = 0;
+    uint64_t link_transitions = 0;
+    uint64_t rx_timestamp_failures = 0;    // Frames received without any timestamp
+    uint64_t tx_timestamp_failures = 0;    // Event messages sent without an egress timestamp
+    uint64_t cpu_time_ns = 0;              // Thread CPU time spent in this port's RX path
+};
+
+/**
+ * @brief Per-port distributions; lock-free, readable from any thread
+ */
+struct PortHistograms {
+    LatencyHistogram offset_magnitude;      // |offset from master| per Sync, ns
+    LatencyHistogram path_delay;            // Mean link delay per peer delay exchange, ns
+    StageLatencies latency;                 // Recorded with enable_performance_monitoring
+};
+
+/**
+ * @brief Protocol state copied from the event loop for the metrics thread
+ */
+struct MetricsSnapshot {
+    struct Port {
+        uint16_t port_id = 0;
+        std::string interface_name;
+        int role = 0;
+        bool link_up = false;
+        TimestampSource rx_timestamp_source = TimestampSource::NONE;
+        TimestampSource tx_timestamp_source = TimestampSource::NONE;
+        const char* rx_filter = "none";
+        int phc_index = -1;
+        uint32_t link_speed_mbps = 0;
+        PhyLatency latency;
+        int64_t link_delay_ns = 0;
+        double neighbor_rate_ratio = 1.0;
+        PortStatistics stats;
+        GptpPortManager::PortCounters protocol;
+    };
+
+    std::vector<Port> ports;
+    bool synchronized = false;
+    bool servo_locked = false;
+    int64_t offset_ns = 0;
+    double frequency_ppb = 0.0;
+    double uptime_s = 0.0;
+    bool system_sync_active = false;        // PHC -> CLOCK_REALTIME synchronization
+    bool system_sync_locked = false;
+    int64_t system_offset_ns = 0;
+
+    struct PhcFollower {
+        int phc_index = -1;
+        int64_t offset_ns = 0;              // Secondary minus disciplined PHC
+        bool locked = false;
+    };
+    std::vector<PhcFollower> phc_followers;
+};
+
+/**
+ * @brief Linux gPTP pipeline: sockets -> port manager -> clock adjuster
+ */
+class GptpPipeline {
+public:
+    GptpPipeline();
+    ~GptpPipeline();
+
+    GptpPipeline(const GptpPipeline&) = delete;
+    GptpPipeline& operator=(const GptpPipeline&) = delete;
+
+    /**
+     * @brief Open a socket on an interface and register it as the next port
+     * @param interface_name Network interface name
+     * @return Result indicating success or error
+     */
+    Result<bool> add_interface(const std::string& interface_name);
+
+    /**
+     * @brief Create the port manager, clock adjuster and event sources
+     *
+     * Must be called after all interfaces were added.
+     * @return Result indicating success or error
+     */
+    Result<bool> initialize();
+
+    /**
+     * @brief Dispatch ready sockets and timers once
+     * @param timeout_ms Maximum time to wait for events
+     */
+    void run_once(int timeout_ms);
+
+    /**
+     * @brief Statistics of a port (port ids start at 1)
+     */
+    const PortStatistics* get_port_statistics(uint16_t port_id) const;
+
+    /**
+     * @brief Distributions of a port (port ids start at 1)
+     */
+    const PortHistograms* get_port_histograms(uint16_t port_id) const;
+
+    /**
+     * @brief Render the latest published snapshot in Prometheus text format
+     *
+     * Only reads lock-free state; called from the metrics server thread.
+     */
+    std::string render_metrics();
+
+    /**
+     * @brief Number of ports in the pipeline
+     */
+    size_t get_port_count() const { return ports_.size(); }
+
+    /**
+     * @brief Access to the protocol engine
+     */
+    GptpPortManager* get_port_manager() { return port_manager_.get(); }
+
+    /**
+     * @brief Log per-port statistics at INFO level
+     */
+    void log_statistics();
+
+private:
+    struct PortContext {
+        uint16_t port_id = 0;
+        int ifindex = 0;
+        bool link_up = true;
+        std::unique_ptr<IGptpSocket> socket;
+        LinuxSocket* linux_socket = nullptr;    // The raw socket behind any recording wrapper
+        std::array<uint8_t, 6> mac{};
+        Timestamp last_tx_timestamp;
+        bool last_tx_valid = false;
+        TimestampSource last_rx_source = TimestampSource::NONE;    // Socket mode until a packet shows the source
+        TimestampSource last_tx_source = TimestampSource::NONE;
+        std::string controller_family;      // From the PCI device id, empty if unknown
+        std::string driver;
+        const char* rx_filter = "none";     // Hardware RX filter the driver applied
+        int phc_index = -1;                 // PHC the timestamps come from, -1 for the system clock
+        uint32_t link_speed_mbps = 0;       // 0 while unknown
+        PhyLatency latency;                 // Compensation applied by the socket
+        int64_t sync_due_ns = 0;            // Monotonic due time of the Sync being sent, 0 if none
+        PortStatistics stats;
+        PortHistograms histograms;
+        ReceivedPacket rx_packet;           // Reused for every frame; sized at port creation
+        GptpPacket tx_packet;
+    };
+
+    class InstrumentedClockAdjuster;
+
+    void handle_readable(PortContext& port);
+    void handle_link_event(const LinkStateEvent& event);
+    void send_message(uint16_t port_id, const std::vector<uint8_t>& payload);
+    bool get_tx_timestamp(uint16_t port_id, Timestamp& tx_time) const;
+    void on_dispatch();
+    void on_sync_due(uint16_t port_id, std::chrono::steady_clock::time_point due_time);
+    void on_clock_adjusted(int64_t servo_output_ns);
+    void on_sync_sample(const SyncSample& sample);
+    void publish_metrics();
+    void publish_time();
+    void install_clock_source(const std::string& name);
+    void select_disciplined_clock(int phc_index);
+    void open_system_sync();
+    void on_role_change(uint16_t port_id, bmca::PortRole new_role);
+    void update_latency_compensation(PortContext& port);
+    static ClockIdentity derive_clock_identity(const std::array<uint8_t, 6>& mac);
+
+    std::vector<std::unique_ptr<PortContext>> ports_;
+    std::unique_ptr<GptpPortManager> port_manager_;
+    std::unique_ptr<IClockAdjuster> clock_adjuster_;
+    EventLoop event_loop_;
+    LinuxLinkMonitor link_monitor_;
+    LinuxAdapterDetector adapter_detector_;
+    AdapterLatencyTable latency_table_;
+    trace::TraceWriter trace_writer_;
+    std::shared_ptr<capture::PcapngWriter> capture_writer_;     // Shared by the ports' recording sockets
+    TripleBuffer<MetricsSnapshot> metrics_snapshot_;
+    bool performance_monitoring_;
+
+    // Shared memory time for local clients, read from the disciplined clock
+    TimePublisher time_publisher_;
+    TimeRateEstimator time_rate_;
+    clockid_t reference_clock_;
+    int reference_phc_index_;
+    LinuxPhcSystemSync phc_sync_;
+    std::vector<PhcGroup> phc_groups_;
+    std::vector<std::unique_ptr<LinuxPhcFollower>> phc_followers_;   // PHCs other than the disciplined one
+#if defined(__x86_64__)
+    std::unique_ptr<TscClockSource> tsc_clock_;        // Process clock source while installed
+#endif
+
+    // Port and monotonic dequeue/dispatch times of the frame being processed
+    PortContext* current_rx_port_;
+    int64_t current_rx_start_ns_;
+    int64_t current_dispatch_ns_;
+
+    std::chrono::steady_clock::time_point started_at_;
+    std::chrono::steady_clock::time_point last_statistics_log_;
+    std::chrono::steady_clock::time_point last_metrics_publish_;
+    std::chrono::steady_clock::time_point last_time_publish_;
+    std::chrono::steady_clock::time_point last_clock_calibration_;
+    std::chrono::steady_clock::time_point last_capture_flush_;
+
+    // Last member: its thread stops before anything it reads is destroyed
+    MetricsServer metrics_server_;
+};
+
+} // namespace gptp
+
+#endif // __linux__
@@ -5,7 +5,8 @@
 
 #include "linux_socket.hpp"
 #include "../../include/gptp_protocol.hpp"
-#include <iostream>
+#include "../../include/clock_source.hpp"
+#include "../utils/logger.hpp"
 #include <sstream>
 #include <chrono>
 #include <cstring>
@@ -19,14 +20,35 @@
 #include <linux/sockios.h>
 #include <linux/ethtool.h>
 #include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
 #include <arpa/inet.h>
+#include <poll.h>
+#include <ctime>
 
 namespace gptp {
 
+namespace {
+    // Hardware TX timestamps can take a few ms on busy NICs; software ones are immediate
+    constexpr int TX_TIMESTAMP_TIMEOUT_MS = 10;
+
+    std::chrono::nanoseconds to_duration(const struct timespec& ts) {
+        return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+    }
+
+    bool is_set(const struct timespec& ts) {
+        return ts.tv_sec != 0 || ts.tv_nsec != 0;
+    }
+}
+
 LinuxSocket::LinuxSocket() 
     : initialized_(false)
     , hardware_timestamping_available_(false)
+    , timestamp_mode_(TimestampSource::USERSPACE)
+    , tx_timestamp_mode_(TimestampSource::USERSPACE)
+    , timestamping_caps_(0)
     , interface_index_(0)
+    , phc_index_(-1)
+    , rx_filter_(HWTSTAMP_FILTER_NONE)
     , raw_socket_(-1)
     , async_thread_running_(false) {
 }
@@ -65,16 +87,24 @@ Result<bool> LinuxSocket::initialize(const std::string& interface_name) {
         return Result<bool>::error("Failed to bind raw socket to interface");
     }
 
-    // Enable hardware timestamping if available
-    hardware_timestamping_available_ = check_hardware_timestamping();
+    // Receive the gPTP multicast group without putting the NIC in promiscuous mode
+    if (!join_gptp_multicast()) {
+        LOG_WARN("⚠️ Failed to join gPTP multicast group on {}", interface_name);
+    }
+
+    // Enable hardware timestamping if available, kernel software timestamps otherwise
+    hardware_timestamping_available_ = check_hardware_timestamping() && enable_timestamping();
     if (hardware_timestamping_available_) {
-        enable_timestamping();
+        timestamp_mode_ = TimestampSource::HARDWARE;
+        tx_timestamp_mode_ = TimestampSource::HARDWARE;
+    } else if (!enable_software_timestamping()) {
+        LOG_WARN("⚠️ No kernel timestamps on {}, using userspace receive/send times", interface_name);
     }
 
-    std::cout << "Linux gPTP socket initialized:" << std::endl;
-    std::cout << "  Interface: " << interface_name_ << " (index: " << interface_index_ << ")" << std::endl;
-    std::cout << "  MAC: " << get_mac_string() << std::endl;
-    std::cout << "  Hardware timestamping: " << (hardware_timestamping_available_ ? "Yes" : "No") << std::endl;
+    LOG_INFO("Linux gPTP socket initialized:");
+    LOG_INFO("  Interface: {} (index: {})", interface_name_, interface_index_);
+    LOG_INFO("  MAC: {}", get_mac_string());
+    LOG_INFO("  Timestamping: rx={} tx={}", to_string(timestamp_mode_), to_string(tx_timestamp_mode_));
 
     initialized_ = true;
     return Result<bool>::success(true);
@@ -119,19 +149,33 @@ Result<bool> LinuxSocket::send_packet(const GptpPacket& packet, PacketTimestamp&
                    packet.payload.data(), packet.payload.size());
     }
 
+    // Stale TX timestamps (late arrivals) must not be matched to this frame
+    if (tx_timestamp_mode_ != TimestampSource::USERSPACE) {
+        drain_error_queue();
+    }
+
     // Send packet
     ssize_t sent = sendto(raw_socket_, frame_data.data(), frame_data.size(), 0,
                          (struct sockaddr*)&socket_address, sizeof(socket_address));
-
-    // Record transmission time
-    auto now = std::chrono::high_resolution_clock::now();
-    timestamp.hardware_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
-    timestamp.is_hardware_timestamp = hardware_timestamping_available_;
-
     if (sent < 0) {
         return Result<bool>::error("Failed to send packet: " + std::string(strerror(errno)));
     }
 
+    timestamp = PacketTimestamp();
+    if (tx_timestamp_mode_ != TimestampSource::USERSPACE) {
+        // The frame is on the wire; a missing kernel or hardware stamp is
+        // reported as an invalid timestamp, never replaced by a worse one
+        if (!read_tx_timestamp(timestamp)) {
+            timestamp = PacketTimestamp();
+        }
+        return Result<bool>::success(true);
+    }
+
+    // No kernel timestamping: userspace approximation taken right after sendto
+    timestamp.software_timestamp = std::chrono::nanoseconds(get_clock_source().now_realtime_ns());
+    timestamp.software_timestamp_valid = true;
+    timestamp.source = TimestampSource::USERSPACE;
+
     return Result<bool>::success(true);
 }
 
@@ -140,60 +184,148 @@ Result<ReceivedPacket> LinuxSocket::receive_packet(uint32_t timeout_ms) {
         return Result<ReceivedPacket>::error("Socket not initialized");
     }
 
-    // Set timeout if specified
-    if (timeout_ms > 0) {
-        struct timeval tv;
-        tv.tv_sec = timeout_ms / 1000;
-        tv.tv_usec = (timeout_ms % 1000) * 1000;
-        setsockopt(raw_socket_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    struct pollfd pfd{};
+    pfd.fd = raw_socket_;
+    pfd.events = POLLIN;
+    int ready = poll(&pfd, 1, timeout_ms > 0 ? static_cast<int>(timeout_ms) : -1);
+    if (ready == 0) {
+        return Result<ReceivedPacket>::error(ErrorCode::TIMEOUT);
+    }
+    if (ready < 0) {
+        return Result<ReceivedPacket>::error("Failed to poll socket: " + std::string(strerror(errno)));
     }
 
-    // Receive packet
-    uint8_t buffer[1518]; // Maximum Ethernet frame size
-    struct sockaddr_ll sender_addr;
-    socklen_t addr_len = sizeof(sender_addr);
+    return read_frame();
+}
+
+Result<ReceivedPacket> LinuxSocket::try_receive_packet() {
+    if (!initialized_) {
+        return Result<ReceivedPacket>::error("Socket not initialized");
+    }
+    return read_frame();
+}
+
+Result<bool> LinuxSocket::try_receive_packet_into(ReceivedPacket& received) {
+    if (!initialized_) {
+        return Result<bool>::error("Socket not initialized");
+    }
+    return read_frame(received);
+}
 
-    ssize_t received = recvfrom(raw_socket_, buffer, sizeof(buffer), 0,
-                               (struct sockaddr*)&sender_addr, &addr_len);
+int LinuxSocket::get_native_handle() const {
+    return raw_socket_;
+}
 
-    if (received < 0) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            return Result<ReceivedPacket>::error("Timeout");
-        }
-        return Result<ReceivedPacket>::error("Failed to receive packet: " + std::string(strerror(errno)));
+int LinuxSocket::get_phc_index() const {
+    return phc_index_;
+}
+
+void LinuxSocket::set_latency_compensation(const PhyLatency& latency) {
+    latency_ = latency;
+}
+
+Result<ReceivedPacket> LinuxSocket::read_frame() {
+    ReceivedPacket received_packet;
+    auto result = read_frame(received_packet);
+    if (result.has_error()) {
+        return Result<ReceivedPacket>::error(result.error());
     }
+    return Result<ReceivedPacket>::success(std::move(received_packet));
+}
+
+Result<bool> LinuxSocket::read_frame(ReceivedPacket& received_packet) {
+    uint8_t buffer[1518]; // Maximum Ethernet frame size
+    uint8_t control[256];
+    struct sockaddr_ll sender_addr{};
+    struct iovec iov{};
+    iov.iov_base = buffer;
+    iov.iov_len = sizeof(buffer);
+
+    struct msghdr msg{};
+    msg.msg_name = &sender_addr;
+    msg.msg_namelen = sizeof(sender_addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t received;
+    do {
+        msg.msg_namelen = sizeof(sender_addr);
+        msg.msg_controllen = sizeof(control);
+        received = recvmsg(raw_socket_, &msg, MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // A TX timestamp that missed its deadline keeps the socket
+                // signalling POLLERR; drop it so the event loop can idle
+                if (tx_timestamp_mode_ != TimestampSource::USERSPACE) {
+                    drain_error_queue();
+                }
+                return Result<bool>::error(ErrorCode::TIMEOUT);
+            }
+            return Result<bool>::error("Failed to receive packet: " + std::string(strerror(errno)));
+        }
+        // Our own transmissions are looped back to packet sockets; skip them
+    } while (sender_addr.sll_pkttype == PACKET_OUTGOING);
 
     // Filter for gPTP packets
-    if (received < sizeof(EthernetFrame)) {
-        return Result<ReceivedPacket>::error("Packet too short");
+    if (static_cast<size_t>(received) < sizeof(EthernetFrame)) {
+        return Result<bool>::error("Packet too short");
     }
 
-    EthernetFrame* eth_header = reinterpret_cast<EthernetFrame*>(buffer);
+    const EthernetFrame* eth_header = reinterpret_cast<const EthernetFrame*>(buffer);
     if (ntohs(eth_header->etherType) != protocol::GPTP_ETHERTYPE) {
-        return Result<ReceivedPacket>::error("Not a gPTP packet");
+        return Result<bool>::error("Not a gPTP packet");
+    }
+
+    // Reset everything but the payload's capacity
+    received_packet.timestamp = PacketTimestamp();
+    received_packet.interface_name = interface_name_;
+
+    // Kernel timestamps arrive as control messages
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+        if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+            struct scm_timestamping ts{};
+            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            // ts[0] = software, ts[2] = raw hardware
+            if (is_set(ts.ts[2])) {
+                received_packet.timestamp.hardware_timestamp =
+                    to_duration(ts.ts[2]) - std::chrono::nanoseconds(latency_.ingress_ns);
+                received_packet.timestamp.source = TimestampSource::HARDWARE;
+            }
+            if (is_set(ts.ts[0])) {
+                received_packet.timestamp.software_timestamp = to_duration(ts.ts[0]);
+                received_packet.timestamp.software_timestamp_valid = true;
+            }
+        } else if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts{};
+            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            received_packet.timestamp.software_timestamp = to_duration(ts);
+            received_packet.timestamp.software_timestamp_valid = true;
+        }
+    }
+    if (received_packet.timestamp.source == TimestampSource::NONE &&
+        received_packet.timestamp.software_timestamp_valid) {
+        received_packet.timestamp.source = TimestampSource::KERNEL_SOFTWARE;
+    }
+
+    // Last resort: userspace receive time
+    if (!received_packet.timestamp.is_valid()) {
+        received_packet.timestamp.software_timestamp = std::chrono::nanoseconds(get_clock_source().now_realtime_ns());
+        received_packet.timestamp.software_timestamp_valid = true;
+        received_packet.timestamp.source = TimestampSource::USERSPACE;
     }
 
-    // Create received packet
-    ReceivedPacket received_packet;
-    
-    // Set timestamp
-    auto now = std::chrono::high_resolution_clock::now();
-    received_packet.timestamp.hardware_timestamp = 
-        std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
-    received_packet.timestamp.is_hardware_timestamp = hardware_timestamping_available_;
-    
     // Copy Ethernet header
     std::memcpy(&received_packet.packet.ethernet, buffer, sizeof(EthernetFrame));
-    
+
     // Copy payload
-    size_t payload_size = received - sizeof(EthernetFrame);
-    if (payload_size > 0) {
-        received_packet.packet.payload.resize(payload_size);
-        std::memcpy(received_packet.packet.payload.data(),
-                   buffer + sizeof(EthernetFrame), payload_size);
-    }
+    received_packet.packet.payload.assign(buffer + sizeof(EthernetFrame), buffer + received);
 
-    return Result<ReceivedPacket>::success(received_packet);
+    return Result<bool>::success(true);
 }
 
 Result<bool> LinuxSocket::start_async_receive(PacketCallback callback) {
@@ -232,6 +364,10 @@ bool LinuxSocket::is_hardware_timestamping_available() const {
     return hardware_timestamping_available_;
 }
 
+TimestampSource LinuxSocket::get_timestamp_mode() const {
+    return timestamp_mode_;
+}
+
 Result<std::array<uint8_t, 6>> LinuxSocket::get_interface_mac() const {
     return Result<std::array<uint8_t, 6>>::success(mac_address_);
 }
@@ -270,6 +406,8 @@ bool LinuxSocket::check_hardware_timestamping() {
     ifr.ifr_data = reinterpret_cast<char*>(&ts_info);
 
     if (ioctl(raw_socket_, SIOCETHTOOL, &ifr) == 0) {
+        phc_index_ = ts_info.phc_index;
+        timestamping_caps_ = ts_info.so_timestamping;
         // Check if hardware timestamping is supported
         return (ts_info.so_timestamping & SOF_TIMESTAMPING_TX_HARDWARE) &&
                (ts_info.so_timestamping & SOF_TIMESTAMPING_RX_HARDWARE);
@@ -279,19 +417,127 @@ bool LinuxSocket::check_hardware_timestamping() {
 }
 
 bool LinuxSocket::enable_timestamping() {
+    // Ask the driver to timestamp only what gPTP needs, widening if it refuses
+    SocketTimestampIoctl ioctl_layer(raw_socket_);
+    RxFilterSelection selection = RxFilterSelector::apply(ioctl_layer, interface_name_, controller_family_);
+    if (!selection.enabled) {
+        LOG_WARN("⚠️ SIOCSHWTSTAMP failed on {}: {}", interface_name_, strerror(selection.error));
+        return false;
+    }
+    if (selection.applied_filter != selection.requested_filter) {
+        LOG_INFO("  RX filter: {} (requested {})", RxFilterSelector::filter_name(selection.applied_filter),
+                 RxFilterSelector::filter_name(selection.requested_filter));
+    } else {
+        LOG_INFO("  RX filter: {}", RxFilterSelector::filter_name(selection.applied_filter));
+    }
+
+    // Software stamps are requested too, to measure kernel-to-userspace latency
     int timestamping_flags = SOF_TIMESTAMPING_TX_HARDWARE |
                             SOF_TIMESTAMPING_RX_HARDWARE |
-                            SOF_TIMESTAMPING_RAW_HARDWARE;
+                            SOF_TIMESTAMPING_RAW_HARDWARE |
+                            SOF_TIMESTAMPING_RX_SOFTWARE |
+                            SOF_TIMESTAMPING_SOFTWARE |
+                            SOF_TIMESTAMPING_OPT_TSONLY;
 
     if (setsockopt(raw_socket_, SOL_SOCKET, SO_TIMESTAMPING,
                    &timestamping_flags, sizeof(timestamping_flags)) < 0) {
-        std::cout << "⚠️ Failed to enable hardware timestamping, using software timestamps" << std::endl;
+        LOG_WARN("⚠️ Failed to enable hardware timestamping, using software timestamps");
         return false;
     }
 
+    rx_filter_ = selection.applied_filter;
     return true;
 }
 
+bool LinuxSocket::enable_software_timestamping() {
+    // Receive stamps come from the stack for every NIC; transmit stamps
+    // only from drivers that call skb_tx_timestamp(), as ethtool reports
+    bool tx_software = (timestamping_caps_ & SOF_TIMESTAMPING_TX_SOFTWARE) != 0;
+    int timestamping_flags = SOF_TIMESTAMPING_RX_SOFTWARE |
+                            SOF_TIMESTAMPING_SOFTWARE |
+                            SOF_TIMESTAMPING_OPT_TSONLY;
+    if (tx_software) {
+        timestamping_flags |= SOF_TIMESTAMPING_TX_SOFTWARE;
+    }
+
+    if (setsockopt(raw_socket_, SOL_SOCKET, SO_TIMESTAMPING,
+                   &timestamping_flags, sizeof(timestamping_flags)) == 0) {
+        timestamp_mode_ = TimestampSource::KERNEL_SOFTWARE;
+        tx_timestamp_mode_ = tx_software ? TimestampSource::KERNEL_SOFTWARE : TimestampSource::USERSPACE;
+        return true;
+    }
+
+    int enable = 1;
+    if (setsockopt(raw_socket_, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == 0) {
+        timestamp_mode_ = TimestampSource::KERNEL_SOFTWARE;
+        return true;
+    }
+    return false;
+}
+
+bool LinuxSocket::read_tx_timestamp(PacketTimestamp& timestamp) {
+    // The stamp is queued on the socket error queue, which signals POLLERR
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TX_TIMESTAMP_TIMEOUT_MS);
+    while (true) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        struct pollfd pfd{};
+        pfd.fd = raw_socket_;
+        if (poll(&pfd, 1, remaining > 0 ? static_cast<int>(remaining) : 0) <= 0 || !(pfd.revents & POLLERR)) {
+            return false;
+        }
+
+        uint8_t control[256];
+        struct msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(raw_socket_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return false;
+        }
+
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+                continue;
+            }
+            struct scm_timestamping ts{};
+            std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            if (tx_timestamp_mode_ == TimestampSource::HARDWARE && is_set(ts.ts[2])) {
+                timestamp.hardware_timestamp = to_duration(ts.ts[2]) + std::chrono::nanoseconds(latency_.egress_ns);
+                timestamp.source = TimestampSource::HARDWARE;
+                return true;
+            }
+            if (tx_timestamp_mode_ == TimestampSource::KERNEL_SOFTWARE && is_set(ts.ts[0])) {
+                timestamp.software_timestamp = to_duration(ts.ts[0]);
+                timestamp.software_timestamp_valid = true;
+                timestamp.source = TimestampSource::KERNEL_SOFTWARE;
+                return true;
+            }
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+    }
+}
+
+void LinuxSocket::drain_error_queue() {
+    uint8_t control[256];
+    struct msghdr msg{};
+    do {
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+    } while (recvmsg(raw_socket_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) >= 0);
+}
+
+bool LinuxSocket::join_gptp_multicast() {
+    struct packet_mreq mreq{};
+    mreq.mr_ifindex = interface_index_;
+    mreq.mr_type = PACKET_MR_MULTICAST;
+    mreq.mr_alen = ETH_ALEN;
+    std::memcpy(mreq.mr_address, protocol::GPTP_MULTICAST_MAC.data(), ETH_ALEN);
+
+    return setsockopt(raw_socket_, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == 0;
+}
+
 std::string LinuxSocket::get_mac_string() const {
     std::stringstream ss;
     ss << std::hex << std::setfill('0');
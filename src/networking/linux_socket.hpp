@@ -6,6 +6,8 @@
 #pragma once
 
 #include "../../include/gptp_socket.hpp"
+#include "../platform/adapter_latency.hpp"
+#include "../platform/hwtstamp_filter.hpp"
 #include <thread>
 #include <atomic>
 
@@ -31,18 +33,54 @@ public:
     void cleanup() override;
     Result<bool> send_packet(const GptpPacket& packet, PacketTimestamp& timestamp) override;
     Result<ReceivedPacket> receive_packet(uint32_t timeout_ms = 0) override;
+    Result<ReceivedPacket> try_receive_packet() override;
+    Result<bool> try_receive_packet_into(ReceivedPacket& received) override;
+    int get_native_handle() const override;
     Result<bool> start_async_receive(PacketCallback callback) override;
     void stop_async_receive() override;
     bool is_hardware_timestamping_available() const override;
+    TimestampSource get_timestamp_mode() const override;
     Result<std::array<uint8_t, 6>> get_interface_mac() const override;
     std::string get_interface_name() const override;
 
+    /**
+     * @brief Index of the PTP hardware clock behind this interface
+     * @return N for /dev/ptpN, or -1 if the NIC has no PHC
+     */
+    int get_phc_index() const;
+
+    /**
+     * @brief Correct hardware timestamps for the PHY latency of the current link
+     *
+     * Ingress latency is subtracted from RX timestamps and egress latency
+     * added to TX timestamps, moving both to the medium dependent interface.
+     */
+    void set_latency_compensation(const PhyLatency& latency);
+    const PhyLatency& get_latency_compensation() const { return latency_; }
+
+    /**
+     * @brief Controller family used to pick the RX filter; set before initialize()
+     */
+    void set_controller_family(const std::string& family) { controller_family_ = family; }
+
+    /**
+     * @brief RX filter the driver applied, HWTSTAMP_FILTER_NONE without hardware timestamping
+     */
+    int get_rx_filter() const { return rx_filter_; }
+
 private:
     bool initialized_;
     std::string interface_name_;
     std::array<uint8_t, 6> mac_address_;
     bool hardware_timestamping_available_;
+    TimestampSource timestamp_mode_;        // Source of RX timestamps
+    TimestampSource tx_timestamp_mode_;     // Source expected on the error queue, or USERSPACE
+    uint32_t timestamping_caps_;            // SOF_TIMESTAMPING_* reported by ethtool
     int interface_index_;
+    int phc_index_;
+    PhyLatency latency_;
+    std::string controller_family_;
+    int rx_filter_;
     
     // Raw socket
     int raw_socket_;
@@ -56,6 +94,12 @@ private:
     bool get_interface_info();
     bool check_hardware_timestamping();
     bool enable_timestamping();
+    bool enable_software_timestamping();
+    bool join_gptp_multicast();
+    bool read_tx_timestamp(PacketTimestamp& timestamp);
+    void drain_error_queue();
+    Result<ReceivedPacket> read_frame();
+    Result<bool> read_frame(ReceivedPacket& received_packet);
     std::string get_mac_string() const;
 };
 
@@ -0,0 +1,212 @@
+/**
+ * @file metrics_server.cpp
+ * @brief HTTP metrics endpoint on a Unix domain socket and optional loopback TCP
+ */
+
+#include "metrics_server.hpp"
+#include "../utils/logger.hpp"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace gptp {
+
+namespace {
+    constexpr int REQUEST_TIMEOUT_MS = 1000;
+    constexpr size_t MAX_REQUEST_SIZE = 4096;
+
+    void write_all(int fd, const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::send(fd, data, length, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+    }
+
+    void respond(int fd, const char* status, const char* content_type, const std::string& body) {
+        std::string header = std::string("HTTP/1.0 ") + status + "\r\n"
+            "Content-Type: " + content_type + "\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n\r\n";
+        write_all(fd, header.data(), header.size());
+        write_all(fd, body.data(), body.size());
+    }
+}
+
+MetricsServer::MetricsServer()
+    : unix_fd_(-1)
+    , tcp_fd_(-1)
+    , wakeup_fd_(-1)
+    , scrapes_(0) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+Result<bool> MetricsServer::start(const Options& options, Renderer renderer) {
+    stop();
+    options_ = options;
+    renderer_ = std::move(renderer);
+
+    if (!options_.socket_path.empty()) {
+        struct sockaddr_un address{};
+        if (options_.socket_path.size() >= sizeof(address.sun_path)) {
+            return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+        }
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, options_.socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        unix_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        ::unlink(options_.socket_path.c_str()); // Stale socket of a previous run
+        if (unix_fd_ < 0 ||
+            ::bind(unix_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::listen(unix_fd_, 8) < 0) {
+            LOG_WARN("Metrics socket {} unavailable: {}", options_.socket_path, std::strerror(errno));
+            if (unix_fd_ >= 0) {
+                ::close(unix_fd_);
+                unix_fd_ = -1;
+            }
+        } else {
+            ::chmod(options_.socket_path.c_str(), 0660);
+            LOG_INFO("Serving metrics on unix:{}", options_.socket_path);
+        }
+    }
+
+    if (options_.http_port != 0) {
+        struct sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options_.http_port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int reuse = 1;
+        tcp_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (tcp_fd_ >= 0) {
+            ::setsockopt(tcp_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (tcp_fd_ < 0 ||
+            ::bind(tcp_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::listen(tcp_fd_, 8) < 0) {
+            LOG_WARN("Metrics HTTP port {} unavailable: {}", options_.http_port, std::strerror(errno));
+            if (tcp_fd_ >= 0) {
+                ::close(tcp_fd_);
+                tcp_fd_ = -1;
+            }
+        } else {
+            LOG_INFO("Serving metrics on http://127.0.0.1:{}/metrics", options_.http_port);
+        }
+    }
+
+    if (unix_fd_ < 0 && tcp_fd_ < 0) {
+        return Result<bool>::error(ErrorCode::NETWORK_ERROR);
+    }
+
+    wakeup_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeup_fd_ < 0) {
+        stop();
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    thread_ = std::thread(&MetricsServer::run, this);
+    return Result<bool>::success(true);
+}
+
+void MetricsServer::stop() {
+    if (thread_.joinable()) {
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeup_fd_, &one, sizeof(one));
+        (void)ignored;
+        thread_.join();
+    }
+    if (unix_fd_ >= 0) {
+        ::close(unix_fd_);
+        ::unlink(options_.socket_path.c_str());
+        unix_fd_ = -1;
+    }
+    if (tcp_fd_ >= 0) {
+        ::close(tcp_fd_);
+        tcp_fd_ = -1;
+    }
+    if (wakeup_fd_ >= 0) {
+        ::close(wakeup_fd_);
+        wakeup_fd_ = -1;
+    }
+}
+
+void MetricsServer::run() {
+    struct pollfd fds[3] = {
+        {wakeup_fd_, POLLIN, 0},
+        {unix_fd_, POLLIN, 0},      // Negative descriptors are ignored by poll
+        {tcp_fd_, POLLIN, 0},
+    };
+
+    for (;;) {
+        int ready = ::poll(fds, 3, -1);
+        if (ready < 0 && errno != EINTR) {
+            LOG_ERROR("Metrics server poll failed: {}", std::strerror(errno));
+            return;
+        }
+        if (fds[0].revents & POLLIN) {
+            return;
+        }
+        for (int i = 1; i < 3; ++i) {
+            if (fds[i].revents & POLLIN) {
+                int client = ::accept4(fds[i].fd, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client >= 0) {
+                    serve(client);
+                    ::close(client);
+                }
+            }
+        }
+    }
+}
+
+void MetricsServer::serve(int client_fd) {
+    // Read the request head; only the request line matters
+    std::string request;
+    char buffer[512];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        struct pollfd pfd = {client_fd, POLLIN, 0};
+        if (::poll(&pfd, 1, REQUEST_TIMEOUT_MS) <= 0) {
+            return;
+        }
+        ssize_t received = ::recv(client_fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    if (request.compare(0, 4, "GET ") != 0) {
+        respond(client_fd, "405 Method Not Allowed", "text/plain", "GET only\n");
+        return;
+    }
+    size_t path_end = request.find(' ', 4);
+    std::string path = request.substr(4, path_end == std::string::npos ? std::string::npos : path_end - 4);
+    if (path != "/metrics" && path != "/") {
+        respond(client_fd, "404 Not Found", "text/plain", "try /metrics\n");
+        return;
+    }
+
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+    respond(client_fd, "200 OK", "text/plain; version=0.0.4", renderer_());
+}
+
+} // namespace gptp
+
+#endif // __linux__
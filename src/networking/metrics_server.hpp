@@ -0,0 +1,66 @@
+/**
+ * @file metrics_server.hpp
+ * @brief HTTP metrics endpoint on a Unix domain socket and optional loopback TCP
+ *
+ * Runs on its own thread; the renderer is invoked there for every scrape
+ * and must only read lock-free state. Query with e.g.
+ *   curl --unix-socket /run/gptp-metrics.sock http://localhost/metrics
+ */
+
+#pragma once
+
+#include "../../include/gptp_types.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+
+namespace gptp {
+
+class MetricsServer {
+public:
+    using Renderer = std::function<std::string()>;
+
+    struct Options {
+        std::string socket_path;        // Empty disables the Unix socket
+        uint16_t http_port = 0;         // 0 disables loopback TCP
+    };
+
+    MetricsServer();
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Bind the listeners and start the server thread
+     * @return Result indicating success or error (no listener could be opened)
+     */
+    Result<bool> start(const Options& options, Renderer renderer);
+
+    /**
+     * @brief Stop the thread and close the listeners
+     */
+    void stop();
+
+    bool is_running() const { return thread_.joinable(); }
+    uint64_t get_scrape_count() const { return scrapes_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void serve(int client_fd);
+
+    Options options_;
+    Renderer renderer_;
+    int unix_fd_;
+    int tcp_fd_;
+    int wakeup_fd_;
+    std::thread thread_;
+    std::atomic<uint64_t> scrapes_;
+};
+
+} // namespace gptp
+
+#endif // __linux__
@@ -0,0 +1,86 @@
+/**
+ * @file recording_socket.cpp
+ * @brief IGptpSocket decorator that captures every frame to pcapng
+ */
+
+#include "recording_socket.hpp"
+#include "../../include/clock_source.hpp"
+
+namespace gptp {
+
+RecordingSocket::RecordingSocket(std::unique_ptr<IGptpSocket> inner, std::shared_ptr<capture::PcapngWriter> writer)
+    : inner_(std::move(inner))
+    , writer_(std::move(writer))
+    , interface_id_(0)
+    , interface_registered_(false) {
+}
+
+RecordingSocket::~RecordingSocket() = default;
+
+Result<bool> RecordingSocket::initialize(const std::string& interface_name) {
+    auto result = inner_->initialize(interface_name);
+    if (result.is_success()) {
+        get_capture_interface();
+    }
+    return result;
+}
+
+void RecordingSocket::cleanup() {
+    inner_->cleanup();
+    if (writer_) {
+        writer_->flush();
+    }
+}
+
+Result<bool> RecordingSocket::send_packet(const GptpPacket& packet, PacketTimestamp& timestamp) {
+    auto result = inner_->send_packet(packet, timestamp);
+    if (result.is_success()) {
+        record(capture::Direction::OUTBOUND, packet, timestamp);
+    }
+    return result;
+}
+
+Result<ReceivedPacket> RecordingSocket::receive_packet(uint32_t timeout_ms) {
+    auto result = inner_->receive_packet(timeout_ms);
+    if (result.is_success()) {
+        record(capture::Direction::INBOUND, result.value().packet, result.value().timestamp);
+    }
+    return result;
+}
+
+Result<ReceivedPacket> RecordingSocket::try_receive_packet() {
+    auto result = inner_->try_receive_packet();
+    if (result.is_success()) {
+        record(capture::Direction::INBOUND, result.value().packet, result.value().timestamp);
+    }
+    return result;
+}
+
+Result<bool> RecordingSocket::start_async_receive(PacketCallback callback) {
+    return inner_->start_async_receive([this, callback](const ReceivedPacket& received) {
+        record(capture::Direction::INBOUND, received.packet, received.timestamp);
+        callback(received);
+    });
+}
+
+uint32_t RecordingSocket::get_capture_interface() {
+    if (!interface_registered_ && writer_) {
+        auto mac = inner_->get_interface_mac();
+        interface_id_ = writer_->add_interface(inner_->get_interface_name(),
+                                               mac.is_success() ? mac.value() : std::array<uint8_t, 6>{});
+        interface_registered_ = true;
+    }
+    return interface_id_;
+}
+
+void RecordingSocket::record(capture::Direction direction, const GptpPacket& packet,
+                             const PacketTimestamp& timestamp) {
+    if (!writer_) {
+        return;
+    }
+    int64_t timestamp_ns = timestamp.is_valid() ? timestamp.get_best_timestamp().count()
+                                                : get_clock_source().now_realtime_ns();
+    writer_->write(get_capture_interface(), timestamp_ns, direction, packet);
+}
+
+} // namespace gptp
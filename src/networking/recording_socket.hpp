@@ -0,0 +1,59 @@
+/**
+ * @file recording_socket.hpp
+ * @brief IGptpSocket decorator that captures every frame to pcapng
+ */
+
+#pragma once
+
+#include "../../include/gptp_socket.hpp"
+#include "../utils/pcapng.hpp"
+#include <memory>
+
+namespace gptp {
+
+/**
+ * @brief Records RX and TX frames of another socket with their timestamps
+ *
+ * Frames are written with the timestamp the stack sees: the RX timestamp
+ * of received frames and the TX timestamp returned by send_packet(), so a
+ * capture replays with the same measurements. Frames without a valid
+ * timestamp are written with the CLOCK_REALTIME time of the call.
+ */
+class RecordingSocket : public IGptpSocket {
+public:
+    RecordingSocket(std::unique_ptr<IGptpSocket> inner, std::shared_ptr<capture::PcapngWriter> writer);
+    ~RecordingSocket() override;
+
+    RecordingSocket(const RecordingSocket&) = delete;
+    RecordingSocket& operator=(const RecordingSocket&) = delete;
+
+    Result<bool> initialize(const std::string& interface_name) override;
+    void cleanup() override;
+    Result<bool> send_packet(const GptpPacket& packet, PacketTimestamp& timestamp) override;
+    Result<ReceivedPacket> receive_packet(uint32_t timeout_ms = 0) override;
+    Result<ReceivedPacket> try_receive_packet() override;
+    int get_native_handle() const override { return inner_->get_native_handle(); }
+    Result<bool> start_async_receive(PacketCallback callback) override;
+    void stop_async_receive() override { inner_->stop_async_receive(); }
+    bool is_hardware_timestamping_available() const override { return inner_->is_hardware_timestamping_available(); }
+    TimestampSource get_timestamp_mode() const override { return inner_->get_timestamp_mode(); }
+    Result<std::array<uint8_t, 6>> get_interface_mac() const override { return inner_->get_interface_mac(); }
+    std::string get_interface_name() const override { return inner_->get_interface_name(); }
+
+    /**
+     * @brief Interface id in the capture; registers the interface on first use
+     */
+    uint32_t get_capture_interface();
+
+    IGptpSocket& inner() { return *inner_; }
+
+private:
+    void record(capture::Direction direction, const GptpPacket& packet, const PacketTimestamp& timestamp);
+
+    std::unique_ptr<IGptpSocket> inner_;
+    std::shared_ptr<capture::PcapngWriter> writer_;
+    uint32_t interface_id_;
+    bool interface_registered_;
+};
+
+} // namespace gptp
@@ -236,10 +236,11 @@ Result<bool> WindowsSocket::send_packet(const GptpPacket& packet, PacketTimestam
         return Result<bool>::error("Socket not initialized");
     }
 
-    // Record transmission time
+    // Record transmission time (userspace approximation)
     auto now = std::chrono::high_resolution_clock::now();
-    timestamp.hardware_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
-    timestamp.is_hardware_timestamp = hardware_timestamping_available_;
+    timestamp.software_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
+    timestamp.software_timestamp_valid = true;
+    timestamp.source = TimestampSource::USERSPACE;
 
 #ifdef HAVE_WPCAP
     if (pcap_handle_) {
@@ -294,9 +295,10 @@ Result<ReceivedPacket> WindowsSocket::receive_packet(uint32_t timeout_ms) {
         
         // Set timestamp
         auto now = std::chrono::high_resolution_clock::now();
-        received_packet.timestamp.hardware_timestamp = 
+        received_packet.timestamp.software_timestamp = 
             std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
-        received_packet.timestamp.is_hardware_timestamp = hardware_timestamping_available_;
+        received_packet.timestamp.software_timestamp_valid = true;
+        received_packet.timestamp.source = TimestampSource::USERSPACE;
         
         // Copy packet data
         received_packet.packet.payload.resize(header->caplen - sizeof(EthernetFrame));
@@ -332,9 +334,10 @@ Result<ReceivedPacket> WindowsSocket::receive_packet(uint32_t timeout_ms) {
         
         // Set timestamp
         auto now = std::chrono::high_resolution_clock::now();
-        received_packet.timestamp.hardware_timestamp = 
+        received_packet.timestamp.software_timestamp = 
             std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
-        received_packet.timestamp.is_hardware_timestamp = false;
+        received_packet.timestamp.software_timestamp_valid = true;
+        received_packet.timestamp.source = TimestampSource::USERSPACE;
         
         // Copy data
         received_packet.packet.payload.resize(received);
@@ -383,6 +386,11 @@ bool WindowsSocket::is_hardware_timestamping_available() const {
     return hardware_timestamping_available_;
 }
 
+TimestampSource WindowsSocket::get_timestamp_mode() const {
+    // Packets are stamped after capture/send returns, whatever the NIC supports
+    return TimestampSource::USERSPACE;
+}
+
 Result<std::array<uint8_t, 6>> WindowsSocket::get_interface_mac() const {
     return Result<std::array<uint8_t, 6>>::success(mac_address_);
 }
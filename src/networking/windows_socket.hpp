@@ -35,6 +35,7 @@ public:
     Result<bool> start_async_receive(PacketCallback callback) override;
     void stop_async_receive() override;
     bool is_hardware_timestamping_available() const override;
+    TimestampSource get_timestamp_mode() const override;
     Result<std::array<uint8_t, 6>> get_interface_mac() const override;
     std::string get_interface_name() const override;
 
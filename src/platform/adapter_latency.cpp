@@ -0,0 +1,79 @@
+/**
+ * @file adapter_latency.cpp
+ * @brief PHY ingress/egress latency compensation per controller family and link speed
+ */
+
+#include "adapter_latency.hpp"
+
+namespace gptp {
+
+AdapterLatencyTable AdapterLatencyTable::with_defaults() {
+    AdapterLatencyTable table;
+
+    // I210 datasheet PHY latencies, applied by igb (IGB_I210_*_LATENCY_*)
+    table.set_builtin("I210", 10, 20662, 9542, "igb");
+    table.set_builtin("I210", 100, 2213, 1024, "igb");
+    table.set_builtin("I210", 1000, 448, 178, "igb");
+
+    // I225/I226 PHY latencies, applied by igc (IGC_I225_*_LATENCY_*)
+    for (const char* family : {"I225", "I226"}) {
+        table.set_builtin(family, 10, 6450, 240, "igc");
+        table.set_builtin(family, 100, 185, 58, "igc");
+        table.set_builtin(family, 1000, 300, 80, "igc");
+        table.set_builtin(family, 2500, 1485, 1325, "igc");
+    }
+
+    // I219, I350 and E810 have no published figures; measure and configure them
+    return table;
+}
+
+void AdapterLatencyTable::set(const std::string& name, uint32_t speed_mbps, const PhyLatency& latency) {
+    Entry entry;
+    entry.latency = latency;
+    entries_[{name, speed_mbps}] = entry;
+}
+
+void AdapterLatencyTable::set_builtin(const std::string& family, uint32_t speed_mbps,
+                                      int64_t ingress_ns, int64_t egress_ns, const std::string& driver) {
+    Entry entry;
+    entry.latency.ingress_ns = ingress_ns;
+    entry.latency.egress_ns = egress_ns;
+    entry.applied_by_driver = driver;
+    entries_[{family, speed_mbps}] = entry;
+}
+
+const AdapterLatencyTable::Entry* AdapterLatencyTable::find(const std::string& name, uint32_t speed_mbps) const {
+    if (name.empty()) {
+        return nullptr;
+    }
+    auto it = entries_.find({name, speed_mbps});
+    if (it == entries_.end()) {
+        it = entries_.find({name, ANY_SPEED});
+    }
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+PhyLatency AdapterLatencyTable::lookup(const std::string& interface_name, const std::string& family,
+                                       const std::string& driver, uint32_t speed_mbps,
+                                       std::string* applied_by) const {
+    if (applied_by) {
+        applied_by->clear();
+    }
+    const Entry* entry = find(interface_name, speed_mbps);
+    if (!entry) {
+        entry = find(family, speed_mbps);
+    }
+    if (!entry) {
+        return PhyLatency{};
+    }
+    // An unknown driver is assumed to be the in-tree one
+    if (!entry->applied_by_driver.empty() && (driver.empty() || entry->applied_by_driver == driver)) {
+        if (applied_by) {
+            *applied_by = entry->applied_by_driver;
+        }
+        return PhyLatency{};
+    }
+    return entry->latency;
+}
+
+} // namespace gptp
@@ -0,0 +1,82 @@
+/**
+ * @file adapter_latency.hpp
+ * @brief PHY ingress/egress latency compensation per controller family and link speed
+ *
+ * Hardware timestamps are taken between the MAC and the PHY, while
+ * IEEE 802.1AS defines them at the medium dependent interface. The fixed
+ * PHY delay in each direction depends on the controller and the link
+ * speed and appears as a constant offset between unlike NICs unless the
+ * timestamps are corrected: ingress latency is subtracted from RX
+ * timestamps, egress latency is added to TX timestamps.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace gptp {
+
+/**
+ * @brief Fixed PHY latencies of one link, ns
+ */
+struct PhyLatency {
+    int64_t ingress_ns = 0;
+    int64_t egress_ns = 0;
+
+    bool is_zero() const { return ingress_ns == 0 && egress_ns == 0; }
+};
+
+/**
+ * @brief Latency table keyed by controller family or interface name and speed
+ *
+ * Built-in entries come from controller datasheets. Some in-tree drivers
+ * already apply those values in the kernel; such entries name the driver
+ * and are skipped while it (or an unidentified driver) is bound, so the
+ * correction is never applied twice. Entries added with set() are
+ * measured residuals and always apply.
+ */
+class AdapterLatencyTable {
+public:
+    static constexpr uint32_t ANY_SPEED = 0;
+
+    /**
+     * @brief Table with the built-in controller family entries
+     */
+    static AdapterLatencyTable with_defaults();
+
+    /**
+     * @brief Add or replace an entry
+     * @param name Controller family (I210, I225, ...) or interface name
+     * @param speed_mbps Link speed, or ANY_SPEED for all speeds
+     */
+    void set(const std::string& name, uint32_t speed_mbps, const PhyLatency& latency);
+
+    /**
+     * @brief Latency to compensate in user space for one link
+     *
+     * Interface entries win over family entries, exact speeds over ANY_SPEED.
+     * @param applied_by Set to the driver that already compensates, if any
+     */
+    PhyLatency lookup(const std::string& interface_name, const std::string& family,
+                      const std::string& driver, uint32_t speed_mbps,
+                      std::string* applied_by = nullptr) const;
+
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        PhyLatency latency;
+        std::string applied_by_driver;      // Empty unless the kernel driver compensates itself
+    };
+
+    void set_builtin(const std::string& family, uint32_t speed_mbps, int64_t ingress_ns, int64_t egress_ns,
+                     const std::string& driver);
+    const Entry* find(const std::string& name, uint32_t speed_mbps) const;
+
+    std::map<std::pair<std::string, uint32_t>, Entry> entries_;
+};
+
+} // namespace gptp
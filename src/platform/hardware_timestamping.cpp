@@ -7,6 +7,7 @@
  */
 
 #include "../../include/gptp_protocol.hpp"
+#include "hwtstamp_filter.hpp"
 #include <chrono>
 #include <memory>
 #include <string>
@@ -25,8 +26,21 @@
 #include <linux/ptp_clock.h>
 #include <linux/sockios.h>
 #include <linux/ethtool.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/timex.h>
 #include <net/if.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ctime>
+
+// Dynamic POSIX clock id for an open /dev/ptpN descriptor (see clock_gettime(2))
+#ifndef FD_TO_CLOCKID
+#define FD_TO_CLOCKID(fd) ((~(clockid_t)(fd) << 3) | 3)
+#endif
 #endif
 
 namespace gptp {
@@ -228,9 +242,9 @@ public:
             return HardwareTimestamp(seconds.count(), nanoseconds.count());
         }
         
-        struct ptp_clock_time ptp_time = {};
-        if (ioctl(ptp_fd_, PTP_CLOCK_GETTIME, &ptp_time) == 0) {
-            return HardwareTimestamp(ptp_time.sec, ptp_time.nsec);
+        struct timespec ptp_time = {};
+        if (clock_gettime(FD_TO_CLOCKID(ptp_fd_), &ptp_time) == 0) {
+            return HardwareTimestamp(ptp_time.tv_sec, ptp_time.tv_nsec);
         }
         
         return HardwareTimestamp(); // Failed to get hardware time
@@ -243,11 +257,16 @@ public:
         
         // Adjust clock offset
         if (offset_ns != 0) {
-            struct ptp_clock_time offset = {};
-            offset.sec = offset_ns / 1000000000LL;
-            offset.nsec = offset_ns % 1000000000LL;
+            struct timex offset = {};
+            offset.modes = ADJ_SETOFFSET | ADJ_NANO;
+            offset.time.tv_sec = offset_ns / 1000000000LL;
+            offset.time.tv_usec = offset_ns % 1000000000LL;
+            if (offset.time.tv_usec < 0) {
+                offset.time.tv_sec -= 1;
+                offset.time.tv_usec += 1000000000LL;
+            }
             
-            if (ioctl(ptp_fd_, PTP_CLOCK_ADJTIME, &offset) != 0) {
+            if (clock_adjtime(FD_TO_CLOCKID(ptp_fd_), &offset) < 0) {
                 std::cerr << "Failed to adjust clock offset" << std::endl;
                 return false;
             }
@@ -259,7 +278,7 @@ public:
             tx.modes = ADJ_FREQUENCY;
             tx.freq = static_cast<long>(freq_adjustment_ppb * 65.536); // Convert ppb to Linux frequency units
             
-            if (adjtimex(&tx) != 0) {
+            if (clock_adjtime(FD_TO_CLOCKID(ptp_fd_), &tx) < 0) {
                 std::cerr << "Failed to adjust clock frequency" << std::endl;
                 return false;
             }
@@ -269,23 +288,33 @@ public:
     }
     
     bool enable_timestamping(bool enable) override {
+        if (enable) {
+            gptp::SocketTimestampIoctl ioctl_layer(socket_fd_);
+            gptp::RxFilterSelection selection = gptp::RxFilterSelector::apply(ioctl_layer, interface_name_, "");
+            if (!selection.enabled) {
+                std::cerr << "Failed to enable hardware timestamping on " << interface_name_ << std::endl;
+                return false;
+            }
+            std::cout << "Hardware timestamping enabled on " << interface_name_ << " (rx filter "
+                      << gptp::RxFilterSelector::filter_name(selection.applied_filter) << ")" << std::endl;
+            return true;
+        }
+
         struct ifreq ifr = {};
         strncpy(ifr.ifr_name, interface_name_.c_str(), IFNAMSIZ - 1);
         
         struct hwtstamp_config config = {};
-        config.tx_type = enable ? HWTSTAMP_TX_ON : HWTSTAMP_TX_OFF;
-        config.rx_filter = enable ? HWTSTAMP_FILTER_PTP_V2_EVENT : HWTSTAMP_FILTER_NONE;
+        config.tx_type = HWTSTAMP_TX_OFF;
+        config.rx_filter = HWTSTAMP_FILTER_NONE;
         
         ifr.ifr_data = reinterpret_cast<char*>(&config);
         
         if (ioctl(socket_fd_, SIOCSHWTSTAMP, &ifr) != 0) {
-            std::cerr << "Failed to " << (enable ? "enable" : "disable") 
-                      << " hardware timestamping on " << interface_name_ << std::endl;
+            std::cerr << "Failed to disable hardware timestamping on " << interface_name_ << std::endl;
             return false;
         }
         
-        std::cout << "Hardware timestamping " << (enable ? "enabled" : "disabled") 
-                  << " on " << interface_name_ << std::endl;
+        std::cout << "Hardware timestamping disabled on " << interface_name_ << std::endl;
         return true;
     }
     
@@ -300,11 +329,12 @@ private:
         
         if (ioctl(socket_fd_, SIOCETHTOOL, &ifr) == 0) {
             capabilities_.tx_hardware_timestamping = (ts_info.tx_types & (1 << HWTSTAMP_TX_ON)) != 0;
-            capabilities_.rx_hardware_timestamping = (ts_info.rx_filters & (1 << HWTSTAMP_FILTER_PTP_V2_EVENT)) != 0;
-            capabilities_.pps_output = (ts_info.ptp_caps & PTP_ENABLE_FEATURE) != 0;
+            capabilities_.rx_hardware_timestamping =
+                ts_info.rx_filters != 0 && !gptp::RxFilterSelector::candidates(ts_info.rx_filters, "").empty();
             
             if (ts_info.phc_index >= 0) {
                 capabilities_.ptp_clock_device = "/dev/ptp" + std::to_string(ts_info.phc_index);
+                query_ptp_clock_caps();
             }
             
             return true;
@@ -312,6 +342,21 @@ private:
         
         return false;
     }
+    
+    void query_ptp_clock_caps() {
+        int fd = open(capabilities_.ptp_clock_device.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        
+        struct ptp_clock_caps caps = {};
+        if (ioctl(fd, PTP_CLOCK_GETCAPS, &caps) == 0) {
+            capabilities_.pps_output = caps.n_per_out > 0;
+            capabilities_.pps_input = caps.n_ext_ts > 0;
+            capabilities_.cross_timestamping = caps.cross_timestamping != 0;
+        }
+        close(fd);
+    }
 };
 #endif // __linux__
 
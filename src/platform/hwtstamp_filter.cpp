@@ -0,0 +1,127 @@
+/**
+ * @file hwtstamp_filter.cpp
+ * @brief Selection of the narrowest hardware RX timestamp filter
+ */
+
+#include "hwtstamp_filter.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <linux/sockios.h>
+
+namespace gptp {
+
+namespace {
+    bool advertises(uint32_t rx_filters, int filter) {
+        return (rx_filters & (1u << filter)) != 0;
+    }
+
+    void set_ifname(struct ifreq& ifr, const std::string& interface_name) {
+        std::memset(&ifr, 0, sizeof(ifr));
+        std::strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+    }
+}
+
+int SocketTimestampIoctl::get_ts_info(const std::string& interface_name, struct ethtool_ts_info& info) {
+    std::memset(&info, 0, sizeof(info));
+    info.cmd = ETHTOOL_GET_TS_INFO;
+
+    struct ifreq ifr;
+    set_ifname(ifr, interface_name);
+    ifr.ifr_data = reinterpret_cast<char*>(&info);
+    return ioctl(socket_fd_, SIOCETHTOOL, &ifr) < 0 ? errno : 0;
+}
+
+int SocketTimestampIoctl::set_hwtstamp(const std::string& interface_name, struct hwtstamp_config& config) {
+    struct ifreq ifr;
+    set_ifname(ifr, interface_name);
+    ifr.ifr_data = reinterpret_cast<char*>(&config);
+    return ioctl(socket_fd_, SIOCSHWTSTAMP, &ifr) < 0 ? errno : 0;
+}
+
+std::vector<int> RxFilterSelector::candidates(uint32_t rx_filters, const std::string& controller_family) {
+    if (rx_filters == 0) {
+        // Older drivers leave rx_filters empty; E810 (ice) only implements ALL,
+        // the Intel 1G/2.5G families implement the PTPv2 event filters
+        if (controller_family == "E810") {
+            rx_filters = 1u << HWTSTAMP_FILTER_ALL;
+        } else if (!controller_family.empty()) {
+            rx_filters = (1u << HWTSTAMP_FILTER_PTP_V2_L2_EVENT) | (1u << HWTSTAMP_FILTER_PTP_V2_EVENT) |
+                         (1u << HWTSTAMP_FILTER_ALL);
+        } else {
+            rx_filters = (1u << HWTSTAMP_FILTER_PTP_V2_EVENT) | (1u << HWTSTAMP_FILTER_ALL);
+        }
+    }
+
+    std::vector<int> filters;
+    for (int filter : {HWTSTAMP_FILTER_PTP_V2_L2_EVENT, HWTSTAMP_FILTER_PTP_V2_EVENT, HWTSTAMP_FILTER_ALL}) {
+        if (advertises(rx_filters, filter)) {
+            filters.push_back(filter);
+        }
+    }
+    return filters;
+}
+
+RxFilterSelection RxFilterSelector::apply(ITimestampIoctl& ioctl, const std::string& interface_name,
+                                          const std::string& controller_family) {
+    RxFilterSelection selection;
+
+    struct ethtool_ts_info info;
+    uint32_t rx_filters = ioctl.get_ts_info(interface_name, info) == 0 ? info.rx_filters : 0;
+
+    std::vector<int> filters = candidates(rx_filters, controller_family);
+    if (filters.empty()) {
+        selection.error = ERANGE;
+        return selection;
+    }
+
+    for (int filter : filters) {
+        struct hwtstamp_config config;
+        std::memset(&config, 0, sizeof(config));
+        config.tx_type = HWTSTAMP_TX_ON;
+        config.rx_filter = filter;
+
+        int error = ioctl.set_hwtstamp(interface_name, config);
+        if (error == 0) {
+            selection.enabled = true;
+            selection.requested_filter = filter;
+            selection.applied_filter = config.rx_filter;
+            selection.error = 0;
+            return selection;
+        }
+        selection.error = error;
+        // Only an unsupported filter is worth retrying with a wider one
+        if (error != ERANGE && error != EINVAL) {
+            break;
+        }
+    }
+    return selection;
+}
+
+const char* RxFilterSelector::filter_name(int filter) {
+    switch (filter) {
+        case HWTSTAMP_FILTER_NONE: return "none";
+        case HWTSTAMP_FILTER_ALL: return "all";
+        case HWTSTAMP_FILTER_SOME: return "some";
+        case HWTSTAMP_FILTER_PTP_V1_L4_EVENT: return "ptp_v1_l4_event";
+        case HWTSTAMP_FILTER_PTP_V1_L4_SYNC: return "ptp_v1_l4_sync";
+        case HWTSTAMP_FILTER_PTP_V1_L4_DELAY_REQ: return "ptp_v1_l4_delay_req";
+        case HWTSTAMP_FILTER_PTP_V2_L4_EVENT: return "ptp_v2_l4_event";
+        case HWTSTAMP_FILTER_PTP_V2_L4_SYNC: return "ptp_v2_l4_sync";
+        case HWTSTAMP_FILTER_PTP_V2_L4_DELAY_REQ: return "ptp_v2_l4_delay_req";
+        case HWTSTAMP_FILTER_PTP_V2_L2_EVENT: return "ptp_v2_l2_event";
+        case HWTSTAMP_FILTER_PTP_V2_L2_SYNC: return "ptp_v2_l2_sync";
+        case HWTSTAMP_FILTER_PTP_V2_L2_DELAY_REQ: return "ptp_v2_l2_delay_req";
+        case HWTSTAMP_FILTER_PTP_V2_EVENT: return "ptp_v2_event";
+        case HWTSTAMP_FILTER_PTP_V2_SYNC: return "ptp_v2_sync";
+        case HWTSTAMP_FILTER_PTP_V2_DELAY_REQ: return "ptp_v2_delay_req";
+        default: return "unknown";
+    }
+}
+
+} // namespace gptp
+
+#endif // __linux__
@@ -0,0 +1,93 @@
+/**
+ * @file hwtstamp_filter.hpp
+ * @brief Selection of the narrowest hardware RX timestamp filter
+ *
+ * gPTP only needs receive timestamps on layer 2 PTPv2 event messages.
+ * Asking the NIC for more (PTP over UDP, or every frame) costs timestamp
+ * logic and, on controllers with a small timestamp FIFO or a single
+ * latch, lets unrelated frames evict the ones that matter.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/ethtool.h>
+#include <linux/net_tstamp.h>
+
+namespace gptp {
+
+/**
+ * @brief Timestamping ioctls of one interface; replaceable in tests
+ */
+class ITimestampIoctl {
+public:
+    virtual ~ITimestampIoctl() = default;
+
+    /**
+     * @brief ETHTOOL_GET_TS_INFO
+     * @return 0 or an errno value
+     */
+    virtual int get_ts_info(const std::string& interface_name, struct ethtool_ts_info& info) = 0;
+
+    /**
+     * @brief SIOCSHWTSTAMP; the driver writes back the filter it applied
+     * @return 0 or an errno value
+     */
+    virtual int set_hwtstamp(const std::string& interface_name, struct hwtstamp_config& config) = 0;
+};
+
+/**
+ * @brief ITimestampIoctl on a socket descriptor (not owned)
+ */
+class SocketTimestampIoctl : public ITimestampIoctl {
+public:
+    explicit SocketTimestampIoctl(int socket_fd) : socket_fd_(socket_fd) {}
+
+    int get_ts_info(const std::string& interface_name, struct ethtool_ts_info& info) override;
+    int set_hwtstamp(const std::string& interface_name, struct hwtstamp_config& config) override;
+
+private:
+    int socket_fd_;
+};
+
+/**
+ * @brief Outcome of configuring hardware timestamping
+ */
+struct RxFilterSelection {
+    bool enabled = false;
+    int requested_filter = HWTSTAMP_FILTER_NONE;
+    int applied_filter = HWTSTAMP_FILTER_NONE;     // As reported back by the driver; may be wider
+    int error = 0;                                  // errno of the last attempt when !enabled
+};
+
+/**
+ * @brief Picks and applies the narrowest RX filter that covers gPTP
+ */
+class RxFilterSelector {
+public:
+    /**
+     * @brief Filters to try, narrowest first
+     *
+     * Uses the filters the driver advertises. Drivers that report none
+     * get the known capabilities of their controller family instead.
+     * @param rx_filters Bit per HWTSTAMP_FILTER_* from ethtool_ts_info
+     * @param controller_family I210, I350, E810, ...; empty if unknown
+     */
+    static std::vector<int> candidates(uint32_t rx_filters, const std::string& controller_family);
+
+    /**
+     * @brief Enable TX and RX hardware timestamping with the narrowest accepted filter
+     */
+    static RxFilterSelection apply(ITimestampIoctl& ioctl, const std::string& interface_name,
+                                   const std::string& controller_family);
+
+    static const char* filter_name(int filter);
+};
+
+} // namespace gptp
+
+#endif // __linux__
@@ -2,12 +2,15 @@
 
 #ifdef __linux__
 
+#include "linux_netlink_discovery.hpp"
+#include "../utils/configuration.hpp"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <cstring>
 #include <unistd.h>
 #include <dirent.h>
+#include <linux/net_tstamp.h>
 
 namespace gptp {
 
@@ -120,23 +123,22 @@ namespace gptp {
         }
 
         std::vector<LinuxIntelAdapterInfo> adapters;
-        
-        struct ifaddrs *ifaddr;
-        if (getifaddrs(&ifaddr) == -1) {
-            return Result<std::vector<LinuxIntelAdapterInfo>>(ErrorCode::NETWORK_ERROR);
+
+        // One netlink dump lists every link with its timestamping capabilities
+        NetlinkInterfaceDiscovery discovery;
+        discovery.set_cache_path(Configuration::instance().network.interface_cache_path);
+        auto links_result = discovery.discover();
+        if (links_result.has_error()) {
+            return Result<std::vector<LinuxIntelAdapterInfo>>(links_result.error());
         }
 
-        for (struct ifaddrs *ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
-            if (ifa->ifa_addr == nullptr || ifa->ifa_addr->sa_family != AF_INET) {
+        for (const auto& link : links_result.value()) {
+            // Only physical Ethernet devices sit on a PCI bus
+            if (!link.is_ethernet || !link.kind.empty() || (link.flags & IFF_LOOPBACK)) {
                 continue;
             }
 
-            std::string interface_name = ifa->ifa_name;
-            
-            // Skip loopback interface
-            if (interface_name == "lo") {
-                continue;
-            }
+            const std::string& interface_name = link.name;
 
             auto pci_info_result = get_pci_info_from_sysfs(interface_name);
             if (pci_info_result.has_error()) {
@@ -172,20 +174,15 @@ namespace gptp {
                     adapter_info.supports_802_1as = (adapter_info.controller_family != "I210");
                 }
 
-                // Get ethtool timestamping capabilities
-                auto ts_info_result = get_ethtool_ts_info(interface_name);
-                if (ts_info_result.is_success()) {
-                    const auto& ts_info = ts_info_result.value();
-                    adapter_info.supports_so_timestamping = (ts_info.so_timestamping != 0);
-                    adapter_info.supports_raw_hardware_timestamp = 
-                        (ts_info.so_timestamping & SOF_TIMESTAMPING_RAW_HARDWARE) != 0;
-                }
+                // Timestamping capabilities came with the discovery dump
+                adapter_info.supports_so_timestamping = (link.timestamping.so_timestamping != 0);
+                adapter_info.supports_raw_hardware_timestamp = 
+                    (link.timestamping.so_timestamping & SOF_TIMESTAMPING_RAW_HARDWARE) != 0;
 
                 adapters.push_back(adapter_info);
             }
         }
 
-        freeifaddrs(ifaddr);
         return Result<std::vector<LinuxIntelAdapterInfo>>(adapters);
     }
 
@@ -337,6 +334,32 @@ namespace gptp {
             ));
     }
 
+    Result<uint32_t> LinuxAdapterDetector::get_link_speed_mbps(const InterfaceName& interface_name) {
+        if (socket_fd_ < 0) {
+            return Result<uint32_t>(ErrorCode::INITIALIZATION_FAILED);
+        }
+
+        struct ethtool_cmd cmd;
+        struct ifreq ifr;
+
+        memset(&cmd, 0, sizeof(cmd));
+        memset(&ifr, 0, sizeof(ifr));
+
+        cmd.cmd = ETHTOOL_GSET;
+        strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+        ifr.ifr_data = reinterpret_cast<char*>(&cmd);
+
+        if (ioctl(socket_fd_, SIOCETHTOOL, &ifr) < 0) {
+            return Result<uint32_t>(ErrorCode::NETWORK_ERROR);
+        }
+
+        uint32_t speed = ethtool_cmd_speed(&cmd);
+        if (speed == 0 || speed == static_cast<uint32_t>(SPEED_UNKNOWN)) {
+            return Result<uint32_t>(ErrorCode::NETWORK_ERROR);
+        }
+        return Result<uint32_t>(speed);
+    }
+
     Result<struct ethtool_ts_info> LinuxAdapterDetector::get_ethtool_ts_info(
         const InterfaceName& interface_name) {
         
@@ -87,6 +87,13 @@ namespace gptp {
          */
         TimestampCapabilities get_intel_timestamp_capabilities(const LinuxIntelAdapterInfo& adapter_info);
 
+        /**
+         * @brief Get the negotiated link speed using ethtool
+         * @param interface_name Network interface name
+         * @return Speed in Mb/s, or an error while the link is down
+         */
+        Result<uint32_t> get_link_speed_mbps(const InterfaceName& interface_name);
+
     private:
         bool initialized_;
         int socket_fd_;
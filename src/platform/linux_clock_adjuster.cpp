@@ -0,0 +1,104 @@
+/**
+ * @file linux_clock_adjuster.cpp
+ * @brief Linux clock adjustment via clock_adjtime(2)
+ */
+
+#include "linux_clock_adjuster.hpp"
+
+#ifdef __linux__
+#include <sys/timex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+// Dynamic POSIX clock id for an open /dev/ptpN descriptor (see clock_gettime(2))
+#ifndef FD_TO_CLOCKID
+#define FD_TO_CLOCKID(fd) ((~(clockid_t)(fd) << 3) | 3)
+#endif
+
+namespace gptp {
+
+namespace {
+    // struct timex frequency is ppm with a 16-bit fractional part
+    constexpr double PPB_TO_SCALED_PPM = 65.536;
+    constexpr double MAX_FREQUENCY_PPB = 500000.0;
+}
+
+LinuxClockAdjuster::LinuxClockAdjuster(int phc_index)
+    : phc_index_(phc_index)
+    , phc_fd_(-1)
+    , clock_id_(CLOCK_REALTIME) {
+}
+
+LinuxClockAdjuster::~LinuxClockAdjuster() {
+    if (phc_fd_ >= 0) {
+        close(phc_fd_);
+    }
+}
+
+Result<bool> LinuxClockAdjuster::initialize() {
+    if (phc_index_ < 0) {
+        clock_id_ = CLOCK_REALTIME;
+        return Result<bool>::success(true);
+    }
+
+    std::string device = "/dev/ptp" + std::to_string(phc_index_);
+    phc_fd_ = open(device.c_str(), O_RDWR);
+    if (phc_fd_ < 0) {
+        return Result<bool>::error(errno == EACCES ? ErrorCode::INSUFFICIENT_PRIVILEGES
+                                                   : ErrorCode::INITIALIZATION_FAILED);
+    }
+    clock_id_ = FD_TO_CLOCKID(phc_fd_);
+    return Result<bool>::success(true);
+}
+
+Result<bool> LinuxClockAdjuster::adjust_frequency(double ppb) {
+    if (ppb > MAX_FREQUENCY_PPB) ppb = MAX_FREQUENCY_PPB;
+    if (ppb < -MAX_FREQUENCY_PPB) ppb = -MAX_FREQUENCY_PPB;
+
+    struct timex tx{};
+    tx.modes = ADJ_FREQUENCY;
+    tx.freq = static_cast<long>(ppb * PPB_TO_SCALED_PPM);
+
+    if (clock_adjtime(clock_id_, &tx) < 0) {
+        return Result<bool>::error(errno == EPERM ? ErrorCode::INSUFFICIENT_PRIVILEGES
+                                                  : ErrorCode::NETWORK_ERROR);
+    }
+    return Result<bool>::success(true);
+}
+
+Result<bool> LinuxClockAdjuster::step_clock(std::chrono::nanoseconds offset) {
+    int64_t offset_ns = offset.count();
+
+    struct timex tx{};
+    tx.modes = ADJ_SETOFFSET | ADJ_NANO;
+    tx.time.tv_sec = offset_ns / 1000000000LL;
+    tx.time.tv_usec = offset_ns % 1000000000LL; // nanoseconds with ADJ_NANO
+    if (tx.time.tv_usec < 0) {
+        tx.time.tv_sec -= 1;
+        tx.time.tv_usec += 1000000000LL;
+    }
+
+    if (clock_adjtime(clock_id_, &tx) < 0) {
+        return Result<bool>::error(errno == EPERM ? ErrorCode::INSUFFICIENT_PRIVILEGES
+                                                  : ErrorCode::NETWORK_ERROR);
+    }
+    return Result<bool>::success(true);
+}
+
+std::string LinuxClockAdjuster::get_name() const {
+    return phc_index_ < 0 ? std::string("CLOCK_REALTIME") : "/dev/ptp" + std::to_string(phc_index_);
+}
+
+std::unique_ptr<LinuxClockAdjuster> LinuxClockAdjuster::create(int phc_index) {
+    auto adjuster = std::make_unique<LinuxClockAdjuster>(phc_index);
+    if (adjuster->initialize().has_error()) {
+        return nullptr;
+    }
+    return adjuster;
+}
+
+} // namespace gptp
+
+#endif // __linux__
@@ -0,0 +1,61 @@
+/**
+ * @file linux_clock_adjuster.hpp
+ * @brief Linux clock adjustment via clock_adjtime(2)
+ */
+
+#pragma once
+
+#include "../../include/clock_adjuster.hpp"
+#include <memory>
+
+#ifdef __linux__
+#include <ctime>
+
+namespace gptp {
+
+/**
+ * @brief Disciplines a PTP hardware clock (/dev/ptpN) or CLOCK_REALTIME
+ */
+class LinuxClockAdjuster : public IClockAdjuster {
+public:
+    /**
+     * @param phc_index N for /dev/ptpN, or -1 for the system clock
+     */
+    explicit LinuxClockAdjuster(int phc_index);
+    ~LinuxClockAdjuster() override;
+
+    LinuxClockAdjuster(const LinuxClockAdjuster&) = delete;
+    LinuxClockAdjuster& operator=(const LinuxClockAdjuster&) = delete;
+
+    /**
+     * @brief Open the clock device
+     * @return Result indicating success or error
+     */
+    Result<bool> initialize();
+
+    Result<bool> adjust_frequency(double ppb) override;
+    Result<bool> step_clock(std::chrono::nanoseconds offset) override;
+    std::string get_name() const override;
+
+    /**
+     * @brief Clock to read the disciplined time from (dynamic PHC clock id or CLOCK_REALTIME)
+     */
+    clockid_t get_clock_id() const { return clock_id_; }
+    int get_phc_index() const { return phc_index_; }
+
+    /**
+     * @brief Create and initialize an adjuster
+     * @param phc_index N for /dev/ptpN, or -1 for the system clock
+     * @return Adjuster, or nullptr if the clock cannot be opened
+     */
+    static std::unique_ptr<LinuxClockAdjuster> create(int phc_index);
+
+private:
+    int phc_index_;
+    int phc_fd_;
+    clockid_t clock_id_;
+};
+
+} // namespace gptp
+
+#endif // __linux__
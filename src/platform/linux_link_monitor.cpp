@@ -0,0 +1,229 @@
+/**
+ * @file linux_link_monitor.cpp
+ * @brief Event-driven link state monitoring via rtnetlink (RTNLGRP_LINK)
+ */
+
+#include "linux_link_monitor.hpp"
+#include "../utils/logger.hpp"
+
+#ifdef __linux__
+
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace gptp {
+
+namespace {
+    constexpr size_t RECEIVE_BUFFER_SIZE = 16384;
+}
+
+bool LinkStateEvent::is_running() const {
+    return !removed && (flags & IFF_UP) && (flags & IFF_RUNNING);
+}
+
+LinuxLinkMonitor::LinuxLinkMonitor()
+    : fd_(-1)
+    , sequence_(0)
+    , dump_sequence_(0)
+    , dump_wanted_(false)
+    , buffer_(RECEIVE_BUFFER_SIZE) {
+}
+
+LinuxLinkMonitor::~LinuxLinkMonitor() {
+    close();
+}
+
+Result<bool> LinuxLinkMonitor::open() {
+    if (fd_ >= 0) {
+        return Result<bool>::success(true);
+    }
+
+    fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd_ < 0) {
+        LOG_ERROR("Failed to create link monitor socket: {}", std::strerror(errno));
+        return Result<bool>::error(ErrorCode::NETWORK_ERROR);
+    }
+
+    struct sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK;
+    if (bind(fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0) {
+        LOG_ERROR("Failed to join RTNLGRP_LINK: {}", std::strerror(errno));
+        close();
+        return Result<bool>::error(ErrorCode::NETWORK_ERROR);
+    }
+
+    return Result<bool>::success(true);
+}
+
+void LinuxLinkMonitor::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    dump_sequence_ = 0;
+    dump_wanted_ = false;
+}
+
+Result<bool> LinuxLinkMonitor::request_dump() {
+    if (fd_ < 0) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    struct {
+        struct nlmsghdr header;
+        struct ifinfomsg info;
+    } request{};
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    request.header.nlmsg_type = RTM_GETLINK;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    if (++sequence_ == 0) {
+        ++sequence_; // 0 means "no dump in flight"
+    }
+    request.header.nlmsg_seq = sequence_;
+    request.info.ifi_family = AF_UNSPEC;
+
+    struct sockaddr_nl kernel{};
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(fd_, &request, request.header.nlmsg_len, 0,
+               reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        LOG_WARN("Link dump request failed: {}", std::strerror(errno));
+        dump_wanted_ = true;
+        return Result<bool>::error(ErrorCode::NETWORK_ERROR);
+    }
+    dump_sequence_ = sequence_;
+    dump_wanted_ = false;
+    return Result<bool>::success(true);
+}
+
+void LinuxLinkMonitor::retry_dump() {
+    if (fd_ >= 0 && dump_wanted_ && dump_sequence_ == 0) {
+        request_dump();
+    }
+}
+
+void LinuxLinkMonitor::handle_completion(const NetlinkCompletion& completion) {
+    if (dump_sequence_ == 0 || completion.sequence != dump_sequence_) {
+        return;
+    }
+    dump_sequence_ = 0;
+    if (completion.error != 0) {
+        // EBUSY: another dump on this socket is still running; ask again
+        // once it has drained
+        LOG_DEBUG("Link dump {} failed: {}", completion.sequence, std::strerror(-completion.error));
+        dump_wanted_ = true;
+    }
+}
+
+size_t LinuxLinkMonitor::process_events(const EventCallback& callback) {
+    size_t delivered = 0;
+    std::vector<LinkStateEvent> events;
+    std::vector<NetlinkCompletion> completions;
+
+    while (fd_ >= 0) {
+        ssize_t received = recv(fd_, buffer_.data(), buffer_.size(), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS) {
+                // Notifications were lost, possibly parts of a dump in flight
+                // too; a fresh dump is owed once the current one finishes
+                LOG_WARN("Link monitor overrun, requesting link dump");
+                dump_wanted_ = true;
+                if (dump_sequence_ == 0) {
+                    request_dump();
+                }
+                continue;
+            }
+            break; // EAGAIN: drained
+        }
+
+        events.clear();
+        completions.clear();
+        if (!parse_messages(buffer_.data(), static_cast<size_t>(received), events, &completions)) {
+            LOG_WARN("Malformed link notification ({} bytes)", received);
+        }
+        for (const auto& event : events) {
+            callback(event);
+            ++delivered;
+        }
+        for (const auto& completion : completions) {
+            handle_completion(completion);
+        }
+    }
+
+    // A dump refused or superseded while draining is requested again now
+    retry_dump();
+
+    return delivered;
+}
+
+bool LinuxLinkMonitor::parse_messages(const uint8_t* data, size_t length, std::vector<LinkStateEvent>& events,
+                                      std::vector<NetlinkCompletion>* completions) {
+    while (length >= NLMSG_HDRLEN) {
+        const auto* header = reinterpret_cast<const struct nlmsghdr*>(data);
+        if (header->nlmsg_len < NLMSG_HDRLEN || header->nlmsg_len > length) {
+            return false;
+        }
+
+        if ((header->nlmsg_type == RTM_NEWLINK || header->nlmsg_type == RTM_DELLINK) &&
+            header->nlmsg_len >= NLMSG_LENGTH(sizeof(struct ifinfomsg))) {
+            const auto* info = reinterpret_cast<const struct ifinfomsg*>(NLMSG_DATA(header));
+
+            LinkStateEvent event;
+            event.ifindex = info->ifi_index;
+            event.flags = info->ifi_flags;
+            event.removed = header->nlmsg_type == RTM_DELLINK;
+
+            const auto* attr = reinterpret_cast<const uint8_t*>(IFLA_RTA(info));
+            size_t attr_length = header->nlmsg_len - NLMSG_LENGTH(sizeof(struct ifinfomsg));
+            while (attr_length >= RTA_LENGTH(0)) {
+                const auto* rta = reinterpret_cast<const struct rtattr*>(attr);
+                if (rta->rta_len < RTA_LENGTH(0) || rta->rta_len > attr_length) {
+                    break;
+                }
+                if (rta->rta_type == IFLA_IFNAME) {
+                    const char* name = static_cast<const char*>(RTA_DATA(rta));
+                    event.name.assign(name, strnlen(name, RTA_PAYLOAD(rta)));
+                }
+                size_t step = RTA_ALIGN(rta->rta_len);
+                if (step >= attr_length) {
+                    break;
+                }
+                attr += step;
+                attr_length -= step;
+            }
+
+            events.push_back(std::move(event));
+        } else if (completions && (header->nlmsg_type == NLMSG_DONE || header->nlmsg_type == NLMSG_ERROR)) {
+            // NLMSG_ERROR carries struct nlmsgerr; a dump's NLMSG_DONE may
+            // carry an int error as well. Both start with the errno.
+            NetlinkCompletion completion;
+            completion.sequence = header->nlmsg_seq;
+            if (header->nlmsg_len >= NLMSG_LENGTH(sizeof(int))) {
+                std::memcpy(&completion.error, NLMSG_DATA(header), sizeof(int));
+            } else if (header->nlmsg_type == NLMSG_ERROR) {
+                completion.error = -EPROTO;
+            }
+            completions->push_back(completion);
+        }
+
+        size_t step = NLMSG_ALIGN(header->nlmsg_len);
+        if (step >= length) {
+            break;
+        }
+        data += step;
+        length -= step;
+    }
+    return true;
+}
+
+} // namespace gptp
+
+#endif // __linux__
@@ -0,0 +1,126 @@
+/**
+ * @file linux_link_monitor.hpp
+ * @brief Event-driven link state monitoring via rtnetlink (RTNLGRP_LINK)
+ */
+
+#pragma once
+
+#include "../../include/gptp_types.hpp"
+
+#ifdef __linux__
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace gptp {
+
+/**
+ * @brief One link state notification (RTM_NEWLINK / RTM_DELLINK)
+ */
+struct LinkStateEvent {
+    int ifindex = 0;
+    std::string name;
+    unsigned int flags = 0;     // IFF_* flags
+    bool removed = false;       // RTM_DELLINK
+
+    /**
+     * @brief Carrier present on an administratively up link
+     */
+    bool is_running() const;
+};
+
+/**
+ * @brief Completion of a netlink request (NLMSG_DONE or NLMSG_ERROR)
+ */
+struct NetlinkCompletion {
+    uint32_t sequence = 0;
+    int error = 0;              // negative errno, 0 on success
+};
+
+/**
+ * @brief Subscribes to kernel link notifications instead of polling carrier state
+ *
+ * The socket is non-blocking and meant to be registered with an event loop;
+ * call process_events() when it becomes readable. If the kernel drops
+ * notifications (receive buffer overrun) a full link dump is requested so
+ * the state converges again. The dump is tracked by sequence number and
+ * requested again until one completes (the kernel refuses a second dump
+ * with EBUSY while one is still running).
+ */
+class LinuxLinkMonitor {
+public:
+    using EventCallback = std::function<void(const LinkStateEvent&)>;
+
+    LinuxLinkMonitor();
+    ~LinuxLinkMonitor();
+
+    LinuxLinkMonitor(const LinuxLinkMonitor&) = delete;
+    LinuxLinkMonitor& operator=(const LinuxLinkMonitor&) = delete;
+
+    /**
+     * @brief Open the netlink socket and join the link multicast group
+     * @return Result indicating success or error
+     */
+    Result<bool> open();
+
+    /**
+     * @brief Close the socket
+     */
+    void close();
+
+    /**
+     * @brief File descriptor to poll for readability, or -1 if not open
+     */
+    int get_native_handle() const { return fd_; }
+
+    /**
+     * @brief Ask the kernel for the current state of all links
+     *
+     * The replies arrive as ordinary events through process_events(). If the
+     * request cannot be sent it stays owed and is retried by retry_dump().
+     */
+    Result<bool> request_dump();
+
+    /**
+     * @brief Request the owed link dump if none is in flight
+     *
+     * Meant for a periodic timer, so a resync whose request failed is not
+     * stalled until the next notification arrives.
+     */
+    void retry_dump();
+
+    /**
+     * @brief True while a full dump is owed or in flight
+     */
+    bool dump_pending() const { return dump_wanted_ || dump_sequence_ != 0; }
+
+    /**
+     * @brief Drain pending notifications
+     * @param callback Invoked once per link message
+     * @return Number of link events delivered
+     */
+    size_t process_events(const EventCallback& callback);
+
+    /**
+     * @brief Decode a buffer of netlink messages into link events
+     * @param completions If set, receives NLMSG_DONE / NLMSG_ERROR replies
+     * @return false if the buffer is malformed
+     */
+    static bool parse_messages(const uint8_t* data, size_t length, std::vector<LinkStateEvent>& events,
+                               std::vector<NetlinkCompletion>* completions = nullptr);
+
+private:
+    void handle_completion(const NetlinkCompletion& completion);
+
+    int fd_;
+    uint32_t sequence_;
+    uint32_t dump_sequence_;    // dump in flight, 0 if none
+    bool dump_wanted_;          // a dump is owed but not yet sent
+    std::vector<uint8_t> buffer_;
+};
+
+} // namespace gptp
+
+#endif // __linux__
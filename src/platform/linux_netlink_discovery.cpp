@@ -0,0 +1,596 @@
+/**
+ * @file linux_netlink_discovery.cpp
+ * @brief Interface and timestamping capability discovery via rtnetlink and ethtool netlink
+ */
+
+#include "linux_netlink_discovery.hpp"
+#include "../utils/logger.hpp"
+
+#ifdef __linux__
+
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/genetlink.h>
+#include <linux/ethtool.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#if __has_include(<linux/ethtool_netlink.h>)
+#include <linux/ethtool_netlink.h>
+#define GPTP_HAVE_ETHTOOL_NETLINK 1
+#endif
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+namespace gptp {
+
+namespace {
+    constexpr size_t RECEIVE_BUFFER_SIZE = 32768;
+    constexpr const char* CACHE_MAGIC = "gptp-ifcache";
+    constexpr int CACHE_VERSION = 1;
+
+    uint32_t read_u32(const uint8_t* data, size_t length) {
+        uint32_t value = 0;
+        std::memcpy(&value, data, std::min(length, sizeof(value)));
+        return value;
+    }
+
+    /**
+     * @brief Walk netlink attributes (struct nlattr and struct rtattr share a layout)
+     */
+    template<typename Handler>
+    void for_each_attribute(const uint8_t* data, size_t length, Handler&& handler) {
+        while (length >= NLA_HDRLEN) {
+            const auto* attr = reinterpret_cast<const struct nlattr*>(data);
+            if (attr->nla_len < NLA_HDRLEN || attr->nla_len > length) {
+                return;
+            }
+            handler(static_cast<uint16_t>(attr->nla_type & NLA_TYPE_MASK),
+                    data + NLA_HDRLEN, static_cast<size_t>(attr->nla_len - NLA_HDRLEN));
+
+            size_t step = NLA_ALIGN(attr->nla_len);
+            if (step >= length) {
+                return;
+            }
+            data += step;
+            length -= step;
+        }
+    }
+
+    /**
+     * @brief Builder for a single netlink request message
+     */
+    class NetlinkRequest {
+    public:
+        NetlinkRequest(uint16_t type, uint16_t flags) : buffer_(NLMSG_HDRLEN, 0) {
+            header()->nlmsg_type = type;
+            header()->nlmsg_flags = flags;
+        }
+
+        template<typename T>
+        void append(const T& fixed_header) {
+            size_t offset = buffer_.size();
+            buffer_.resize(offset + NLMSG_ALIGN(sizeof(T)), 0);
+            std::memcpy(buffer_.data() + offset, &fixed_header, sizeof(T));
+        }
+
+        void put_attribute(uint16_t type, const void* data, size_t length) {
+            struct nlattr attr{};
+            attr.nla_type = type;
+            attr.nla_len = static_cast<uint16_t>(NLA_HDRLEN + length);
+
+            size_t offset = buffer_.size();
+            buffer_.resize(offset + NLA_ALIGN(attr.nla_len), 0);
+            std::memcpy(buffer_.data() + offset, &attr, sizeof(attr));
+            if (length > 0) {
+                std::memcpy(buffer_.data() + offset + NLA_HDRLEN, data, length);
+            }
+        }
+
+        size_t begin_nested(uint16_t type) {
+            size_t offset = buffer_.size();
+            put_attribute(static_cast<uint16_t>(type | NLA_F_NESTED), nullptr, 0);
+            return offset;
+        }
+
+        void end_nested(size_t offset) {
+            auto* attr = reinterpret_cast<struct nlattr*>(buffer_.data() + offset);
+            attr->nla_len = static_cast<uint16_t>(buffer_.size() - offset);
+        }
+
+        struct nlmsghdr* header() {
+            return reinterpret_cast<struct nlmsghdr*>(buffer_.data());
+        }
+
+        std::vector<uint8_t>& finish(uint32_t sequence) {
+            header()->nlmsg_len = static_cast<uint32_t>(buffer_.size());
+            header()->nlmsg_seq = sequence;
+            return buffer_;
+        }
+
+    private:
+        std::vector<uint8_t> buffer_;
+    };
+
+    /**
+     * @brief RAII netlink socket performing request/response exchanges
+     */
+    class NetlinkSocket {
+    public:
+        explicit NetlinkSocket(int protocol)
+            : fd_(socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, protocol))
+            , sequence_(0)
+            , buffer_(RECEIVE_BUFFER_SIZE) {
+        }
+
+        ~NetlinkSocket() {
+            if (fd_ >= 0) {
+                close(fd_);
+            }
+        }
+
+        NetlinkSocket(const NetlinkSocket&) = delete;
+        NetlinkSocket& operator=(const NetlinkSocket&) = delete;
+
+        bool is_open() const { return fd_ >= 0; }
+
+        /**
+         * @brief Send a request and pass every reply message to the handler
+         * @return false on socket errors or a netlink error reply (errno is set)
+         */
+        template<typename Handler>
+        bool transact(NetlinkRequest& request, Handler&& handler) {
+            const auto& bytes = request.finish(++sequence_);
+
+            struct sockaddr_nl kernel{};
+            kernel.nl_family = AF_NETLINK;
+            if (sendto(fd_, bytes.data(), bytes.size(), 0,
+                       reinterpret_cast<struct sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+                return false;
+            }
+
+            while (true) {
+                ssize_t received = recv(fd_, buffer_.data(), buffer_.size(), 0);
+                if (received < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+
+                bool multipart = false;
+                int remaining = static_cast<int>(received);
+                for (auto* message = reinterpret_cast<struct nlmsghdr*>(buffer_.data());
+                     NLMSG_OK(message, remaining);
+                     message = NLMSG_NEXT(message, remaining)) {
+                    if (message->nlmsg_seq != sequence_) {
+                        continue;
+                    }
+                    if (message->nlmsg_type == NLMSG_DONE) {
+                        return true;
+                    }
+                    if (message->nlmsg_type == NLMSG_ERROR) {
+                        const auto* error = reinterpret_cast<const struct nlmsgerr*>(NLMSG_DATA(message));
+                        if (error->error != 0) {
+                            errno = -error->error;
+                            return false;
+                        }
+                        return true;
+                    }
+                    multipart = (message->nlmsg_flags & NLM_F_MULTI) != 0;
+                    handler(message);
+                }
+
+                if (!multipart) {
+                    return true;
+                }
+            }
+        }
+
+    private:
+        int fd_;
+        uint32_t sequence_;
+        std::vector<uint8_t> buffer_;
+    };
+
+#ifdef GPTP_HAVE_ETHTOOL_NETLINK
+    /**
+     * @brief First word of a compact ethtool bitset (all tsinfo bitsets fit in 32 bits)
+     */
+    uint32_t read_compact_bitset(const uint8_t* data, size_t length) {
+        uint32_t value = 0;
+        for_each_attribute(data, length, [&](uint16_t type, const uint8_t* payload, size_t payload_length) {
+            if (type == ETHTOOL_A_BITSET_VALUE) {
+                value = read_u32(payload, payload_length);
+            }
+        });
+        return value;
+    }
+#endif
+}
+
+// ============================================================================
+// NetlinkInterfaceDiscovery Implementation
+// ============================================================================
+
+NetlinkInterfaceDiscovery::NetlinkInterfaceDiscovery() = default;
+
+void NetlinkInterfaceDiscovery::set_cache_path(const std::string& path) {
+    cache_path_ = path;
+}
+
+Result<std::vector<LinkRecord>> NetlinkInterfaceDiscovery::discover() {
+    auto start = std::chrono::steady_clock::now();
+    stats_ = DiscoveryStats();
+
+    auto links_result = dump_links();
+    if (links_result.has_error()) {
+        return links_result;
+    }
+    std::vector<LinkRecord> links = links_result.value();
+    stats_.links = links.size();
+
+    load_cache(links);
+
+    bool missing = std::any_of(links.begin(), links.end(),
+                               [](const LinkRecord& link) { return !link.timestamping.valid; });
+    if (missing) {
+        std::map<int, LinkTimestampInfo> info_by_index;
+        bool have_dump = dump_timestamping(info_by_index);
+
+        for (auto& link : links) {
+            if (link.timestamping.valid) {
+                continue;
+            }
+            auto it = have_dump ? info_by_index.find(link.ifindex) : info_by_index.end();
+            if (it != info_by_index.end()) {
+                link.timestamping = it->second;
+            } else {
+                query_timestamping_ioctl(link.name, link.timestamping);
+            }
+            // Only real replies are valid and cached; a failed query (driver
+            // still probing, transient error) is asked again on the next run
+            if (!link.timestamping.valid) {
+                LOG_DEBUG("No timestamping information for {} yet", link.name);
+            }
+        }
+
+        save_cache(links);
+    }
+
+    stats_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    LOG_DEBUG("Discovered {} links in {}us ({} cached, {} netlink requests, {} ioctls)",
+              stats_.links, stats_.elapsed.count(), stats_.cached,
+              stats_.netlink_requests, stats_.ioctl_queries);
+
+    return Result<std::vector<LinkRecord>>::success(std::move(links));
+}
+
+Result<LinkTimestampInfo> NetlinkInterfaceDiscovery::query_timestamping(const std::string& interface_name) {
+    LinkTimestampInfo info;
+    if (!query_timestamping_ioctl(interface_name, info)) {
+        return Result<LinkTimestampInfo>::error(errno == ENODEV ? ErrorCode::INTERFACE_NOT_FOUND
+                                                                : ErrorCode::TIMESTAMPING_NOT_SUPPORTED);
+    }
+    return Result<LinkTimestampInfo>::success(info);
+}
+
+Result<std::vector<LinkRecord>> NetlinkInterfaceDiscovery::dump_links() {
+    NetlinkSocket socket(NETLINK_ROUTE);
+    if (!socket.is_open()) {
+        return Result<std::vector<LinkRecord>>::error(ErrorCode::NETWORK_ERROR);
+    }
+
+    NetlinkRequest request(RTM_GETLINK, NLM_F_REQUEST | NLM_F_DUMP);
+    struct ifinfomsg link_request{};
+    link_request.ifi_family = AF_UNSPEC;
+    request.append(link_request);
+#ifdef RTEXT_FILTER_SKIP_STATS
+    // Statistics make up most of each reply; we never look at them
+    uint32_t ext_mask = RTEXT_FILTER_SKIP_STATS;
+    request.put_attribute(IFLA_EXT_MASK, &ext_mask, sizeof(ext_mask));
+#endif
+
+    std::vector<LinkRecord> links;
+    stats_.netlink_requests++;
+    bool ok = socket.transact(request, [&links](const struct nlmsghdr* message) {
+        if (message->nlmsg_type != RTM_NEWLINK) {
+            return;
+        }
+        const auto* info = reinterpret_cast<const struct ifinfomsg*>(NLMSG_DATA(message));
+        size_t header_length = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+        if (message->nlmsg_len < header_length) {
+            return;
+        }
+
+        LinkRecord link;
+        link.ifindex = info->ifi_index;
+        link.flags = info->ifi_flags;
+        link.is_ethernet = (info->ifi_type == ARPHRD_ETHER);
+
+        const auto* attributes = reinterpret_cast<const uint8_t*>(message) + NLMSG_ALIGN(header_length);
+        for_each_attribute(attributes, message->nlmsg_len - NLMSG_ALIGN(header_length),
+            [&link](uint16_t type, const uint8_t* payload, size_t length) {
+                switch (type) {
+                    case IFLA_IFNAME:
+                        link.name.assign(reinterpret_cast<const char*>(payload), strnlen(reinterpret_cast<const char*>(payload), length));
+                        break;
+                    case IFLA_ADDRESS:
+                        if (length == link.mac.size()) {
+                            std::memcpy(link.mac.data(), payload, length);
+                        }
+                        break;
+                    case IFLA_LINKINFO:
+                        for_each_attribute(payload, length, [&link](uint16_t info_type, const uint8_t* data, size_t data_length) {
+                            if (info_type == IFLA_INFO_KIND) {
+                                link.kind.assign(reinterpret_cast<const char*>(data), strnlen(reinterpret_cast<const char*>(data), data_length));
+                            }
+                        });
+                        break;
+                    default:
+                        break;
+                }
+            });
+
+        if (!link.name.empty()) {
+            links.push_back(std::move(link));
+        }
+    });
+
+    if (!ok) {
+        LOG_ERROR("RTM_GETLINK dump failed: {}", std::strerror(errno));
+        return Result<std::vector<LinkRecord>>::error(ErrorCode::NETWORK_ERROR);
+    }
+
+    std::sort(links.begin(), links.end(),
+              [](const LinkRecord& a, const LinkRecord& b) { return a.ifindex < b.ifindex; });
+    return Result<std::vector<LinkRecord>>::success(std::move(links));
+}
+
+bool NetlinkInterfaceDiscovery::dump_timestamping(std::map<int, LinkTimestampInfo>& info_by_index) {
+#ifdef GPTP_HAVE_ETHTOOL_NETLINK
+    NetlinkSocket socket(NETLINK_GENERIC);
+    if (!socket.is_open()) {
+        return false;
+    }
+
+    // Resolve the ethtool generic netlink family
+    NetlinkRequest family_request(GENL_ID_CTRL, NLM_F_REQUEST);
+    struct genlmsghdr control{};
+    control.cmd = CTRL_CMD_GETFAMILY;
+    control.version = 1;
+    family_request.append(control);
+    family_request.put_attribute(CTRL_ATTR_FAMILY_NAME, ETHTOOL_GENL_NAME, sizeof(ETHTOOL_GENL_NAME));
+
+    uint16_t family_id = 0;
+    stats_.netlink_requests++;
+    bool ok = socket.transact(family_request, [&family_id](const struct nlmsghdr* message) {
+        const auto* attributes = reinterpret_cast<const uint8_t*>(NLMSG_DATA(message)) + GENL_HDRLEN;
+        for_each_attribute(attributes, message->nlmsg_len - NLMSG_HDRLEN - GENL_HDRLEN,
+            [&family_id](uint16_t type, const uint8_t* payload, size_t length) {
+                if (type == CTRL_ATTR_FAMILY_ID && length >= sizeof(uint16_t)) {
+                    std::memcpy(&family_id, payload, sizeof(uint16_t));
+                }
+            });
+    });
+    if (!ok || family_id == 0) {
+        LOG_DEBUG("ethtool netlink unavailable, falling back to SIOCETHTOOL");
+        return false;
+    }
+
+    // One dump returns timestamping information for every device
+    NetlinkRequest tsinfo_request(family_id, NLM_F_REQUEST | NLM_F_DUMP);
+    struct genlmsghdr command{};
+    command.cmd = ETHTOOL_MSG_TSINFO_GET;
+    command.version = ETHTOOL_GENL_VERSION;
+    tsinfo_request.append(command);
+    size_t header = tsinfo_request.begin_nested(ETHTOOL_A_TSINFO_HEADER);
+    uint32_t flags = ETHTOOL_FLAG_COMPACT_BITSETS;
+    tsinfo_request.put_attribute(ETHTOOL_A_HEADER_FLAGS, &flags, sizeof(flags));
+    tsinfo_request.end_nested(header);
+
+    stats_.netlink_requests++;
+    ok = socket.transact(tsinfo_request, [&info_by_index](const struct nlmsghdr* message) {
+        int ifindex = 0;
+        LinkTimestampInfo info;
+        info.valid = true;
+
+        const auto* attributes = reinterpret_cast<const uint8_t*>(NLMSG_DATA(message)) + GENL_HDRLEN;
+        for_each_attribute(attributes, message->nlmsg_len - NLMSG_HDRLEN - GENL_HDRLEN,
+            [&](uint16_t type, const uint8_t* payload, size_t length) {
+                switch (type) {
+                    case ETHTOOL_A_TSINFO_HEADER:
+                        for_each_attribute(payload, length, [&ifindex](uint16_t header_type, const uint8_t* data, size_t data_length) {
+                            if (header_type == ETHTOOL_A_HEADER_DEV_INDEX) {
+                                ifindex = static_cast<int>(read_u32(data, data_length));
+                            }
+                        });
+                        break;
+                    case ETHTOOL_A_TSINFO_TIMESTAMPING:
+                        info.so_timestamping = read_compact_bitset(payload, length);
+                        break;
+                    case ETHTOOL_A_TSINFO_TX_TYPES:
+                        info.tx_types = read_compact_bitset(payload, length);
+                        break;
+                    case ETHTOOL_A_TSINFO_RX_FILTERS:
+                        info.rx_filters = read_compact_bitset(payload, length);
+                        break;
+                    case ETHTOOL_A_TSINFO_PHC_INDEX:
+                        info.phc_index = static_cast<int>(read_u32(payload, length));
+                        break;
+                    default:
+                        break;
+                }
+            });
+
+        if (ifindex == 0) {
+            return;
+        }
+        // Newer kernels report one entry per timestamp provider; prefer the one with a PHC
+        auto it = info_by_index.find(ifindex);
+        if (it == info_by_index.end() || (it->second.phc_index < 0 && info.phc_index >= 0)) {
+            info_by_index[ifindex] = info;
+        }
+    });
+
+    if (!ok) {
+        LOG_DEBUG("ETHTOOL_MSG_TSINFO_GET dump failed: {}", std::strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    (void)info_by_index;
+    return false;
+#endif
+}
+
+bool NetlinkInterfaceDiscovery::query_timestamping_ioctl(const std::string& interface_name, LinkTimestampInfo& info) {
+    if (interface_name.empty() || interface_name.length() >= IFNAMSIZ) {
+        errno = EINVAL;
+        return false;
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct ethtool_ts_info ts_info{};
+    ts_info.cmd = ETHTOOL_GET_TS_INFO;
+    struct ifreq ifr{};
+    std::strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+    ifr.ifr_data = reinterpret_cast<char*>(&ts_info);
+
+    stats_.ioctl_queries++;
+    int result = ioctl(fd, SIOCETHTOOL, &ifr);
+    int saved_errno = errno;
+    close(fd);
+    if (result < 0) {
+        errno = saved_errno;
+        return false;
+    }
+
+    info.so_timestamping = ts_info.so_timestamping;
+    info.tx_types = ts_info.tx_types;
+    info.rx_filters = ts_info.rx_filters;
+    info.phc_index = ts_info.phc_index;
+    info.valid = true;
+    return true;
+}
+
+// ============================================================================
+// Capability cache
+// ============================================================================
+
+bool NetlinkInterfaceDiscovery::load_cache(std::vector<LinkRecord>& links) {
+    if (cache_path_.empty()) {
+        return false;
+    }
+
+    std::ifstream file(cache_path_);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Interface indexes are never reused within a boot, so a reloaded driver
+    // or a recreated device gets a new index and misses the cache
+    std::string magic, boot_id;
+    int version = 0;
+    if (!(file >> magic >> version >> boot_id) || magic != CACHE_MAGIC ||
+        version != CACHE_VERSION || boot_id != read_boot_id()) {
+        return false;
+    }
+
+    std::map<int, std::pair<std::string, LinkRecord>> cached;
+    LinkRecord entry;
+    std::string mac;
+    while (file >> entry.ifindex >> entry.name >> mac >> entry.timestamping.so_timestamping
+                >> entry.timestamping.tx_types >> entry.timestamping.rx_filters >> entry.timestamping.phc_index) {
+        cached[entry.ifindex] = {mac, entry};
+    }
+
+    for (auto& link : links) {
+        auto it = cached.find(link.ifindex);
+        if (it != cached.end() && it->second.second.name == link.name && it->second.first == format_mac(link.mac)) {
+            link.timestamping = it->second.second.timestamping;
+            link.timestamping.valid = true;
+            stats_.cached++;
+        }
+    }
+    return stats_.cached > 0;
+}
+
+void NetlinkInterfaceDiscovery::save_cache(const std::vector<LinkRecord>& links) const {
+    if (cache_path_.empty()) {
+        return;
+    }
+
+    std::string temp_path = cache_path_ + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            LOG_DEBUG("Cannot write interface cache {}", temp_path);
+            return;
+        }
+
+        file << CACHE_MAGIC << ' ' << CACHE_VERSION << ' ' << read_boot_id() << '\n';
+        for (const auto& link : links) {
+            if (!link.timestamping.valid) {
+                continue;
+            }
+            file << link.ifindex << ' ' << link.name << ' ' << format_mac(link.mac) << ' '
+                 << link.timestamping.so_timestamping << ' ' << link.timestamping.tx_types << ' '
+                 << link.timestamping.rx_filters << ' ' << link.timestamping.phc_index << '\n';
+        }
+        if (!file.good()) {
+            return;
+        }
+    }
+    std::rename(temp_path.c_str(), cache_path_.c_str());
+}
+
+std::string NetlinkInterfaceDiscovery::read_boot_id() {
+    std::ifstream file("/proc/sys/kernel/random/boot_id");
+    std::string boot_id;
+    if (!(file >> boot_id)) {
+        return "unknown";
+    }
+    return boot_id;
+}
+
+// ============================================================================
+// Conversions
+// ============================================================================
+
+TimestampCapabilities NetlinkInterfaceDiscovery::to_capabilities(const LinkTimestampInfo& info) {
+    TimestampCapabilities caps;
+    const uint32_t so = info.so_timestamping;
+
+    caps.hardware_timestamping_supported = (so & SOF_TIMESTAMPING_RAW_HARDWARE) != 0;
+    caps.software_timestamping_supported = (so & (SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_RX_SOFTWARE)) != 0;
+    caps.transmit_timestamping = (so & (SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_TX_SOFTWARE)) != 0;
+    caps.receive_timestamping = (so & (SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE)) != 0;
+    caps.tagged_transmit = caps.transmit_timestamping;
+    caps.all_transmit = (info.tx_types & (1u << HWTSTAMP_TX_ON)) != 0;
+    caps.all_receive = (info.rx_filters & (1u << HWTSTAMP_FILTER_ALL)) != 0;
+    return caps;
+}
+
+std::string NetlinkInterfaceDiscovery::format_mac(const std::array<uint8_t, 6>& mac) {
+    char text[18];
+    std::snprintf(text, sizeof(text), "%02x:%02x:%02x:%02x:%02x:%02x",
+                  mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return text;
+}
+
+} // namespace gptp
+
+#endif // __linux__
@@ -0,0 +1,115 @@
+/**
+ * @file linux_netlink_discovery.hpp
+ * @brief Interface and timestamping capability discovery via rtnetlink and ethtool netlink
+ */
+
+#pragma once
+
+#include "../../include/gptp_types.hpp"
+
+#ifdef __linux__
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gptp {
+
+/**
+ * @brief Timestamping information of one link (ETHTOOL_MSG_TSINFO_GET / ETHTOOL_GET_TS_INFO)
+ */
+struct LinkTimestampInfo {
+    uint32_t so_timestamping = 0;   // SOF_TIMESTAMPING_* capability bits
+    uint32_t tx_types = 0;          // Bit per HWTSTAMP_TX_* value
+    uint32_t rx_filters = 0;        // Bit per HWTSTAMP_FILTER_* value
+    int phc_index = -1;             // /dev/ptpN, or -1 without a PHC
+    bool valid = false;
+};
+
+/**
+ * @brief One network link as reported by RTM_GETLINK
+ */
+struct LinkRecord {
+    int ifindex = 0;
+    std::string name;
+    std::array<uint8_t, 6> mac{};
+    unsigned int flags = 0;         // IFF_* flags
+    bool is_ethernet = false;       // ARPHRD_ETHER
+    std::string kind;               // IFLA_INFO_KIND (veth, bridge, vlan, ...); empty for physical NICs
+    LinkTimestampInfo timestamping;
+};
+
+/**
+ * @brief Collects links, MAC addresses, PHC indexes and timestamping
+ *        capabilities for all interfaces with a handful of netlink requests
+ *
+ * One RTM_GETLINK dump lists the links; one ETHTOOL_MSG_TSINFO_GET dump
+ * returns the timestamping information of every link. On kernels without
+ * ethtool netlink the SIOCETHTOOL ioctl is used per link instead.
+ *
+ * Timestamping information does not change while the driver stays bound,
+ * so it is cached in a file keyed by boot id, ifindex, name and MAC; a
+ * restart only needs the link dump.
+ */
+class NetlinkInterfaceDiscovery {
+public:
+    /**
+     * @brief Statistics of the last discover() call
+     */
+    struct DiscoveryStats {
+        size_t links = 0;
+        size_t cached = 0;              // Links whose timestamping info came from the cache
+        size_t netlink_requests = 0;
+        size_t ioctl_queries = 0;
+        std::chrono::microseconds elapsed{0};
+    };
+
+    NetlinkInterfaceDiscovery();
+    ~NetlinkInterfaceDiscovery() = default;
+
+    /**
+     * @brief Set the capability cache file; an empty path disables caching
+     */
+    void set_cache_path(const std::string& path);
+
+    /**
+     * @brief Enumerate all links with their timestamping information
+     * @return Links ordered by interface index
+     */
+    Result<std::vector<LinkRecord>> discover();
+
+    /**
+     * @brief Query timestamping information of a single interface
+     */
+    Result<LinkTimestampInfo> query_timestamping(const std::string& interface_name);
+
+    const DiscoveryStats& get_last_stats() const { return stats_; }
+
+    /**
+     * @brief Map kernel timestamping information to capability flags
+     */
+    static TimestampCapabilities to_capabilities(const LinkTimestampInfo& info);
+
+    /**
+     * @brief Format a MAC address as aa:bb:cc:dd:ee:ff
+     */
+    static std::string format_mac(const std::array<uint8_t, 6>& mac);
+
+private:
+    std::string cache_path_;
+    DiscoveryStats stats_;
+
+    Result<std::vector<LinkRecord>> dump_links();
+    bool dump_timestamping(std::map<int, LinkTimestampInfo>& info_by_index);
+    bool query_timestamping_ioctl(const std::string& interface_name, LinkTimestampInfo& info);
+
+    bool load_cache(std::vector<LinkRecord>& links);
+    void save_cache(const std::vector<LinkRecord>& links) const;
+    static std::string read_boot_id();
+};
+
+} // namespace gptp
+
+#endif // __linux__
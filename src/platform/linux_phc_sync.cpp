@@ -0,0 +1,384 @@
+/**
+ * @file linux_phc_sync.cpp
+ * @brief Synchronizes the system clock and secondary PHCs to a PTP hardware clock
+ */
+
+#include "linux_phc_sync.hpp"
+#include "linux_clock_adjuster.hpp"
+#include "../utils/logger.hpp"
+
+#ifdef __linux__
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace gptp {
+
+namespace {
+    constexpr int64_t LOCK_THRESHOLD_NS = 1000;
+    constexpr unsigned int LOCK_SAMPLES = 4;
+    constexpr int64_t STEP_THRESHOLD_NS = 20000000;     // Step instead of slewing beyond 20 ms
+
+    int64_t to_ns(const struct ptp_clock_time& time) {
+        return static_cast<int64_t>(time.sec) * 1000000000LL + time.nsec;
+    }
+
+    servo::ServoConfig make_servo_config() {
+        // ClockServo divides by 1000, so these are Kp = 0.7 and Ki = 0.3
+        // ppb per ns at a 1 s update interval, as phc2sys uses
+        servo::ServoConfig config;
+        config.proportional_gain = 700.0;
+        config.integral_gain = 300.0;
+        config.max_frequency_adjustment = 500000.0;
+        config.max_phase_adjustment = static_cast<double>(STEP_THRESHOLD_NS);
+        return config;
+    }
+
+    int64_t read_ns(clockid_t clock_id) {
+        struct timespec ts{};
+        clock_gettime(clock_id, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    /**
+     * Step or slew a clock that is offset_ns ahead of its reference
+     * @return true once the offset stayed below the lock threshold
+     */
+    bool steer(IClockAdjuster& clock, servo::ClockServo& servo, int64_t offset_ns,
+               std::chrono::steady_clock::time_point now, unsigned int& good_samples) {
+        if (std::llabs(offset_ns) > STEP_THRESHOLD_NS) {
+            LOG_INFO("Stepping {} by {}ns", clock.get_name(), -offset_ns);
+            clock.step_clock(std::chrono::nanoseconds(-offset_ns));
+            servo.reset();
+            good_samples = 0;
+            return false;
+        }
+
+        servo.update_servo(std::chrono::nanoseconds(offset_ns), now);
+        clock.adjust_frequency(-servo.get_frequency_adjustment());
+
+        if (std::llabs(offset_ns) < LOCK_THRESHOLD_NS) {
+            good_samples = good_samples < LOCK_SAMPLES ? good_samples + 1 : LOCK_SAMPLES;
+        } else {
+            good_samples = 0;
+        }
+        return good_samples >= LOCK_SAMPLES;
+    }
+}
+
+const char* to_string(PhcCrossTimestamp::Method method) {
+    switch (method) {
+        case PhcCrossTimestamp::Method::PRECISE: return "PTP_SYS_OFFSET_PRECISE";
+        case PhcCrossTimestamp::Method::EXTENDED: return "PTP_SYS_OFFSET_EXTENDED";
+        case PhcCrossTimestamp::Method::BASIC: return "PTP_SYS_OFFSET";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// LinuxPhcSystemSync Implementation
+// ============================================================================
+
+LinuxPhcSystemSync::LinuxPhcSystemSync()
+    : phc_fd_(-1)
+    , method_(PhcCrossTimestamp::Method::BASIC)
+    , system_clock_(nullptr)
+    , servo_(make_servo_config())
+    , last_offset_ns_(0)
+    , good_samples_(0)
+    , locked_(false)
+    , updates_(0) {
+}
+
+LinuxPhcSystemSync::~LinuxPhcSystemSync() {
+    close();
+}
+
+Result<bool> LinuxPhcSystemSync::open(const Options& options, IClockAdjuster* system_clock) {
+    close();
+    options_ = options;
+    if (options_.phc_index < 0) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+    if (options_.samples == 0 || options_.samples > PTP_MAX_SAMPLES) {
+        options_.samples = PTP_MAX_SAMPLES;
+    }
+
+    std::string device = "/dev/ptp" + std::to_string(options_.phc_index);
+    phc_fd_ = ::open(device.c_str(), O_RDONLY | O_CLOEXEC);
+    if (phc_fd_ < 0) {
+        LOG_ERROR("Failed to open {}: {}", device, std::strerror(errno));
+        return Result<bool>::error(errno == EACCES ? ErrorCode::INSUFFICIENT_PRIVILEGES
+                                                   : ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    // Probe from most to least precise; drivers reject what they lack
+    struct ptp_sys_offset_precise precise{};
+    struct ptp_sys_offset_extended extended{};
+    extended.n_samples = 1;
+    if (::ioctl(phc_fd_, PTP_SYS_OFFSET_PRECISE, &precise) == 0) {
+        method_ = PhcCrossTimestamp::Method::PRECISE;
+    } else if (::ioctl(phc_fd_, PTP_SYS_OFFSET_EXTENDED, &extended) == 0) {
+        method_ = PhcCrossTimestamp::Method::EXTENDED;
+    } else {
+        method_ = PhcCrossTimestamp::Method::BASIC;
+    }
+
+    system_clock_ = system_clock;
+    if (system_clock_ == nullptr) {
+        owned_clock_ = LinuxClockAdjuster::create(-1);
+        if (!owned_clock_) {
+            close();
+            return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+        }
+        system_clock_ = owned_clock_.get();
+    }
+
+    auto probe = measure();
+    if (probe.has_error()) {
+        LOG_ERROR("{} cannot be read against the system clock", device);
+        close();
+        return Result<bool>::error(probe.error());
+    }
+
+    LOG_INFO("Synchronizing {} from {} using {}", system_clock_->get_name(), device, to_string(method_));
+    return Result<bool>::success(true);
+}
+
+void LinuxPhcSystemSync::close() {
+    if (phc_fd_ >= 0) {
+        ::close(phc_fd_);
+        phc_fd_ = -1;
+    }
+    owned_clock_.reset();
+    system_clock_ = nullptr;
+    servo_.reset();
+    good_samples_ = 0;
+    locked_ = false;
+}
+
+void LinuxPhcSystemSync::poll(std::chrono::steady_clock::time_point now) {
+    if (phc_fd_ < 0 || (updates_ > 0 && now - last_update_ < options_.interval)) {
+        return;
+    }
+    auto cross = measure();
+    if (cross.has_error()) {
+        LOG_WARN("PHC cross-timestamp failed");
+        return;
+    }
+    update(cross.value(), now);
+}
+
+Result<PhcCrossTimestamp> LinuxPhcSystemSync::measure() {
+    if (phc_fd_ < 0) {
+        return Result<PhcCrossTimestamp>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    switch (method_) {
+        case PhcCrossTimestamp::Method::PRECISE: {
+            struct ptp_sys_offset_precise precise{};
+            if (::ioctl(phc_fd_, PTP_SYS_OFFSET_PRECISE, &precise) < 0) {
+                return Result<PhcCrossTimestamp>::error(ErrorCode::NETWORK_ERROR);
+            }
+            PhcCrossTimestamp cross;
+            cross.phc_ns = to_ns(precise.device);
+            cross.system_ns = to_ns(precise.sys_realtime);
+            cross.method = PhcCrossTimestamp::Method::PRECISE;
+            return Result<PhcCrossTimestamp>::success(cross);
+        }
+        case PhcCrossTimestamp::Method::EXTENDED: {
+            struct ptp_sys_offset_extended extended{};
+            extended.n_samples = options_.samples;
+            if (::ioctl(phc_fd_, PTP_SYS_OFFSET_EXTENDED, &extended) < 0) {
+                return Result<PhcCrossTimestamp>::error(ErrorCode::NETWORK_ERROR);
+            }
+            return Result<PhcCrossTimestamp>::success(select_extended(extended));
+        }
+        case PhcCrossTimestamp::Method::BASIC: {
+            struct ptp_sys_offset basic{};
+            basic.n_samples = options_.samples;
+            if (::ioctl(phc_fd_, PTP_SYS_OFFSET, &basic) < 0) {
+                return Result<PhcCrossTimestamp>::error(ErrorCode::NETWORK_ERROR);
+            }
+            return Result<PhcCrossTimestamp>::success(select_basic(basic));
+        }
+    }
+    return Result<PhcCrossTimestamp>::error(ErrorCode::NETWORK_ERROR);
+}
+
+int64_t LinuxPhcSystemSync::update(const PhcCrossTimestamp& cross, std::chrono::steady_clock::time_point now) {
+    // Positive offset: the system clock is ahead of the PHC
+    int64_t offset = cross.system_ns - (cross.phc_ns - static_cast<int64_t>(options_.utc_offset_s) * 1000000000LL);
+    last_offset_ns_ = offset;
+    last_update_ = now;
+    updates_++;
+
+    if (system_clock_ == nullptr) {
+        return offset;
+    }
+
+    bool locked = steer(*system_clock_, servo_, offset, now, good_samples_);
+    if (locked_ != locked) {
+        locked_ = locked;
+        LOG_INFO("System clock {} to the PHC (offset {}ns)", locked_ ? "locked" : "unlocked", offset);
+    }
+    return offset;
+}
+
+PhcCrossTimestamp LinuxPhcSystemSync::select_extended(const struct ptp_sys_offset_extended& result) {
+    PhcCrossTimestamp best;
+    best.method = PhcCrossTimestamp::Method::EXTENDED;
+    best.window_ns = INT64_MAX;
+    for (unsigned int i = 0; i < result.n_samples && i < PTP_MAX_SAMPLES; ++i) {
+        int64_t before = to_ns(result.ts[i][0]);
+        int64_t after = to_ns(result.ts[i][2]);
+        if (after - before >= 0 && after - before < best.window_ns) {
+            best.window_ns = after - before;
+            best.system_ns = before + best.window_ns / 2;
+            best.phc_ns = to_ns(result.ts[i][1]);
+        }
+    }
+    return best;
+}
+
+PhcCrossTimestamp LinuxPhcSystemSync::select_basic(const struct ptp_sys_offset& result) {
+    PhcCrossTimestamp best;
+    best.method = PhcCrossTimestamp::Method::BASIC;
+    best.window_ns = INT64_MAX;
+    for (unsigned int i = 0; i < result.n_samples && i < PTP_MAX_SAMPLES; ++i) {
+        int64_t before = to_ns(result.ts[2 * i]);
+        int64_t after = to_ns(result.ts[2 * i + 2]);
+        if (after - before >= 0 && after - before < best.window_ns) {
+            best.window_ns = after - before;
+            best.system_ns = before + best.window_ns / 2;
+            best.phc_ns = to_ns(result.ts[2 * i + 1]);
+        }
+    }
+    return best;
+}
+
+// ============================================================================
+// PHC grouping and LinuxPhcFollower Implementation
+// ============================================================================
+
+std::vector<PhcGroup> group_ports_by_phc(const std::vector<std::pair<uint16_t, int>>& port_phcs) {
+    std::vector<PhcGroup> groups;
+    for (const auto& port : port_phcs) {
+        auto it = std::find_if(groups.begin(), groups.end(),
+                               [&](const PhcGroup& group) { return group.phc_index == port.second; });
+        if (it == groups.end()) {
+            PhcGroup group;
+            group.phc_index = port.second;
+            groups.push_back(group);
+            it = groups.end() - 1;
+        }
+        it->port_ids.push_back(port.first);
+    }
+    return groups;
+}
+
+LinuxPhcFollower::LinuxPhcFollower()
+    : clock_id_(CLOCK_REALTIME)
+    , servo_(make_servo_config())
+    , last_offset_ns_(0)
+    , good_samples_(0)
+    , locked_(false)
+    , updates_(0) {
+}
+
+LinuxPhcFollower::~LinuxPhcFollower() {
+    close();
+}
+
+Result<bool> LinuxPhcFollower::open(const Options& options) {
+    close();
+    options_ = options;
+    if (options_.phc_index < 0) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+    if (options_.samples == 0) {
+        options_.samples = 1;
+    }
+
+    auto clock = LinuxClockAdjuster::create(options_.phc_index);
+    if (!clock) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    clock_id_ = clock->get_clock_id();
+    clock_ = std::move(clock);
+    brackets_.assign(options_.samples, Bracket{});  // Reused by every measurement
+
+    LOG_INFO("PHC /dev/ptp{} follows the disciplined PHC", options_.phc_index);
+    return Result<bool>::success(true);
+}
+
+void LinuxPhcFollower::close() {
+    clock_.reset();
+    clock_id_ = CLOCK_REALTIME;
+    servo_.reset();
+    good_samples_ = 0;
+    locked_ = false;
+}
+
+void LinuxPhcFollower::poll(std::chrono::steady_clock::time_point now) {
+    if (!clock_ || (updates_ > 0 && now - last_update_ < options_.interval)) {
+        return;
+    }
+    auto offset = measure();
+    if (offset.has_error()) {
+        LOG_WARN("Reading /dev/ptp{} against the disciplined PHC failed", options_.phc_index);
+        return;
+    }
+    update(offset.value(), now);
+}
+
+Result<int64_t> LinuxPhcFollower::measure() {
+    if (!clock_) {
+        return Result<int64_t>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    for (auto& bracket : brackets_) {
+        bracket[0] = read_ns(options_.primary_clock);
+        bracket[1] = read_ns(clock_id_);
+        bracket[2] = read_ns(options_.primary_clock);
+    }
+    return Result<int64_t>::success(select_bracket(brackets_));
+}
+
+int64_t LinuxPhcFollower::update(int64_t offset_ns, std::chrono::steady_clock::time_point now) {
+    last_offset_ns_ = offset_ns;
+    last_update_ = now;
+    updates_++;
+
+    if (!clock_) {
+        return offset_ns;
+    }
+
+    bool locked = steer(*clock_, servo_, offset_ns, now, good_samples_);
+    if (locked_ != locked) {
+        locked_ = locked;
+        LOG_INFO("PHC /dev/ptp{} {} to the disciplined PHC (offset {}ns)", options_.phc_index,
+                 locked_ ? "locked" : "unlocked", offset_ns);
+    }
+    return offset_ns;
+}
+
+int64_t LinuxPhcFollower::select_bracket(const std::vector<Bracket>& brackets) {
+    int64_t best_window = INT64_MAX;
+    int64_t offset = 0;
+    for (const auto& bracket : brackets) {
+        int64_t window = bracket[2] - bracket[0];
+        if (window >= 0 && window < best_window) {
+            best_window = window;
+            offset = bracket[1] - (bracket[0] + window / 2);
+        }
+    }
+    return offset;
+}
+
+} // namespace gptp
+
+#endif // __linux__
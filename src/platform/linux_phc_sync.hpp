@@ -0,0 +1,215 @@
+/**
+ * @file linux_phc_sync.hpp
+ * @brief Synchronizes the system clock and secondary PHCs to a PTP hardware clock
+ *
+ * Replaces a separate phc2sys process: the PHC disciplined by gPTP is
+ * compared with CLOCK_REALTIME using the most precise cross-timestamp the
+ * driver offers, and a dedicated servo steers the system clock. PHCs of
+ * other NICs follow the disciplined PHC the same way.
+ */
+
+#pragma once
+
+#include "../../include/clock_adjuster.hpp"
+#include "../../include/clock_servo.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/ptp_clock.h>
+#include <ctime>
+
+namespace gptp {
+
+/**
+ * @brief One simultaneous reading of the PHC and CLOCK_REALTIME
+ */
+struct PhcCrossTimestamp {
+    enum class Method {
+        PRECISE,        // PTP_SYS_OFFSET_PRECISE: device cross-timestamp, no bracket
+        EXTENDED,       // PTP_SYS_OFFSET_EXTENDED: system/PHC/system triplets
+        BASIC           // PTP_SYS_OFFSET: interleaved system/PHC readings
+    };
+
+    int64_t phc_ns = 0;
+    int64_t system_ns = 0;          // CLOCK_REALTIME at the PHC reading
+    int64_t window_ns = 0;          // Width of the bracket the pair came from
+    Method method = Method::PRECISE;
+};
+
+const char* to_string(PhcCrossTimestamp::Method method);
+
+/**
+ * @brief PHC -> CLOCK_REALTIME synchronizer with its own servo
+ */
+class LinuxPhcSystemSync {
+public:
+    struct Options {
+        int phc_index = -1;
+        std::chrono::milliseconds interval{1000};
+        int utc_offset_s = 37;          // PHC runs on TAI; 0 if it carries UTC
+        unsigned int samples = 9;       // Brackets per EXTENDED/BASIC measurement
+    };
+
+    LinuxPhcSystemSync();
+    ~LinuxPhcSystemSync();
+
+    LinuxPhcSystemSync(const LinuxPhcSystemSync&) = delete;
+    LinuxPhcSystemSync& operator=(const LinuxPhcSystemSync&) = delete;
+
+    /**
+     * @brief Open the PHC, probe the best cross-timestamp method
+     * @param options Synchronizer options
+     * @param system_clock Adjuster of the system clock (not owned); nullptr
+     *        opens CLOCK_REALTIME internally
+     * @return Result indicating success or error
+     */
+    Result<bool> open(const Options& options, IClockAdjuster* system_clock = nullptr);
+
+    void close();
+    bool is_open() const { return phc_fd_ >= 0; }
+
+    /**
+     * @brief Measure and steer if the interval elapsed; call from a periodic timer
+     */
+    void poll(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Take one cross-timestamp with the probed method
+     */
+    Result<PhcCrossTimestamp> measure();
+
+    /**
+     * @brief Feed one measurement to the servo and adjust the system clock
+     * @return Offset of the system clock from the PHC (system - PHC), ns
+     */
+    int64_t update(const PhcCrossTimestamp& cross, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Pick the narrowest system/PHC/system triplet
+     */
+    static PhcCrossTimestamp select_extended(const struct ptp_sys_offset_extended& result);
+
+    /**
+     * @brief Pick the narrowest system/PHC/system window of interleaved readings
+     */
+    static PhcCrossTimestamp select_basic(const struct ptp_sys_offset& result);
+
+    PhcCrossTimestamp::Method get_method() const { return method_; }
+    int64_t get_last_offset_ns() const { return last_offset_ns_; }
+    double get_frequency_ppb() const { return -servo_.get_frequency_adjustment(); }
+    bool is_locked() const { return locked_; }
+    uint64_t get_update_count() const { return updates_; }
+
+private:
+    Options options_;
+    int phc_fd_;
+    PhcCrossTimestamp::Method method_;
+    std::unique_ptr<IClockAdjuster> owned_clock_;
+    IClockAdjuster* system_clock_;
+    servo::ClockServo servo_;
+    std::chrono::steady_clock::time_point last_update_;
+    int64_t last_offset_ns_;
+    unsigned int good_samples_;
+    bool locked_;
+    uint64_t updates_;
+};
+
+/**
+ * @brief Ports timestamping against one physical clock
+ */
+struct PhcGroup {
+    int phc_index = -1;                 // -1 for ports without a PHC
+    std::vector<uint16_t> port_ids;
+};
+
+/**
+ * @brief Group ports by PHC index, in order of first appearance
+ * @param port_phcs (port id, PHC index) per port
+ */
+std::vector<PhcGroup> group_ports_by_phc(const std::vector<std::pair<uint16_t, int>>& port_phcs);
+
+/**
+ * @brief Keeps a secondary PHC aligned to the PHC disciplined by gPTP
+ *
+ * Ports of a multi-port NIC share one PHC and need nothing; ports on other
+ * NICs timestamp against their own PHC, which must not get a second servo
+ * fed from the network. It is steered to the primary PHC instead, using
+ * primary/secondary/primary reads as phc2sys does for PHC pairs.
+ */
+class LinuxPhcFollower {
+public:
+    struct Options {
+        clockid_t primary_clock = CLOCK_REALTIME;   // Dynamic clock id of the disciplined PHC
+        int phc_index = -1;                         // Secondary PHC
+        std::chrono::milliseconds interval{1000};
+        unsigned int samples = 5;                   // Brackets per measurement
+    };
+
+    /**
+     * @brief One primary/secondary/primary reading, ns
+     */
+    using Bracket = std::array<int64_t, 3>;
+
+    LinuxPhcFollower();
+    ~LinuxPhcFollower();
+
+    LinuxPhcFollower(const LinuxPhcFollower&) = delete;
+    LinuxPhcFollower& operator=(const LinuxPhcFollower&) = delete;
+
+    /**
+     * @brief Open the secondary PHC for adjustment
+     * @return Result indicating success or error
+     */
+    Result<bool> open(const Options& options);
+
+    void close();
+    bool is_open() const { return clock_ != nullptr; }
+
+    /**
+     * @brief Measure and steer if the interval elapsed; call from a periodic timer
+     */
+    void poll(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Offset of the secondary from the primary PHC (secondary - primary), ns
+     */
+    Result<int64_t> measure();
+
+    /**
+     * @brief Feed one offset to the servo and adjust the secondary PHC
+     * @return The offset
+     */
+    int64_t update(int64_t offset_ns, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Offset from the narrowest bracket
+     */
+    static int64_t select_bracket(const std::vector<Bracket>& brackets);
+
+    int get_phc_index() const { return options_.phc_index; }
+    int64_t get_last_offset_ns() const { return last_offset_ns_; }
+    double get_frequency_ppb() const { return -servo_.get_frequency_adjustment(); }
+    bool is_locked() const { return locked_; }
+    uint64_t get_update_count() const { return updates_; }
+
+private:
+    Options options_;
+    std::unique_ptr<IClockAdjuster> clock_;
+    clockid_t clock_id_;
+    std::vector<Bracket> brackets_;     // options_.samples entries, sized by open()
+    servo::ClockServo servo_;
+    std::chrono::steady_clock::time_point last_update_;
+    int64_t last_offset_ns_;
+    unsigned int good_samples_;
+    bool locked_;
+    uint64_t updates_;
+};
+
+} // namespace gptp
+
+#endif // __linux__
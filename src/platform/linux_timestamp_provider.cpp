@@ -5,22 +5,17 @@
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE  // Enable GNU extensions for networking
 #endif
-#include <cstring>
-#include <sstream>
-#include <iomanip>
+#include "../utils/configuration.hpp"
+#include "../utils/logger.hpp"
+#include <net/if.h>
 #include <errno.h>
 
 namespace gptp {
 
-    LinuxTimestampProvider::LinuxTimestampProvider() : initialized_(false), socket_fd_(-1) {
+    LinuxTimestampProvider::LinuxTimestampProvider() : initialized_(false) {
     }
 
     LinuxTimestampProvider::~LinuxTimestampProvider() {
-        // Don't call virtual function from destructor - cleanup directly
-        if (socket_fd_ >= 0) {
-            close(socket_fd_);
-            socket_fd_ = -1;
-        }
         initialized_ = false;
     }
 
@@ -29,21 +24,13 @@ namespace gptp {
             return Result<bool>(true);
         }
 
-        // Create a socket for ioctl operations
-        socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
-        if (socket_fd_ < 0) {
-            return Result<bool>(LinuxTimestampProvider::map_linux_error(errno));
-        }
-
+        discovery_.set_cache_path(Configuration::instance().network.interface_cache_path);
         initialized_ = true;
         return Result<bool>(true);
     }
 
     void LinuxTimestampProvider::cleanup() {
-        if (socket_fd_ >= 0) {
-            close(socket_fd_);
-            socket_fd_ = -1;
-        }
+        links_.clear();
         initialized_ = false;
     }
 
@@ -54,35 +41,18 @@ namespace gptp {
             return Result<TimestampCapabilities>(ErrorCode::INITIALIZATION_FAILED);
         }
 
-        // For now, return basic capabilities based on interface name
-        // In a full implementation, this would use ethtool to query actual capabilities
-        TimestampCapabilities caps;
-        
-        // Skip loopback interface
-        if (interface_name == "lo") {
-            caps.software_timestamping_supported = false;
-            caps.hardware_timestamping_supported = false;
-            caps.transmit_timestamping = false;
-            caps.receive_timestamping = false;
-            caps.tagged_transmit = false;
-            caps.all_transmit = false;
-            caps.all_receive = false;
-            return Result<TimestampCapabilities>(caps);
+        // Answer from the last discovery dump when possible
+        auto it = links_.find(interface_name);
+        if (it != links_.end() && it->second.timestamping.valid) {
+            return Result<TimestampCapabilities>(
+                NetlinkInterfaceDiscovery::to_capabilities(it->second.timestamping));
         }
-        
-        // Most Linux systems support software timestamping
-        caps.software_timestamping_supported = true;
-        caps.transmit_timestamping = true;
-        caps.receive_timestamping = true;
-        
-        // Hardware timestamping detection would require ethtool queries
-        // For now, assume it might be available (this is a simplified implementation)
-        caps.hardware_timestamping_supported = false; // Conservative default
-        caps.tagged_transmit = false;
-        caps.all_transmit = false;
-        caps.all_receive = false;
-        
-        return Result<TimestampCapabilities>(caps);
+
+        auto info_result = discovery_.query_timestamping(interface_name);
+        if (info_result.has_error()) {
+            return Result<TimestampCapabilities>(info_result.error());
+        }
+        return Result<TimestampCapabilities>(NetlinkInterfaceDiscovery::to_capabilities(info_result.value()));
     }
 
     Result<std::vector<NetworkInterface>> LinuxTimestampProvider::get_network_interfaces() {
@@ -90,96 +60,57 @@ namespace gptp {
             return Result<std::vector<NetworkInterface>>(ErrorCode::INITIALIZATION_FAILED);
         }
 
-        std::vector<NetworkInterface> interfaces;
-        
-        struct ifaddrs *ifaddr;
-        const struct ifaddrs *ifa;
-        if (getifaddrs(&ifaddr) == -1) {
-            return Result<std::vector<NetworkInterface>>(LinuxTimestampProvider::map_linux_error(errno));
+        auto links_result = discovery_.discover();
+        if (links_result.has_error()) {
+            return Result<std::vector<NetworkInterface>>(links_result.error());
         }
 
-        // Iterate through linked list of interfaces
-        for (ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
-            if (ifa->ifa_addr == nullptr) {
+        links_.clear();
+        std::vector<NetworkInterface> interfaces;
+        for (const auto& link : links_result.value()) {
+            links_[link.name] = link;
+            if (!is_port_candidate(link)) {
                 continue;
             }
 
-            // Only process AF_INET interfaces (IPv4)
-            if (ifa->ifa_addr->sa_family == AF_INET) {
-                NetworkInterface interface = convert_ifaddr_info(*ifa);
-                
-                // Skip loopback interfaces
-                if (interface.name != "lo" && !interface.name.empty()) {
-                    interfaces.push_back(interface);
-                }
-            }
+            NetworkInterface interface;
+            interface.name = link.name;
+            interface.description = link.kind.empty() ? "ethernet" : link.kind;
+            interface.mac_address = NetlinkInterfaceDiscovery::format_mac(link.mac);
+            interface.is_active = (link.flags & IFF_UP) && (link.flags & IFF_RUNNING);
+            interface.phc_index = link.timestamping.phc_index;
+            interface.capabilities = NetlinkInterfaceDiscovery::to_capabilities(link.timestamping);
+            interfaces.push_back(interface);
         }
 
-        freeifaddrs(ifaddr);
+        const auto& stats = discovery_.get_last_stats();
+        LOG_INFO("Enumerated {} links in {}us ({} with cached capabilities)",
+                 stats.links, stats.elapsed.count(), stats.cached);
+
         return Result<std::vector<NetworkInterface>>(interfaces);
     }
 
     bool LinuxTimestampProvider::is_hardware_timestamping_available() const {
-        // In a full implementation, this would check for:
-        // 1. Kernel support (SO_TIMESTAMPING)
-        // 2. Driver support (ethtool queries)
-        // 3. Hardware support (NIC capabilities)
-        
-        // For now, return true as most modern Linux systems support it
-        return true;
-    }
-
-    NetworkInterface LinuxTimestampProvider::convert_ifaddr_info(const struct ifaddrs& ifaddr) const {
-        NetworkInterface interface;
-        interface.name = ifaddr.ifa_name;
-        
-        // Get MAC address
-        interface.mac_address = get_interface_mac_address(interface.name);
-        
-        // Check if interface is up
-        interface.is_active = (ifaddr.ifa_flags & IFF_UP) && (ifaddr.ifa_flags & IFF_RUNNING);
-        
-        // Get timestamp capabilities for this interface
-        auto caps_result = const_cast<LinuxTimestampProvider*>(this)->get_timestamp_capabilities(interface.name);
-        if (caps_result.is_success()) {
-            interface.capabilities = caps_result.value();
+        for (const auto& entry : links_) {
+            if (is_port_candidate(entry.second) &&
+                NetlinkInterfaceDiscovery::to_capabilities(entry.second.timestamping).hardware_timestamping_supported) {
+                return true;
+            }
         }
-        
-        return interface;
+        return false;
     }
 
-    std::string LinuxTimestampProvider::get_interface_mac_address(const InterfaceName& interface_name) const {
-        if (socket_fd_ < 0) {
-            return "";
+    bool LinuxTimestampProvider::is_port_candidate(const LinkRecord& link) {
+        if (!link.is_ethernet || (link.flags & IFF_LOOPBACK)) {
+            return false;
         }
-
-        struct ifreq ifr;
-        std::memset(&ifr, 0, sizeof(ifr));
-        
-        // Safely copy interface name
-        if (interface_name.length() >= IFNAMSIZ) {
-            return ""; // Interface name too long
+        if (link.kind.empty()) {
+            return true;
         }
-        std::strncpy(ifr.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
-        ifr.ifr_name[IFNAMSIZ - 1] = '\0'; // Ensure null termination
-
-        if (ioctl(socket_fd_, SIOCGIFHWADDR, &ifr) < 0) {
-            return "";
+        if (link.kind == "bridge" || link.kind == "bond" || link.kind == "team") {
+            return false;
         }
-
-        // Convert MAC address to string format
-        std::stringstream mac_stream;
-        const unsigned char* mac = reinterpret_cast<const unsigned char*>(ifr.ifr_hwaddr.sa_data);
-        
-        for (int i = 0; i < 6; ++i) {
-            if (i > 0) {
-                mac_stream << ":";
-            }
-            mac_stream << std::hex << std::setw(2) << std::setfill('0') 
-                      << static_cast<unsigned int>(mac[i]);
-        }
-        
-        return mac_stream.str();
+        return (link.flags & IFF_RUNNING) != 0;
     }
 
     ErrorCode LinuxTimestampProvider::map_linux_error(int errno_value) {
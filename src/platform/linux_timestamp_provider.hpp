@@ -4,11 +4,8 @@
 
 #ifdef __linux__
 
-#include <sys/socket.h>
-#include <sys/ioctl.h>
-#include <net/if.h>
-#include <ifaddrs.h>
-#include <unistd.h>
+#include "linux_netlink_discovery.hpp"
+#include <map>
 
 namespace gptp {
 
@@ -45,28 +42,16 @@ namespace gptp {
 
     private:
         bool initialized_;
-        int socket_fd_;
+        NetlinkInterfaceDiscovery discovery_;
+        std::map<InterfaceName, LinkRecord> links_;  // Last discovery result by name
 
         /**
-         * @brief Convert Linux network interface to our NetworkInterface struct
-         * @param ifaddr Linux ifaddrs structure
-         * @return NetworkInterface object
+         * @brief Whether a link should be offered as a gPTP port candidate
+         * 
+         * Physical Ethernet NICs always qualify. Virtual links (veth, vlan, ...)
+         * only while running; bridges and bonds never do, gPTP runs on their members.
          */
-        NetworkInterface convert_ifaddr_info(const struct ifaddrs& ifaddr) const;
-
-        /**
-         * @brief Get hardware timestamping capabilities using ethtool
-         * @param interface_name Name of the network interface
-         * @return TimestampCapabilities object
-         */
-        TimestampCapabilities get_ethtool_timestamping_caps(const InterfaceName& interface_name) const;
-
-        /**
-         * @brief Get MAC address for a network interface
-         * @param interface_name Name of the network interface
-         * @return MAC address as string or empty string on error
-         */
-        std::string get_interface_mac_address(const InterfaceName& interface_name) const;
+        static bool is_port_candidate(const LinkRecord& link);
 
         /**
          * @brief Convert Linux error codes to our ErrorCode enum
@@ -0,0 +1,196 @@
+/**
+ * @file tsc_clock_source.cpp
+ * @brief Clock source reading the CPU time stamp counter
+ */
+
+#include "tsc_clock_source.hpp"
+#include "../utils/logger.hpp"
+
+#if defined(__linux__) && defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace gptp {
+
+namespace {
+    __extension__ typedef __int128 int128_t;
+
+    constexpr int SAMPLE_TRIES = 5;
+    constexpr auto INITIAL_CALIBRATION = std::chrono::milliseconds(10);
+    constexpr double MAX_TSC_DEVIATION = 500e-6;    // TSC vs CLOCK_MONOTONIC_RAW before giving up
+    constexpr double MAX_SLEW = 1000e-6;            // Beyond this the clock was stepped, not slewed
+    constexpr double MAX_CORRECTION = 500e-6;       // Rate change used to close the gap to the kernel clock
+
+    int64_t clock_ns(clockid_t clock_id) {
+        struct timespec ts{};
+        clock_gettime(clock_id, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    uint64_t read_tsc() {
+        unsigned int aux;
+        return __rdtscp(&aux);
+    }
+}
+
+int64_t TscClockSource::ClockMap::convert(uint64_t tsc) const {
+    int128_t delta = static_cast<int128_t>(static_cast<int64_t>(tsc - anchor_tsc)) * mult;
+    return anchor_ns + static_cast<int64_t>(delta >> 32);
+}
+
+bool TscClockSource::has_invariant_tsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+}
+
+std::unique_ptr<TscClockSource> TscClockSource::create() {
+    if (!has_invariant_tsc()) {
+        LOG_INFO("No invariant TSC; reading clocks with clock_gettime");
+        return nullptr;
+    }
+
+    std::unique_ptr<TscClockSource> source(new TscClockSource());
+    source->first_raw_ = sample(CLOCK_MONOTONIC_RAW);
+    source->last_realtime_ = sample(CLOCK_REALTIME);
+    source->last_monotonic_ = sample(CLOCK_MONOTONIC);
+    std::this_thread::sleep_for(INITIAL_CALIBRATION);
+    source->recalibrate();
+    if (source->is_fallback()) {
+        return nullptr;
+    }
+
+    LOG_INFO("TSC clock source calibrated at {} kHz", static_cast<int64_t>(source->get_frequency_hz() / 1e3));
+    return source;
+}
+
+int64_t TscClockSource::now_realtime_ns() {
+    if (fallback_.load(std::memory_order_relaxed)) {
+        return clock_ns(CLOCK_REALTIME);
+    }
+    return read_params().realtime.convert(read_tsc());
+}
+
+int64_t TscClockSource::now_monotonic_ns() {
+    if (fallback_.load(std::memory_order_relaxed)) {
+        return clock_ns(CLOCK_MONOTONIC);
+    }
+    return read_params().monotonic.convert(read_tsc());
+}
+
+void TscClockSource::recalibrate() {
+    if (is_fallback()) {
+        return;
+    }
+
+    // The rate comes from the whole baseline so it sharpens over time
+    Sample raw = sample(CLOCK_MONOTONIC_RAW);
+    double ns_per_tick = static_cast<double>(raw.ns - first_raw_.ns) / static_cast<double>(raw.tsc - first_raw_.tsc);
+    if (!(ns_per_tick > 0.0) ||
+        (ns_per_tick_ > 0.0 && std::fabs(ns_per_tick / ns_per_tick_ - 1.0) > MAX_TSC_DEVIATION)) {
+        LOG_WARN("TSC disagrees with CLOCK_MONOTONIC_RAW; falling back to clock_gettime");
+        fallback_.store(true, std::memory_order_relaxed);
+        return;
+    }
+    ns_per_tick_ = ns_per_tick;
+
+    Sample realtime = sample(CLOCK_REALTIME);
+    Sample monotonic = sample(CLOCK_MONOTONIC);
+    Params current = read_params();
+    Params params;
+    params.realtime = follow(current.realtime, last_realtime_, realtime, true);
+    params.monotonic = follow(current.monotonic, last_monotonic_, monotonic, false);
+    last_realtime_ = realtime;
+    last_monotonic_ = monotonic;
+    write_params(params);
+}
+
+double TscClockSource::get_frequency_hz() const {
+    return ns_per_tick_ > 0.0 ? 1e9 / ns_per_tick_ : 0.0;
+}
+
+TscClockSource::Sample TscClockSource::sample(clockid_t clock_id) {
+    // Keep the narrowest TSC bracket around the clock read
+    Sample best;
+    uint64_t best_width = UINT64_MAX;
+    for (int i = 0; i < SAMPLE_TRIES; ++i) {
+        uint64_t before = read_tsc();
+        int64_t ns = clock_ns(clock_id);
+        uint64_t after = read_tsc();
+        if (after - before < best_width) {
+            best_width = after - before;
+            best.tsc = before + best_width / 2;
+            best.ns = ns;
+        }
+    }
+    return best;
+}
+
+TscClockSource::ClockMap TscClockSource::follow(const ClockMap& map, const Sample& previous, const Sample& current,
+                                                bool follow_steps) const {
+    // Run at the rate the clock was observed to run; after a step use the TSC rate
+    double rate = ns_per_tick_;
+    double interval = 0.0;
+    bool stepped = false;
+    if (current.tsc > previous.tsc) {
+        interval = static_cast<double>(current.tsc - previous.tsc);
+        double observed = static_cast<double>(current.ns - previous.ns) / interval;
+        if (std::fabs(observed / ns_per_tick_ - 1.0) <= MAX_SLEW) {
+            rate = observed;
+        } else {
+            stepped = true;
+        }
+    }
+
+    ClockMap next;
+    next.anchor_tsc = current.tsc;
+    if (map.mult == 0 || (stepped && follow_steps)) {
+        // First calibration, or the kernel clock itself jumped
+        next.anchor_ns = current.ns;
+    } else {
+        // Continue from the published reading and close the gap to the kernel
+        // clock over the next interval (assumed as long as the last one).
+        // Falling behind is caught up with a forward step; running ahead is
+        // only ever slewed out, never stepped back
+        next.anchor_ns = map.convert(current.tsc);
+        double error = static_cast<double>(current.ns - next.anchor_ns);
+        double slewable = MAX_CORRECTION * rate * interval;
+        if (error > slewable) {
+            next.anchor_ns = current.ns;
+        } else if (interval > 0.0) {
+            rate += std::max(error, -slewable) / interval;
+        }
+    }
+    next.mult = static_cast<uint64_t>(std::llround(rate * 4294967296.0));
+    return next;
+}
+
+TscClockSource::Params TscClockSource::read_params() const {
+    Params params;
+    uint32_t begin;
+    do {
+        begin = sequence_.load(std::memory_order_acquire);
+        params = params_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((begin & 1u) != 0 || sequence_.load(std::memory_order_relaxed) != begin);
+    return params;
+}
+
+void TscClockSource::write_params(const Params& params) {
+    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    params_ = params;
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+} // namespace gptp
+
+#endif // __linux__ && __x86_64__
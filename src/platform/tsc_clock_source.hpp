@@ -0,0 +1,104 @@
+/**
+ * @file tsc_clock_source.hpp
+ * @brief Clock source reading the CPU time stamp counter
+ *
+ * An rdtscp read costs a few ns and never leaves user space, unlike
+ * clock_gettime on kernels or VMs without a usable vDSO clock. The TSC
+ * rate is calibrated against CLOCK_MONOTONIC_RAW over a growing baseline;
+ * CLOCK_MONOTONIC and CLOCK_REALTIME are followed at the rate they were
+ * observed to run over the last calibration interval, so NTP or PHC slewing
+ * of the system clock is tracked. Each recalibration continues from the
+ * current reading and slews out the extrapolation error over the following
+ * interval, so readings never jump backwards; only a step of the kernel's
+ * CLOCK_REALTIME is followed by a step.
+ */
+
+#pragma once
+
+#include "../../include/clock_source.hpp"
+#include <atomic>
+#include <memory>
+
+#if defined(__linux__) && defined(__x86_64__)
+#include <ctime>
+
+namespace gptp {
+
+/**
+ * @brief Calibrated TSC clock source for Linux x86-64
+ */
+class TscClockSource : public IClockSource {
+public:
+    ~TscClockSource() override = default;
+
+    TscClockSource(const TscClockSource&) = delete;
+    TscClockSource& operator=(const TscClockSource&) = delete;
+
+    /**
+     * @brief Calibrate a TSC clock source; takes about 10 ms
+     * @return Source, or nullptr if the CPU has no invariant TSC
+     */
+    static std::unique_ptr<TscClockSource> create();
+
+    /**
+     * @brief Whether the TSC runs at a constant rate in all power states
+     */
+    static bool has_invariant_tsc();
+
+    int64_t now_realtime_ns() override;
+    int64_t now_monotonic_ns() override;
+    std::string get_name() const override { return "tsc"; }
+
+    /**
+     * @brief Re-anchor the clocks; call about once a second from one thread
+     *
+     * Falls back to clock_gettime for good if the TSC stops agreeing
+     * with CLOCK_MONOTONIC_RAW.
+     */
+    void recalibrate();
+
+    double get_frequency_hz() const;
+    bool is_fallback() const { return fallback_.load(std::memory_order_relaxed); }
+
+private:
+    struct Sample {
+        uint64_t tsc = 0;
+        int64_t ns = 0;
+    };
+
+    // ns = anchor_ns + ((tsc - anchor_tsc) * mult) >> 32
+    struct ClockMap {
+        uint64_t anchor_tsc = 0;
+        int64_t anchor_ns = 0;
+        uint64_t mult = 0;
+
+        int64_t convert(uint64_t tsc) const;
+    };
+
+    struct Params {
+        ClockMap realtime;
+        ClockMap monotonic;
+    };
+
+    TscClockSource() = default;
+
+    static Sample sample(clockid_t clock_id);
+    ClockMap follow(const ClockMap& map, const Sample& previous, const Sample& current, bool follow_steps) const;
+    Params read_params() const;
+    void write_params(const Params& params);
+
+    // Sequence lock: readers on any thread, recalibrate() writes
+    std::atomic<uint32_t> sequence_{0};
+    Params params_;
+    std::atomic<bool> fallback_{false};
+
+    // Writer-only calibration state
+    Sample first_raw_;
+    Sample last_realtime_;
+    Sample last_monotonic_;
+    double ns_per_tick_ = 0.0;
+};
+
+} // namespace gptp
+
+#endif // __linux__ && __x86_64__
@@ -0,0 +1,445 @@
+/**
+ * @file replay_socket.cpp
+ * @brief Feed a pcapng or pcap capture back into the stack on virtual time
+ */
+
+#include "replay_socket.hpp"
+#include "../utils/logger.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace gptp {
+namespace sim {
+
+namespace {
+    constexpr int64_t MATCH_WINDOW_NS = 1000000000LL;   // Sync and Pdelay intervals are at most 1 s
+    constexpr size_t HEADER_SIZE = 34;
+    constexpr size_t SEQUENCE_ID_OFFSET = 30;
+    constexpr size_t SOURCE_PORT_OFFSET = 20;
+    constexpr size_t REQUESTING_PORT_OFFSET = 44;       // Pdelay_Resp and Pdelay_Resp_Follow_Up
+    constexpr size_t PORT_IDENTITY_SIZE = 10;
+
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+
+    uint16_t sequence_id_of(const std::vector<uint8_t>& payload) {
+        return static_cast<uint16_t>((payload[SEQUENCE_ID_OFFSET] << 8) | payload[SEQUENCE_ID_OFFSET + 1]);
+    }
+
+    ClockIdentity identity_at(const std::vector<uint8_t>& payload, size_t offset) {
+        ClockIdentity identity;
+        std::copy(payload.begin() + static_cast<std::ptrdiff_t>(offset),
+                  payload.begin() + static_cast<std::ptrdiff_t>(offset + identity.id.size()), identity.id.begin());
+        return identity;
+    }
+
+    bool is_pdelay_response(uint8_t message_type) {
+        return message_type == static_cast<uint8_t>(protocol::MessageType::PDELAY_RESP) ||
+               message_type == static_cast<uint8_t>(protocol::MessageType::PDELAY_RESP_FOLLOW_UP);
+    }
+}
+
+// ============================================================================
+// ReplaySocket Implementation
+// ============================================================================
+
+ReplaySocket::ReplaySocket(CaptureReplay& replay, uint32_t interface_id, std::string interface_name,
+                           const std::array<uint8_t, 6>& mac)
+    : replay_(&replay)
+    , interface_id_(interface_id)
+    , interface_name_(std::move(interface_name))
+    , mac_(mac)
+    , initialized_(false) {
+}
+
+ReplaySocket::~ReplaySocket() {
+    if (replay_) {
+        replay_->detach(*this);
+    }
+}
+
+Result<bool> ReplaySocket::initialize(const std::string& interface_name) {
+    if (interface_name != interface_name_ || !replay_) {
+        return Result<bool>::error(ErrorCode::INTERFACE_NOT_FOUND);
+    }
+    initialized_ = true;
+    return Result<bool>::success(true);
+}
+
+void ReplaySocket::cleanup() {
+    initialized_ = false;
+    callback_ = nullptr;
+    queue_.clear();
+}
+
+Result<bool> ReplaySocket::send_packet(const GptpPacket& packet, PacketTimestamp& timestamp) {
+    if (!initialized_ || !replay_) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    replay_->transmit(*this, packet, timestamp);
+    return Result<bool>::success(true);
+}
+
+void ReplaySocket::deliver(const GptpPacket& packet, int64_t timestamp_ns) {
+    if (!initialized_) {
+        return;
+    }
+    PacketTimestamp timestamp;
+    timestamp.hardware_timestamp = std::chrono::nanoseconds(timestamp_ns);
+    timestamp.source = TimestampSource::HARDWARE;
+
+    if (callback_) {
+        callback_(ReceivedPacket(packet, timestamp, interface_name_));
+    } else {
+        queue_.emplace_back(packet, timestamp, interface_name_);
+    }
+}
+
+Result<ReceivedPacket> ReplaySocket::receive_packet(uint32_t) {
+    return try_receive_packet();
+}
+
+Result<ReceivedPacket> ReplaySocket::try_receive_packet() {
+    if (queue_.empty()) {
+        return Result<ReceivedPacket>::error(ErrorCode::TIMEOUT);
+    }
+    ReceivedPacket received = std::move(queue_.front());
+    queue_.pop_front();
+    return Result<ReceivedPacket>::success(std::move(received));
+}
+
+Result<bool> ReplaySocket::start_async_receive(PacketCallback callback) {
+    callback_ = std::move(callback);
+    while (callback_ && !queue_.empty()) {
+        ReceivedPacket received = std::move(queue_.front());
+        queue_.pop_front();
+        callback_(received);
+    }
+    return Result<bool>::success(true);
+}
+
+void ReplaySocket::stop_async_receive() {
+    callback_ = nullptr;
+}
+
+Result<std::array<uint8_t, 6>> ReplaySocket::get_interface_mac() const {
+    return Result<std::array<uint8_t, 6>>::success(mac_);
+}
+
+// ============================================================================
+// CaptureReplay Implementation
+// ============================================================================
+
+CaptureReplay::CaptureReplay(EventScheduler& scheduler)
+    : scheduler_(scheduler)
+    , has_identity_(false)
+    , damaged_(false)
+    , shift_ns_(0)
+    , cursor_(0)
+    , next_event_(0) {
+}
+
+CaptureReplay::~CaptureReplay() {
+    if (next_event_ != 0) {
+        scheduler_.cancel(next_event_);
+    }
+    for (auto id : response_events_) {
+        scheduler_.cancel(id);
+    }
+    for (auto* socket : sockets_) {
+        if (socket) {
+            socket->replay_ = nullptr;
+        }
+    }
+}
+
+Result<bool> CaptureReplay::load(const std::string& path) {
+    capture::CaptureReader reader;
+    auto open_result = reader.open(path);
+    if (open_result.has_error()) {
+        LOG_ERROR("Cannot open capture {}", path);
+        return open_result;
+    }
+
+    capture::CapturedFrame captured;
+    while (reader.next(captured)) {
+        size_t offset = capture::gptp_payload_offset(captured.data.data(), captured.data.size());
+        if (offset == 0 || captured.data.size() < offset + HEADER_SIZE) {
+            statistics_.frames_skipped++;
+            continue;
+        }
+        Frame frame;
+        frame.timestamp_ns = captured.timestamp_ns;
+        frame.interface_id = captured.interface_id;
+        frame.direction = captured.direction;
+        std::memcpy(frame.packet.ethernet.destination.data(), captured.data.data(), 6);
+        std::memcpy(frame.packet.ethernet.source.data(), captured.data.data() + 6, 6);
+        frame.packet.payload.assign(captured.data.begin() + static_cast<std::ptrdiff_t>(offset), captured.data.end());
+        frame.message_type = frame.packet.payload[0] & 0x0F;
+        frame.sequence_id = sequence_id_of(frame.packet.payload);
+        frames_.push_back(std::move(frame));
+    }
+    damaged_ = reader.is_damaged();
+    if (damaged_) {
+        LOG_WARN("Capture {} is truncated or damaged; replaying the first {} frames", path, frames_.size());
+    }
+
+    interfaces_ = reader.interfaces();
+    if (interfaces_.empty() || frames_.empty()) {
+        LOG_ERROR("Capture {} holds no gPTP frames", path);
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+    std::stable_sort(frames_.begin(), frames_.end(),
+                     [](const Frame& a, const Frame& b) { return a.timestamp_ns < b.timestamp_ns; });
+    statistics_.frames_loaded = frames_.size();
+    shift_ns_ = frames_.front().timestamp_ns - scheduler_.now_ns();
+    sockets_.assign(interfaces_.size(), nullptr);
+
+    for (const auto& frame : frames_) {
+        if (frame.direction == capture::Direction::OUTBOUND) {
+            set_clock_identity(identity_at(frame.packet.payload, SOURCE_PORT_OFFSET));
+            break;
+        }
+    }
+    if (!has_identity_) {
+        for (const auto& frame : frames_) {
+            const auto& mac = interfaces_[frame.interface_id].mac;
+            if (mac != std::array<uint8_t, 6>{} && frame.packet.ethernet.source == mac) {
+                set_clock_identity(identity_at(frame.packet.payload, SOURCE_PORT_OFFSET));
+                break;
+            }
+        }
+    }
+    return Result<bool>::success(true);
+}
+
+void CaptureReplay::set_clock_identity(const ClockIdentity& identity) {
+    identity_ = identity;
+    has_identity_ = true;
+}
+
+std::unique_ptr<ReplaySocket> CaptureReplay::create_socket(uint32_t interface_id) {
+    if (interface_id >= interfaces_.size() || sockets_[interface_id]) {
+        return nullptr;
+    }
+    const auto& interface = interfaces_[interface_id];
+    auto socket = std::make_unique<ReplaySocket>(*this, interface_id, interface.name, interface.mac);
+    sockets_[interface_id] = socket.get();
+    return socket;
+}
+
+void CaptureReplay::start() {
+    // Directions the capture left open follow from the recorded clock identity
+    for (auto& frame : frames_) {
+        if (frame.direction == capture::Direction::UNKNOWN) {
+            bool own = has_identity_ && identity_at(frame.packet.payload, SOURCE_PORT_OFFSET) == identity_;
+            frame.direction = own ? capture::Direction::OUTBOUND : capture::Direction::INBOUND;
+        }
+    }
+
+    // Recorded Pdelay exchanges of the recorded system, by interface and sequence id
+    std::map<std::pair<uint32_t, uint16_t>, size_t> requests;
+    for (size_t i = 0; i < frames_.size(); ++i) {
+        Frame& frame = frames_[i];
+        if (frame.direction == capture::Direction::OUTBOUND) {
+            outbound_[{frame.interface_id, frame.message_type}].push_back(i);
+            if (frame.message_type == static_cast<uint8_t>(protocol::MessageType::PDELAY_REQ)) {
+                requests[{frame.interface_id, frame.sequence_id}] = i;
+            }
+            continue;
+        }
+        if (!is_pdelay_response(frame.message_type) || !has_identity_ ||
+            frame.packet.payload.size() < REQUESTING_PORT_OFFSET + PORT_IDENTITY_SIZE ||
+            !(identity_at(frame.packet.payload, REQUESTING_PORT_OFFSET) == identity_)) {
+            continue;
+        }
+        auto request = requests.find({frame.interface_id, frame.sequence_id});
+        if (request != requests.end() && frame.timestamp_ns - frames_[request->second].timestamp_ns < MATCH_WINDOW_NS) {
+            frames_[request->second].responses.push_back(i);
+            frame.held = true;
+        }
+    }
+
+    cursor_ = 0;
+    schedule_next();
+}
+
+int64_t CaptureReplay::end_time_ns() const {
+    return frames_.empty() ? scheduler_.now_ns() : frames_.back().timestamp_ns - shift_ns_;
+}
+
+void CaptureReplay::schedule_next() {
+    next_event_ = 0;
+    while (cursor_ < frames_.size() &&
+           (frames_[cursor_].direction == capture::Direction::OUTBOUND || frames_[cursor_].held)) {
+        cursor_++;
+    }
+    if (cursor_ >= frames_.size()) {
+        return;
+    }
+    int64_t due_ns = std::max(frames_[cursor_].timestamp_ns - shift_ns_, scheduler_.now_ns());
+    next_event_ = scheduler_.schedule_at(due_ns, [this]() {
+        const Frame& frame = frames_[cursor_++];
+        ReplaySocket* socket = frame.interface_id < sockets_.size() ? sockets_[frame.interface_id] : nullptr;
+        if (socket) {
+            statistics_.frames_delivered++;
+            socket->deliver(frame.packet, frame.timestamp_ns);
+        }
+        schedule_next();
+    });
+}
+
+void CaptureReplay::schedule_response(size_t index, const GptpPacket& request) {
+    const Frame& frame = frames_[index];
+    GptpPacket response = frame.packet;
+    std::copy(request.payload.begin() + SEQUENCE_ID_OFFSET, request.payload.begin() + SEQUENCE_ID_OFFSET + 2,
+              response.payload.begin() + SEQUENCE_ID_OFFSET);
+    std::copy(request.payload.begin() + SOURCE_PORT_OFFSET,
+              request.payload.begin() + SOURCE_PORT_OFFSET + PORT_IDENTITY_SIZE,
+              response.payload.begin() + REQUESTING_PORT_OFFSET);
+
+    // Never before the request: the stack has to see its TX timestamp first
+    int64_t due_ns = std::max(frame.timestamp_ns - shift_ns_, scheduler_.now_ns() + 1);
+    uint32_t interface_id = frame.interface_id;
+    int64_t timestamp_ns = frame.timestamp_ns;
+    auto id = std::make_shared<EventScheduler::EventId>(0);
+    *id = scheduler_.schedule_at(due_ns, [this, id, interface_id, timestamp_ns, response]() {
+        response_events_.erase(*id);
+        ReplaySocket* socket = sockets_[interface_id];
+        if (socket) {
+            statistics_.frames_delivered++;
+            socket->deliver(response, timestamp_ns);
+        }
+    });
+    response_events_.insert(*id);
+}
+
+CaptureReplay::Frame* CaptureReplay::find_outbound(uint32_t interface_id, uint8_t message_type, int64_t capture_ns) {
+    auto candidates = outbound_.find({interface_id, message_type});
+    if (candidates == outbound_.end()) {
+        return nullptr;
+    }
+    const auto& indices = candidates->second;
+    auto it = std::lower_bound(indices.begin(), indices.end(), capture_ns - MATCH_WINDOW_NS,
+                               [this](size_t index, int64_t time_ns) { return frames_[index].timestamp_ns < time_ns; });
+    Frame* best = nullptr;
+    int64_t best_distance = std::numeric_limits<int64_t>::max();
+    for (; it != indices.end() && frames_[*it].timestamp_ns <= capture_ns + MATCH_WINDOW_NS; ++it) {
+        Frame& frame = frames_[*it];
+        int64_t distance = std::abs(frame.timestamp_ns - capture_ns);
+        if (!frame.used && distance < best_distance) {
+            best = &frame;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+void CaptureReplay::transmit(ReplaySocket& socket, const GptpPacket& packet, PacketTimestamp& timestamp) {
+    int64_t now_capture_ns = capture_time_ns(scheduler_.now_ns());
+    timestamp.source = TimestampSource::HARDWARE;
+    timestamp.hardware_timestamp = std::chrono::nanoseconds(now_capture_ns);
+
+    Frame* recorded = nullptr;
+    if (packet.payload.size() >= HEADER_SIZE) {
+        recorded = find_outbound(socket.interface_id_, packet.payload[0] & 0x0F, now_capture_ns);
+    }
+    if (!recorded) {
+        statistics_.tx_timestamps_extrapolated++;
+        return;
+    }
+
+    recorded->used = true;
+    timestamp.hardware_timestamp = std::chrono::nanoseconds(recorded->timestamp_ns);
+    statistics_.tx_timestamps_recorded++;
+    if (!recorded->responses.empty()) {
+        statistics_.pdelay_exchanges_paired++;
+        for (size_t index : recorded->responses) {
+            schedule_response(index, packet);
+        }
+    }
+}
+
+void CaptureReplay::detach(ReplaySocket& socket) {
+    if (socket.interface_id_ < sockets_.size() && sockets_[socket.interface_id_] == &socket) {
+        sockets_[socket.interface_id_] = nullptr;
+    }
+}
+
+// ============================================================================
+// ReplayedTimeAwareSystem Implementation
+// ============================================================================
+
+ReplayedTimeAwareSystem::ReplayedTimeAwareSystem(CaptureReplay& replay, const ClockIdentity& identity)
+    : replay_(replay)
+    , scheduler_(replay.scheduler())
+    , tick_event_(0) {
+    port_manager_ = std::make_unique<GptpPortManager>(identity,
+        [this](uint16_t port_id, const std::vector<uint8_t>& payload) {
+            if (port_id == 0 || port_id > ports_.size()) {
+                return;
+            }
+            Port& port = ports_[port_id - 1];
+            GptpPacket packet;
+            packet.set_source_mac(port.socket->get_interface_mac().value());
+            packet.payload = payload;
+            PacketTimestamp timestamp;
+            port.last_tx_valid = port.socket->send_packet(packet, timestamp).is_success();
+            port.last_tx = to_timestamp(timestamp.get_best_timestamp().count());
+        });
+    port_manager_->set_tx_timestamp_provider([this](uint16_t port_id, Timestamp& tx_time) {
+        if (port_id == 0 || port_id > ports_.size() || !ports_[port_id - 1].last_tx_valid) {
+            return false;
+        }
+        tx_time = ports_[port_id - 1].last_tx;
+        return true;
+    });
+
+    for (size_t i = 0; i < replay_.interface_count(); ++i) {
+        auto port_id = static_cast<uint16_t>(ports_.size() + 1);
+        Port port;
+        port.socket = replay_.create_socket(static_cast<uint32_t>(i));
+        if (!port.socket || port.socket->initialize(port.socket->get_interface_name()).has_error()) {
+            continue;
+        }
+        port.socket->start_async_receive([this, port_id](const ReceivedPacket& received) {
+            port_manager_->process_frame(port_id, received.packet.payload.data(), received.packet.payload.size(),
+                                         to_timestamp(received.timestamp.get_best_timestamp().count()));
+        });
+        ports_.push_back(std::move(port));
+        port_manager_->add_port(port_id);
+    }
+}
+
+ReplayedTimeAwareSystem::~ReplayedTimeAwareSystem() {
+    stop();
+}
+
+void ReplayedTimeAwareSystem::start(std::chrono::nanoseconds tick) {
+    stop();
+    for (size_t i = 0; i < ports_.size(); ++i) {
+        port_manager_->enable_port(static_cast<uint16_t>(i + 1));
+    }
+    replay_.start();
+    tick_event_ = scheduler_.schedule_every(tick, [this]() {
+        port_manager_->run_periodic_tasks(scheduler_.now());
+    });
+}
+
+void ReplayedTimeAwareSystem::stop() {
+    if (tick_event_ != 0) {
+        scheduler_.cancel(tick_event_);
+        tick_event_ = 0;
+        for (size_t i = 0; i < ports_.size(); ++i) {
+            port_manager_->disable_port(static_cast<uint16_t>(i + 1));
+        }
+    }
+}
+
+} // namespace sim
+} // namespace gptp
@@ -0,0 +1,224 @@
+/**
+ * @file replay_socket.hpp
+ * @brief Feed a pcapng or pcap capture back into the stack on virtual time
+ *
+ * Inbound frames of the capture are delivered at their capture time with
+ * their captured timestamp as the hardware RX timestamp. Frames the stack
+ * sends are matched to the nearest recorded frame of the same type on the
+ * same interface, whose timestamp becomes the TX timestamp; when nothing
+ * matches, the TX timestamp is the capture time of the moment of sending.
+ *
+ * Pdelay_Req sequence ids of the replayed stack do not line up with the
+ * recorded ones, so the recorded responses to each recorded Pdelay_Req are
+ * held back and handed to the stack's matching request instead, with its
+ * sequence id and port identity. Link delay then comes out of the recorded
+ * timestamps alone.
+ */
+
+#pragma once
+
+#include "virtual_time.hpp"
+#include "../utils/pcapng.hpp"
+#include "../../include/gptp_port_manager.hpp"
+#include "../../include/gptp_socket.hpp"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace gptp {
+namespace sim {
+
+class CaptureReplay;
+
+/**
+ * @brief IGptpSocket on one interface of a capture
+ *
+ * Frames go to the async callback when one is set, else to a receive
+ * queue; receive_packet() reports TIMEOUT when the queue is empty.
+ */
+class ReplaySocket : public IGptpSocket {
+public:
+    ReplaySocket(CaptureReplay& replay, uint32_t interface_id, std::string interface_name,
+                 const std::array<uint8_t, 6>& mac);
+    ~ReplaySocket() override;
+
+    ReplaySocket(const ReplaySocket&) = delete;
+    ReplaySocket& operator=(const ReplaySocket&) = delete;
+
+    Result<bool> initialize(const std::string& interface_name) override;
+    void cleanup() override;
+    Result<bool> send_packet(const GptpPacket& packet, PacketTimestamp& timestamp) override;
+    Result<ReceivedPacket> receive_packet(uint32_t timeout_ms = 0) override;
+    Result<ReceivedPacket> try_receive_packet() override;
+    Result<bool> start_async_receive(PacketCallback callback) override;
+    void stop_async_receive() override;
+    bool is_hardware_timestamping_available() const override { return true; }
+    Result<std::array<uint8_t, 6>> get_interface_mac() const override;
+    std::string get_interface_name() const override { return interface_name_; }
+
+    /**
+     * @brief Called by the replay when a frame is due
+     */
+    void deliver(const GptpPacket& packet, int64_t timestamp_ns);
+
+private:
+    CaptureReplay* replay_;                 // Null once the replay is gone
+    uint32_t interface_id_;
+    std::string interface_name_;
+    std::array<uint8_t, 6> mac_;
+    bool initialized_;
+    PacketCallback callback_;
+    std::deque<ReceivedPacket> queue_;
+
+    friend class CaptureReplay;
+};
+
+/**
+ * @brief A capture loaded for replay on an EventScheduler
+ *
+ * Capture time maps onto virtual time with a constant shift fixed by
+ * load(): the first frame of the capture is due at the scheduler's
+ * current time.
+ */
+class CaptureReplay {
+public:
+    struct Statistics {
+        uint64_t frames_loaded = 0;
+        uint64_t frames_skipped = 0;            // Not gPTP or too short
+        uint64_t frames_delivered = 0;
+        uint64_t tx_timestamps_recorded = 0;    // Taken from a matching outbound frame
+        uint64_t tx_timestamps_extrapolated = 0;
+        uint64_t pdelay_exchanges_paired = 0;
+    };
+
+    explicit CaptureReplay(EventScheduler& scheduler);
+    ~CaptureReplay();
+
+    CaptureReplay(const CaptureReplay&) = delete;
+    CaptureReplay& operator=(const CaptureReplay&) = delete;
+
+    /**
+     * @brief Read a whole capture
+     *
+     * The clock identity of the recorded system is taken from its first
+     * outbound frame, or from a frame sent with an interface's own MAC.
+     */
+    Result<bool> load(const std::string& path);
+
+    /**
+     * @brief Override the recorded system's clock identity
+     *
+     * Needed for captures without directions or interface MACs, such as
+     * classic pcap, where it tells outbound frames from inbound ones.
+     */
+    void set_clock_identity(const ClockIdentity& identity);
+    bool has_clock_identity() const { return has_identity_; }
+    const ClockIdentity& get_clock_identity() const { return identity_; }
+
+    size_t interface_count() const { return interfaces_.size(); }
+    const capture::CaptureInterface& get_interface(size_t index) const { return interfaces_[index]; }
+
+    /**
+     * @brief Socket for an interface of the capture
+     */
+    std::unique_ptr<ReplaySocket> create_socket(uint32_t interface_id);
+
+    /**
+     * @brief Start delivering inbound frames; create the sockets first
+     */
+    void start();
+
+    /**
+     * @brief Virtual time of the last frame of the capture
+     */
+    int64_t end_time_ns() const;
+
+    /**
+     * @brief Capture time at a virtual time
+     */
+    int64_t capture_time_ns(int64_t virtual_ns) const { return virtual_ns + shift_ns_; }
+
+    EventScheduler& scheduler() { return scheduler_; }
+    bool is_damaged() const { return damaged_; }
+    const Statistics& get_statistics() const { return statistics_; }
+
+private:
+    struct Frame {
+        int64_t timestamp_ns = 0;           // Capture time
+        uint32_t interface_id = 0;
+        capture::Direction direction = capture::Direction::UNKNOWN;
+        uint8_t message_type = 0;
+        uint16_t sequence_id = 0;
+        bool held = false;                  // Response handed out by a Pdelay_Req of the stack
+        bool used = false;                  // Outbound frame whose timestamp was handed out
+        std::vector<size_t> responses;      // Of a recorded outbound Pdelay_Req
+        GptpPacket packet;
+    };
+
+    void transmit(ReplaySocket& socket, const GptpPacket& packet, PacketTimestamp& timestamp);
+    void detach(ReplaySocket& socket);
+    void schedule_next();
+    void schedule_response(size_t index, const GptpPacket& request);
+    Frame* find_outbound(uint32_t interface_id, uint8_t message_type, int64_t capture_ns);
+
+    EventScheduler& scheduler_;
+    std::vector<capture::CaptureInterface> interfaces_;
+    std::vector<Frame> frames_;
+    std::map<std::pair<uint32_t, uint8_t>, std::vector<size_t>> outbound_;   // By interface and message type
+    std::vector<ReplaySocket*> sockets_;    // By interface id
+    ClockIdentity identity_;
+    bool has_identity_;
+    bool damaged_;
+    int64_t shift_ns_;                      // Capture minus virtual time
+    size_t cursor_;                         // Next frame to deliver
+    EventScheduler::EventId next_event_;
+    std::set<EventScheduler::EventId> response_events_;
+    Statistics statistics_;
+
+    friend class ReplaySocket;
+};
+
+/**
+ * @brief A GptpPortManager with one port per interface of a capture
+ *
+ * No clock adjuster is installed: the recorded timestamps already carry
+ * the corrections of the recorded servo, so the replayed servo's output
+ * has nothing to act on and its offsets are the recorded system's.
+ */
+class ReplayedTimeAwareSystem {
+public:
+    ReplayedTimeAwareSystem(CaptureReplay& replay, const ClockIdentity& identity);
+    ~ReplayedTimeAwareSystem();
+
+    ReplayedTimeAwareSystem(const ReplayedTimeAwareSystem&) = delete;
+    ReplayedTimeAwareSystem& operator=(const ReplayedTimeAwareSystem&) = delete;
+
+    /**
+     * @brief Enable the ports, start the replay and tick periodically
+     */
+    void start(std::chrono::nanoseconds tick = std::chrono::milliseconds(10));
+    void stop();
+
+    GptpPortManager& port_manager() { return *port_manager_; }
+
+private:
+    struct Port {
+        std::unique_ptr<ReplaySocket> socket;
+        Timestamp last_tx;
+        bool last_tx_valid = false;
+    };
+
+    CaptureReplay& replay_;
+    EventScheduler& scheduler_;
+    std::unique_ptr<GptpPortManager> port_manager_;
+    std::vector<Port> ports_;
+    EventScheduler::EventId tick_event_;
+};
+
+} // namespace sim
+} // namespace gptp
@@ -0,0 +1,412 @@
+/**
+ * @file simulated_network.cpp
+ * @brief In-process virtual network behind IGptpSocket
+ */
+
+#include "simulated_network.hpp"
+#include "../networking/recording_socket.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace gptp {
+namespace sim {
+
+namespace {
+    constexpr int64_t WANDER_STEP_NS = 1000000000LL;
+
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+
+    int64_t scale(int64_t elapsed_ns, double ppb) {
+        return elapsed_ns + std::llround(static_cast<double>(elapsed_ns) * ppb * 1e-9);
+    }
+}
+
+// ============================================================================
+// SimulatedNode Implementation
+// ============================================================================
+
+SimulatedNode::SimulatedNode(SimulatedNetwork& network, uint16_t node_id, std::string name,
+                             const OscillatorModel& oscillator, uint64_t seed)
+    : network_(network)
+    , node_id_(node_id)
+    , name_(std::move(name))
+    , oscillator_(oscillator)
+    , rng_(seed)
+    , frequency_error_ppb_(oscillator.frequency_error_ppb)
+    , correction_ppb_(0.0) {
+    base_true_ns_ = network_.true_time_ns();
+    base_local_ns_ = base_true_ns_ + oscillator_.initial_offset_ns;
+    next_wander_ns_ = base_true_ns_ + WANDER_STEP_NS;
+}
+
+void SimulatedNode::advance_to(int64_t true_ns) {
+    // Frequency changes only at wander steps, so local time stays piecewise linear
+    while (oscillator_.wander_ppb > 0.0 && next_wander_ns_ <= true_ns) {
+        base_local_ns_ += scale(next_wander_ns_ - base_true_ns_, frequency_error_ppb_ + correction_ppb_);
+        base_true_ns_ = next_wander_ns_;
+        frequency_error_ppb_ += std::normal_distribution<double>(0.0, oscillator_.wander_ppb)(rng_);
+        next_wander_ns_ += WANDER_STEP_NS;
+    }
+    base_local_ns_ += scale(true_ns - base_true_ns_, frequency_error_ppb_ + correction_ppb_);
+    base_true_ns_ = true_ns;
+}
+
+int64_t SimulatedNode::local_time_ns() {
+    advance_to(network_.true_time_ns());
+    return base_local_ns_;
+}
+
+int64_t SimulatedNode::timestamp_at_ns(int64_t delay_ns) {
+    int64_t local = local_time_ns() + scale(delay_ns, frequency_error_ppb_ + correction_ppb_);
+    int64_t resolution = oscillator_.timestamp_resolution_ns;
+    return resolution > 1 ? local - local % resolution : local;
+}
+
+int64_t SimulatedNode::offset_from_true_ns() {
+    return local_time_ns() - network_.true_time_ns();
+}
+
+Result<bool> SimulatedNode::adjust_frequency(double ppb) {
+    advance_to(network_.true_time_ns());
+    correction_ppb_ = ppb;
+    return Result<bool>::success(true);
+}
+
+Result<bool> SimulatedNode::step_clock(std::chrono::nanoseconds offset) {
+    advance_to(network_.true_time_ns());
+    base_local_ns_ += offset.count();
+    return Result<bool>::success(true);
+}
+
+ClockIdentity SimulatedNode::get_clock_identity() const {
+    ClockIdentity identity;
+    const uint8_t bytes[8] = {0x02, 0x00, 0x00, 0xFF, 0xFE, 0x00,
+                              static_cast<uint8_t>(node_id_ >> 8), static_cast<uint8_t>(node_id_)};
+    std::copy(std::begin(bytes), std::end(bytes), identity.id.begin());
+    return identity;
+}
+
+// ============================================================================
+// SimulatedSocket Implementation
+// ============================================================================
+
+SimulatedSocket::SimulatedSocket(SimulatedNetwork& network, SimulatedNode& node, std::string interface_name,
+                                 const std::array<uint8_t, 6>& mac)
+    : network_(&network)
+    , node_(node)
+    , interface_name_(std::move(interface_name))
+    , mac_(mac)
+    , initialized_(false) {
+}
+
+SimulatedSocket::~SimulatedSocket() {
+    if (network_) {
+        network_->detach(*this);
+    }
+}
+
+Result<bool> SimulatedSocket::initialize(const std::string& interface_name) {
+    if (interface_name != interface_name_ || !network_) {
+        return Result<bool>::error(ErrorCode::INTERFACE_NOT_FOUND);
+    }
+    initialized_ = true;
+    return Result<bool>::success(true);
+}
+
+void SimulatedSocket::cleanup() {
+    initialized_ = false;
+    callback_ = nullptr;
+    queue_.clear();
+}
+
+Result<bool> SimulatedSocket::send_packet(const GptpPacket& packet, PacketTimestamp& timestamp) {
+    if (!initialized_ || !network_) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    int64_t egress_ns = network_->egress_latency_ns(*this);
+    timestamp.hardware_timestamp = std::chrono::nanoseconds(node_.timestamp_at_ns(egress_ns));
+    timestamp.software_timestamp = std::chrono::nanoseconds(network_->true_time_ns());
+    timestamp.software_timestamp_valid = true;
+    timestamp.source = TimestampSource::HARDWARE;
+    network_->transmit(*this, packet);
+    return Result<bool>::success(true);
+}
+
+void SimulatedSocket::deliver(const GptpPacket& packet) {
+    if (!initialized_) {
+        return;
+    }
+    PacketTimestamp timestamp;
+    timestamp.hardware_timestamp = std::chrono::nanoseconds(node_.timestamp_ns());
+    timestamp.software_timestamp = std::chrono::nanoseconds(network_->true_time_ns());
+    timestamp.software_timestamp_valid = true;
+    timestamp.source = TimestampSource::HARDWARE;
+
+    if (callback_) {
+        callback_(ReceivedPacket(packet, timestamp, interface_name_));
+    } else {
+        queue_.emplace_back(packet, timestamp, interface_name_);
+    }
+}
+
+Result<ReceivedPacket> SimulatedSocket::receive_packet(uint32_t) {
+    return try_receive_packet();
+}
+
+Result<ReceivedPacket> SimulatedSocket::try_receive_packet() {
+    if (queue_.empty()) {
+        return Result<ReceivedPacket>::error(ErrorCode::TIMEOUT);
+    }
+    ReceivedPacket received = std::move(queue_.front());
+    queue_.pop_front();
+    return Result<ReceivedPacket>::success(std::move(received));
+}
+
+Result<bool> SimulatedSocket::start_async_receive(PacketCallback callback) {
+    callback_ = std::move(callback);
+    while (callback_ && !queue_.empty()) {
+        ReceivedPacket received = std::move(queue_.front());
+        queue_.pop_front();
+        callback_(received);
+    }
+    return Result<bool>::success(true);
+}
+
+void SimulatedSocket::stop_async_receive() {
+    callback_ = nullptr;
+}
+
+Result<std::array<uint8_t, 6>> SimulatedSocket::get_interface_mac() const {
+    return Result<std::array<uint8_t, 6>>::success(mac_);
+}
+
+// ============================================================================
+// SimulatedNetwork Implementation
+// ============================================================================
+
+SimulatedNetwork::SimulatedNetwork(EventScheduler& scheduler, uint64_t seed)
+    : scheduler_(scheduler)
+    , rng_(seed) {
+}
+
+SimulatedNetwork::~SimulatedNetwork() {
+    for (auto& entry : endpoints_) {
+        if (entry.second.socket) {
+            entry.second.socket->network_ = nullptr;
+        }
+    }
+}
+
+SimulatedNode& SimulatedNetwork::add_node(const std::string& name, const OscillatorModel& oscillator) {
+    auto node_id = static_cast<uint16_t>(nodes_.size() + 1);
+    nodes_.push_back(std::make_unique<SimulatedNode>(*this, node_id, name, oscillator, rng_()));
+    return *nodes_.back();
+}
+
+std::unique_ptr<SimulatedSocket> SimulatedNetwork::create_socket(SimulatedNode& node,
+                                                                 const std::string& interface_name) {
+    if (endpoints_.count(interface_name) != 0) {
+        return nullptr;
+    }
+    auto serial = static_cast<uint32_t>(endpoints_.size() + 1);
+    std::array<uint8_t, 6> mac = {0x02, 0x00, static_cast<uint8_t>(serial >> 24), static_cast<uint8_t>(serial >> 16),
+                                  static_cast<uint8_t>(serial >> 8), static_cast<uint8_t>(serial)};
+    auto socket = std::make_unique<SimulatedSocket>(*this, node, interface_name, mac);
+    endpoints_[interface_name].socket = socket.get();
+    return socket;
+}
+
+Result<bool> SimulatedNetwork::connect(const std::string& interface_a, const std::string& interface_b,
+                                       const LinkModel& link) {
+    auto a = endpoints_.find(interface_a);
+    auto b = endpoints_.find(interface_b);
+    if (a == endpoints_.end() || b == endpoints_.end() || a == b ||
+        !a->second.peer.empty() || !b->second.peer.empty()) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+    a->second.peer = interface_b;
+    a->second.link = link;
+    a->second.a_side = true;
+    b->second.peer = interface_a;
+    b->second.link = link;
+    b->second.a_side = false;
+    return Result<bool>::success(true);
+}
+
+Result<bool> SimulatedNetwork::set_link_up(const std::string& interface_name, bool up) {
+    auto it = endpoints_.find(interface_name);
+    if (it == endpoints_.end()) {
+        return Result<bool>::error(ErrorCode::INTERFACE_NOT_FOUND);
+    }
+    it->second.up = up;
+    auto peer = endpoints_.find(it->second.peer);
+    if (peer != endpoints_.end()) {
+        peer->second.up = up;
+    }
+    return Result<bool>::success(true);
+}
+
+int64_t SimulatedNetwork::sample_delay(const Endpoint& from) {
+    const LinkModel& link = from.link;
+    int64_t delay = link.delay_ns + (from.a_side ? link.asymmetry_ns / 2 : -(link.asymmetry_ns / 2));
+    double jitter = 0.0;
+    switch (link.jitter) {
+        case JitterDistribution::NONE:
+            break;
+        case JitterDistribution::UNIFORM:
+            jitter = std::uniform_real_distribution<double>(0.0, static_cast<double>(link.jitter_ns))(rng_);
+            break;
+        case JitterDistribution::NORMAL:
+            jitter = std::fabs(std::normal_distribution<double>(0.0, static_cast<double>(link.jitter_ns))(rng_));
+            break;
+        case JitterDistribution::EXPONENTIAL:
+            if (link.jitter_ns > 0) {
+                jitter = std::exponential_distribution<double>(1.0 / static_cast<double>(link.jitter_ns))(rng_);
+            }
+            break;
+    }
+    return std::max<int64_t>(0, delay + std::llround(jitter));
+}
+
+void SimulatedNetwork::transmit(SimulatedSocket& socket, const GptpPacket& packet) {
+    statistics_.frames_sent++;
+    auto from = endpoints_.find(socket.interface_name_);
+    if (from == endpoints_.end() || from->second.peer.empty() || !from->second.up) {
+        statistics_.frames_lost++;
+        return;
+    }
+    Endpoint& endpoint = from->second;
+    if (endpoint.link.loss_probability > 0.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < endpoint.link.loss_probability) {
+        statistics_.frames_lost++;
+        return;
+    }
+
+    int64_t arrival = scheduler_.now_ns() + endpoint.link.egress_latency_ns + sample_delay(endpoint);
+    if (endpoint.link.reorder_probability > 0.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < endpoint.link.reorder_probability) {
+        arrival += endpoint.link.reorder_delay_ns;
+        statistics_.frames_reordered++;
+    } else {
+        // A cable is FIFO: jitter delays frames but does not swap them
+        arrival = std::max(arrival, endpoint.last_arrival_ns);
+        endpoint.last_arrival_ns = arrival;
+    }
+
+    std::string destination = endpoint.peer;
+    scheduler_.schedule_at(arrival, [this, destination, packet]() {
+        auto to = endpoints_.find(destination);
+        if (to == endpoints_.end() || to->second.socket == nullptr || !to->second.up) {
+            statistics_.frames_lost++;
+            return;
+        }
+        statistics_.frames_delivered++;
+        to->second.socket->deliver(packet);
+    });
+}
+
+int64_t SimulatedNetwork::egress_latency_ns(const SimulatedSocket& socket) const {
+    auto it = endpoints_.find(socket.interface_name_);
+    return it != endpoints_.end() && !it->second.peer.empty() ? it->second.link.egress_latency_ns : 0;
+}
+
+void SimulatedNetwork::detach(SimulatedSocket& socket) {
+    auto it = endpoints_.find(socket.interface_name_);
+    if (it != endpoints_.end() && it->second.socket == &socket) {
+        it->second.socket = nullptr;
+    }
+}
+
+// ============================================================================
+// SimulatedTimeAwareSystem Implementation
+// ============================================================================
+
+SimulatedTimeAwareSystem::SimulatedTimeAwareSystem(SimulatedNetwork& network, SimulatedNode& node)
+    : network_(network)
+    , node_(node)
+    , tick_event_(0)
+    , profiling_(false) {
+    port_manager_ = std::make_unique<GptpPortManager>(node_.get_clock_identity(),
+        [this](uint16_t port_id, const std::vector<uint8_t>& payload) {
+            if (port_id == 0 || port_id > ports_.size()) {
+                return;
+            }
+            Port& port = ports_[port_id - 1];
+            GptpPacket& packet = port.tx_packet;
+            packet.set_source_mac(port.socket->get_interface_mac().value());
+            packet.payload.assign(payload.begin(), payload.end());
+            PacketTimestamp timestamp;
+            port.last_tx_valid = port.socket->send_packet(packet, timestamp).is_success();
+            port.last_tx = to_timestamp(timestamp.get_best_timestamp().count());
+        });
+    port_manager_->set_tx_timestamp_provider([this](uint16_t port_id, Timestamp& tx_time) {
+        if (port_id == 0 || port_id > ports_.size() || !ports_[port_id - 1].last_tx_valid) {
+            return false;
+        }
+        tx_time = ports_[port_id - 1].last_tx;
+        return true;
+    });
+}
+
+SimulatedTimeAwareSystem::~SimulatedTimeAwareSystem() {
+    stop();
+}
+
+uint16_t SimulatedTimeAwareSystem::add_port(const std::string& interface_name) {
+    auto port_id = static_cast<uint16_t>(ports_.size() + 1);
+    Port port;
+    port.socket = network_.create_socket(node_, interface_name);
+    if (port.socket && capture_writer_) {
+        port.socket = std::make_unique<RecordingSocket>(std::move(port.socket), capture_writer_);
+    }
+    if (!port.socket || port.socket->initialize(interface_name).has_error()) {
+        return 0;
+    }
+    port.socket->start_async_receive([this, port_id](const ReceivedPacket& received) {
+        auto started = profiling_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        ParseResult result = port_manager_->process_frame(port_id, received.packet.payload.data(),
+                                                          received.packet.payload.size(),
+                                                          to_timestamp(received.timestamp.get_best_timestamp().count()));
+        statistics_.frames_received++;
+        statistics_.parse_errors += result == ParseResult::SUCCESS ? 0 : 1;
+        if (profiling_) {
+            statistics_.busy_ns += (std::chrono::steady_clock::now() - started).count();
+        }
+    });
+    ports_.push_back(std::move(port));
+    port_manager_->add_port(port_id);
+    return port_id;
+}
+
+void SimulatedTimeAwareSystem::start(std::chrono::nanoseconds tick) {
+    stop();
+    port_manager_->set_clock_adjuster(&node_);
+    for (size_t i = 0; i < ports_.size(); ++i) {
+        port_manager_->enable_port(static_cast<uint16_t>(i + 1));
+    }
+    tick_event_ = network_.scheduler().schedule_every(tick, [this]() {
+        auto started = profiling_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        port_manager_->run_periodic_tasks(network_.scheduler().now());
+        if (profiling_) {
+            statistics_.busy_ns += (std::chrono::steady_clock::now() - started).count();
+        }
+    });
+}
+
+void SimulatedTimeAwareSystem::stop() {
+    if (tick_event_ != 0) {
+        network_.scheduler().cancel(tick_event_);
+        tick_event_ = 0;
+        for (size_t i = 0; i < ports_.size(); ++i) {
+            port_manager_->disable_port(static_cast<uint16_t>(i + 1));
+        }
+    }
+}
+
+} // namespace sim
+} // namespace gptp
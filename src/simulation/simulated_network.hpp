@@ -0,0 +1,307 @@
+/**
+ * @file simulated_network.hpp
+ * @brief In-process virtual network behind IGptpSocket
+ *
+ * Nodes model their own oscillator and timestamp frames with it; links
+ * model propagation delay, asymmetry, jitter, loss and reordering. All
+ * randomness comes from one seeded generator and all time from an
+ * EventScheduler, so a topology replays identically for a given seed.
+ */
+
+#pragma once
+
+#include "virtual_time.hpp"
+#include "../../include/clock_adjuster.hpp"
+#include "../../include/gptp_port_manager.hpp"
+#include "../../include/gptp_socket.hpp"
+#include "../utils/pcapng.hpp"
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gptp {
+namespace sim {
+
+class SimulatedNetwork;
+
+/**
+ * @brief Free-running local oscillator of a node
+ */
+struct OscillatorModel {
+    int64_t initial_offset_ns = 0;          // Local minus true time at start
+    double frequency_error_ppb = 0.0;       // Positive: the oscillator runs fast
+    double wander_ppb = 0.0;                // Random-walk step of the frequency error per second, 1 sigma
+    int64_t timestamp_resolution_ns = 0;    // Timestamp granularity, 0 for exact (8 on I210)
+};
+
+/**
+ * @brief One time-aware system's clock; its adjuster is the simulated PHC
+ *
+ * Local time runs at (1 + error + correction) times the true rate,
+ * where the correction is what adjust_frequency() set last.
+ */
+class SimulatedNode : public IClockAdjuster {
+public:
+    SimulatedNode(SimulatedNetwork& network, uint16_t node_id, std::string name,
+                  const OscillatorModel& oscillator, uint64_t seed);
+
+    Result<bool> adjust_frequency(double ppb) override;
+    Result<bool> step_clock(std::chrono::nanoseconds offset) override;
+    std::string get_name() const override { return name_; }
+
+    /**
+     * @brief Local clock now, ns since the epoch
+     */
+    int64_t local_time_ns();
+
+    /**
+     * @brief Local clock now, quantized like a hardware timestamp
+     */
+    int64_t timestamp_ns() { return timestamp_at_ns(0); }
+
+    /**
+     * @brief Hardware timestamp of an event delay_ns in the future
+     */
+    int64_t timestamp_at_ns(int64_t delay_ns);
+
+    /**
+     * @brief Local minus true time now
+     */
+    int64_t offset_from_true_ns();
+
+    double get_frequency_error_ppb() const { return frequency_error_ppb_; }
+    double get_correction_ppb() const { return correction_ppb_; }
+    uint16_t get_node_id() const { return node_id_; }
+
+    /**
+     * @brief Clock identity derived from the node id
+     */
+    ClockIdentity get_clock_identity() const;
+
+private:
+    void advance_to(int64_t true_ns);
+
+    SimulatedNetwork& network_;
+    uint16_t node_id_;
+    std::string name_;
+    OscillatorModel oscillator_;
+    std::mt19937_64 rng_;
+    double frequency_error_ppb_;
+    double correction_ppb_;
+    int64_t base_true_ns_;                  // Local time is linear since this true time
+    int64_t base_local_ns_;
+    int64_t next_wander_ns_;
+};
+
+/**
+ * @brief Delay distribution of frames on a link
+ */
+enum class JitterDistribution {
+    NONE,
+    UNIFORM,            // [0, jitter_ns]
+    NORMAL,             // |N(0, jitter_ns)|
+    EXPONENTIAL         // Mean jitter_ns, the long tail of a queueing bridge
+};
+
+/**
+ * @brief Properties of a full-duplex link
+ */
+struct LinkModel {
+    int64_t egress_latency_ns = 1000;       // From send_packet() to the wire, where TX is timestamped
+    int64_t delay_ns = 500;                 // Mean one-way propagation delay
+    int64_t asymmetry_ns = 0;               // A->B is delay + asymmetry/2, B->A delay - asymmetry/2
+    JitterDistribution jitter = JitterDistribution::NONE;
+    int64_t jitter_ns = 0;
+    double loss_probability = 0.0;
+    double reorder_probability = 0.0;       // Frame held back by reorder_delay_ns, later ones overtake it
+    int64_t reorder_delay_ns = 1000000;
+};
+
+/**
+ * @brief IGptpSocket on a SimulatedNetwork endpoint
+ *
+ * Timestamps are hardware timestamps of the owning node's clock. Frames
+ * go to the async callback when one is set, else to a receive queue;
+ * receive_packet() never blocks on virtual time and reports TIMEOUT
+ * when the queue is empty.
+ */
+class SimulatedSocket : public IGptpSocket {
+public:
+    SimulatedSocket(SimulatedNetwork& network, SimulatedNode& node, std::string interface_name,
+                    const std::array<uint8_t, 6>& mac);
+    ~SimulatedSocket() override;
+
+    SimulatedSocket(const SimulatedSocket&) = delete;
+    SimulatedSocket& operator=(const SimulatedSocket&) = delete;
+
+    Result<bool> initialize(const std::string& interface_name) override;
+    void cleanup() override;
+    Result<bool> send_packet(const GptpPacket& packet, PacketTimestamp& timestamp) override;
+    Result<ReceivedPacket> receive_packet(uint32_t timeout_ms = 0) override;
+    Result<ReceivedPacket> try_receive_packet() override;
+    Result<bool> start_async_receive(PacketCallback callback) override;
+    void stop_async_receive() override;
+    bool is_hardware_timestamping_available() const override { return true; }
+    Result<std::array<uint8_t, 6>> get_interface_mac() const override;
+    std::string get_interface_name() const override { return interface_name_; }
+
+    SimulatedNode& get_node() { return node_; }
+
+    /**
+     * @brief Called by the network when a frame arrives
+     */
+    void deliver(const GptpPacket& packet);
+
+private:
+    SimulatedNetwork* network_;             // Null once the network is gone
+    SimulatedNode& node_;
+    std::string interface_name_;
+    std::array<uint8_t, 6> mac_;
+    bool initialized_;
+    PacketCallback callback_;
+    std::deque<ReceivedPacket> queue_;
+
+    friend class SimulatedNetwork;
+};
+
+/**
+ * @brief Nodes, links and frame delivery on an EventScheduler
+ *
+ * Sockets must be destroyed before the network or detach themselves;
+ * nodes are owned by the network.
+ */
+class SimulatedNetwork {
+public:
+    struct Statistics {
+        uint64_t frames_sent = 0;
+        uint64_t frames_delivered = 0;
+        uint64_t frames_lost = 0;           // Link loss, link down or unconnected endpoint
+        uint64_t frames_reordered = 0;
+    };
+
+    explicit SimulatedNetwork(EventScheduler& scheduler, uint64_t seed = 1);
+    ~SimulatedNetwork();
+
+    SimulatedNetwork(const SimulatedNetwork&) = delete;
+    SimulatedNetwork& operator=(const SimulatedNetwork&) = delete;
+
+    SimulatedNode& add_node(const std::string& name, const OscillatorModel& oscillator = OscillatorModel());
+
+    /**
+     * @brief Socket for a new interface of a node; interface names are network-wide
+     */
+    std::unique_ptr<SimulatedSocket> create_socket(SimulatedNode& node, const std::string& interface_name);
+
+    /**
+     * @brief Cable two interfaces together
+     */
+    Result<bool> connect(const std::string& interface_a, const std::string& interface_b,
+                         const LinkModel& link = LinkModel());
+
+    /**
+     * @brief Carrier of the link on an interface; down drops frames both ways
+     */
+    Result<bool> set_link_up(const std::string& interface_name, bool up);
+
+    EventScheduler& scheduler() { return scheduler_; }
+    const Statistics& get_statistics() const { return statistics_; }
+    size_t node_count() const { return nodes_.size(); }
+    SimulatedNode& node(size_t index) { return *nodes_[index]; }
+
+    /**
+     * @brief True time now, ns since the epoch
+     */
+    int64_t true_time_ns() { return scheduler_.clock().now_realtime_ns(); }
+
+private:
+    struct Endpoint {
+        SimulatedSocket* socket = nullptr;
+        std::string peer;                   // Empty while unconnected
+        LinkModel link;
+        bool a_side = true;                 // Direction for the asymmetry
+        bool up = true;
+        int64_t last_arrival_ns = 0;        // Keeps non-reordered frames in order
+    };
+
+    void transmit(SimulatedSocket& socket, const GptpPacket& packet);
+    void detach(SimulatedSocket& socket);
+    int64_t egress_latency_ns(const SimulatedSocket& socket) const;
+    int64_t sample_delay(const Endpoint& from);
+
+    EventScheduler& scheduler_;
+    std::mt19937_64 rng_;
+    std::vector<std::unique_ptr<SimulatedNode>> nodes_;
+    std::map<std::string, Endpoint> endpoints_;
+    Statistics statistics_;
+
+    friend class SimulatedSocket;
+};
+
+/**
+ * @brief A GptpPortManager wired to a node and its simulated sockets
+ */
+class SimulatedTimeAwareSystem {
+public:
+    struct Statistics {
+        uint64_t frames_received = 0;
+        uint64_t parse_errors = 0;
+        int64_t busy_ns = 0;                // Wall time in the stack, while profiling
+    };
+
+    SimulatedTimeAwareSystem(SimulatedNetwork& network, SimulatedNode& node);
+    ~SimulatedTimeAwareSystem();
+
+    SimulatedTimeAwareSystem(const SimulatedTimeAwareSystem&) = delete;
+    SimulatedTimeAwareSystem& operator=(const SimulatedTimeAwareSystem&) = delete;
+
+    /**
+     * @brief Add a port on a new interface; call before start()
+     * @return Port id
+     */
+    uint16_t add_port(const std::string& interface_name);
+
+    /**
+     * @brief Record every frame of ports added from now on
+     */
+    void set_capture_writer(std::shared_ptr<capture::PcapngWriter> writer) { capture_writer_ = std::move(writer); }
+
+    /**
+     * @brief Enable the ports, let the servo steer the node clock and tick periodically
+     */
+    void start(std::chrono::nanoseconds tick = std::chrono::milliseconds(10));
+    void stop();
+
+    /**
+     * @brief Measure the wall time spent processing frames and ticks
+     */
+    void set_profiling(bool enabled) { profiling_ = enabled; }
+
+    GptpPortManager& port_manager() { return *port_manager_; }
+    SimulatedNode& node() { return node_; }
+    const Statistics& get_statistics() const { return statistics_; }
+
+private:
+    struct Port {
+        std::unique_ptr<IGptpSocket> socket;
+        Timestamp last_tx;
+        bool last_tx_valid = false;
+        GptpPacket tx_packet;
+    };
+
+    SimulatedNetwork& network_;
+    SimulatedNode& node_;
+    std::unique_ptr<GptpPortManager> port_manager_;
+    std::shared_ptr<capture::PcapngWriter> capture_writer_;
+    std::vector<Port> ports_;
+    EventScheduler::EventId tick_event_;
+    bool profiling_;
+    Statistics statistics_;
+};
+
+} // namespace sim
+} // namespace gptp
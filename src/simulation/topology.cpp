@@ -0,0 +1,166 @@
+/**
+ * @file topology.cpp
+ * @brief Chains, rings, trees and random meshes of simulated time-aware systems
+ */
+
+#include "topology.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <set>
+
+namespace gptp {
+namespace sim {
+
+namespace {
+    int64_t draw(std::mt19937_64& rng, int64_t max_abs) {
+        if (max_abs <= 0) {
+            return 0;
+        }
+        return std::uniform_int_distribution<int64_t>(-max_abs, max_abs)(rng);
+    }
+
+    double draw(std::mt19937_64& rng, double max_abs) {
+        if (max_abs <= 0.0) {
+            return 0.0;
+        }
+        return std::uniform_real_distribution<double>(-max_abs, max_abs)(rng);
+    }
+}
+
+Topology::Topology(EventScheduler& scheduler, const TopologyOptions& options)
+    : options_(options)
+    , rng_(options.seed)
+    , network_(scheduler, options.seed) {
+}
+
+Topology::~Topology() {
+    // Systems hold sockets on the network
+    systems_.clear();
+}
+
+size_t Topology::add_node() {
+    OscillatorModel oscillator = options_.oscillator_spread;
+    oscillator.initial_offset_ns = draw(rng_, options_.oscillator_spread.initial_offset_ns);
+    oscillator.frequency_error_ppb = draw(rng_, options_.oscillator_spread.frequency_error_ppb);
+
+    size_t index = systems_.size();
+    SimulatedNode& node = network_.add_node("n" + std::to_string(index), oscillator);
+    systems_.push_back(std::make_unique<SimulatedTimeAwareSystem>(network_, node));
+    neighbours_.emplace_back();
+    return index;
+}
+
+void Topology::link(size_t a, size_t b) {
+    if (a == b || a >= systems_.size() || b >= systems_.size()) {
+        return;
+    }
+    auto port_name = [this](size_t index) {
+        return "n" + std::to_string(index) + ".p" + std::to_string(neighbours_[index].size() + 1);
+    };
+    std::string name_a = port_name(a);
+    std::string name_b = port_name(b);
+    if (systems_[a]->add_port(name_a) == 0 || systems_[b]->add_port(name_b) == 0) {
+        return;
+    }
+    network_.connect(name_a, name_b, options_.link);
+    neighbours_[a].push_back(b);
+    neighbours_[b].push_back(a);
+    links_.emplace_back(a, b);
+}
+
+void Topology::build(Kind kind, size_t nodes, double param) {
+    size_t first = systems_.size();
+    for (size_t i = 0; i < nodes; ++i) {
+        add_node();
+    }
+
+    switch (kind) {
+        case Kind::CHAIN:
+        case Kind::RING:
+            for (size_t i = 1; i < nodes; ++i) {
+                link(first + i - 1, first + i);
+            }
+            if (kind == Kind::RING && nodes > 2) {
+                link(first + nodes - 1, first);
+            }
+            break;
+        case Kind::TREE: {
+            size_t fan_out = std::max<size_t>(1, static_cast<size_t>(param));
+            for (size_t i = 1; i < nodes; ++i) {
+                link(first + (i - 1) / fan_out, first + i);
+            }
+            break;
+        }
+        case Kind::RANDOM_MESH: {
+            std::set<std::pair<size_t, size_t>> cabled;
+            for (size_t i = 1; i < nodes; ++i) {
+                size_t parent = std::uniform_int_distribution<size_t>(0, i - 1)(rng_);
+                link(first + parent, first + i);
+                cabled.emplace(parent, i);
+            }
+            auto extra = static_cast<size_t>(std::llround(param * static_cast<double>(nodes)));
+            size_t attempts = extra * 20;
+            while (extra > 0 && nodes > 2 && attempts-- > 0) {
+                size_t a = std::uniform_int_distribution<size_t>(0, nodes - 1)(rng_);
+                size_t b = std::uniform_int_distribution<size_t>(0, nodes - 1)(rng_);
+                if (a == b || !cabled.emplace(std::min(a, b), std::max(a, b)).second) {
+                    continue;
+                }
+                link(first + a, first + b);
+                extra--;
+            }
+            break;
+        }
+    }
+}
+
+void Topology::set_priority1(size_t index, uint8_t priority1) {
+    systems_[index]->port_manager().set_local_clock_properties(priority1, ClockQuality(), 248);
+}
+
+void Topology::start() {
+    for (auto& system : systems_) {
+        system->start(options_.tick);
+    }
+}
+
+void Topology::stop_node(size_t index) {
+    systems_[index]->stop();
+}
+
+std::vector<size_t> Topology::hop_distances(size_t from, size_t excluded) const {
+    std::vector<size_t> distance(systems_.size(), std::numeric_limits<size_t>::max());
+    std::deque<size_t> queue;
+    distance[from] = 0;
+    queue.push_back(from);
+    while (!queue.empty()) {
+        size_t current = queue.front();
+        queue.pop_front();
+        for (size_t next : neighbours_[current]) {
+            if (next != excluded && distance[next] == std::numeric_limits<size_t>::max()) {
+                distance[next] = distance[current] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return distance;
+}
+
+int64_t Topology::offset_between(size_t index, size_t reference) {
+    return node(index).local_time_ns() - node(reference).local_time_ns();
+}
+
+const char* Topology::kind_name(Kind kind) {
+    switch (kind) {
+        case Kind::CHAIN: return "chain";
+        case Kind::RING: return "ring";
+        case Kind::TREE: return "tree";
+        case Kind::RANDOM_MESH: return "mesh";
+    }
+    return "unknown";
+}
+
+} // namespace sim
+} // namespace gptp
@@ -0,0 +1,108 @@
+/**
+ * @file topology.hpp
+ * @brief Chains, rings, trees and random meshes of simulated time-aware systems
+ *
+ * A Topology owns the nodes' SimulatedTimeAwareSystems on one
+ * SimulatedNetwork and knows the cabling, so benchmarks and tests can ask
+ * for hop distances and ground-truth offsets without tracking ports.
+ */
+
+#pragma once
+
+#include "simulated_network.hpp"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace gptp {
+namespace sim {
+
+/**
+ * @brief Spread of the node oscillators and the links of a generated topology
+ *
+ * Each node draws its offset and frequency error uniformly from
+ * [-max, +max]; wander and timestamp resolution are taken as they are.
+ */
+struct TopologyOptions {
+    OscillatorModel oscillator_spread;
+    LinkModel link;
+    std::chrono::nanoseconds tick = std::chrono::milliseconds(10);
+    uint64_t seed = 1;
+};
+
+class Topology {
+public:
+    enum class Kind {
+        CHAIN,          // 0 - 1 - ... - n-1, grandmaster at one end
+        RING,           // Chain closed back to node 0
+        TREE,           // Complete tree of the given fan-out rooted at node 0
+        RANDOM_MESH     // Random spanning tree plus extra random links
+    };
+
+    Topology(EventScheduler& scheduler, const TopologyOptions& options);
+    ~Topology();
+
+    Topology(const Topology&) = delete;
+    Topology& operator=(const Topology&) = delete;
+
+    /**
+     * @brief Build a topology of the given kind
+     * @param param Fan-out for TREE, extra links per node (may be fractional) for RANDOM_MESH
+     */
+    void build(Kind kind, size_t nodes, double param = 0.0);
+
+    /**
+     * @brief Add a node with an oscillator drawn from the options
+     * @return Node index
+     */
+    size_t add_node();
+
+    /**
+     * @brief Cable two nodes with a new port on each; call before start()
+     */
+    void link(size_t a, size_t b);
+
+    /**
+     * @brief Make a node preferred by BMCA; lower priority1 wins
+     */
+    void set_priority1(size_t index, uint8_t priority1);
+
+    void start();
+
+    /**
+     * @brief Silence a node as if it lost power
+     */
+    void stop_node(size_t index);
+
+    size_t size() const { return systems_.size(); }
+    SimulatedTimeAwareSystem& system(size_t index) { return *systems_[index]; }
+    SimulatedNode& node(size_t index) { return systems_[index]->node(); }
+    SimulatedNetwork& network() { return network_; }
+    size_t link_count() const { return links_.size(); }
+
+    /**
+     * @brief Hops from a node to every node, SIZE_MAX if unreachable
+     * @param excluded Node treated as removed, e.g. a failed grandmaster
+     */
+    std::vector<size_t> hop_distances(size_t from, size_t excluded = SIZE_MAX) const;
+
+    /**
+     * @brief Local time of a node minus local time of another, ns
+     */
+    int64_t offset_between(size_t index, size_t reference);
+
+    static const char* kind_name(Kind kind);
+
+private:
+    TopologyOptions options_;
+    std::mt19937_64 rng_;
+    SimulatedNetwork network_;
+    std::vector<std::unique_ptr<SimulatedTimeAwareSystem>> systems_;
+    std::vector<std::vector<size_t>> neighbours_;
+    std::vector<std::pair<size_t, size_t>> links_;
+};
+
+} // namespace sim
+} // namespace gptp
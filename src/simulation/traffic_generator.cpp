@@ -0,0 +1,223 @@
+/**
+ * @file traffic_generator.cpp
+ * @brief Synthetic gPTP load from many clock identities
+ */
+
+#include "traffic_generator.hpp"
+#include "../../include/message_serializer.hpp"
+#include <cmath>
+
+namespace gptp {
+namespace sim {
+
+namespace {
+    constexpr size_t STREAMS = 4;
+    constexpr uint16_t SYNC_LENGTH = 44;
+    constexpr uint16_t PDELAY_REQ_LENGTH = 54;
+    constexpr uint16_t ANNOUNCE_LENGTH = 64;
+    constexpr uint16_t TWO_STEP_FLAG = 0x0200;
+    constexpr uint8_t RESERVED_MESSAGE_TYPES[] = {0x4, 0x5, 0x6, 0x7, 0xE, 0xF};
+
+    int64_t log_interval_ns(int log_interval) {
+        return static_cast<int64_t>(std::ldexp(1e9, log_interval));
+    }
+
+    GptpMessageHeader make_header(protocol::MessageType type, uint32_t index, uint16_t sequence_id,
+                                  uint16_t length, uint8_t control, int log_interval) {
+        GptpMessageHeader header;
+        header.messageType = static_cast<uint8_t>(type);
+        header.messageLength = length;
+        header.sourcePortIdentity.clockIdentity = TrafficGenerator::identity(index);
+        header.sourcePortIdentity.portNumber = 1;
+        header.sequenceId = sequence_id;
+        header.controlField = control;
+        header.logMessageInterval = static_cast<int8_t>(log_interval);
+        return header;
+    }
+
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+}
+
+TrafficGenerator::TrafficGenerator(IGptpSocket& socket, const TrafficProfile& profile, int64_t start_ns)
+    : socket_(socket)
+    , profile_(profile)
+    , rng_(profile.seed)
+    , sequence_ids_((profile.identities + profile.storm_identities) * STREAMS, 0) {
+    for (size_t i = 0; i < profile_.identities; ++i) {
+        auto index = static_cast<uint32_t>(i);
+        if (profile_.sync) {
+            schedule(index, Stream::SYNC, start_ns);
+        }
+        if (profile_.pdelay) {
+            schedule(index, Stream::PDELAY, start_ns);
+        }
+        if (profile_.announce) {
+            schedule(index, Stream::ANNOUNCE, start_ns);
+        }
+    }
+    for (size_t i = 0; i < profile_.storm_identities; ++i) {
+        schedule(static_cast<uint32_t>(profile_.identities + i), Stream::STORM, start_ns);
+    }
+}
+
+ClockIdentity TrafficGenerator::identity(size_t index) {
+    ClockIdentity identity;
+    const uint8_t bytes[8] = {0x0A, 0x4C, 0x47, 0xFF, 0xFE, static_cast<uint8_t>(index >> 16),
+                              static_cast<uint8_t>(index >> 8), static_cast<uint8_t>(index)};
+    std::copy(std::begin(bytes), std::end(bytes), identity.id.begin());
+    return identity;
+}
+
+double TrafficGenerator::frames_per_second(const TrafficProfile& profile) {
+    double per_identity = 0.0;
+    if (profile.sync) {
+        per_identity += 2.0 / std::ldexp(1.0, profile.sync_log_interval);
+    }
+    if (profile.pdelay) {
+        per_identity += 1.0 / std::ldexp(1.0, profile.pdelay_log_interval);
+    }
+    if (profile.announce) {
+        per_identity += 1.0 / std::ldexp(1.0, profile.announce_log_interval);
+    }
+    return per_identity * static_cast<double>(profile.identities) +
+           static_cast<double>(profile.storm_identities) / std::ldexp(1.0, profile.storm_log_interval);
+}
+
+int64_t TrafficGenerator::interval_ns(Stream stream) const {
+    switch (stream) {
+        case Stream::SYNC: return log_interval_ns(profile_.sync_log_interval);
+        case Stream::PDELAY: return log_interval_ns(profile_.pdelay_log_interval);
+        case Stream::ANNOUNCE: return log_interval_ns(profile_.announce_log_interval);
+        case Stream::STORM: return log_interval_ns(profile_.storm_log_interval);
+    }
+    return log_interval_ns(0);
+}
+
+void TrafficGenerator::schedule(uint32_t index, Stream stream, int64_t start_ns) {
+    // A random phase within the first interval spreads the identities out
+    int64_t interval = interval_ns(stream);
+    int64_t phase = std::uniform_int_distribution<int64_t>(0, interval - 1)(rng_);
+    queue_.push({start_ns + phase, index, stream});
+}
+
+size_t TrafficGenerator::run_until(int64_t now_ns) {
+    size_t sent = 0;
+    while (!queue_.empty() && queue_.top().due_ns <= now_ns) {
+        Due due = queue_.top();
+        queue_.pop();
+        emit(due);
+        sent++;
+        due.due_ns += interval_ns(due.stream);
+        queue_.push(due);
+    }
+    return sent;
+}
+
+void TrafficGenerator::emit(const Due& due) {
+    using serialization::MessageSerializer;
+    uint16_t& sequence_id = sequence_ids_[due.index * STREAMS + static_cast<size_t>(due.stream)];
+    auto id = static_cast<uint32_t>(profile_.first_identity + due.index);
+    PacketTimestamp timestamp;
+
+    switch (due.stream) {
+        case Stream::SYNC: {
+            SyncMessage sync;
+            sync.header = make_header(protocol::MessageType::SYNC, id, sequence_id, SYNC_LENGTH, 0x00,
+                                      profile_.sync_log_interval);
+            sync.header.flags = TWO_STEP_FLAG;
+            send(id, MessageSerializer::serialize_sync(sync), timestamp, statistics_.sync);
+
+            FollowUpMessage follow_up;
+            follow_up.header = make_header(protocol::MessageType::FOLLOW_UP, id, sequence_id, SYNC_LENGTH,
+                                           0x02, profile_.sync_log_interval);
+            follow_up.preciseOriginTimestamp = timestamp.is_valid() ? to_timestamp(timestamp.get_best_timestamp().count())
+                                                                    : to_timestamp(due.due_ns);
+            PacketTimestamp unused;
+            send(id, MessageSerializer::serialize_followup(follow_up), unused, statistics_.follow_up);
+            break;
+        }
+        case Stream::PDELAY: {
+            PdelayReqMessage request;
+            request.header = make_header(protocol::MessageType::PDELAY_REQ, id, sequence_id,
+                                         PDELAY_REQ_LENGTH, 0x05, profile_.pdelay_log_interval);
+            send(id, MessageSerializer::serialize_pdelay_req(request), timestamp, statistics_.pdelay_req);
+            break;
+        }
+        case Stream::ANNOUNCE:
+        case Stream::STORM: {
+            bool storm = due.stream == Stream::STORM;
+            AnnounceMessage announce;
+            announce.header = make_header(protocol::MessageType::ANNOUNCE, id, sequence_id, ANNOUNCE_LENGTH,
+                                          0x05, storm ? profile_.storm_log_interval : profile_.announce_log_interval);
+            announce.currentUtcOffset = 37;
+            announce.grandmasterIdentity = identity(id);
+            announce.grandmasterPriority1 = storm ? static_cast<uint8_t>(rng_() & 0xFF) : profile_.priority1;
+            announce.grandmasterPriority2 = storm ? static_cast<uint8_t>(rng_() & 0xFF) : 248;
+            announce.grandmasterClockQuality = (248u << 24) | (0xFEu << 16) | 0x436Au;
+            send(id, MessageSerializer::serialize_announce(announce), timestamp,
+                 storm ? statistics_.storm_announce : statistics_.announce);
+            break;
+        }
+    }
+    sequence_id++;
+}
+
+void TrafficGenerator::send(uint32_t index, std::vector<uint8_t> payload, PacketTimestamp& timestamp,
+                            uint64_t& counter) {
+    uint64_t* sent = &counter;
+    if (profile_.malformed_fraction > 0.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < profile_.malformed_fraction) {
+        corrupt(payload);
+        sent = &statistics_.malformed;
+    }
+
+    GptpPacket packet;
+    packet.set_source_mac({0x0A, 0x4C, 0x47, static_cast<uint8_t>(index >> 16), static_cast<uint8_t>(index >> 8),
+                           static_cast<uint8_t>(index)});
+    packet.payload = std::move(payload);
+    if (socket_.send_packet(packet, timestamp).has_error()) {
+        statistics_.send_errors++;
+        return;
+    }
+    (*sent)++;
+}
+
+void TrafficGenerator::corrupt(std::vector<uint8_t>& payload) {
+    switch (std::uniform_int_distribution<int>(0, 6)(rng_)) {
+        case 0:     // Truncated header
+            payload.resize(std::uniform_int_distribution<size_t>(1, 33)(rng_));
+            break;
+        case 1:     // Truncated body
+            payload.resize(std::uniform_int_distribution<size_t>(34, payload.size() - 1)(rng_));
+            break;
+        case 2:     // PTPv1
+            payload[1] = static_cast<uint8_t>((payload[1] & 0xF0) | 0x01);
+            break;
+        case 3: {   // Reserved messageType
+            size_t pick = std::uniform_int_distribution<size_t>(0, sizeof(RESERVED_MESSAGE_TYPES) - 1)(rng_);
+            payload[0] = static_cast<uint8_t>((payload[0] & 0xF0) | RESERVED_MESSAGE_TYPES[pick]);
+            break;
+        }
+        case 4: {   // messageLength beyond the frame
+            auto length = static_cast<uint16_t>(payload.size() + std::uniform_int_distribution<int>(1, 200)(rng_));
+            payload[2] = static_cast<uint8_t>(length >> 8);
+            payload[3] = static_cast<uint8_t>(length);
+            break;
+        }
+        case 5:     // transportSpecific of IEEE 1588 instead of 802.1AS
+            payload[0] &= 0x0F;
+            break;
+        default:    // Noise
+            for (auto& byte : payload) {
+                byte = static_cast<uint8_t>(rng_());
+            }
+            break;
+    }
+}
+
+} // namespace sim
+} // namespace gptp
@@ -0,0 +1,119 @@
+/**
+ * @file traffic_generator.hpp
+ * @brief Synthetic gPTP load from many clock identities
+ *
+ * Each synthetic identity is a neighbour port that runs its own Sync /
+ * Follow_Up, Pdelay_Req and Announce streams at configurable intervals,
+ * phase-shifted at random so thousands of them do not fire in lockstep.
+ * A share of the frames can be replaced by malformed ones, and a separate
+ * set of identities can run an announce storm: fast Announces claiming
+ * ever-changing grandmaster priorities.
+ *
+ * Frames go out through any IGptpSocket, a LinuxSocket on a veth pair or
+ * a SimulatedSocket, and are paced by whoever calls run_until().
+ */
+
+#pragma once
+
+#include "../../include/gptp_socket.hpp"
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace gptp {
+namespace sim {
+
+struct TrafficProfile {
+    size_t identities = 100;            // Synthetic neighbour ports, one clock identity each
+    size_t first_identity = 0;          // Index of the first, to keep several generators apart
+    int sync_log_interval = -3;         // Intervals are 2^n s; -7 is 7.8 ms
+    int pdelay_log_interval = 0;
+    int announce_log_interval = 0;
+    bool sync = true;
+    bool pdelay = true;
+    bool announce = true;
+    uint8_t priority1 = 254;            // Announced for the synthetic grandmasters
+    double malformed_fraction = 0.0;    // Share of frames replaced by a malformed variant
+    size_t storm_identities = 0;        // Identities announcing random priorities
+    int storm_log_interval = -7;
+    uint64_t seed = 1;
+};
+
+/**
+ * @brief Emits a TrafficProfile through a socket as time advances
+ */
+class TrafficGenerator {
+public:
+    struct Statistics {
+        uint64_t sync = 0;
+        uint64_t follow_up = 0;
+        uint64_t pdelay_req = 0;
+        uint64_t announce = 0;
+        uint64_t storm_announce = 0;
+        uint64_t malformed = 0;
+        uint64_t send_errors = 0;
+
+        uint64_t total() const { return sync + follow_up + pdelay_req + announce + storm_announce + malformed; }
+    };
+
+    /**
+     * @param start_ns Time of the first frames, in the caller's time base
+     */
+    TrafficGenerator(IGptpSocket& socket, const TrafficProfile& profile, int64_t start_ns);
+
+    /**
+     * @brief Send every frame due at or before now_ns
+     * @return Frames sent
+     */
+    size_t run_until(int64_t now_ns);
+
+    /**
+     * @brief Due time of the next frame
+     */
+    int64_t next_due_ns() const { return queue_.empty() ? INT64_MAX : queue_.top().due_ns; }
+
+    /**
+     * @brief Nominal frame rate of the profile, frames per second
+     */
+    static double frames_per_second(const TrafficProfile& profile);
+
+    /**
+     * @brief Clock identity of synthetic port index
+     */
+    static ClockIdentity identity(size_t index);
+
+    const Statistics& get_statistics() const { return statistics_; }
+
+private:
+    enum class Stream : uint8_t {
+        SYNC,
+        PDELAY,
+        ANNOUNCE,
+        STORM
+    };
+
+    struct Due {
+        int64_t due_ns;
+        uint32_t index;
+        Stream stream;
+
+        bool operator>(const Due& other) const { return due_ns > other.due_ns; }
+    };
+
+    void schedule(uint32_t index, Stream stream, int64_t due_ns);
+    void emit(const Due& due);
+    void send(uint32_t index, std::vector<uint8_t> payload, PacketTimestamp& timestamp, uint64_t& counter);
+    void corrupt(std::vector<uint8_t>& payload);
+    int64_t interval_ns(Stream stream) const;
+
+    IGptpSocket& socket_;
+    TrafficProfile profile_;
+    std::mt19937_64 rng_;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> queue_;
+    std::vector<uint16_t> sequence_ids_;    // Per identity and stream
+    Statistics statistics_;
+};
+
+} // namespace sim
+} // namespace gptp
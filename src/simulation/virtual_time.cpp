@@ -0,0 +1,138 @@
+/**
+ * @file virtual_time.cpp
+ * @brief Virtual clock and discrete-event scheduler for simulated runs
+ */
+
+#include "virtual_time.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace gptp {
+namespace sim {
+
+// ============================================================================
+// VirtualClockSource Implementation
+// ============================================================================
+
+VirtualClockSource::VirtualClockSource(int64_t start_monotonic_ns, int64_t realtime_offset_ns)
+    : monotonic_ns_(start_monotonic_ns)
+    , realtime_offset_ns_(realtime_offset_ns) {
+}
+
+int64_t VirtualClockSource::now_realtime_ns() {
+    return monotonic_ns_.load(std::memory_order_acquire) + realtime_offset_ns_;
+}
+
+int64_t VirtualClockSource::now_monotonic_ns() {
+    return monotonic_ns_.load(std::memory_order_acquire);
+}
+
+void VirtualClockSource::set_monotonic_ns(int64_t time_ns) {
+    if (time_ns > monotonic_ns_.load(std::memory_order_relaxed)) {
+        monotonic_ns_.store(time_ns, std::memory_order_release);
+    }
+}
+
+void VirtualClockSource::advance(std::chrono::nanoseconds delta) {
+    set_monotonic_ns(monotonic_ns_.load(std::memory_order_relaxed) + delta.count());
+}
+
+// ============================================================================
+// EventScheduler Implementation
+// ============================================================================
+
+EventScheduler::EventScheduler(int64_t start_monotonic_ns)
+    : clock_(start_monotonic_ns)
+    , next_sequence_(0)
+    , next_id_(1)
+    , events_run_(0) {
+}
+
+EventScheduler::EventId EventScheduler::push(int64_t time_ns, int64_t period_ns, Callback callback, EventId id) {
+    if (id == 0) {
+        id = next_id_++;
+        active_.insert(id);
+    }
+    queue_.push_back(Event{std::max(time_ns, now_ns()), next_sequence_++, id, period_ns, std::move(callback)});
+    std::push_heap(queue_.begin(), queue_.end(), Later());
+    return id;
+}
+
+EventScheduler::EventId EventScheduler::schedule_at(int64_t time_ns, Callback callback) {
+    return push(time_ns, 0, std::move(callback));
+}
+
+EventScheduler::EventId EventScheduler::schedule_after(std::chrono::nanoseconds delay, Callback callback) {
+    return push(now_ns() + delay.count(), 0, std::move(callback));
+}
+
+EventScheduler::EventId EventScheduler::schedule_every(std::chrono::nanoseconds period, Callback callback) {
+    int64_t period_ns = std::max<int64_t>(period.count(), 1);
+    return push(now_ns() + period_ns, period_ns, std::move(callback));
+}
+
+void EventScheduler::cancel(EventId id) {
+    active_.erase(id);
+}
+
+bool EventScheduler::step() {
+    while (!queue_.empty()) {
+        std::pop_heap(queue_.begin(), queue_.end(), Later());
+        Event event = std::move(queue_.back());
+        queue_.pop_back();
+        if (active_.count(event.id) == 0) {
+            continue;
+        }
+
+        clock_.set_monotonic_ns(event.time_ns);
+        if (event.period_ns == 0) {
+            active_.erase(event.id);
+        }
+        event.callback();
+        events_run_++;
+
+        // The callback may have cancelled its own periodic event
+        if (event.period_ns != 0 && active_.count(event.id) != 0) {
+            push(event.time_ns + event.period_ns, event.period_ns, std::move(event.callback), event.id);
+        }
+        return true;
+    }
+    return false;
+}
+
+uint64_t EventScheduler::run_until(int64_t time_ns) {
+    uint64_t before = events_run_;
+    for (;;) {
+        // Cancelled entries at the top must not let step() run past time_ns
+        while (!queue_.empty() && active_.count(queue_.front().id) == 0) {
+            std::pop_heap(queue_.begin(), queue_.end(), Later());
+            queue_.pop_back();
+        }
+        if (queue_.empty() || queue_.front().time_ns > time_ns) {
+            break;
+        }
+        step();
+    }
+    clock_.set_monotonic_ns(time_ns);
+    return events_run_ - before;
+}
+
+uint64_t EventScheduler::run_for(std::chrono::nanoseconds duration) {
+    return run_until(now_ns() + duration.count());
+}
+
+// ============================================================================
+// ScopedVirtualTime Implementation
+// ============================================================================
+
+ScopedVirtualTime::ScopedVirtualTime(EventScheduler& scheduler)
+    : previous_(&get_clock_source()) {
+    set_clock_source(&scheduler.clock());
+}
+
+ScopedVirtualTime::~ScopedVirtualTime() {
+    set_clock_source(previous_);
+}
+
+} // namespace sim
+} // namespace gptp
@@ -0,0 +1,146 @@
+/**
+ * @file virtual_time.hpp
+ * @brief Virtual clock and discrete-event scheduler for simulated runs
+ *
+ * Protocol code reads time through the process-wide IClockSource. With a
+ * VirtualClockSource installed, time only moves when the EventScheduler
+ * advances it to the next event, so hours of protocol operation run in
+ * as long as the events themselves take to process.
+ */
+
+#pragma once
+
+#include "../../include/clock_source.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace gptp {
+namespace sim {
+
+/**
+ * @brief Clock source that only moves when told to
+ */
+class VirtualClockSource : public IClockSource {
+public:
+    /**
+     * @param start_monotonic_ns Initial monotonic time
+     * @param realtime_offset_ns Wall clock minus monotonic time
+     */
+    explicit VirtualClockSource(int64_t start_monotonic_ns = 0,
+                                int64_t realtime_offset_ns = 1700000000LL * 1000000000LL);
+
+    int64_t now_realtime_ns() override;
+    int64_t now_monotonic_ns() override;
+    std::string get_name() const override { return "virtual"; }
+
+    /**
+     * @brief Move monotonic time to time_ns; never moves backwards
+     */
+    void set_monotonic_ns(int64_t time_ns);
+
+    void advance(std::chrono::nanoseconds delta);
+
+private:
+    std::atomic<int64_t> monotonic_ns_;
+    const int64_t realtime_offset_ns_;
+};
+
+/**
+ * @brief Single-threaded discrete-event scheduler on virtual time
+ *
+ * Events run in time order, ties in scheduling order. Running an event
+ * first moves the clock to its time; callbacks may schedule or cancel
+ * further events.
+ */
+class EventScheduler {
+public:
+    using Callback = std::function<void()>;
+    using EventId = uint64_t;
+
+    explicit EventScheduler(int64_t start_monotonic_ns = 0);
+
+    EventScheduler(const EventScheduler&) = delete;
+    EventScheduler& operator=(const EventScheduler&) = delete;
+
+    VirtualClockSource& clock() { return clock_; }
+    int64_t now_ns() { return clock_.now_monotonic_ns(); }
+    std::chrono::steady_clock::time_point now() { return steady_now_of(now_ns()); }
+
+    EventId schedule_at(int64_t time_ns, Callback callback);
+    EventId schedule_after(std::chrono::nanoseconds delay, Callback callback);
+
+    /**
+     * @brief Run callback every period, first after one period
+     */
+    EventId schedule_every(std::chrono::nanoseconds period, Callback callback);
+
+    void cancel(EventId id);
+
+    /**
+     * @brief Run the earliest event
+     * @return false if none is pending
+     */
+    bool step();
+
+    /**
+     * @brief Run every event up to and including time_ns, then move the clock there
+     * @return Number of events run
+     */
+    uint64_t run_until(int64_t time_ns);
+    uint64_t run_for(std::chrono::nanoseconds duration);
+
+    size_t pending() const { return active_.size(); }
+    uint64_t get_events_run() const { return events_run_; }
+
+    static std::chrono::steady_clock::time_point steady_now_of(int64_t time_ns) {
+        return std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(time_ns)));
+    }
+
+private:
+    struct Event {
+        int64_t time_ns;
+        uint64_t sequence;
+        EventId id;
+        int64_t period_ns;          // 0 for one-shot events
+        Callback callback;
+    };
+
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const {
+            return a.time_ns != b.time_ns ? a.time_ns > b.time_ns : a.sequence > b.sequence;
+        }
+    };
+
+    EventId push(int64_t time_ns, int64_t period_ns, Callback callback, EventId id = 0);
+
+    VirtualClockSource clock_;
+    std::vector<Event> queue_;                  // Min-heap on (time, sequence)
+    std::unordered_set<EventId> active_;        // Scheduled and not cancelled; heap entries of others are skipped
+    uint64_t next_sequence_;
+    EventId next_id_;
+    uint64_t events_run_;
+};
+
+/**
+ * @brief Installs a scheduler's virtual clock process-wide for its lifetime
+ */
+class ScopedVirtualTime {
+public:
+    explicit ScopedVirtualTime(EventScheduler& scheduler);
+    ~ScopedVirtualTime();
+
+    ScopedVirtualTime(const ScopedVirtualTime&) = delete;
+    ScopedVirtualTime& operator=(const ScopedVirtualTime&) = delete;
+
+private:
+    IClockSource* previous_;
+};
+
+} // namespace sim
+} // namespace gptp
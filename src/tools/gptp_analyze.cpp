@@ -0,0 +1,178 @@
+/**
+ * @file gptp_analyze.cpp
+ * @brief MTIE/TDEV/ADEV of the offset series in sync trace files
+ *
+ * Usage: gptp-analyze [--port N] [--threads N] [--csv] trace.bin.2 trace.bin.1 trace.bin
+ *
+ * Segments are decoded in parallel (each one starts with keyframes) and
+ * concatenated in argument order, so pass them oldest first. The offset of
+ * the selected port's SYNC samples is taken as the time error series,
+ * sampled at the median Sync interval.
+ */
+
+#include "../utils/sync_trace.hpp"
+#include "../utils/timing_analysis.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gptp;
+
+namespace {
+    struct SegmentData {
+        bool valid = false;
+        std::vector<int64_t> receipt_ns;
+        std::vector<double> offset_ns;
+        uint16_t first_port = 0;
+    };
+
+    void print_usage(const char* program) {
+        std::fprintf(stderr, "Usage: %s [--port N] [--threads N] [--csv] trace.bin [...]\n", program);
+    }
+
+    void decode_segment(const std::string& path, int port_filter, SegmentData& data) {
+        trace::TraceReader reader;
+        if (reader.open(path).has_error()) {
+            return;
+        }
+        data.valid = true;
+        data.receipt_ns.reserve(reader.header()->record_count);
+        data.offset_ns.reserve(reader.header()->record_count);
+
+        SyncSample sample;
+        while (reader.next(sample)) {
+            if (sample.kind != SyncSample::Kind::SYNC) {
+                continue;
+            }
+            if (data.first_port == 0) {
+                data.first_port = sample.port_id;
+            }
+            uint16_t wanted = port_filter > 0 ? static_cast<uint16_t>(port_filter) : data.first_port;
+            if (sample.port_id == wanted) {
+                data.receipt_ns.push_back(sample.t2_ns);
+                data.offset_ns.push_back(static_cast<double>(sample.offset_ns));
+            }
+        }
+    }
+
+    double median_interval_s(const std::vector<int64_t>& receipt_ns) {
+        std::vector<int64_t> intervals;
+        intervals.reserve(receipt_ns.size());
+        for (size_t i = 1; i < receipt_ns.size(); ++i) {
+            intervals.push_back(receipt_ns[i] - receipt_ns[i - 1]);
+        }
+        if (intervals.empty()) {
+            return 0.0;
+        }
+        auto middle = intervals.begin() + static_cast<std::ptrdiff_t>(intervals.size() / 2);
+        std::nth_element(intervals.begin(), middle, intervals.end());
+        return static_cast<double>(*middle) / 1e9;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int port = 0;
+    unsigned threads = 0;
+    bool csv = false;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+
+    if (inputs.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    analysis::TimingAnalyzer analyzer(threads);
+
+    // Without --port every segment must agree on the port, so resolve it first
+    std::vector<SegmentData> segments(inputs.size());
+    size_t next = 0;
+    if (port == 0) {
+        decode_segment(inputs.front(), 0, segments.front());
+        port = segments.front().first_port;
+        next = 1;
+    }
+
+    std::vector<std::thread> decoders;
+    while (next < inputs.size()) {
+        decoders.clear();
+        for (unsigned t = 0; t < analyzer.get_thread_count() && next < inputs.size(); ++t, ++next) {
+            decoders.emplace_back(decode_segment, std::cref(inputs[next]), port, std::ref(segments[next]));
+        }
+        for (auto& decoder : decoders) {
+            decoder.join();
+        }
+    }
+
+    std::vector<int64_t> receipt_ns;
+    std::vector<double> x_ns;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (!segments[i].valid) {
+            std::fprintf(stderr, "%s: not a readable trace file\n", inputs[i].c_str());
+            return 1;
+        }
+        receipt_ns.insert(receipt_ns.end(), segments[i].receipt_ns.begin(), segments[i].receipt_ns.end());
+        x_ns.insert(x_ns.end(), segments[i].offset_ns.begin(), segments[i].offset_ns.end());
+        segments[i] = SegmentData();
+    }
+
+    double tau0 = median_interval_s(receipt_ns);
+    if (x_ns.size() < 3 || tau0 <= 0.0) {
+        std::fprintf(stderr, "Not enough SYNC samples for port %d\n", port);
+        return 1;
+    }
+
+    auto windows = analysis::TimingAnalyzer::log_windows(x_ns.size() - 1);
+    auto mtie = analyzer.mtie(x_ns, tau0, windows);
+    auto tdev = analyzer.tdev(x_ns, tau0, windows);
+    auto adev = analyzer.adev(x_ns, tau0, windows);
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::fprintf(stderr, "port %d: %zu samples, tau0 %.6f s, %u threads, %.3f s\n",
+                 port, x_ns.size(), tau0, analyzer.get_thread_count(), elapsed);
+
+    if (csv) {
+        std::printf("tau_s,mtie_ns,tdev_ns,adev\n");
+    } else {
+        std::printf("%14s %14s %14s %14s\n", "tau [s]", "MTIE [ns]", "TDEV [ns]", "ADEV");
+    }
+
+    // Windows are sorted, each statistic covers a prefix of them
+    for (size_t w = 0; w < mtie.size(); ++w) {
+        char tdev_text[32] = "";
+        char adev_text[32] = "";
+        if (w < tdev.size()) {
+            std::snprintf(tdev_text, sizeof(tdev_text), "%.3f", tdev[w].value);
+        }
+        if (w < adev.size()) {
+            std::snprintf(adev_text, sizeof(adev_text), "%.3e", adev[w].value);
+        }
+        if (csv) {
+            std::printf("%.6f,%.3f,%s,%s\n", mtie[w].tau_s, mtie[w].value, tdev_text, adev_text);
+        } else {
+            std::printf("%14.6f %14.3f %14s %14s\n", mtie[w].tau_s, mtie[w].value, tdev_text, adev_text);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,428 @@
+/**
+ * @file gptp_bench_pipeline.cpp
+ * @brief Throughput of the whole receive path, without sockets
+ *
+ * Usage: gptp-bench-pipeline [--duration S] [--sync-interval LOG] [--foreign N] [--seed N]
+ *        gptp-bench-pipeline --capture FILE [--clock-identity XX:XX:XX:XX:XX:XX:XX:XX]
+ *
+ * Timestamped frames are handed to GptpPortManager::process_frame() in a
+ * tight loop: parse and validate, port dispatch, Sync / Follow_Up
+ * correlation, BMCA, path delay and the servo, disciplining a simulated
+ * clock. Time is virtual and advances to each frame's receive time, so
+ * periodic tasks run as often as they would live; they are timed apart
+ * from the frames.
+ *
+ * The synthetic workload is a grandmaster on port 1, which answers the
+ * stack's Pdelay_Req, and --foreign neighbours with worse priorities on
+ * port 2. A capture replays its inbound frames instead, port N being
+ * capture interface N-1; recorded Pdelay responses do not match the
+ * stack's requests, so path delay is not exercised.
+ *
+ * Reported are frames per second and, per message type, nanoseconds and
+ * heap allocations per frame. Timer overhead is subtracted.
+ */
+
+#include "../simulation/simulated_network.hpp"
+#include "../simulation/traffic_generator.hpp"
+#include "../utils/allocation_counter.hpp"
+#include "../utils/logger.hpp"
+#include "../utils/pcapng.hpp"
+#include "../../include/gptp_port_manager.hpp"
+#include "../../include/message_serializer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t LINK_DELAY_NS = 500;
+    constexpr int64_t PDELAY_TURNAROUND_NS = 10000;
+    constexpr int64_t TICK_NS = 10000000;
+    constexpr size_t CALIBRATION_ROUNDS = 100000;
+
+    struct Frame {
+        int64_t arrival_ns = 0;         // Virtual time of reception
+        int64_t timestamp_ns = -1;      // Receive timestamp; -1 for the local clock at arrival
+        uint16_t port_id = 1;
+        std::vector<uint8_t> payload;
+    };
+
+    struct Cost {
+        uint64_t count = 0;
+        uint64_t errors = 0;
+        int64_t ns = 0;
+        uint64_t allocations = 0;
+    };
+
+    void print_usage(const char* program) {
+        std::fprintf(stderr,
+            "Usage: %s [--duration S] [--sync-interval LOG] [--foreign N] [--seed N]\n"
+            "       %s --capture FILE [--clock-identity XX:XX:XX:XX:XX:XX:XX:XX]\n", program, program);
+    }
+
+    bool parse_identity(const char* text, ClockIdentity& identity) {
+        unsigned int bytes[8];
+        if (std::sscanf(text, "%x:%x:%x:%x:%x:%x:%x:%x", &bytes[0], &bytes[1], &bytes[2], &bytes[3],
+                        &bytes[4], &bytes[5], &bytes[6], &bytes[7]) != 8) {
+            return false;
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            if (bytes[i] > 0xFF) {
+                return false;
+            }
+            identity.id[i] = static_cast<uint8_t>(bytes[i]);
+        }
+        return true;
+    }
+
+    const char* type_name(uint8_t type) {
+        switch (static_cast<protocol::MessageType>(type)) {
+            case protocol::MessageType::SYNC: return "Sync";
+            case protocol::MessageType::DELAY_REQ: return "Delay_Req";
+            case protocol::MessageType::PDELAY_REQ: return "Pdelay_Req";
+            case protocol::MessageType::PDELAY_RESP: return "Pdelay_Resp";
+            case protocol::MessageType::FOLLOW_UP: return "Follow_Up";
+            case protocol::MessageType::DELAY_RESP: return "Delay_Resp";
+            case protocol::MessageType::PDELAY_RESP_FOLLOW_UP: return "Pdelay_Resp_FU";
+            case protocol::MessageType::ANNOUNCE: return "Announce";
+            case protocol::MessageType::SIGNALING: return "Signaling";
+            case protocol::MessageType::MANAGEMENT: return "Management";
+        }
+        return "reserved";
+    }
+
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+
+    // Cost of the pair of clock reads around each measured call
+    int64_t timer_overhead_ns() {
+        std::vector<int64_t> samples(CALIBRATION_ROUNDS);
+        for (auto& sample : samples) {
+            auto start = std::chrono::steady_clock::now();
+            sample = (std::chrono::steady_clock::now() - start).count();
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    /**
+     * @brief Collects a generator's frames instead of sending them
+     */
+    class FrameListSocket : public IGptpSocket {
+    public:
+        FrameListSocket(std::vector<Frame>& frames, uint16_t port_id, int64_t true_shift_ns)
+            : frames_(frames)
+            , port_id_(port_id)
+            , true_shift_ns_(true_shift_ns)
+            , now_ns_(0) {
+        }
+
+        // True time of the frames about to be sent
+        void set_time(int64_t now_ns) { now_ns_ = now_ns; }
+
+        Result<bool> initialize(const std::string&) override { return Result<bool>::success(true); }
+        void cleanup() override {}
+        Result<bool> send_packet(const GptpPacket& packet, PacketTimestamp&) override {
+            Frame frame;
+            frame.arrival_ns = now_ns_ + LINK_DELAY_NS - true_shift_ns_;
+            frame.port_id = port_id_;
+            frame.payload = packet.payload;
+            frames_.push_back(std::move(frame));
+            return Result<bool>::success(true);
+        }
+        Result<ReceivedPacket> receive_packet(uint32_t) override {
+            return Result<ReceivedPacket>::error(ErrorCode::TIMEOUT);
+        }
+        Result<bool> start_async_receive(PacketCallback) override { return Result<bool>::success(true); }
+        void stop_async_receive() override {}
+        bool is_hardware_timestamping_available() const override { return true; }
+        Result<std::array<uint8_t, 6>> get_interface_mac() const override {
+            return Result<std::array<uint8_t, 6>>::success({0x02, 0, 0, 0, 0, static_cast<uint8_t>(port_id_)});
+        }
+        std::string get_interface_name() const override { return "bench" + std::to_string(port_id_); }
+
+    private:
+        std::vector<Frame>& frames_;
+        uint16_t port_id_;
+        int64_t true_shift_ns_;
+        int64_t now_ns_;
+    };
+
+    // Frames of a generator from start_ns to end_ns of virtual time; its timestamps are true time
+    void generate(const TrafficProfile& profile, uint16_t port_id, int64_t start_ns, int64_t end_ns,
+                  int64_t true_shift_ns, std::vector<Frame>& frames) {
+        FrameListSocket socket(frames, port_id, true_shift_ns);
+        TrafficGenerator generator(socket, profile, start_ns + true_shift_ns);
+        for (int64_t due = generator.next_due_ns(); due < end_ns + true_shift_ns; due = generator.next_due_ns()) {
+            socket.set_time(due);
+            generator.run_until(due);
+        }
+    }
+
+    bool load_capture(const std::string& path, std::vector<Frame>& frames, int64_t& start_ns) {
+        capture::CaptureReader reader;
+        if (reader.open(path).has_error()) {
+            std::fprintf(stderr, "Cannot read %s\n", path.c_str());
+            return false;
+        }
+        capture::CapturedFrame captured;
+        while (reader.next(captured)) {
+            size_t offset = capture::gptp_payload_offset(captured.data.data(), captured.data.size());
+            if (captured.direction == capture::Direction::OUTBOUND || offset == 0 || offset >= captured.data.size()) {
+                continue;
+            }
+            Frame frame;
+            frame.arrival_ns = captured.timestamp_ns;
+            frame.timestamp_ns = captured.timestamp_ns;
+            frame.port_id = static_cast<uint16_t>(captured.interface_id + 1);
+            frame.payload.assign(captured.data.begin() + static_cast<std::ptrdiff_t>(offset), captured.data.end());
+            frames.push_back(std::move(frame));
+        }
+        std::stable_sort(frames.begin(), frames.end(), [](const Frame& a, const Frame& b) {
+            return a.arrival_ns < b.arrival_ns;
+        });
+        if (frames.empty()) {
+            std::fprintf(stderr, "%s: no inbound gPTP frames\n", path.c_str());
+            return false;
+        }
+        start_ns = frames.front().arrival_ns;
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    double duration_s = 600.0;
+    int sync_log_interval = -3;
+    size_t foreign = 16;
+    uint64_t seed = 1;
+    std::string capture_path;
+    ClockIdentity identity;
+    bool identity_given = false;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--duration") == 0 && has_value) {
+            duration_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sync-interval") == 0 && has_value) {
+            sync_log_interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--foreign") == 0 && has_value) {
+            foreign = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            seed = static_cast<uint64_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--capture") == 0 && has_value) {
+            capture_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--clock-identity") == 0 && has_value) {
+            if (!parse_identity(argv[++i], identity)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            identity_given = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (duration_s <= 0.0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Logger::instance().set_level(LogLevel::ERROR);
+
+    // All frames are built up front, so building them is not part of the measurement
+    const bool synthetic = capture_path.empty();
+    std::vector<Frame> frames;
+    int64_t start_ns = 1000000000LL;
+    uint16_t ports = 2;
+    if (!synthetic) {
+        if (!load_capture(capture_path, frames, start_ns)) {
+            return 1;
+        }
+        for (const auto& frame : frames) {
+            ports = std::max(ports, frame.port_id);
+        }
+    }
+
+    EventScheduler scheduler(start_ns);
+    ScopedVirtualTime virtual_time(scheduler);
+    SimulatedNetwork network(scheduler, seed);
+    OscillatorModel oscillator;
+    oscillator.frequency_error_ppb = 10.0;
+    SimulatedNode& local = network.add_node("bench", oscillator);
+    // Virtual time runs from start_ns; the grandmaster's timestamps are true time
+    const int64_t true_shift_ns = network.true_time_ns() - scheduler.now_ns();
+    if (!identity_given) {
+        identity = local.get_clock_identity();
+    }
+    if (synthetic) {
+        const int64_t end_ns = start_ns + static_cast<int64_t>(duration_s * 1e9);
+        TrafficProfile grandmaster;
+        grandmaster.identities = 1;
+        grandmaster.sync_log_interval = sync_log_interval;
+        grandmaster.priority1 = 100;
+        grandmaster.seed = seed;
+        generate(grandmaster, 1, start_ns, end_ns, true_shift_ns, frames);
+        TrafficProfile neighbours;
+        neighbours.identities = foreign;
+        neighbours.first_identity = 1;
+        neighbours.seed = seed + 1;
+        if (foreign > 0) {
+            generate(neighbours, 2, start_ns, end_ns, true_shift_ns, frames);
+        }
+        std::stable_sort(frames.begin(), frames.end(), [](const Frame& a, const Frame& b) {
+            return a.arrival_ns < b.arrival_ns;
+        });
+    }
+
+    std::unique_ptr<GptpPortManager> manager;
+    std::array<Cost, 16> costs{};
+    Cost ticks;
+    auto measure = [&](Cost& cost, auto&& work) {
+        uint64_t allocations = allocation_count();
+        auto started = std::chrono::steady_clock::now();
+        bool ok = work();
+        cost.ns += (std::chrono::steady_clock::now() - started).count();
+        cost.allocations += allocation_count() - allocations;
+        cost.count++;
+        cost.errors += ok ? 0 : 1;
+    };
+    auto receive = [&](const Frame& frame) {
+        Timestamp receipt = to_timestamp(frame.timestamp_ns >= 0 ? frame.timestamp_ns : local.local_time_ns());
+        uint8_t type = frame.payload.empty() ? 0 : frame.payload[0] & 0x0F;
+        measure(costs[type], [&]() {
+            return manager->process_frame(frame.port_id, frame.payload.data(), frame.payload.size(), receipt) ==
+                   ParseResult::SUCCESS;
+        });
+    };
+
+    // The grandmaster answers the stack's Pdelay_Req on port 1 on time, through the scheduler
+    std::vector<Timestamp> last_tx(ports + 1);
+    manager = std::make_unique<GptpPortManager>(identity, [&](uint16_t port_id, const std::vector<uint8_t>& payload) {
+        last_tx[port_id] = to_timestamp(local.local_time_ns());
+        serialization::MessageView view;
+        if (!synthetic || port_id != 1 || !serialization::MessageView::parse(payload.data(), payload.size(), view) ||
+            view.header.messageType != static_cast<uint8_t>(protocol::MessageType::PDELAY_REQ)) {
+            return;
+        }
+        int64_t t2 = network.true_time_ns() + LINK_DELAY_NS;
+        int64_t t3 = t2 + PDELAY_TURNAROUND_NS;
+        PdelayRespMessage response;
+        response.header.messageLength = 54;
+        response.header.sourcePortIdentity.clockIdentity = TrafficGenerator::identity(0);
+        response.header.sourcePortIdentity.portNumber = 1;
+        response.header.sequenceId = view.header.sequenceId;
+        response.header.flags = 0x0200;
+        response.requestReceiptTimestamp = to_timestamp(t2);
+        response.requestingPortIdentity = view.header.sourcePortIdentity;
+        PdelayRespFollowUpMessage follow_up;
+        follow_up.header = response.header;
+        follow_up.header.messageType = static_cast<uint8_t>(protocol::MessageType::PDELAY_RESP_FOLLOW_UP);
+        follow_up.header.controlField = 0x05;
+        follow_up.header.flags = 0;
+        follow_up.responseOriginTimestamp = to_timestamp(t3);
+        follow_up.requestingPortIdentity = view.header.sourcePortIdentity;
+
+        auto frames_out = std::make_shared<std::array<Frame, 2>>();
+        (*frames_out)[0].payload = serialization::MessageSerializer::serialize_pdelay_resp(response);
+        (*frames_out)[1].payload = serialization::MessageSerializer::serialize_pdelay_resp_followup(follow_up);
+        scheduler.schedule_at(t3 + LINK_DELAY_NS - true_shift_ns, [&receive, frames_out]() {
+            receive((*frames_out)[0]);
+            receive((*frames_out)[1]);
+        });
+    });
+    manager->set_tx_timestamp_provider([&](uint16_t port_id, Timestamp& tx_time) {
+        if (port_id >= last_tx.size()) {
+            return false;
+        }
+        tx_time = last_tx[port_id];
+        return true;
+    });
+    for (uint16_t port_id = 1; port_id <= ports; ++port_id) {
+        manager->add_port(port_id);
+    }
+    manager->set_clock_adjuster(&local);
+    for (uint16_t port_id = 1; port_id <= ports; ++port_id) {
+        manager->enable_port(port_id);
+    }
+    scheduler.schedule_every(std::chrono::nanoseconds(TICK_NS), [&]() {
+        measure(ticks, [&]() {
+            manager->run_periodic_tasks(scheduler.now());
+            return true;
+        });
+    });
+
+    const int64_t overhead_ns = timer_overhead_ns();
+    const uint64_t allocations_before = allocation_count();
+    auto wall_start = std::chrono::steady_clock::now();
+    for (const Frame& frame : frames) {
+        scheduler.run_until(std::max(frame.arrival_ns, scheduler.now_ns()));
+        receive(frame);
+    }
+    // The last Pdelay responses
+    scheduler.run_for(std::chrono::milliseconds(1));
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    const uint64_t allocations_total = allocation_count() - allocations_before;
+    const double simulated_s = static_cast<double>(scheduler.now_ns() - start_ns) / 1e9;
+
+    Cost total;
+    for (auto& cost : costs) {
+        cost.ns = std::max<int64_t>(0, cost.ns - static_cast<int64_t>(cost.count) * overhead_ns);
+        total.count += cost.count;
+        total.errors += cost.errors;
+        total.ns += cost.ns;
+        total.allocations += cost.allocations;
+    }
+    ticks.ns = std::max<int64_t>(0, ticks.ns - static_cast<int64_t>(ticks.count) * overhead_ns);
+    double frames_count = static_cast<double>(std::max<uint64_t>(total.count, 1));
+
+    std::printf("Workload:     %s, %.0f s simulated, %" PRIu64 " frames\n",
+                synthetic ? "synthetic" : capture_path.c_str(), simulated_s, total.count);
+    std::printf("Receive path: %.0f frames/s, %.1f ns/frame, %.2f allocations/frame\n",
+                total.ns > 0 ? frames_count * 1e9 / static_cast<double>(total.ns) : 0.0,
+                static_cast<double>(total.ns) / frames_count,
+                static_cast<double>(total.allocations) / frames_count);
+    std::printf("Whole loop:   %.0f frames/s with periodic tasks and bookkeeping, %.2f allocations/frame\n",
+                wall_s > 0.0 ? frames_count / wall_s : 0.0, static_cast<double>(allocations_total) / frames_count);
+    std::printf("\n%-16s %10s %10s %13s %8s\n", "type", "frames", "ns/frame", "allocs/frame", "rejected");
+    for (size_t type = 0; type < costs.size(); ++type) {
+        const Cost& cost = costs[type];
+        if (cost.count == 0) {
+            continue;
+        }
+        double count = static_cast<double>(cost.count);
+        std::printf("%-16s %10" PRIu64 " %10.1f %13.2f %8" PRIu64 "\n", type_name(static_cast<uint8_t>(type)),
+                    cost.count, static_cast<double>(cost.ns) / count, static_cast<double>(cost.allocations) / count,
+                    cost.errors);
+    }
+    if (ticks.count > 0) {
+        double count = static_cast<double>(ticks.count);
+        std::printf("%-16s %10" PRIu64 " %10.1f %13.2f\n", "periodic tick", ticks.count,
+                    static_cast<double>(ticks.ns) / count, static_cast<double>(ticks.allocations) / count);
+    }
+
+    // The numbers only mean something if the frames actually drove the stack
+    auto status = manager->get_sync_status(1);
+    std::printf("\nPort 1: %s, offset %" PRId64 " ns, link delay %" PRId64 " ns\n",
+                status.synchronized ? "synchronized" : "not synchronized",
+                static_cast<int64_t>(status.current_offset.count()),
+                static_cast<int64_t>(manager->get_link_delay(1).count()));
+    return 0;
+}
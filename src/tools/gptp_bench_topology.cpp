@@ -0,0 +1,375 @@
+/**
+ * @file gptp_bench_topology.cpp
+ * @brief Convergence and CPU cost of the protocol stack on large simulated topologies
+ *
+ * Usage: gptp-bench-topology [--scenario NAME | --topology KIND --nodes N [--param X]]
+ *                            [--duration S] [--gm-loss-at S] [--settle S]
+ *                            [--lock-threshold NS] [--freq-error PPB] [--initial-offset NS]
+ *                            [--wander PPB] [--jitter NS] [--seed N] [--csv]
+ *
+ * Every node runs a real GptpPortManager on simulated links and virtual
+ * time. Node 0 is the grandmaster, node 1 its backup. Offsets are ground
+ * truth from the simulated oscillators, sampled every 125 ms:
+ *   - first lock: synchronized slave with |offset to the grandmaster| under
+ *     the threshold for 1 s
+ *   - worst offset: largest |offset| from --settle until the grandmaster
+ *     is lost, at the node farthest from it and over all nodes
+ *   - reconvergence: time from silencing node 0 until every node still
+ *     connected to node 1 agrees on node 1 and has exactly one slave port
+ * CPU time and resident memory are per node; CPU is also normalized to
+ * one simulated second.
+ */
+
+#include "../simulation/topology.hpp"
+#include "../utils/logger.hpp"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t SAMPLE_INTERVAL_NS = 125000000LL;
+    constexpr int LOCK_SAMPLES = 8;
+    constexpr size_t UNREACHABLE = SIZE_MAX;
+
+    struct Scenario {
+        std::string name;
+        Topology::Kind kind;
+        size_t nodes;
+        double param;
+    };
+
+    // The standard suite: automotive chain, industrial line, plant-sized meshes
+    const Scenario STANDARD_SCENARIOS[] = {
+        {"chain-7", Topology::Kind::CHAIN, 8, 0.0},
+        {"line-32", Topology::Kind::CHAIN, 33, 0.0},
+        {"mesh-100", Topology::Kind::RANDOM_MESH, 100, 0.5},
+        {"mesh-1000", Topology::Kind::RANDOM_MESH, 1000, 0.2},
+    };
+
+    struct Settings {
+        double duration_s = 600.0;
+        double gm_loss_at_s = 400.0;
+        double settle_s = 300.0;
+        int64_t lock_threshold_ns = 1000;
+        TopologyOptions options;
+        bool csv = false;
+    };
+
+    struct Report {
+        size_t nodes = 0;
+        size_t links = 0;
+        size_t last_hop = 0;
+        size_t locked = 0;
+        size_t servo_locked = 0;
+        double median_lock_s = -1.0;
+        double worst_lock_s = -1.0;
+        int64_t worst_last_hop_ns = 0;
+        int64_t worst_any_ns = 0;
+        double reconvergence_s = -1.0;
+        double wall_s = 0.0;
+        double cpu_s = 0.0;
+        double simulated_s = 0.0;
+        long rss_kib = 0;
+    };
+
+    void print_usage(const char* program) {
+        std::fprintf(stderr,
+            "Usage: %s [--scenario chain-7|line-32|mesh-100|mesh-1000|all]\n"
+            "          [--topology chain|ring|tree|mesh --nodes N [--param X]]\n"
+            "          [--duration S] [--gm-loss-at S] [--settle S] [--lock-threshold NS]\n"
+            "          [--freq-error PPB] [--initial-offset NS] [--wander PPB] [--jitter NS]\n"
+            "          [--seed N] [--csv]\n", program);
+    }
+
+    bool parse_kind(const char* name, Topology::Kind& kind) {
+        for (auto candidate : {Topology::Kind::CHAIN, Topology::Kind::RING,
+                               Topology::Kind::TREE, Topology::Kind::RANDOM_MESH}) {
+            if (std::strcmp(name, Topology::kind_name(candidate)) == 0) {
+                kind = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    long resident_kib() {
+        std::ifstream statm("/proc/self/statm");
+        long pages = 0;
+        long resident = 0;
+        if (!(statm >> pages >> resident)) {
+            return 0;
+        }
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+    double cpu_seconds() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+               static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    double median(std::vector<double> values) {
+        if (values.empty()) {
+            return -1.0;
+        }
+        auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    }
+
+    bool synchronized_slave(GptpPortManager& manager) {
+        for (const auto& role : manager.get_port_roles()) {
+            if (role.second == bmca::PortRole::SLAVE && manager.get_sync_status(role.first).synchronized) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Every surviving node follows the backup and has a single path to it
+    bool reconverged(Topology& topology, const std::vector<size_t>& reachable, const ClockIdentity& backup) {
+        for (size_t i = 1; i < topology.size(); ++i) {
+            if (reachable[i] == UNREACHABLE) {
+                continue;
+            }
+            auto& manager = topology.system(i).port_manager();
+            size_t slaves = 0;
+            for (const auto& role : manager.get_port_roles()) {
+                if (role.second == bmca::PortRole::SLAVE) {
+                    slaves++;
+                }
+                if (!(manager.get_grandmaster(role.first).grandmaster_identity == backup)) {
+                    return false;
+                }
+            }
+            if (slaves != (i == 1 ? 0u : 1u)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Report run(const Scenario& scenario, const Settings& settings) {
+        Report report;
+        long rss_before = resident_kib();
+
+        EventScheduler scheduler(1000000000LL);
+        ScopedVirtualTime virtual_time(scheduler);
+        Topology topology(scheduler, settings.options);
+        topology.build(scenario.kind, scenario.nodes, scenario.param);
+        topology.set_priority1(0, 100);
+        if (topology.size() > 1) {
+            topology.set_priority1(1, 110);
+        }
+
+        report.nodes = topology.size();
+        report.links = topology.link_count();
+        auto hops = topology.hop_distances(0);
+        for (size_t i = 0; i < hops.size(); ++i) {
+            if (hops[i] != UNREACHABLE && hops[i] > hops[report.last_hop]) {
+                report.last_hop = i;
+            }
+        }
+
+        const int64_t start_ns = scheduler.now_ns();
+        const int64_t settle_ns = start_ns + static_cast<int64_t>(settings.settle_s * 1e9);
+        const int64_t loss_ns = start_ns + static_cast<int64_t>(settings.gm_loss_at_s * 1e9);
+        const int64_t end_ns = start_ns + static_cast<int64_t>(settings.duration_s * 1e9);
+        const bool gm_loss = topology.size() > 2 && loss_ns < end_ns;
+
+        std::vector<int> in_threshold(topology.size(), 0);
+        std::vector<double> lock_s(topology.size(), -1.0);
+        std::vector<size_t> reachable;
+        ClockIdentity backup = topology.size() > 1 ? topology.node(1).get_clock_identity() : ClockIdentity();
+
+        scheduler.schedule_every(std::chrono::nanoseconds(SAMPLE_INTERVAL_NS), [&]() {
+            int64_t now = scheduler.now_ns();
+            if (now < loss_ns || !gm_loss) {
+                for (size_t i = 1; i < topology.size(); ++i) {
+                    int64_t offset = std::llabs(topology.offset_between(i, 0));
+                    bool good = offset < settings.lock_threshold_ns &&
+                                (lock_s[i] >= 0.0 || synchronized_slave(topology.system(i).port_manager()));
+                    in_threshold[i] = good ? in_threshold[i] + 1 : 0;
+                    if (in_threshold[i] == LOCK_SAMPLES && lock_s[i] < 0.0) {
+                        lock_s[i] = static_cast<double>(now - start_ns - (LOCK_SAMPLES - 1) * SAMPLE_INTERVAL_NS) / 1e9;
+                    }
+                    if (now >= settle_ns) {
+                        report.worst_any_ns = std::max(report.worst_any_ns, offset);
+                        if (i == report.last_hop) {
+                            report.worst_last_hop_ns = std::max(report.worst_last_hop_ns, offset);
+                        }
+                    }
+                }
+            } else if (report.reconvergence_s < 0.0 && reconverged(topology, reachable, backup)) {
+                report.reconvergence_s = static_cast<double>(now - loss_ns) / 1e9;
+            }
+        });
+        if (gm_loss) {
+            scheduler.schedule_at(loss_ns, [&]() {
+                topology.stop_node(0);
+                reachable = topology.hop_distances(1, 0);
+            });
+        }
+
+        double cpu_before = cpu_seconds();
+        auto wall_before = std::chrono::steady_clock::now();
+        topology.start();
+        scheduler.run_until(end_ns);
+        report.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_before).count();
+        report.cpu_s = cpu_seconds() - cpu_before;
+        report.simulated_s = static_cast<double>(end_ns - start_ns) / 1e9;
+        report.rss_kib = resident_kib() - rss_before;
+
+        std::vector<double> locked;
+        for (size_t i = 1; i < topology.size(); ++i) {
+            if (lock_s[i] >= 0.0) {
+                locked.push_back(lock_s[i]);
+            }
+            for (const auto& role : topology.system(i).port_manager().get_port_roles()) {
+                if (role.second == bmca::PortRole::SLAVE &&
+                    topology.system(i).port_manager().get_sync_status(role.first).servo_locked) {
+                    report.servo_locked++;
+                }
+            }
+        }
+        report.locked = locked.size();
+        report.median_lock_s = median(locked);
+        report.worst_lock_s = locked.empty() ? -1.0 : *std::max_element(locked.begin(), locked.end());
+        return report;
+    }
+
+    void print_report(const Scenario& scenario, const Settings& settings, const Report& report) {
+        double nodes = static_cast<double>(std::max<size_t>(report.nodes, 1));
+        double cpu_us_per_node_s = report.cpu_s * 1e6 / nodes / std::max(report.simulated_s, 1e-9);
+
+        if (settings.csv) {
+            std::printf("%s,%zu,%zu,%zu,%zu,%.3f,%.3f,%" PRId64 ",%" PRId64 ",%.3f,%.3f,%.3f,%.1f,%.1f\n",
+                        scenario.name.c_str(), report.nodes, report.links, report.locked, report.servo_locked,
+                        report.median_lock_s, report.worst_lock_s, report.worst_last_hop_ns, report.worst_any_ns,
+                        report.reconvergence_s, report.wall_s, report.cpu_s, cpu_us_per_node_s,
+                        static_cast<double>(report.rss_kib) / nodes);
+            return;
+        }
+
+        std::printf("%s: %zu nodes, %zu links, %.0f s simulated in %.2f s (%.0fx real time)\n",
+                    scenario.name.c_str(), report.nodes, report.links, report.simulated_s, report.wall_s,
+                    report.simulated_s / std::max(report.wall_s, 1e-9));
+        if (report.locked > 0) {
+            std::printf("  first lock      %zu/%zu nodes, median %.2f s, worst %.2f s (|offset| < %" PRId64 " ns for 1 s)\n",
+                        report.locked, report.nodes - 1, report.median_lock_s, report.worst_lock_s,
+                        settings.lock_threshold_ns);
+        } else {
+            std::printf("  first lock      no node within %" PRId64 " ns\n", settings.lock_threshold_ns);
+        }
+        std::printf("  servo locked    %zu/%zu nodes at the end\n", report.servo_locked, report.nodes - 1);
+        std::printf("  worst offset    %" PRId64 " ns at the last hop (node %zu), %" PRId64 " ns over all nodes\n",
+                    report.worst_last_hop_ns, report.last_hop, report.worst_any_ns);
+        if (report.reconvergence_s >= 0.0) {
+            std::printf("  gm loss         BMCA reconverged in %.2f s\n", report.reconvergence_s);
+        } else if (report.nodes > 2 && settings.gm_loss_at_s < settings.duration_s) {
+            std::printf("  gm loss         BMCA not reconverged within %.0f s\n",
+                        settings.duration_s - settings.gm_loss_at_s);
+        }
+        std::printf("  cost            %.1f us CPU per node per simulated second, %.1f KiB per node\n",
+                    cpu_us_per_node_s, static_cast<double>(report.rss_kib) / nodes);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    // Clocks boot milliseconds apart; TCXO-grade frequency error
+    settings.options.oscillator_spread.initial_offset_ns = 10000000;
+    settings.options.oscillator_spread.frequency_error_ppb = 1000.0;
+    settings.options.oscillator_spread.wander_ppb = 0.1;
+    settings.options.oscillator_spread.timestamp_resolution_ns = 8;
+    settings.options.link.jitter = JitterDistribution::NORMAL;
+    settings.options.link.jitter_ns = 10;
+
+    std::vector<Scenario> scenarios;
+    std::string scenario_name;
+    Scenario custom{"custom", Topology::Kind::CHAIN, 0, 0.0};
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--scenario") == 0 && has_value) {
+            scenario_name = argv[++i];
+        } else if (std::strcmp(argv[i], "--topology") == 0 && has_value) {
+            if (!parse_kind(argv[++i], custom.kind)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            custom.name = argv[i];
+        } else if (std::strcmp(argv[i], "--nodes") == 0 && has_value) {
+            custom.nodes = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--param") == 0 && has_value) {
+            custom.param = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--duration") == 0 && has_value) {
+            settings.duration_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--gm-loss-at") == 0 && has_value) {
+            settings.gm_loss_at_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--settle") == 0 && has_value) {
+            settings.settle_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--lock-threshold") == 0 && has_value) {
+            settings.lock_threshold_ns = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--freq-error") == 0 && has_value) {
+            settings.options.oscillator_spread.frequency_error_ppb = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--initial-offset") == 0 && has_value) {
+            settings.options.oscillator_spread.initial_offset_ns = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--wander") == 0 && has_value) {
+            settings.options.oscillator_spread.wander_ppb = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--jitter") == 0 && has_value) {
+            settings.options.link.jitter_ns = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            settings.options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--csv") == 0) {
+            settings.csv = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (custom.nodes > 0) {
+        custom.name += "-" + std::to_string(custom.nodes);
+        scenarios.push_back(custom);
+    } else {
+        for (const auto& scenario : STANDARD_SCENARIOS) {
+            if (scenario_name.empty() || scenario_name == "all" || scenario_name == scenario.name) {
+                scenarios.push_back(scenario);
+            }
+        }
+    }
+    if (scenarios.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Logger::instance().set_level(LogLevel::ERROR);
+    if (settings.csv) {
+        std::printf("scenario,nodes,links,locked,servo_locked,median_lock_s,worst_lock_s,"
+                    "worst_last_hop_ns,worst_offset_ns,reconvergence_s,wall_s,cpu_s,"
+                    "cpu_us_per_node_per_sim_s,kib_per_node\n");
+    }
+    for (const auto& scenario : scenarios) {
+        print_report(scenario, settings, run(scenario, settings));
+        std::fflush(stdout);
+    }
+    return 0;
+}
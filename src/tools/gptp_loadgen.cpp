@@ -0,0 +1,540 @@
+/**
+ * @file gptp_loadgen.cpp
+ * @brief Offer synthetic gPTP load to a time-aware system and report what it does to sync
+ *
+ * Usage: gptp-loadgen [--identities N] [--sync-interval LOG] [--pdelay-interval LOG]
+ *                     [--announce-interval LOG] [--no-sync] [--no-pdelay] [--no-announce]
+ *                     [--malformed FRACTION] [--storm N] [--storm-interval LOG]
+ *                     [--priority1 P] [--duration S] [--sweep] [--max-identities N]
+ *                     [--seed N] [--lock-threshold NS]
+ *                     [--interface IF [--metrics-socket PATH] [--dut-interface IF]]
+ *
+ * Without --interface the device under test is a simulated system on
+ * virtual time: port 1 follows a simulated grandmaster, port 2 faces the
+ * generator. Time spent in the stack is measured on the wall clock; the
+ * daemon runs its stack on one event loop thread, so a busy share of the
+ * simulated time at or above 1.0 means frames would queue up and drop.
+ *
+ * With --interface the frames go out on a real interface, typically one
+ * end of a veth pair whose other end the daemon runs on, paced on the
+ * wall clock. The daemon's metrics endpoint, when given, tells how many
+ * frames it received and rejected and whether it stayed synchronized.
+ *
+ * A step holds lock when every sample, 8 per second, finds the system
+ * synchronized to the same grandmaster within the lock threshold: by
+ * default twice the worst offset of an unloaded run of the same length.
+ *
+ * --sweep doubles the number of identities from --identities up to
+ * --max-identities and stops at the first rate the system does not take.
+ */
+
+#include "../simulation/simulated_network.hpp"
+#include "../simulation/traffic_generator.hpp"
+#include "../networking/linux_socket.hpp"
+#include "../utils/logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t SAMPLE_INTERVAL_NS = 125000000;
+    constexpr int64_t SETTLE_S = 300;
+    constexpr int LOCKED_SECONDS = 10;
+    constexpr int64_t MIN_LOCK_THRESHOLD_NS = 1000;
+    constexpr uint8_t PDELAY_RESP = 0x3;
+
+    struct Settings {
+        TrafficProfile profile;
+        double duration_s = 30.0;
+        bool sweep = false;
+        size_t max_identities = 65536;
+        int64_t lock_threshold_ns = 0;     // 0: twice the worst unloaded offset
+        std::string interface;
+        std::string metrics_socket;
+        std::string dut_interface;
+    };
+
+    struct StepReport {
+        double offered_fps = 0.0;
+        TrafficGenerator::Statistics sent;
+        double sent_fps = 0.0;
+        uint64_t responses = 0;
+        // Simulated device under test
+        uint64_t frames_received = 0;
+        uint64_t parse_errors = 0;
+        double busy_share = 0.0;
+        // Daemon metrics, raw mode
+        bool have_metrics = false;
+        double metrics_received = 0.0;
+        double metrics_parse_errors = 0.0;
+        double metrics_receive_errors = 0.0;
+        // Both
+        uint64_t samples = 0;
+        uint64_t locked_samples = 0;
+        int64_t worst_offset_ns = 0;
+        uint64_t grandmaster_changes = 0;
+
+        bool held_lock() const { return samples > 0 && locked_samples == samples && grandmaster_changes == 0; }
+    };
+
+    void print_usage(const char* program) {
+        std::fprintf(stderr,
+            "Usage: %s [--identities N] [--sync-interval LOG] [--pdelay-interval LOG]\n"
+            "          [--announce-interval LOG] [--no-sync] [--no-pdelay] [--no-announce]\n"
+            "          [--malformed FRACTION] [--storm N] [--storm-interval LOG]\n"
+            "          [--priority1 P] [--duration S] [--sweep] [--max-identities N]\n"
+            "          [--seed N] [--lock-threshold NS]\n"
+            "          [--interface IF [--metrics-socket PATH] [--dut-interface IF]]\n", program);
+    }
+
+    bool synchronized_slave(GptpPortManager& manager) {
+        for (const auto& role : manager.get_port_roles()) {
+            if (role.second == bmca::PortRole::SLAVE && manager.get_sync_status(role.first).synchronized) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool is_pdelay_response(const ReceivedPacket& received) {
+        return !received.packet.payload.empty() && (received.packet.payload[0] & 0x0F) == PDELAY_RESP;
+    }
+
+    // Sum of a metric's samples, optionally only those of one interface
+    double sum_metric(const std::string& text, const std::string& name, const std::string& interface,
+                      bool& found) {
+        double sum = 0.0;
+        const std::string label = "interface=\"" + interface + "\"";
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            std::string line = text.substr(start, end - start);
+            start = end + 1;
+            if (line.compare(0, name.size(), name) != 0 || line.size() <= name.size() ||
+                (line[name.size()] != ' ' && line[name.size()] != '{')) {
+                continue;
+            }
+            if (!interface.empty() && line.find(label) == std::string::npos) {
+                continue;
+            }
+            size_t space = line.rfind(' ');
+            sum += std::strtod(line.c_str() + space + 1, nullptr);
+            found = true;
+        }
+        return sum;
+    }
+
+    bool scrape(const std::string& socket_path, std::string& text) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return false;
+        }
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+        const char request[] = "GET /metrics HTTP/1.0\r\n\r\n";
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::send(fd, request, sizeof(request) - 1, MSG_NOSIGNAL) < 0) {
+            ::close(fd);
+            return false;
+        }
+        text.clear();
+        char buffer[4096];
+        pollfd pfd{fd, POLLIN, 0};
+        while (::poll(&pfd, 1, 1000) > 0) {
+            ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                break;
+            }
+            text.append(buffer, static_cast<size_t>(received));
+        }
+        ::close(fd);
+        return text.compare(0, 12, "HTTP/1.0 200") == 0;
+    }
+
+    class SimulatedTarget {
+    public:
+        explicit SimulatedTarget(const Settings& settings)
+            : settings_(settings)
+            , scheduler_(1000000000LL)
+            , virtual_time_(scheduler_)
+            , network_(scheduler_, settings.profile.seed)
+            , grandmaster_(network_.add_node("gm"))
+            , dut_(network_.add_node("dut", dut_oscillator()))
+            , loadgen_(network_.add_node("loadgen"))
+            , gm_system_(network_, grandmaster_)
+            , dut_system_(network_, dut_)
+            , responses_(0) {
+            gm_system_.add_port("gm.p1");
+            dut_system_.add_port("dut.p1");
+            dut_system_.add_port("dut.p2");
+            socket_ = network_.create_socket(loadgen_, "loadgen.p1");
+            socket_->initialize("loadgen.p1");
+            // Without a receiver the DUT's answers would pile up in the socket's queue
+            socket_->start_async_receive([this](const ReceivedPacket& received) {
+                responses_ += is_pdelay_response(received) ? 1 : 0;
+            });
+            network_.connect("gm.p1", "dut.p1");
+            network_.connect("dut.p2", "loadgen.p1");
+            gm_system_.port_manager().set_local_clock_properties(100, ClockQuality(), 248);
+        }
+
+        // Unloaded start until the DUT holds lock for a while; false if it never does
+        bool settle() {
+            gm_system_.start();
+            dut_system_.start();
+            int locked = 0;
+            for (int64_t s = 0; s < SETTLE_S && locked < LOCKED_SECONDS; ++s) {
+                scheduler_.run_for(std::chrono::seconds(1));
+                locked = synchronized_slave(dut_system_.port_manager()) ? locked + 1 : 0;
+            }
+            return locked == LOCKED_SECONDS;
+        }
+
+        StepReport run(const TrafficProfile& profile, int64_t lock_threshold_ns) {
+            StepReport report;
+            report.offered_fps = TrafficGenerator::frames_per_second(profile);
+            const int64_t start_ns = scheduler_.now_ns();
+            const int64_t end_ns = start_ns + static_cast<int64_t>(settings_.duration_s * 1e9);
+            const auto before = dut_system_.get_statistics();
+            const uint64_t responses_before = responses_;
+            const ClockIdentity grandmaster = grandmaster_.get_clock_identity();
+
+            TrafficGenerator generator(*socket_, profile, start_ns);
+            EventScheduler::EventId pump = 0;
+            std::function<void()> pump_next = [&]() {
+                int64_t due = generator.next_due_ns();
+                if (due < end_ns) {
+                    pump = scheduler_.schedule_at(due, [&]() {
+                        generator.run_until(scheduler_.now_ns());
+                        pump_next();
+                    });
+                }
+            };
+            pump_next();
+            auto sampler = scheduler_.schedule_every(std::chrono::nanoseconds(SAMPLE_INTERVAL_NS), [&]() {
+                auto& manager = dut_system_.port_manager();
+                int64_t offset = std::llabs(offset_ns());
+                report.samples++;
+                report.locked_samples += synchronized_slave(manager) && offset < lock_threshold_ns ? 1 : 0;
+                report.worst_offset_ns = std::max(report.worst_offset_ns, offset);
+                report.grandmaster_changes += manager.get_grandmaster(1).grandmaster_identity == grandmaster ? 0 : 1;
+            });
+
+            dut_system_.set_profiling(true);
+            scheduler_.run_until(end_ns);
+            dut_system_.set_profiling(false);
+            scheduler_.cancel(sampler);
+            scheduler_.cancel(pump);
+
+            const auto& after = dut_system_.get_statistics();
+            report.sent = generator.get_statistics();
+            report.sent_fps = static_cast<double>(report.sent.total()) / settings_.duration_s;
+            report.responses = responses_ - responses_before;
+            report.frames_received = after.frames_received - before.frames_received;
+            report.parse_errors = after.parse_errors - before.parse_errors;
+            report.busy_share = static_cast<double>(after.busy_ns - before.busy_ns) / (settings_.duration_s * 1e9);
+            return report;
+        }
+
+    private:
+        static OscillatorModel dut_oscillator() {
+            OscillatorModel oscillator;
+            oscillator.initial_offset_ns = 10000000;
+            oscillator.frequency_error_ppb = 100.0;
+            return oscillator;
+        }
+
+        int64_t offset_ns() {
+            return dut_.offset_from_true_ns() - grandmaster_.offset_from_true_ns();
+        }
+
+        const Settings& settings_;
+        EventScheduler scheduler_;
+        ScopedVirtualTime virtual_time_;
+        SimulatedNetwork network_;
+        SimulatedNode& grandmaster_;
+        SimulatedNode& dut_;
+        SimulatedNode& loadgen_;
+        SimulatedTimeAwareSystem gm_system_;
+        SimulatedTimeAwareSystem dut_system_;
+        std::unique_ptr<SimulatedSocket> socket_;
+        uint64_t responses_;
+    };
+
+    class InterfaceTarget {
+    public:
+        explicit InterfaceTarget(const Settings& settings)
+            : settings_(settings)
+            , responses_(0) {
+        }
+
+        ~InterfaceTarget() {
+            socket_.stop_async_receive();
+            socket_.cleanup();
+        }
+
+        bool open() {
+            if (socket_.initialize(settings_.interface).has_error()) {
+                std::fprintf(stderr, "Cannot open %s\n", settings_.interface.c_str());
+                return false;
+            }
+            socket_.start_async_receive([this](const ReceivedPacket& received) {
+                if (is_pdelay_response(received)) {
+                    responses_.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            std::string text;
+            if (!settings_.metrics_socket.empty() && !scrape(settings_.metrics_socket, text)) {
+                std::fprintf(stderr, "Cannot scrape %s\n", settings_.metrics_socket.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        StepReport run(const TrafficProfile& profile, int64_t lock_threshold_ns) {
+            StepReport report;
+            report.offered_fps = TrafficGenerator::frames_per_second(profile);
+            const uint64_t responses_before = responses_.load(std::memory_order_relaxed);
+            double received_before = 0.0;
+            double parse_errors_before = 0.0;
+            double receive_errors_before = 0.0;
+            std::string text;
+            if (!settings_.metrics_socket.empty() && scrape(settings_.metrics_socket, text)) {
+                received_before = metric(text, "gptp_port_frames_received_total", report);
+                parse_errors_before = metric(text, "gptp_port_parse_errors_total", report);
+                receive_errors_before = metric(text, "gptp_port_receive_errors_total", report);
+            }
+
+            const int64_t start_ns = now_ns();
+            const int64_t end_ns = start_ns + static_cast<int64_t>(settings_.duration_s * 1e9);
+            int64_t next_scrape_ns = start_ns;
+            TrafficGenerator generator(socket_, profile, start_ns);
+            for (int64_t now = start_ns; now < end_ns; now = now_ns()) {
+                generator.run_until(now);
+                if (report.have_metrics && now >= next_scrape_ns) {
+                    sample_daemon(report, lock_threshold_ns);
+                    next_scrape_ns += 1000000000LL;
+                }
+                int64_t wake_ns = std::min({generator.next_due_ns(), next_scrape_ns, end_ns});
+                if (wake_ns > now) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(wake_ns - now));
+                }
+            }
+
+            report.sent = generator.get_statistics();
+            report.sent_fps = static_cast<double>(report.sent.total()) / settings_.duration_s;
+            // Responses still in flight are counted after a short grace period
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            report.responses = responses_.load(std::memory_order_relaxed) - responses_before;
+            if (report.have_metrics && scrape(settings_.metrics_socket, text)) {
+                report.metrics_received = metric(text, "gptp_port_frames_received_total", report) - received_before;
+                report.metrics_parse_errors = metric(text, "gptp_port_parse_errors_total", report) -
+                                              parse_errors_before;
+                report.metrics_receive_errors = metric(text, "gptp_port_receive_errors_total", report) -
+                                                receive_errors_before;
+            }
+            return report;
+        }
+
+    private:
+        static int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        double metric(const std::string& text, const std::string& name, StepReport& report) {
+            return sum_metric(text, name, settings_.dut_interface, report.have_metrics);
+        }
+
+        void sample_daemon(StepReport& report, int64_t lock_threshold_ns) {
+            std::string text;
+            if (!scrape(settings_.metrics_socket, text)) {
+                report.samples++;
+                return;
+            }
+            bool found = false;
+            bool synchronized = sum_metric(text, "gptp_synchronized", "", found) > 0.0;
+            auto offset = static_cast<int64_t>(std::fabs(sum_metric(text, "gptp_offset_from_master_ns", "", found)));
+            report.samples++;
+            report.locked_samples += synchronized && offset < lock_threshold_ns ? 1 : 0;
+            report.worst_offset_ns = std::max(report.worst_offset_ns, offset);
+        }
+
+        const Settings& settings_;
+        LinuxSocket socket_;
+        std::atomic<uint64_t> responses_;
+    };
+
+    void print_report(size_t identities, const StepReport& report, bool simulated) {
+        std::printf("%6zu identities: offered %9.0f frames/s, sent %9.0f frames/s (%" PRIu64 " malformed",
+                    identities, report.offered_fps, report.sent_fps, report.sent.malformed);
+        if (report.sent.send_errors > 0) {
+            std::printf(", %" PRIu64 " send errors", report.sent.send_errors);
+        }
+        std::printf("), %" PRIu64 " Pdelay_Resp to %" PRIu64 " Pdelay_Req\n", report.responses, report.sent.pdelay_req);
+        if (simulated) {
+            std::printf("        DUT: %" PRIu64 " frames, %" PRIu64 " parse errors, busy %.4f of real time%s\n",
+                        report.frames_received, report.parse_errors, report.busy_share,
+                        report.busy_share >= 1.0 ? " (saturated, would drop)" : "");
+        } else if (report.have_metrics) {
+            std::printf("        DUT: %.0f frames (%.0f not seen), %.0f parse errors, %.0f receive errors\n",
+                        report.metrics_received,
+                        std::max(0.0, static_cast<double>(report.sent.total()) - report.metrics_received),
+                        report.metrics_parse_errors, report.metrics_receive_errors);
+        }
+        if (report.samples > 0) {
+            std::printf("        sync: locked %" PRIu64 "/%" PRIu64 " samples, worst offset %" PRId64 " ns",
+                        report.locked_samples, report.samples, report.worst_offset_ns);
+            if (simulated) {
+                std::printf(", %" PRIu64 " samples with another grandmaster", report.grandmaster_changes);
+            }
+            std::printf("\n");
+        }
+    }
+
+    template <typename Target>
+    int run_steps(Target& target, const Settings& settings, bool simulated) {
+        // The servo wanders a little even unloaded; lock is lost when load makes it wander further
+        int64_t lock_threshold_ns = settings.lock_threshold_ns;
+        if (lock_threshold_ns <= 0) {
+            TrafficProfile idle = settings.profile;
+            idle.sync = idle.pdelay = idle.announce = false;
+            idle.storm_identities = 0;
+            StepReport baseline = target.run(idle, INT64_MAX);
+            lock_threshold_ns = std::max(2 * baseline.worst_offset_ns, MIN_LOCK_THRESHOLD_NS);
+            if (baseline.samples > 0) {
+                std::printf("Unloaded: worst offset %" PRId64 " ns, lock threshold %" PRId64 " ns\n",
+                            baseline.worst_offset_ns, lock_threshold_ns);
+            }
+            if (baseline.locked_samples < baseline.samples) {
+                std::fprintf(stderr, "Not synchronized without load\n");
+                return 1;
+            }
+        }
+
+        TrafficProfile profile = settings.profile;
+        size_t passed = 0;
+        double passed_fps = 0.0;
+        while (true) {
+            StepReport report = target.run(profile, lock_threshold_ns);
+            print_report(profile.identities, report, simulated);
+            bool took_it = (report.samples == 0 || report.held_lock()) && report.busy_share < 1.0;
+            if (!took_it || !settings.sweep || profile.identities * 2 > settings.max_identities) {
+                if (settings.sweep) {
+                    if (took_it) {
+                        std::printf("Capacity: at least %zu identities (%.0f frames/s)\n",
+                                    profile.identities, report.offered_fps);
+                    } else if (passed > 0) {
+                        std::printf("Capacity: %zu identities (%.0f frames/s)\n", passed, passed_fps);
+                    } else {
+                        std::printf("Capacity: below %zu identities\n", profile.identities);
+                    }
+                }
+                return took_it ? 0 : 2;
+            }
+            passed = profile.identities;
+            passed_fps = report.offered_fps;
+            profile.identities *= 2;
+            profile.seed++;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    TrafficProfile& profile = settings.profile;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--identities") == 0 && has_value) {
+            profile.identities = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--sync-interval") == 0 && has_value) {
+            profile.sync_log_interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--pdelay-interval") == 0 && has_value) {
+            profile.pdelay_log_interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--announce-interval") == 0 && has_value) {
+            profile.announce_log_interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-sync") == 0) {
+            profile.sync = false;
+        } else if (std::strcmp(argv[i], "--no-pdelay") == 0) {
+            profile.pdelay = false;
+        } else if (std::strcmp(argv[i], "--no-announce") == 0) {
+            profile.announce = false;
+        } else if (std::strcmp(argv[i], "--malformed") == 0 && has_value) {
+            profile.malformed_fraction = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--storm") == 0 && has_value) {
+            profile.storm_identities = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--storm-interval") == 0 && has_value) {
+            profile.storm_log_interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--priority1") == 0 && has_value) {
+            profile.priority1 = static_cast<uint8_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            profile.seed = static_cast<uint64_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--duration") == 0 && has_value) {
+            settings.duration_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep") == 0) {
+            settings.sweep = true;
+        } else if (std::strcmp(argv[i], "--max-identities") == 0 && has_value) {
+            settings.max_identities = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--lock-threshold") == 0 && has_value) {
+            settings.lock_threshold_ns = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--interface") == 0 && has_value) {
+            settings.interface = argv[++i];
+        } else if (std::strcmp(argv[i], "--metrics-socket") == 0 && has_value) {
+            settings.metrics_socket = argv[++i];
+        } else if (std::strcmp(argv[i], "--dut-interface") == 0 && has_value) {
+            settings.dut_interface = argv[++i];
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (profile.identities == 0 || settings.duration_s <= 0.0 || profile.malformed_fraction < 0.0 ||
+        profile.malformed_fraction > 1.0 || (settings.interface.empty() && !settings.metrics_socket.empty())) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Logger::instance().set_level(LogLevel::ERROR);
+
+    if (!settings.interface.empty()) {
+        InterfaceTarget target(settings);
+        if (!target.open()) {
+            return 1;
+        }
+        return run_steps(target, settings, false);
+    }
+
+    SimulatedTarget target(settings);
+    if (!target.settle()) {
+        std::fprintf(stderr, "The simulated system did not synchronize within %" PRId64 " s\n", SETTLE_S);
+        return 1;
+    }
+    return run_steps(target, settings, true);
+}
@@ -0,0 +1,214 @@
+/**
+ * @file gptp_replay.cpp
+ * @brief Replay a pcapng or pcap capture through the protocol stack on virtual time
+ *
+ * Usage: gptp-replay CAPTURE [--clock-identity XX:XX:XX:XX:XX:XX:XX:XX]
+ *                            [--trace FILE] [--tick MS] [--verbose]
+ *
+ * The capture's inbound frames drive a GptpPortManager with one port per
+ * captured interface, RX -> parse -> BMCA -> path delay -> servo, as fast
+ * as the CPU allows. The stack takes the recorded system's clock identity
+ * so BMCA decides as it did in the field; the identity comes from the
+ * capture's outbound frames unless given. Sync and Pdelay samples can be
+ * written as a sync trace for gptp-analyze.
+ */
+
+#include "../simulation/replay_socket.hpp"
+#include "../utils/logger.hpp"
+#include "../utils/sync_trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    void print_usage(const char* program) {
+        std::fprintf(stderr,
+            "Usage: %s CAPTURE [--clock-identity XX:XX:XX:XX:XX:XX:XX:XX]\n"
+            "          [--trace FILE] [--tick MS] [--verbose]\n", program);
+    }
+
+    bool parse_identity(const char* text, ClockIdentity& identity) {
+        unsigned int bytes[8];
+        if (std::sscanf(text, "%x:%x:%x:%x:%x:%x:%x:%x", &bytes[0], &bytes[1], &bytes[2], &bytes[3],
+                        &bytes[4], &bytes[5], &bytes[6], &bytes[7]) != 8) {
+            return false;
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            if (bytes[i] > 0xFF) {
+                return false;
+            }
+            identity.id[i] = static_cast<uint8_t>(bytes[i]);
+        }
+        return true;
+    }
+
+    std::string format_identity(const ClockIdentity& identity) {
+        char buffer[24];
+        std::snprintf(buffer, sizeof(buffer), "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
+                      identity.id[0], identity.id[1], identity.id[2], identity.id[3],
+                      identity.id[4], identity.id[5], identity.id[6], identity.id[7]);
+        return buffer;
+    }
+
+    const char* role_name(bmca::PortRole role) {
+        switch (role) {
+            case bmca::PortRole::MASTER: return "master";
+            case bmca::PortRole::SLAVE: return "slave";
+            case bmca::PortRole::PASSIVE: return "passive";
+            case bmca::PortRole::DISABLED: return "disabled";
+        }
+        return "unknown";
+    }
+
+    struct OffsetStatistics {
+        uint64_t count = 0;
+        uint64_t locked = 0;
+        int64_t min_ns = INT64_MAX;
+        int64_t max_ns = INT64_MIN;
+        double sum_ns = 0.0;
+        double sum_squares = 0.0;
+        int64_t last_path_delay_ns = 0;
+        uint64_t pdelay_count = 0;
+
+        void add(const SyncSample& sample) {
+            if (sample.kind == SyncSample::Kind::PDELAY) {
+                pdelay_count++;
+                last_path_delay_ns = sample.path_delay_ns;
+                return;
+            }
+            count++;
+            locked += sample.servo_locked ? 1 : 0;
+            min_ns = std::min(min_ns, sample.offset_ns);
+            max_ns = std::max(max_ns, sample.offset_ns);
+            sum_ns += static_cast<double>(sample.offset_ns);
+            sum_squares += static_cast<double>(sample.offset_ns) * static_cast<double>(sample.offset_ns);
+            last_path_delay_ns = sample.path_delay_ns;
+        }
+    };
+}
+
+int main(int argc, char* argv[]) {
+    std::string capture_path;
+    std::string trace_path;
+    ClockIdentity identity;
+    bool identity_given = false;
+    int64_t tick_ms = 10;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--clock-identity") == 0 && has_value) {
+            if (!parse_identity(argv[++i], identity)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            identity_given = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && has_value) {
+            trace_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--tick") == 0 && has_value) {
+            tick_ms = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (argv[i][0] != '-' && capture_path.empty()) {
+            capture_path = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (capture_path.empty() || tick_ms <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Logger::instance().set_level(verbose ? LogLevel::DEBUG : LogLevel::WARN);
+
+    EventScheduler scheduler(1000000000LL);
+    ScopedVirtualTime virtual_time(scheduler);
+    CaptureReplay replay(scheduler);
+    if (replay.load(capture_path).has_error()) {
+        return 1;
+    }
+    if (identity_given) {
+        replay.set_clock_identity(identity);
+    } else if (!replay.has_clock_identity()) {
+        std::fprintf(stderr, "%s: cannot tell the recorded system's frames apart; pass --clock-identity\n",
+                     capture_path.c_str());
+        return 1;
+    }
+
+    trace::TraceWriter trace_writer;
+    if (!trace_path.empty()) {
+        trace::TraceWriter::Options trace_options;
+        trace_options.path = trace_path;
+        if (trace_writer.open(trace_options).has_error()) {
+            std::fprintf(stderr, "Cannot create trace %s\n", trace_path.c_str());
+            return 1;
+        }
+    }
+
+    ReplayedTimeAwareSystem system(replay, replay.get_clock_identity());
+    std::vector<OffsetStatistics> statistics(replay.interface_count() + 1);
+    system.port_manager().set_sync_sample_callback([&](const SyncSample& sample) {
+        if (sample.port_id < statistics.size()) {
+            statistics[sample.port_id].add(sample);
+        }
+        if (trace_writer.is_open()) {
+            trace_writer.write(sample);
+        }
+    });
+
+    auto wall_start = std::chrono::steady_clock::now();
+    system.start(std::chrono::milliseconds(tick_ms));
+    // A little past the last frame, so its Follow_Up and responses are handled
+    scheduler.run_until(replay.end_time_ns() + 1000000000LL);
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    trace_writer.close();
+
+    const auto& replay_statistics = replay.get_statistics();
+    double captured_s = static_cast<double>(replay.end_time_ns() - 1000000000LL) / 1e9;
+    std::printf("Capture:          %s%s\n", capture_path.c_str(), replay.is_damaged() ? " (truncated)" : "");
+    std::printf("Clock identity:   %s\n", format_identity(replay.get_clock_identity()).c_str());
+    std::printf("Frames:           %" PRIu64 " gPTP, %" PRIu64 " skipped, %" PRIu64 " delivered\n",
+                replay_statistics.frames_loaded, replay_statistics.frames_skipped,
+                replay_statistics.frames_delivered);
+    std::printf("TX timestamps:    %" PRIu64 " recorded, %" PRIu64 " extrapolated, %" PRIu64
+                " Pdelay exchanges paired\n", replay_statistics.tx_timestamps_recorded,
+                replay_statistics.tx_timestamps_extrapolated, replay_statistics.pdelay_exchanges_paired);
+    std::printf("Replayed:         %.1f s of capture in %.3f s (%.0f frames/s)\n", captured_s, wall_s,
+                wall_s > 0.0 ? static_cast<double>(replay_statistics.frames_delivered) / wall_s : 0.0);
+
+    auto& manager = system.port_manager();
+    auto roles = manager.get_port_roles();
+    for (const auto& role : roles) {
+        uint16_t port_id = role.first;
+        const OffsetStatistics& port = statistics[port_id];
+        std::printf("Port %u (%s): %s, grandmaster %s, link delay %" PRId64 " ns, %" PRIu64 " pdelay samples\n",
+                    port_id, replay.get_interface(port_id - 1).name.c_str(), role_name(role.second),
+                    format_identity(manager.get_grandmaster(port_id).grandmaster_identity).c_str(),
+                    port.last_path_delay_ns, port.pdelay_count);
+        if (port.count == 0) {
+            continue;
+        }
+        double mean = port.sum_ns / static_cast<double>(port.count);
+        double rms = std::sqrt(port.sum_squares / static_cast<double>(port.count));
+        std::printf("  offset: %" PRIu64 " samples (%" PRIu64 " locked), mean %.1f ns, rms %.1f ns,"
+                    " min %" PRId64 " ns, max %" PRId64 " ns\n",
+                    port.count, port.locked, mean, rms, port.min_ns, port.max_ns);
+    }
+    system.stop();
+    return 0;
+}
@@ -0,0 +1,348 @@
+/**
+ * @file gptp_soak.cpp
+ * @brief Days of operation on virtual time, checked for memory growth and accuracy drift
+ *
+ * Usage: gptp-soak [--days D] [--nodes N] [--loss P] [--identities N] [--sync-interval LOG]
+ *                  [--malformed F] [--sample-interval S] [--warmup S] [--growth PCT]
+ *                  [--max-offset NS] [--max-outage S] [--seed N] [--csv]
+ *
+ * A chain of N time-aware systems on lossy, jittery links follows the
+ * grandmaster at one end while a traffic generator loads the last node
+ * with --identities foreign neighbours. Every --sample-interval the run
+ * records the process's resident memory, live heap allocations, the
+ * protocol state sizes summed over all nodes, the worst |offset| of the
+ * last node to the grandmaster and the longest time any node went without
+ * a synchronized slave port since the previous sample.
+ *
+ * Samples taken during --warmup are not judged. Of the rest, the maximum
+ * of each quantity over the last quarter is compared with the first
+ * quarter: memory, allocations or state growing by more than --growth
+ * percent (plus a small absolute slack), or the worst offset more than
+ * doubling, fails the run with exit status 1, as does an outage longer
+ * than --max-outage or any offset over --max-offset. Lost frames make
+ * short outages normal: a few Syncs in a row go missing now and then.
+ */
+
+#include "../simulation/topology.hpp"
+#include "../simulation/traffic_generator.hpp"
+#include "../utils/allocation_counter.hpp"
+#include "../utils/logger.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t OFFSET_INTERVAL_NS = 125000000LL;
+    constexpr double OFFSET_INTERVAL_S = OFFSET_INTERVAL_NS / 1e9;
+    constexpr int64_t MIN_DRIFT_NS = 1000;
+
+    struct Settings {
+        double days = 1.0;
+        size_t nodes = 3;
+        double sample_interval_s = 3600.0;
+        double warmup_s = 21600.0;
+        double growth_percent = 5.0;
+        int64_t max_offset_ns = 0;
+        double max_outage_s = 5.0;
+        TopologyOptions options;
+        TrafficProfile load;
+        bool csv = false;
+    };
+
+    struct Sample {
+        double time_h = 0.0;
+        long rss_kib = 0;
+        int64_t live_allocations = 0;
+        uint64_t allocations = 0;
+        GptpPortManager::StateSizes sizes;
+        int64_t worst_offset_ns = 0;
+        double longest_outage_s = 0.0;
+    };
+
+    // A quantity judged for growth, with the absolute slack it may grow by
+    struct Metric {
+        const char* name;
+        std::function<double(const Sample&)> value;
+        double slack;
+    };
+
+    void print_usage(const char* program) {
+        std::printf("Usage: %s [options]\n", program);
+        std::printf("  --days D               Simulated days (default: 1)\n");
+        std::printf("  --nodes N              Time-aware systems in the chain (default: 3)\n");
+        std::printf("  --loss P               Frame loss probability per link (default: 0.01)\n");
+        std::printf("  --identities N         Foreign neighbours loading the last node (default: 20)\n");
+        std::printf("  --sync-interval LOG    Their Sync interval, 2^LOG s (default: -5)\n");
+        std::printf("  --malformed F          Share of their frames malformed (default: 0.01)\n");
+        std::printf("  --sample-interval S    Seconds between samples (default: 3600)\n");
+        std::printf("  --warmup S             Seconds before samples are judged (default: 21600)\n");
+        std::printf("  --growth PCT           Allowed growth of memory and state (default: 5)\n");
+        std::printf("  --max-offset NS        Fail on any larger |offset| after warm-up (default: off)\n");
+        std::printf("  --max-outage S         Fail on a node unsynchronized for longer (default: 5)\n");
+        std::printf("  --seed N               Random seed (default: 1)\n");
+        std::printf("  --csv                  Samples as CSV\n");
+    }
+
+    long resident_kib() {
+        std::ifstream statm("/proc/self/statm");
+        long pages = 0;
+        long resident = 0;
+        if (!(statm >> pages >> resident)) {
+            return 0;
+        }
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+    bool synchronized_slave(GptpPortManager& manager) {
+        for (const auto& role : manager.get_port_roles()) {
+            if (role.second == bmca::PortRole::SLAVE && manager.get_sync_status(role.first).synchronized) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void print_sample(const Sample& sample, bool csv) {
+        if (csv) {
+            std::printf("%.2f,%ld,%" PRId64 ",%" PRIu64 ",%zu,%zu,%zu,%" PRId64 ",%.3f\n", sample.time_h,
+                        sample.rss_kib, sample.live_allocations, sample.allocations, sample.sizes.pending_syncs,
+                        sample.sizes.pdelay_history, sample.sizes.bmca_masters, sample.worst_offset_ns,
+                        sample.longest_outage_s);
+            return;
+        }
+        std::printf("%8.2f %10ld %12" PRId64 " %14" PRIu64 " %8zu %8zu %8zu %12" PRId64 " %9.3f\n", sample.time_h,
+                    sample.rss_kib, sample.live_allocations, sample.allocations, sample.sizes.pending_syncs,
+                    sample.sizes.pdelay_history, sample.sizes.bmca_masters, sample.worst_offset_ns,
+                    sample.longest_outage_s);
+    }
+
+    double max_over(const std::vector<Sample>& samples, size_t first, size_t last,
+                    const std::function<double(const Sample&)>& value) {
+        double result = 0.0;
+        for (size_t i = first; i < last; ++i) {
+            result = std::max(result, value(samples[i]));
+        }
+        return result;
+    }
+
+    // Judge the samples after warm-up; returns the number of failed checks
+    int judge(const std::vector<Sample>& samples, const Settings& settings, std::FILE* out) {
+        if (samples.size() < 4) {
+            std::fprintf(out, "Too few samples after warm-up to judge growth (%zu, need 4)\n", samples.size());
+            return 1;
+        }
+        const size_t quarter = samples.size() / 4;
+        const double growth = 1.0 + settings.growth_percent / 100.0;
+        int failures = 0;
+
+        const Metric metrics[] = {
+            {"resident memory, KiB", [](const Sample& s) { return static_cast<double>(s.rss_kib); }, 1024.0},
+            {"live allocations", [](const Sample& s) { return static_cast<double>(s.live_allocations); }, 100.0},
+            {"pending Syncs", [](const Sample& s) { return static_cast<double>(s.sizes.pending_syncs); }, 4.0},
+            {"pdelay history", [](const Sample& s) { return static_cast<double>(s.sizes.pdelay_history); }, 4.0},
+            {"BMCA masters", [](const Sample& s) { return static_cast<double>(s.sizes.bmca_masters); }, 4.0},
+        };
+        for (const auto& metric : metrics) {
+            double early = max_over(samples, 0, quarter, metric.value);
+            double late = max_over(samples, samples.size() - quarter, samples.size(), metric.value);
+            bool grew = late > early * growth + metric.slack;
+            std::fprintf(out, "  %-22s %12.0f -> %12.0f  %s\n", metric.name, early, late, grew ? "GROWING" : "ok");
+            failures += grew ? 1 : 0;
+        }
+
+        auto offset = [](const Sample& s) { return static_cast<double>(s.worst_offset_ns); };
+        double early = max_over(samples, 0, quarter, offset);
+        double late = max_over(samples, samples.size() - quarter, samples.size(), offset);
+        bool drifted = late > std::max(2.0 * early, early + MIN_DRIFT_NS);
+        std::fprintf(out, "  %-22s %12.0f -> %12.0f  %s\n", "worst |offset|, ns", early, late, drifted ? "DRIFTING" : "ok");
+        failures += drifted ? 1 : 0;
+
+        double worst = max_over(samples, 0, samples.size(), offset);
+        if (settings.max_offset_ns > 0 && worst > static_cast<double>(settings.max_offset_ns)) {
+            std::fprintf(out, "  worst |offset| %.0f ns exceeds %" PRId64 " ns\n", worst, settings.max_offset_ns);
+            failures++;
+        }
+        double outage = max_over(samples, 0, samples.size(), [](const Sample& s) { return s.longest_outage_s; });
+        if (outage > settings.max_outage_s) {
+            std::fprintf(out, "  a node was unsynchronized for %.3f s, more than %.3f s\n", outage,
+                         settings.max_outage_s);
+            failures++;
+        }
+        return failures;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    // Clocks boot milliseconds apart; TCXO-grade frequency error with wander
+    settings.options.oscillator_spread.initial_offset_ns = 10000000;
+    settings.options.oscillator_spread.frequency_error_ppb = 1000.0;
+    settings.options.oscillator_spread.wander_ppb = 0.1;
+    settings.options.oscillator_spread.timestamp_resolution_ns = 8;
+    settings.options.link.jitter = JitterDistribution::NORMAL;
+    settings.options.link.jitter_ns = 10;
+    settings.options.link.loss_probability = 0.01;
+    settings.load.identities = 20;
+    settings.load.sync_log_interval = -5;
+    settings.load.malformed_fraction = 0.01;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--days") == 0 && has_value) {
+            settings.days = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--nodes") == 0 && has_value) {
+            settings.nodes = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--loss") == 0 && has_value) {
+            settings.options.link.loss_probability = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--identities") == 0 && has_value) {
+            settings.load.identities = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--sync-interval") == 0 && has_value) {
+            settings.load.sync_log_interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--malformed") == 0 && has_value) {
+            settings.load.malformed_fraction = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sample-interval") == 0 && has_value) {
+            settings.sample_interval_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && has_value) {
+            settings.warmup_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--growth") == 0 && has_value) {
+            settings.growth_percent = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-offset") == 0 && has_value) {
+            settings.max_offset_ns = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-outage") == 0 && has_value) {
+            settings.max_outage_s = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            settings.options.seed = std::strtoull(argv[++i], nullptr, 10);
+            settings.load.seed = settings.options.seed;
+        } else if (std::strcmp(argv[i], "--csv") == 0) {
+            settings.csv = true;
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (settings.nodes < 2 || settings.days <= 0.0 || settings.sample_interval_s <= 0.0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Logger::instance().set_level(LogLevel::ERROR);
+
+    EventScheduler scheduler(1000000000LL);
+    ScopedVirtualTime virtual_time(scheduler);
+    Topology topology(scheduler, settings.options);
+    topology.build(Topology::Kind::CHAIN, settings.nodes);
+    topology.set_priority1(0, 100);
+
+    // The load enters the last node on a port of its own, over a clean link
+    const size_t last = topology.size() - 1;
+    SimulatedNetwork& network = topology.network();
+    std::string load_port = "n" + std::to_string(last) + ".load";
+    topology.system(last).add_port(load_port);
+    auto load_socket = network.create_socket(network.add_node("loadgen"), "loadgen.p1");
+    if (load_socket->initialize("loadgen.p1").has_error() || network.connect("loadgen.p1", load_port).has_error()) {
+        std::fprintf(stderr, "Cannot attach the traffic generator\n");
+        return 1;
+    }
+    load_socket->start_async_receive([](const ReceivedPacket&) {});    // Its replies are not needed
+    std::unique_ptr<TrafficGenerator> generator;
+    if (settings.load.identities > 0) {
+        generator = std::make_unique<TrafficGenerator>(*load_socket, settings.load, scheduler.now_ns());
+    }
+
+    const int64_t start_ns = scheduler.now_ns();
+    const int64_t warmup_ns = start_ns + static_cast<int64_t>(settings.warmup_s * 1e9);
+    const int64_t end_ns = start_ns + static_cast<int64_t>(settings.days * 86400e9);
+
+    std::function<void()> pump = [&]() {
+        if (generator && generator->next_due_ns() <= end_ns) {
+            scheduler.schedule_at(generator->next_due_ns(), [&]() {
+                generator->run_until(scheduler.now_ns());
+                pump();
+            });
+        }
+    };
+    pump();
+
+    int64_t worst_offset_ns = 0;
+    double longest_outage_s = 0.0;
+    std::vector<double> outage_s(topology.size(), 0.0);
+    scheduler.schedule_every(std::chrono::nanoseconds(OFFSET_INTERVAL_NS), [&]() {
+        if (scheduler.now_ns() < warmup_ns) {
+            return;
+        }
+        worst_offset_ns = std::max<int64_t>(worst_offset_ns, std::llabs(topology.offset_between(last, 0)));
+        for (size_t i = 1; i < topology.size(); ++i) {
+            outage_s[i] = synchronized_slave(topology.system(i).port_manager()) ? 0.0 : outage_s[i] + OFFSET_INTERVAL_S;
+            longest_outage_s = std::max(longest_outage_s, outage_s[i]);
+        }
+    });
+
+    if (settings.csv) {
+        std::printf("time_h,rss_kib,live_allocations,allocations,pending_syncs,pdelay_history,bmca_masters,"
+                    "worst_offset_ns,longest_outage_s\n");
+    } else {
+        std::printf("Soaking %zu nodes for %.2f simulated days: %zu foreign neighbours, %.0f frames/s of load, "
+                    "%.1f%% link loss\n\n", topology.size(), settings.days, settings.load.identities,
+                    generator ? TrafficGenerator::frames_per_second(settings.load) : 0.0,
+                    settings.options.link.loss_probability * 100.0);
+        std::printf("%8s %10s %12s %14s %8s %8s %8s %12s %9s\n", "hours", "rss KiB", "live allocs", "allocations",
+                    "pending", "pdelay", "masters", "worst ns", "outage s");
+    }
+
+    std::vector<Sample> judged;
+    scheduler.schedule_every(std::chrono::nanoseconds(static_cast<int64_t>(settings.sample_interval_s * 1e9)), [&]() {
+        int64_t now = scheduler.now_ns();
+        Sample sample;
+        sample.time_h = static_cast<double>(now - start_ns) / 3600e9;
+        sample.rss_kib = resident_kib();
+        sample.live_allocations = live_allocation_count();
+        sample.allocations = allocation_count();
+        for (size_t i = 0; i < topology.size(); ++i) {
+            auto sizes = topology.system(i).port_manager().get_state_sizes();
+            sample.sizes.ports += sizes.ports;
+            sample.sizes.pending_syncs += sizes.pending_syncs;
+            sample.sizes.pdelay_history += sizes.pdelay_history;
+            sample.sizes.bmca_masters += sizes.bmca_masters;
+        }
+        sample.worst_offset_ns = worst_offset_ns;
+        sample.longest_outage_s = longest_outage_s;
+        worst_offset_ns = 0;
+        longest_outage_s = 0.0;
+
+        print_sample(sample, settings.csv);
+        std::fflush(stdout);
+        if (now > warmup_ns) {
+            judged.push_back(sample);
+        }
+    });
+
+    auto wall_before = std::chrono::steady_clock::now();
+    topology.start();
+    scheduler.run_until(end_ns);
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_before).count();
+
+    if (settings.csv) {
+        return judge(judged, settings, stderr) > 0 ? 1 : 0;
+    }
+    std::printf("\n%.2f simulated days in %.0f s (%.0fx real time); first and last quarter after warm-up:\n",
+                settings.days, wall_s, settings.days * 86400.0 / std::max(wall_s, 1e-9));
+    int failures = judge(judged, settings, stdout);
+    std::printf("\n%s\n", failures > 0 ? "FAIL" : "PASS");
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file gptp_trace.cpp
+ * @brief Decode binary sync traces to CSV
+ *
+ * Usage: gptp-trace [-o output.csv] trace.bin [trace.bin.1 ...]
+ *
+ * Files are decoded in the order given; pass rotated segments oldest first
+ * (e.g. trace.bin.2 trace.bin.1 trace.bin) for a chronological export.
+ */
+
+#include "../utils/sync_trace.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace gptp;
+
+namespace {
+    void print_usage(const char* program) {
+        std::fprintf(stderr, "Usage: %s [-o output.csv] trace.bin [trace.bin.1 ...]\n", program);
+    }
+
+    const char* kind_name(SyncSample::Kind kind) {
+        return kind == SyncSample::Kind::PDELAY ? "pdelay" : "sync";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string output_path;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output_path = argv[++i];
+        } else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+
+    if (inputs.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (!output_path.empty()) {
+        out = std::fopen(output_path.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "Cannot write %s\n", output_path.c_str());
+            return 1;
+        }
+    }
+
+    std::fprintf(out, "kind,port,t1_ns,t2_ns,t3_ns,t4_ns,offset_ns,path_delay_ns,rate_ratio,servo_ppb,locked\n");
+
+    int status = 0;
+    for (const auto& input : inputs) {
+        trace::TraceReader reader;
+        if (reader.open(input).has_error()) {
+            std::fprintf(stderr, "%s: not a readable trace file\n", input.c_str());
+            status = 1;
+            continue;
+        }
+
+        uint64_t decoded = 0;
+        SyncSample sample;
+        while (reader.next(sample)) {
+            std::fprintf(out, "%s,%u,%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%.12f,%.3f,%d\n",
+                         kind_name(sample.kind), sample.port_id,
+                         sample.t1_ns, sample.t2_ns, sample.t3_ns, sample.t4_ns,
+                         sample.offset_ns, sample.path_delay_ns,
+                         sample.rate_ratio, sample.servo_ppb, sample.servo_locked ? 1 : 0);
+            decoded++;
+        }
+
+        if (decoded != reader.header()->record_count) {
+            std::fprintf(stderr, "%s: decoded %" PRIu64 " of %" PRIu64 " records\n",
+                         input.c_str(), decoded, reader.header()->record_count);
+            status = 1;
+        }
+    }
+
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return status;
+}
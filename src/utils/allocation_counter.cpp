@@ -0,0 +1,119 @@
+/**
+ * @file allocation_counter.cpp
+ * @brief Counting replacements of the global operator new and delete
+ */
+
+#include "allocation_counter.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifndef _WIN32
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int MAX_TRACE_FRAMES = 32;
+
+    std::atomic<uint64_t> g_allocations{0};
+    std::atomic<uint64_t> g_deallocations{0};
+    std::atomic<uint64_t> g_violations{0};
+
+    // Plain thread-locals: no constructors may run inside operator new
+    thread_local int t_guard_depth = 0;
+    thread_local bool t_abort_on_violation = false;
+    thread_local bool t_reporting = false;
+
+    void report_violation(std::size_t size) {
+        g_violations.fetch_add(1, std::memory_order_relaxed);
+
+        // The report allocates itself (backtrace loads libgcc on first use)
+        t_reporting = true;
+        char message[96];
+        int length = std::snprintf(message, sizeof(message),
+                                   "Heap allocation of %zu bytes inside an allocation guard\n", size);
+#ifndef _WIN32
+        if (length > 0) {
+            ssize_t unused = write(STDERR_FILENO, message, static_cast<size_t>(length));
+            (void)unused;
+        }
+        void* frames[MAX_TRACE_FRAMES];
+        int depth = backtrace(frames, MAX_TRACE_FRAMES);
+        backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+#else
+        (void)length;
+        std::fputs(message, stderr);
+#endif
+        t_reporting = false;
+
+        if (t_abort_on_violation) {
+            std::abort();
+        }
+    }
+
+    void release(void* memory) noexcept {
+        if (memory != nullptr) {
+            g_deallocations.fetch_add(1, std::memory_order_relaxed);
+            std::free(memory);
+        }
+    }
+}
+
+namespace gptp {
+
+uint64_t allocation_count() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+int64_t live_allocation_count() {
+    return static_cast<int64_t>(g_allocations.load(std::memory_order_relaxed) -
+                                g_deallocations.load(std::memory_order_relaxed));
+}
+
+uint64_t allocation_violation_count() {
+    return g_violations.load(std::memory_order_relaxed);
+}
+
+ScopedAllocationGuard::ScopedAllocationGuard(bool abort_on_violation)
+    : previous_abort_(t_abort_on_violation) {
+    t_guard_depth++;
+    t_abort_on_violation = t_abort_on_violation || abort_on_violation;
+}
+
+ScopedAllocationGuard::~ScopedAllocationGuard() {
+    t_guard_depth--;
+    t_abort_on_violation = previous_abort_;
+}
+
+ScopedAllocationAllowance::ScopedAllocationAllowance()
+    : previous_depth_(t_guard_depth) {
+    t_guard_depth = 0;
+}
+
+ScopedAllocationAllowance::~ScopedAllocationAllowance() {
+    t_guard_depth = previous_depth_;
+}
+
+} // namespace gptp
+
+// Array and nothrow forms end up here through the library's defaults
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (t_guard_depth > 0 && !t_reporting) {
+        report_violation(size);
+    }
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    release(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    release(memory);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file allocation_counter.hpp
+ * @brief Process-wide heap allocation counts
+ *
+ * allocation_counter.cpp replaces the global operator new and delete, so
+ * the counts only exist in programs that link it: benchmarks, soak runs
+ * and tests, never the daemon. Counting is one relaxed atomic increment.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace gptp {
+
+/**
+ * @brief Heap allocations made since the process started
+ */
+uint64_t allocation_count();
+
+/**
+ * @brief Allocations not freed yet
+ */
+int64_t live_allocation_count();
+
+/**
+ * @brief Allocations made inside a ScopedAllocationGuard
+ */
+uint64_t allocation_violation_count();
+
+/**
+ * @brief Forbids heap allocation on this thread while in scope
+ *
+ * Wraps code that must not allocate once warmed up. Each allocation made
+ * anyway is counted as a violation and reported on stderr with a stack
+ * trace; with abort_on_violation the process aborts right there, so a
+ * debugger or core dump shows the culprit. Guards nest.
+ */
+class ScopedAllocationGuard {
+public:
+    explicit ScopedAllocationGuard(bool abort_on_violation = false);
+    ~ScopedAllocationGuard();
+
+    ScopedAllocationGuard(const ScopedAllocationGuard&) = delete;
+    ScopedAllocationGuard& operator=(const ScopedAllocationGuard&) = delete;
+
+private:
+    bool previous_abort_;
+};
+
+/**
+ * @brief Lifts the enclosing guards on this thread while in scope
+ *
+ * For allocations that belong to a test harness rather than the code under
+ * test, such as a simulated network queueing a frame.
+ */
+class ScopedAllocationAllowance {
+public:
+    ScopedAllocationAllowance();
+    ~ScopedAllocationAllowance();
+
+    ScopedAllocationAllowance(const ScopedAllocationAllowance&) = delete;
+    ScopedAllocationAllowance& operator=(const ScopedAllocationAllowance&) = delete;
+
+private:
+    int previous_depth_;
+};
+
+} // namespace gptp
@@ -1,6 +1,10 @@
 #include "configuration.hpp"
 #include "logger.hpp"
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
 #include <cstdlib>
+#include <exception>
 #include <fstream>
 
 namespace gptp {
@@ -39,31 +43,83 @@ namespace gptp {
             value.erase(0, value.find_first_not_of(" \t"));
             value.erase(value.find_last_not_of(" \t") + 1);
 
-            // Parse configuration values
-            if (key == "preferred_interface") {
-                network.preferred_interface = value;
-            } else if (key == "auto_select_interface") {
-                network.auto_select_interface = (value == "true" || value == "1");
-            } else if (key == "sync_interval_ms") {
-                network.sync_interval_ms = std::stoi(value);
-            } else if (key == "announce_interval_ms") {
-                network.announce_interval_ms = std::stoi(value);
-            } else if (key == "hardware_timestamping_preferred") {
-                network.hardware_timestamping_preferred = (value == "true" || value == "1");
-            } else if (key == "log_level") {
-                logging.log_level = value;
-            } else if (key == "console_output") {
-                logging.console_output = (value == "true" || value == "1");
-            } else if (key == "file_output") {
-                logging.file_output = (value == "true" || value == "1");
-            } else if (key == "log_file_path") {
-                logging.log_file_path = value;
-            } else if (key == "run_as_service") {
-                system.run_as_service = (value == "true" || value == "1");
-            } else if (key == "enable_statistics") {
-                system.enable_statistics = (value == "true" || value == "1");
-            } else {
-                LOG_WARN("Unknown configuration key: {}", key);
+            // Parse configuration values; std::stoi throws on a malformed number
+            try {
+                if (key == "preferred_interface") {
+                    network.preferred_interface = value;
+                } else if (key == "auto_select_interface") {
+                    network.auto_select_interface = (value == "true" || value == "1");
+                } else if (key == "sync_interval_ms") {
+                    network.sync_interval_ms = std::stoi(value);
+                } else if (key == "announce_interval_ms") {
+                    network.announce_interval_ms = std::stoi(value);
+                } else if (key == "hardware_timestamping_preferred") {
+                    network.hardware_timestamping_preferred = (value == "true" || value == "1");
+                } else if (key == "max_interfaces") {
+                    network.max_interfaces = std::stoi(value);
+                } else if (key == "interface_cache_path") {
+                    network.interface_cache_path = value;
+                } else if (key == "log_level") {
+                    logging.log_level = value;
+                } else if (key == "console_output") {
+                    logging.console_output = (value == "true" || value == "1");
+                } else if (key == "file_output") {
+                    logging.file_output = (value == "true" || value == "1");
+                } else if (key == "log_file_path") {
+                    logging.log_file_path = value;
+                } else if (key == "max_log_file_size_mb") {
+                    logging.max_log_file_size_mb = std::stoi(value);
+                } else if (key == "max_log_files") {
+                    logging.max_log_files = std::stoi(value);
+                } else if (key == "trace_file_path") {
+                    logging.trace_file_path = value;
+                } else if (key == "trace_file_size_mb") {
+                    logging.trace_file_size_mb = std::stoi(value);
+                } else if (key == "trace_max_files") {
+                    logging.trace_max_files = std::stoi(value);
+                } else if (key == "capture_file_path") {
+                    logging.capture_file_path = value;
+                } else if (key == "capture_file_size_mb") {
+                    logging.capture_file_size_mb = std::stoi(value);
+                } else if (key == "capture_max_files") {
+                    logging.capture_max_files = std::stoi(value);
+                } else if (key == "run_as_service") {
+                    system.run_as_service = (value == "true" || value == "1");
+                } else if (key == "enable_statistics") {
+                    system.enable_statistics = (value == "true" || value == "1");
+                } else if (key == "statistics_interval_ms") {
+                    system.statistics_interval_ms = std::stoi(value);
+                } else if (key == "enable_performance_monitoring") {
+                    system.enable_performance_monitoring = (value == "true" || value == "1");
+                } else if (key == "metrics_socket_path") {
+                    system.metrics_socket_path = value;
+                } else if (key == "metrics_http_port") {
+                    system.metrics_http_port = std::stoi(value);
+                } else if (key == "time_shm_name") {
+                    system.time_shm_name = value;
+                } else if (key == "phc_system_sync") {
+                    system.phc_system_sync = (value == "true" || value == "1");
+                } else if (key == "phc_system_sync_interval_ms") {
+                    system.phc_system_sync_interval_ms = std::stoi(value);
+                } else if (key == "phc_utc_offset_s") {
+                    system.phc_utc_offset_s = std::stoi(value);
+                } else if (key == "clock_source") {
+                    system.clock_source = value;
+                } else if (key.compare(0, 8, "latency.") == 0 && key.size() > 8) {
+                    LatencyOverride latency;
+                    if (!parse_latency_override(key.substr(8), value, latency)) {
+                        LOG_ERROR("Invalid latency entry {}={} (expected latency.<name>[@<speed_mbps>]="
+                                  "<ingress_ns>,<egress_ns>)", key, value);
+                        parse_errors_++;
+                        continue;
+                    }
+                    network.latency_overrides[key.substr(8)] = latency;
+                } else {
+                    LOG_WARN("Unknown configuration key: {}", key);
+                }
+            } catch (const std::exception&) {
+                LOG_ERROR("Invalid value for {}: {}", key, value);
+                parse_errors_++;
             }
         }
 
@@ -71,6 +127,46 @@ namespace gptp {
         return true;
     }
 
+    bool Configuration::parse_latency_override(const std::string& key, const std::string& value,
+                                               LatencyOverride& latency) {
+        // Whole-string numbers only: no sign on the speed, nothing trailing
+        auto parse_integer = [](const std::string& text, bool allow_sign, long long& result) {
+            if (text.empty() || !(std::isdigit(static_cast<unsigned char>(text[0])) ||
+                                  (allow_sign && text[0] == '-' && text.size() > 1))) {
+                return false;
+            }
+            errno = 0;
+            char* end = nullptr;
+            result = std::strtoll(text.c_str(), &end, 10);
+            return errno == 0 && *end == '\0';
+        };
+
+        size_t at = key.find('@');
+        latency.name = key.substr(0, at);
+        if (latency.name.empty()) {
+            return false;
+        }
+        latency.speed_mbps = 0;
+        if (at != std::string::npos) {
+            long long speed = 0;
+            if (!parse_integer(key.substr(at + 1), false, speed) || speed <= 0 || speed > UINT32_MAX) {
+                return false;
+            }
+            latency.speed_mbps = static_cast<uint32_t>(speed);
+        }
+
+        size_t comma = value.find(',');
+        long long ingress = 0;
+        long long egress = 0;
+        if (comma == std::string::npos || !parse_integer(value.substr(0, comma), true, ingress) ||
+            !parse_integer(value.substr(comma + 1), true, egress)) {
+            return false;
+        }
+        latency.ingress_ns = ingress;
+        latency.egress_ns = egress;
+        return true;
+    }
+
     bool Configuration::save_to_file(const std::string& config_file) const {
         std::ofstream file(config_file);
         if (!file.is_open()) {
@@ -87,16 +183,38 @@ namespace gptp {
         file << "sync_interval_ms=" << network.sync_interval_ms << "\n";
         file << "announce_interval_ms=" << network.announce_interval_ms << "\n";
         file << "hardware_timestamping_preferred=" << (network.hardware_timestamping_preferred ? "true" : "false") << "\n";
+        file << "max_interfaces=" << network.max_interfaces << "\n";
+        file << "interface_cache_path=" << network.interface_cache_path << "\n";
+        for (const auto& entry : network.latency_overrides) {
+            file << "latency." << entry.first << "=" << entry.second.ingress_ns << "," << entry.second.egress_ns << "\n";
+        }
 
         file << "\n# Logging Configuration\n";
         file << "log_level=" << logging.log_level << "\n";
         file << "console_output=" << (logging.console_output ? "true" : "false") << "\n";
         file << "file_output=" << (logging.file_output ? "true" : "false") << "\n";
         file << "log_file_path=" << logging.log_file_path << "\n";
+        file << "max_log_file_size_mb=" << logging.max_log_file_size_mb << "\n";
+        file << "max_log_files=" << logging.max_log_files << "\n";
+        file << "trace_file_path=" << logging.trace_file_path << "\n";
+        file << "trace_file_size_mb=" << logging.trace_file_size_mb << "\n";
+        file << "trace_max_files=" << logging.trace_max_files << "\n";
+        file << "capture_file_path=" << logging.capture_file_path << "\n";
+        file << "capture_file_size_mb=" << logging.capture_file_size_mb << "\n";
+        file << "capture_max_files=" << logging.capture_max_files << "\n";
 
         file << "\n# System Configuration\n";
         file << "run_as_service=" << (system.run_as_service ? "true" : "false") << "\n";
         file << "enable_statistics=" << (system.enable_statistics ? "true" : "false") << "\n";
+        file << "statistics_interval_ms=" << system.statistics_interval_ms << "\n";
+        file << "enable_performance_monitoring=" << (system.enable_performance_monitoring ? "true" : "false") << "\n";
+        file << "metrics_socket_path=" << system.metrics_socket_path << "\n";
+        file << "metrics_http_port=" << system.metrics_http_port << "\n";
+        file << "time_shm_name=" << system.time_shm_name << "\n";
+        file << "phc_system_sync=" << (system.phc_system_sync ? "true" : "false") << "\n";
+        file << "phc_system_sync_interval_ms=" << system.phc_system_sync_interval_ms << "\n";
+        file << "phc_utc_offset_s=" << system.phc_utc_offset_s << "\n";
+        file << "clock_source=" << system.clock_source << "\n";
 
         LOG_INFO("Configuration saved to file: {}", config_file);
         return true;
@@ -115,7 +233,12 @@ namespace gptp {
         }
 
         if ((env_value = std::getenv("GPTP_SYNC_INTERVAL")) != nullptr) {
-            network.sync_interval_ms = std::stoi(env_value);
+            try {
+                network.sync_interval_ms = std::stoi(env_value);
+            } catch (const std::exception&) {
+                LOG_ERROR("Invalid value for GPTP_SYNC_INTERVAL: {}", env_value);
+                parse_errors_++;
+            }
         }
 
         if ((env_value = std::getenv("GPTP_HARDWARE_TS")) != nullptr) {
@@ -128,6 +251,11 @@ namespace gptp {
     bool Configuration::validate() const {
         bool valid = true;
 
+        if (parse_errors_ > 0) {
+            LOG_ERROR("{} configuration value(s) could not be parsed", parse_errors_);
+            valid = false;
+        }
+
         // Validate network configuration
         if (network.sync_interval_ms <= 0 || network.sync_interval_ms > 10000) {
             LOG_ERROR("Invalid sync_interval_ms: {}", network.sync_interval_ms);
@@ -139,6 +267,11 @@ namespace gptp {
             valid = false;
         }
 
+        if (network.max_interfaces < 0) {
+            LOG_ERROR("Invalid max_interfaces: {}", network.max_interfaces);
+            valid = false;
+        }
+
         // Validate logging configuration
         if (logging.log_level != "TRACE" && logging.log_level != "DEBUG" && 
             logging.log_level != "INFO" && logging.log_level != "WARN" && 
@@ -147,6 +280,53 @@ namespace gptp {
             valid = false;
         }
 
+        if (logging.max_log_file_size_mb <= 0) {
+            LOG_ERROR("Invalid max_log_file_size_mb: {}", logging.max_log_file_size_mb);
+            valid = false;
+        }
+
+        if (logging.max_log_files <= 0) {
+            LOG_ERROR("Invalid max_log_files: {}", logging.max_log_files);
+            valid = false;
+        }
+
+        if (system.statistics_interval_ms <= 0) {
+            LOG_ERROR("Invalid statistics_interval_ms: {}", system.statistics_interval_ms);
+            valid = false;
+        }
+
+        if (system.metrics_http_port < 0 || system.metrics_http_port > 65535) {
+            LOG_ERROR("Invalid metrics_http_port: {}", system.metrics_http_port);
+            valid = false;
+        }
+
+        if (system.clock_source != "auto" && system.clock_source != "tsc" && system.clock_source != "system") {
+            LOG_ERROR("Invalid clock_source: {} (expected auto, tsc or system)", system.clock_source);
+            valid = false;
+        }
+
+        if (system.phc_system_sync_interval_ms <= 0) {
+            LOG_ERROR("Invalid phc_system_sync_interval_ms: {}", system.phc_system_sync_interval_ms);
+            valid = false;
+        }
+
+        if (!system.time_shm_name.empty() &&
+            (system.time_shm_name[0] != '/' || system.time_shm_name.find('/', 1) != std::string::npos)) {
+            LOG_ERROR("Invalid time_shm_name: {} (expected /name)", system.time_shm_name);
+            valid = false;
+        }
+
+        if (logging.trace_file_size_mb <= 0 || logging.trace_max_files <= 0) {
+            LOG_ERROR("Invalid trace file limits: {} MB x {}", logging.trace_file_size_mb, logging.trace_max_files);
+            valid = false;
+        }
+
+        if (logging.capture_file_size_mb <= 0 || logging.capture_max_files <= 0) {
+            LOG_ERROR("Invalid capture file limits: {} MB x {}", logging.capture_file_size_mb,
+                      logging.capture_max_files);
+            valid = false;
+        }
+
         if (valid) {
             LOG_DEBUG("Configuration validation passed");
         } else {
@@ -2,6 +2,9 @@
 
 #include <string>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
 
 namespace gptp {
 
@@ -18,6 +21,24 @@ namespace gptp {
             return config;
         }
 
+        /**
+         * @brief Measured PHY latencies of one NIC or controller family, ns
+         */
+        struct LatencyOverride {
+            std::string name;               // Controller family or interface
+            uint32_t speed_mbps = 0;        // 0 (AdapterLatencyTable::ANY_SPEED) for every link speed
+            int64_t ingress_ns = 0;
+            int64_t egress_ns = 0;
+        };
+
+        /**
+         * @brief Parse one latency.<name>[@<speed_mbps>]=<ingress_ns>,<egress_ns> entry
+         * @param key Key without the "latency." prefix
+         * @return false if the key or value is malformed; nothing throws
+         */
+        static bool parse_latency_override(const std::string& key, const std::string& value,
+                                           LatencyOverride& latency);
+
         // Network configuration
         struct NetworkConfig {
             std::string preferred_interface;
@@ -26,7 +47,10 @@ namespace gptp {
             int announce_interval_ms = 1000;  // IEEE 802.1AS compliant: 1 second
             int pdelay_req_interval_ms = 1000;  // IEEE 802.1AS compliant: 1 second
             bool hardware_timestamping_preferred = true;
-            int max_interfaces = 10;
+            int max_interfaces = 0;  // 0 = run on every gPTP-capable interface
+            std::string interface_cache_path = "/run/gptp-interfaces.cache";  // Empty disables the cache
+            // latency.<family|interface>[@<speed_mbps>]=<ingress_ns>,<egress_ns>; replaces built-in values
+            std::map<std::string, LatencyOverride> latency_overrides;
         } network;
 
         // Timing configuration  
@@ -58,6 +82,12 @@ namespace gptp {
             std::string log_file_path = "gptp.log";
             int max_log_file_size_mb = 10;
             int max_log_files = 5;
+            std::string trace_file_path;                        // Binary sync trace, empty disables
+            int trace_file_size_mb = 16;
+            int trace_max_files = 8;
+            std::string capture_file_path;                      // pcapng of every RX/TX frame, empty disables
+            int capture_file_size_mb = 64;
+            int capture_max_files = 4;
         } logging;
 
         // System configuration
@@ -65,7 +95,14 @@ namespace gptp {
             bool run_as_service = false;
             bool enable_statistics = true;
             int statistics_interval_ms = 5000;
-            bool enable_performance_monitoring = false;
+            bool enable_performance_monitoring = false;         // Per-stage latency histograms
+            std::string metrics_socket_path = "/run/gptp-metrics.sock"; // Empty disables
+            int metrics_http_port = 0;                          // Loopback only, 0 disables
+            std::string time_shm_name = "/gptp-time";           // Shared memory time for clients, empty disables
+            bool phc_system_sync = false;                       // Steer CLOCK_REALTIME to the disciplined PHC
+            int phc_system_sync_interval_ms = 1000;
+            int phc_utc_offset_s = 37;                          // TAI - UTC; 0 if the PHC carries UTC
+            std::string clock_source = "auto";                  // Software timestamp clock: auto, tsc or system
         } system;
 
         /**
@@ -89,6 +126,8 @@ namespace gptp {
 
         /**
          * @brief Validate configuration values
+         *
+         * Also fails if a value in the file or environment could not be parsed.
          * @return true if configuration is valid, false otherwise
          */
         bool validate() const;
@@ -99,6 +138,8 @@ namespace gptp {
         }
 
         static void load_defaults();
+
+        size_t parse_errors_ = 0;   // Values rejected by load_from_file() / load_from_environment()
     };
 
 } // namespace gptp
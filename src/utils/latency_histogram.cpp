@@ -0,0 +1,74 @@
+/**
+ * @file latency_histogram.cpp
+ * @brief Fixed-memory, lock-free latency histogram with HDR-style buckets
+ */
+
+#include "latency_histogram.hpp"
+
+#include <limits>
+
+namespace gptp {
+
+static_assert(LatencyHistogram::BUCKET_COUNT == 1024, "histogram layout");
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_ns_.store(0, std::memory_order_relaxed);
+    min_ns_.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_release);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot result;
+    result.count = count_.load(std::memory_order_acquire);
+    result.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+    result.max_ns = max_ns_.load(std::memory_order_relaxed);
+    result.min_ns = result.count > 0 ? min_ns_.load(std::memory_order_relaxed) : 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+int64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+    constexpr size_t LINEAR_BUCKETS = size_t{1} << (SUB_BUCKET_BITS + 1);
+    if (index < LINEAR_BUCKETS) {
+        return static_cast<int64_t>(index);
+    }
+    int shift = static_cast<int>(index >> SUB_BUCKET_BITS) - 1;
+    uint64_t mantissa = (index & ((size_t{1} << SUB_BUCKET_BITS) - 1)) + (uint64_t{1} << SUB_BUCKET_BITS);
+    return static_cast<int64_t>(((mantissa + 1) << shift) - 1);
+}
+
+int64_t LatencyHistogram::Snapshot::value_at_percentile(double percentile) const {
+    uint64_t total = 0;
+    for (uint64_t bucket : buckets) {
+        total += bucket;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+    if (target < 1) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= target) {
+            int64_t bound = bucket_upper_bound(i);
+            return bound < max_ns ? bound : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+} // namespace gptp
@@ -0,0 +1,120 @@
+/**
+ * @file latency_histogram.hpp
+ * @brief Fixed-memory, lock-free latency histogram with HDR-style buckets
+ *
+ * Values below 64 ns get one bucket each; above that every power of two is
+ * split into 32 linear sub-buckets, so any recorded value is reported with
+ * at most ~3% relative error. Values are clamped to 2^36 ns (~68 s), which
+ * bounds the histogram to 1024 buckets (8 KiB).
+ *
+ * record() is wait-free and may be called from any thread; snapshot() can
+ * run concurrently from a metrics reader and sees a consistent-enough view
+ * (counts are read bucket by bucket, never torn).
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace gptp {
+
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int MAX_VALUE_BITS = 36;
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS - 1) * (size_t{1} << SUB_BUCKET_BITS)
+                                           + (size_t{1} << (SUB_BUCKET_BITS + 1));
+    static constexpr int64_t MAX_VALUE_NS = (int64_t{1} << MAX_VALUE_BITS) - 1;
+
+    /**
+     * @brief Point-in-time copy of a histogram
+     */
+    struct Snapshot {
+        uint64_t count = 0;
+        int64_t sum_ns = 0;
+        int64_t min_ns = 0;
+        int64_t max_ns = 0;
+        std::array<uint64_t, BUCKET_COUNT> buckets{};
+
+        int64_t mean_ns() const {
+            return count > 0 ? sum_ns / static_cast<int64_t>(count) : 0;
+        }
+
+        /**
+         * @brief Upper bound of the bucket holding the given percentile
+         * @param percentile 0..100
+         */
+        int64_t value_at_percentile(double percentile) const;
+    };
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one latency; negative values count as zero
+     */
+    void record(int64_t value_ns) {
+        if (value_ns < 0) {
+            value_ns = 0;
+        } else if (value_ns > MAX_VALUE_NS) {
+            value_ns = MAX_VALUE_NS;
+        }
+
+        buckets_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+
+        int64_t current = max_ns_.load(std::memory_order_relaxed);
+        while (value_ns > current &&
+               !max_ns_.compare_exchange_weak(current, value_ns, std::memory_order_relaxed)) {
+        }
+        current = min_ns_.load(std::memory_order_relaxed);
+        while (value_ns < current &&
+               !min_ns_.compare_exchange_weak(current, value_ns, std::memory_order_relaxed)) {
+        }
+
+        // Published last so a reader never sees more samples than bucket counts
+        count_.fetch_add(1, std::memory_order_release);
+    }
+
+    Snapshot snapshot() const;
+
+    void reset();
+
+    uint64_t get_count() const { return count_.load(std::memory_order_acquire); }
+
+    static size_t bucket_index(int64_t value_ns) {
+        uint64_t value = static_cast<uint64_t>(value_ns);
+        if (value < (uint64_t{1} << (SUB_BUCKET_BITS + 1))) {
+            return static_cast<size_t>(value);
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        int msb = 63 - __builtin_clzll(value);
+#else
+        int msb = 0;
+        while (value >> (msb + 1)) {
+            ++msb;
+        }
+#endif
+        int shift = msb - SUB_BUCKET_BITS;
+        return static_cast<size_t>(shift) * (size_t{1} << SUB_BUCKET_BITS) + static_cast<size_t>(value >> shift);
+    }
+
+    /**
+     * @brief Largest value that maps to the bucket
+     */
+    static int64_t bucket_upper_bound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<int64_t> sum_ns_;
+    std::atomic<int64_t> min_ns_;
+    std::atomic<int64_t> max_ns_;
+};
+
+} // namespace gptp
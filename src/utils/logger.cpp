@@ -0,0 +1,615 @@
+#include "logger.hpp"
+#include "../../include/clock_source.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gptp {
+
+    namespace logging {
+
+        std::string format_message(const char* format, const std::string* args, size_t count) {
+            std::string message;
+            size_t next_arg = 0;
+            const char* cursor = format;
+
+            while (*cursor) {
+                const char* placeholder = std::strstr(cursor, "{}");
+                if (!placeholder || next_arg >= count) {
+                    message.append(cursor);
+                    break;
+                }
+                message.append(cursor, static_cast<size_t>(placeholder - cursor));
+                message.append(args[next_arg++]);
+                cursor = placeholder + 2;
+            }
+
+            for (; next_arg < count; ++next_arg) {
+                message.push_back(' ');
+                message.append(args[next_arg]);
+            }
+            return message;
+        }
+
+    } // namespace logging
+
+    namespace {
+
+        constexpr size_t MAX_ARGUMENTS = 32;
+        constexpr auto WRITER_IDLE_WAIT = std::chrono::milliseconds(10);
+
+        const char* level_to_string(LogLevel level) {
+            switch (level) {
+                case LogLevel::TRACE: return "TRACE";
+                case LogLevel::DEBUG: return "DEBUG";
+                case LogLevel::INFO:  return "INFO ";
+                case LogLevel::WARN:  return "WARN ";
+                case LogLevel::ERROR: return "ERROR";
+                case LogLevel::FATAL: return "FATAL";
+                default: return "UNKNOWN";
+            }
+        }
+
+        /**
+         * @brief "[YYYY-mm-dd HH:MM:SS.mmm] [LEVEL] " prefix of a line
+         */
+        void append_prefix(std::string& out, int64_t timestamp_ns, LogLevel level) {
+            std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000LL);
+            int milliseconds = static_cast<int>((timestamp_ns / 1000000LL) % 1000);
+
+            std::tm local{};
+#ifdef _WIN32
+            localtime_s(&local, &seconds);
+#else
+            localtime_r(&seconds, &local);
+#endif
+            char prefix[64];
+            size_t length = std::strftime(prefix, sizeof(prefix), "[%Y-%m-%d %H:%M:%S", &local);
+            std::snprintf(prefix + length, sizeof(prefix) - length, ".%03d] [%s] ",
+                          milliseconds, level_to_string(level));
+            out.append(prefix);
+        }
+
+        /**
+         * @brief Render a packed record as one output line
+         */
+        int64_t decode_record(const uint8_t* data, size_t size, std::string& out) {
+            const char* format = nullptr;
+            int64_t timestamp_ns = 0;
+            std::memcpy(&format, data, sizeof(format));
+            LogLevel level = static_cast<LogLevel>(data[sizeof(format)]);
+            std::memcpy(&timestamp_ns, data + sizeof(format) + 1, sizeof(timestamp_ns));
+            size_t count = data[sizeof(format) + 1 + sizeof(timestamp_ns)];
+            bool truncated = data[sizeof(format) + 2 + sizeof(timestamp_ns)] != 0;
+
+            std::string args[MAX_ARGUMENTS];
+            count = std::min(count, MAX_ARGUMENTS);
+            size_t offset = logging::RecordBuffer::HEADER_SIZE;
+            for (size_t i = 0; i < count && offset < size; ++i) {
+                auto type = static_cast<logging::ArgType>(data[offset++]);
+                switch (type) {
+                    case logging::ArgType::INT: {
+                        int64_t value;
+                        std::memcpy(&value, data + offset, sizeof(value));
+                        offset += sizeof(value);
+                        args[i] = std::to_string(value);
+                        break;
+                    }
+                    case logging::ArgType::UINT: {
+                        uint64_t value;
+                        std::memcpy(&value, data + offset, sizeof(value));
+                        offset += sizeof(value);
+                        args[i] = std::to_string(value);
+                        break;
+                    }
+                    case logging::ArgType::DOUBLE: {
+                        double value;
+                        std::memcpy(&value, data + offset, sizeof(value));
+                        offset += sizeof(value);
+                        std::ostringstream stream;
+                        stream << value;
+                        args[i] = stream.str();
+                        break;
+                    }
+                    case logging::ArgType::BOOL:
+                        args[i] = data[offset++] ? "true" : "false";
+                        break;
+                    case logging::ArgType::CHAR:
+                        args[i] = std::string(1, static_cast<char>(data[offset++]));
+                        break;
+                    case logging::ArgType::STRING: {
+                        uint16_t length;
+                        std::memcpy(&length, data + offset, sizeof(length));
+                        offset += sizeof(length);
+                        args[i].assign(reinterpret_cast<const char*>(data + offset), length);
+                        offset += length;
+                        break;
+                    }
+                }
+            }
+
+            append_prefix(out, timestamp_ns, level);
+            out.append(logging::format_message(format, args, count));
+            if (truncated) {
+                out.append(" [truncated]");
+            }
+            out.push_back('\n');
+            return timestamp_ns;
+        }
+
+        /**
+         * @brief Single-producer/single-consumer byte ring of one logging thread
+         *
+         * Records are framed by a 32-bit length and start on 8-byte
+         * boundaries; a record that does not fit before the end of the
+         * buffer is preceded by a wrap marker.
+         */
+        class ThreadRing {
+        public:
+            explicit ThreadRing(size_t capacity)
+                : buffer_(round_up_power_of_two(capacity))
+                , mask_(buffer_.size() - 1)
+                , head_(0)
+                , tail_(0)
+                , dropped_(0)
+                , retired_(false) {
+            }
+
+            /**
+             * @brief Append a record (producer thread only)
+             * @return false if the ring is full
+             */
+            bool push(const uint8_t* data, size_t length) {
+                const uint64_t head = head_.load(std::memory_order_relaxed);
+                const uint64_t tail = tail_.load(std::memory_order_acquire);
+                const size_t total = align(sizeof(uint32_t) + length);
+                const size_t until_end = buffer_.size() - (head & mask_);
+                const size_t skip = total > until_end ? until_end : 0;
+
+                if (total > buffer_.size() / 2 || buffer_.size() - (head - tail) < skip + total) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                uint64_t position = head;
+                if (skip) {
+                    uint32_t marker = WRAP_MARKER;
+                    std::memcpy(&buffer_[position & mask_], &marker, sizeof(marker));
+                    position += skip;
+                }
+                uint32_t length32 = static_cast<uint32_t>(length);
+                std::memcpy(&buffer_[position & mask_], &length32, sizeof(length32));
+                std::memcpy(&buffer_[(position & mask_) + sizeof(uint32_t)], data, length);
+                head_.store(position + total, std::memory_order_release);
+                return true;
+            }
+
+            /**
+             * @brief Hand every queued record to a handler (consumer thread only)
+             */
+            template<typename Handler>
+            size_t drain(Handler&& handler) {
+                uint64_t tail = tail_.load(std::memory_order_relaxed);
+                const uint64_t head = head_.load(std::memory_order_acquire);
+                size_t records = 0;
+
+                while (tail != head) {
+                    uint32_t length;
+                    std::memcpy(&length, &buffer_[tail & mask_], sizeof(length));
+                    if (length == WRAP_MARKER) {
+                        tail += buffer_.size() - (tail & mask_);
+                        continue;
+                    }
+                    handler(&buffer_[(tail & mask_) + sizeof(uint32_t)], static_cast<size_t>(length));
+                    tail += align(sizeof(uint32_t) + length);
+                    ++records;
+                }
+
+                tail_.store(tail, std::memory_order_release);
+                return records;
+            }
+
+            bool empty() const {
+                return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+            }
+
+            uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+            void retire() { retired_.store(true, std::memory_order_release); }
+            bool retired() const { return retired_.load(std::memory_order_acquire); }
+
+        private:
+            static constexpr uint32_t WRAP_MARKER = 0xFFFFFFFFu;
+
+            static size_t align(size_t length) {
+                return (length + 7) & ~static_cast<size_t>(7);
+            }
+
+            static size_t round_up_power_of_two(size_t value) {
+                size_t result = 4096;
+                while (result < value) {
+                    result <<= 1;
+                }
+                return result;
+            }
+
+            std::vector<uint8_t> buffer_;
+            const size_t mask_;
+            alignas(64) std::atomic<uint64_t> head_;
+            alignas(64) std::atomic<uint64_t> tail_;
+            std::atomic<uint64_t> dropped_;
+            std::atomic<bool> retired_;
+        };
+
+        /**
+         * @brief Per-thread handle; retires the ring when the thread exits
+         */
+        struct ThreadRingHandle {
+            std::shared_ptr<ThreadRing> ring;
+            uint64_t generation = 0;
+
+            ~ThreadRingHandle() {
+                if (ring) {
+                    ring->retire();
+                }
+            }
+        };
+
+        thread_local ThreadRingHandle t_ring_handle;
+
+    } // namespace
+
+    // ============================================================================
+    // Background writer
+    // ============================================================================
+
+    class Logger::Backend {
+    public:
+        Backend()
+            : generation_(0)
+            , running_(false)
+            , stop_requested_(false)
+            , flush_requested_(0)
+            , flush_completed_(0)
+            , file_(nullptr)
+            , file_size_(0)
+            , reported_dropped_(0)
+            , retired_dropped_(0) {
+        }
+
+        bool start(const AsyncOptions& options) {
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            if (running_) {
+                return true;
+            }
+
+            options_ = options;
+            if (options_.file_output && !open_file()) {
+                return false;
+            }
+
+            {
+                std::lock_guard<std::mutex> rings_lock(rings_mutex_);
+                rings_.clear();
+                generation_++;
+            }
+            stop_requested_ = false;
+            running_ = true;
+            writer_ = std::thread([this]() { run(); });
+            return true;
+        }
+
+        void stop() {
+            std::lock_guard<std::mutex> lock(control_mutex_);
+            if (!running_) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> wake_lock(wake_mutex_);
+                stop_requested_ = true;
+            }
+            wake_.notify_all();
+            writer_.join();
+            running_ = false;
+
+            if (file_) {
+                std::fclose(file_);
+                file_ = nullptr;
+            }
+        }
+
+        void flush() {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            if (!running_ || stop_requested_) {
+                return;
+            }
+            uint64_t ticket = ++flush_requested_;
+            wake_.notify_all();
+            flushed_.wait(lock, [this, ticket]() { return flush_completed_ >= ticket || stop_requested_; });
+        }
+
+        bool push(const uint8_t* data, size_t length) {
+            ThreadRingHandle& handle = t_ring_handle;
+            if (!handle.ring || handle.generation != generation_) {
+                if (handle.ring) {
+                    handle.ring->retire();
+                }
+                handle.ring = std::make_shared<ThreadRing>(options_.ring_capacity_bytes);
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                handle.generation = generation_;
+                rings_.push_back(handle.ring);
+            }
+            return handle.ring->push(data, length);
+        }
+
+        uint64_t dropped() {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            uint64_t total = retired_dropped_;
+            for (const auto& ring : rings_) {
+                total += ring->dropped();
+            }
+            return total;
+        }
+
+        /**
+         * @brief Write already formatted text synchronously (non-async mode)
+         */
+        void write_direct(const std::string& text) {
+            std::lock_guard<std::mutex> lock(direct_mutex_);
+            std::fwrite(text.data(), 1, text.size(), stdout);
+            std::fflush(stdout);
+        }
+
+    private:
+        struct Line {
+            int64_t timestamp_ns;
+            std::string text;
+        };
+
+        void run() {
+            for (;;) {
+                uint64_t flush_target;
+                bool stopping;
+                {
+                    std::unique_lock<std::mutex> lock(wake_mutex_);
+                    wake_.wait_for(lock, WRITER_IDLE_WAIT, [this]() {
+                        return stop_requested_ || flush_requested_ > flush_completed_;
+                    });
+                    flush_target = flush_requested_;
+                    stopping = stop_requested_;
+                }
+
+                drain();
+
+                {
+                    std::lock_guard<std::mutex> lock(wake_mutex_);
+                    flush_completed_ = flush_target;
+                }
+                flushed_.notify_all();
+
+                if (stopping) {
+                    drain();
+                    return;
+                }
+            }
+        }
+
+        void drain() {
+            std::vector<std::shared_ptr<ThreadRing>> rings;
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings = rings_;
+            }
+
+            lines_.clear();
+            for (const auto& ring : rings) {
+                ring->drain([this](const uint8_t* data, size_t size) {
+                    Line line;
+                    line.timestamp_ns = decode_record(data, size, line.text);
+                    lines_.push_back(std::move(line));
+                });
+            }
+
+            // Interleave threads by record time
+            std::stable_sort(lines_.begin(), lines_.end(), [](const Line& a, const Line& b) {
+                return a.timestamp_ns < b.timestamp_ns;
+            });
+
+            batch_.clear();
+            for (const auto& line : lines_) {
+                batch_.append(line.text);
+            }
+
+            uint64_t total_dropped = collect_retired_and_count_dropped();
+            if (total_dropped > reported_dropped_) {
+                append_prefix(batch_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count(), LogLevel::WARN);
+                batch_.append("Logger dropped ");
+                batch_.append(std::to_string(total_dropped - reported_dropped_));
+                batch_.append(" messages (ring full)\n");
+                reported_dropped_ = total_dropped;
+            }
+
+            if (!batch_.empty()) {
+                write(batch_);
+            }
+        }
+
+        uint64_t collect_retired_and_count_dropped() {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            uint64_t total = 0;
+            for (auto it = rings_.begin(); it != rings_.end();) {
+                if ((*it)->retired() && (*it)->empty()) {
+                    retired_dropped_ += (*it)->dropped();
+                    it = rings_.erase(it);
+                } else {
+                    total += (*it)->dropped();
+                    ++it;
+                }
+            }
+            return total + retired_dropped_;
+        }
+
+        void write(const std::string& text) {
+            if (options_.console_output) {
+                std::fwrite(text.data(), 1, text.size(), stdout);
+                std::fflush(stdout);
+            }
+            if (file_) {
+                if (file_size_ > 0 && file_size_ + text.size() > options_.max_file_size_bytes) {
+                    rotate();
+                }
+                if (file_) {
+                    std::fwrite(text.data(), 1, text.size(), file_);
+                    std::fflush(file_);
+                    file_size_ += text.size();
+                }
+            }
+        }
+
+        bool open_file() {
+            file_ = std::fopen(options_.file_path.c_str(), "a");
+            if (!file_) {
+                return false;
+            }
+            std::fseek(file_, 0, SEEK_END);
+            long position = std::ftell(file_);
+            file_size_ = position > 0 ? static_cast<size_t>(position) : 0;
+            return true;
+        }
+
+        /**
+         * @brief gptp.log -> gptp.log.1 -> ... -> gptp.log.<max_files - 1>
+         */
+        void rotate() {
+            std::fclose(file_);
+            file_ = nullptr;
+
+            const std::string& path = options_.file_path;
+            if (options_.max_files > 1) {
+                std::remove((path + "." + std::to_string(options_.max_files - 1)).c_str());
+                for (int index = options_.max_files - 2; index >= 1; --index) {
+                    std::rename((path + "." + std::to_string(index)).c_str(),
+                                (path + "." + std::to_string(index + 1)).c_str());
+                }
+                std::rename(path.c_str(), (path + ".1").c_str());
+            }
+
+            file_ = std::fopen(path.c_str(), "w");
+            file_size_ = 0;
+        }
+
+        AsyncOptions options_;
+        std::atomic<uint64_t> generation_;
+
+        std::mutex control_mutex_;
+        std::thread writer_;
+        std::atomic<bool> running_;
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+        std::condition_variable flushed_;
+        bool stop_requested_;
+        uint64_t flush_requested_;
+        uint64_t flush_completed_;
+
+        std::mutex rings_mutex_;
+        std::vector<std::shared_ptr<ThreadRing>> rings_;
+
+        std::mutex direct_mutex_;
+
+        // Writer thread state
+        FILE* file_;
+        size_t file_size_;
+        uint64_t reported_dropped_;
+        uint64_t retired_dropped_;
+        std::vector<Line> lines_;
+        std::string batch_;
+    };
+
+    // ============================================================================
+    // Logger
+    // ============================================================================
+
+    Logger& Logger::instance() {
+        // Never destroyed: static destructors elsewhere may still log
+        static Logger* logger = new Logger();
+        return *logger;
+    }
+
+    Logger::Logger()
+        : current_level_(static_cast<int>(LogLevel::INFO))
+        , async_running_(false)
+        , backend_(new Backend()) {
+    }
+
+    Logger::~Logger() {
+        stop_async();
+        delete backend_;
+    }
+
+    bool Logger::start_async(const AsyncOptions& options) {
+        if (!backend_->start(options)) {
+            return false;
+        }
+        if (!async_running_.exchange(true, std::memory_order_acq_rel)) {
+            static bool exit_hook_installed = false;
+            if (!exit_hook_installed) {
+                exit_hook_installed = true;
+                std::atexit([]() { Logger::instance().stop_async(); });
+            }
+        }
+        return true;
+    }
+
+    void Logger::stop_async() {
+        async_running_.store(false, std::memory_order_release);
+        backend_->stop();
+    }
+
+    void Logger::flush() {
+        if (async_running_.load(std::memory_order_acquire)) {
+            backend_->flush();
+        }
+    }
+
+    uint64_t Logger::get_dropped_count() const {
+        return backend_->dropped();
+    }
+
+    bool Logger::parse_level(const std::string& name, LogLevel& level) {
+        static const std::pair<const char*, LogLevel> levels[] = {
+            {"TRACE", LogLevel::TRACE}, {"DEBUG", LogLevel::DEBUG}, {"INFO", LogLevel::INFO},
+            {"WARN", LogLevel::WARN}, {"ERROR", LogLevel::ERROR}, {"FATAL", LogLevel::FATAL}
+        };
+        for (const auto& entry : levels) {
+            if (name == entry.first) {
+                level = entry.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int64_t Logger::now_ns() {
+        return get_clock_source().now_realtime_ns();
+    }
+
+    void Logger::submit(const logging::RecordBuffer& record) {
+        if (async_running_.load(std::memory_order_acquire)) {
+            backend_->push(record.data(), record.size());
+            return;
+        }
+
+        std::string line;
+        decode_record(record.data(), record.size(), line);
+        backend_->write_direct(line);
+    }
+
+} // namespace gptp
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <sstream>
-#include <iostream>
-#include <chrono>
-#include <iomanip>
+#include <type_traits>
+#include <utility>
+
+// Statements below this level are removed at compile time
+// (0 = TRACE ... 5 = FATAL); see GPTP_LOG_MIN_LEVEL in CMakeLists.txt
+#ifndef GPTP_LOG_MIN_LEVEL
+#define GPTP_LOG_MIN_LEVEL 0
+#endif
 
 namespace gptp {
 
@@ -17,35 +26,228 @@ namespace gptp {
         FATAL = 5
     };
 
+    namespace logging {
+
+        /**
+         * @brief Type tag of one packed log argument
+         */
+        enum class ArgType : uint8_t {
+            INT = 0,
+            UINT = 1,
+            DOUBLE = 2,
+            BOOL = 3,
+            CHAR = 4,
+            STRING = 5
+        };
+
+        /**
+         * @brief Fixed-size buffer a log statement is packed into
+         *
+         * Layout: format pointer, level, timestamp, argument count, then one
+         * tagged value per argument. Strings are copied (truncated to
+         * MAX_STRING_LENGTH); everything else is stored in 1 or 8 bytes.
+         * Arguments that do not fit are dropped and the record is marked
+         * truncated.
+         */
+        class RecordBuffer {
+        public:
+            static constexpr size_t CAPACITY = 1024;
+            static constexpr size_t MAX_STRING_LENGTH = 256;
+
+            RecordBuffer(LogLevel level, const char* format, int64_t timestamp_ns)
+                : size_(HEADER_SIZE) {
+                std::memcpy(data_, &format, sizeof(format));
+                data_[LEVEL_OFFSET] = static_cast<uint8_t>(level);
+                std::memcpy(data_ + TIMESTAMP_OFFSET, &timestamp_ns, sizeof(timestamp_ns));
+                data_[COUNT_OFFSET] = 0;
+                data_[TRUNCATED_OFFSET] = 0;
+            }
+
+            void add_int(int64_t value) { add_fixed(ArgType::INT, &value, sizeof(value)); }
+            void add_uint(uint64_t value) { add_fixed(ArgType::UINT, &value, sizeof(value)); }
+            void add_double(double value) { add_fixed(ArgType::DOUBLE, &value, sizeof(value)); }
+            void add_bool(bool value) { uint8_t byte = value ? 1 : 0; add_fixed(ArgType::BOOL, &byte, 1); }
+            void add_char(char value) { add_fixed(ArgType::CHAR, &value, 1); }
+
+            void add_string(const char* value, size_t length) {
+                if (length > MAX_STRING_LENGTH) {
+                    length = MAX_STRING_LENGTH;
+                }
+                if (size_ + 1 + sizeof(uint16_t) + length > CAPACITY) {
+                    data_[TRUNCATED_OFFSET] = 1;
+                    return;
+                }
+                uint16_t length16 = static_cast<uint16_t>(length);
+                data_[size_++] = static_cast<uint8_t>(ArgType::STRING);
+                std::memcpy(data_ + size_, &length16, sizeof(length16));
+                size_ += sizeof(length16);
+                std::memcpy(data_ + size_, value, length);
+                size_ += length;
+                data_[COUNT_OFFSET]++;
+            }
+
+            const uint8_t* data() const { return data_; }
+            size_t size() const { return size_; }
+
+            static constexpr size_t HEADER_SIZE = sizeof(const char*) + 1 + sizeof(int64_t) + 2;
+
+        private:
+            static constexpr size_t LEVEL_OFFSET = sizeof(const char*);
+            static constexpr size_t TIMESTAMP_OFFSET = LEVEL_OFFSET + 1;
+            static constexpr size_t COUNT_OFFSET = TIMESTAMP_OFFSET + sizeof(int64_t);
+            static constexpr size_t TRUNCATED_OFFSET = COUNT_OFFSET + 1;
+
+            void add_fixed(ArgType type, const void* value, size_t length) {
+                if (size_ + 1 + length > CAPACITY) {
+                    data_[TRUNCATED_OFFSET] = 1;
+                    return;
+                }
+                data_[size_++] = static_cast<uint8_t>(type);
+                std::memcpy(data_ + size_, value, length);
+                size_ += length;
+                data_[COUNT_OFFSET]++;
+            }
+
+            uint8_t data_[CAPACITY];
+            size_t size_;
+        };
+
+        // Argument packing; anything without a dedicated overload is
+        // rendered with operator<< on the calling thread
+        inline void pack(RecordBuffer& record, bool value) { record.add_bool(value); }
+        inline void pack(RecordBuffer& record, char value) { record.add_char(value); }
+        inline void pack(RecordBuffer& record, float value) { record.add_double(value); }
+        inline void pack(RecordBuffer& record, double value) { record.add_double(value); }
+        inline void pack(RecordBuffer& record, long double value) { record.add_double(static_cast<double>(value)); }
+        inline void pack(RecordBuffer& record, const char* value) {
+            if (value) {
+                record.add_string(value, std::strlen(value));
+            } else {
+                record.add_string("(null)", 6);
+            }
+        }
+        inline void pack(RecordBuffer& record, char* value) { pack(record, static_cast<const char*>(value)); }
+        inline void pack(RecordBuffer& record, const std::string& value) { record.add_string(value.data(), value.size()); }
+
+        template<typename T>
+        void pack(RecordBuffer& record, const T& value) {
+            if constexpr (std::is_enum<T>::value) {
+                record.add_int(static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+                record.add_int(static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral<T>::value) {
+                record.add_uint(static_cast<uint64_t>(value));
+            } else {
+                std::ostringstream stream;
+                stream << value;
+                const std::string text = stream.str();
+                record.add_string(text.data(), text.size());
+            }
+        }
+
+        /**
+         * @brief Substitute "{}" placeholders in a format with argument texts
+         *
+         * Placeholders without an argument are kept; surplus arguments are
+         * appended separated by spaces.
+         */
+        std::string format_message(const char* format, const std::string* args, size_t count);
+
+    } // namespace logging
+
     /**
      * @brief Simple, modern logging framework for gPTP
-     * 
-     * This provides a lightweight logging solution with different log levels,
-     * formatted output, and thread-safe operation.
+     *
+     * Log statements are packed on the calling thread into a record holding
+     * the format string's address and the raw arguments. In asynchronous
+     * mode (start_async()) records go into a lock-free ring owned by the
+     * calling thread and a background thread formats them and writes to the
+     * console and/or a size-rotated file. Without start_async() records are
+     * formatted and written immediately.
+     *
+     * The LOG_* macros require a string literal as format: only its address
+     * is stored until the record is formatted.
      */
     class Logger {
     public:
-        static Logger& instance() {
-            static Logger logger;
-            return logger;
-        }
+        /**
+         * @brief Output configuration for asynchronous mode
+         */
+        struct AsyncOptions {
+            bool console_output = true;
+            bool file_output = false;
+            std::string file_path = "gptp.log";
+            size_t max_file_size_bytes = 10 * 1024 * 1024;
+            int max_files = 5;                      // Including the active file
+            size_t ring_capacity_bytes = 256 * 1024; // Per producing thread
+        };
+
+        static Logger& instance();
 
         void set_level(LogLevel level) {
-            current_level_ = level;
+            current_level_.store(static_cast<int>(level), std::memory_order_relaxed);
         }
 
         LogLevel get_level() const {
-            return current_level_;
+            return static_cast<LogLevel>(current_level_.load(std::memory_order_relaxed));
+        }
+
+        bool is_enabled(LogLevel level) const {
+            return static_cast<int>(level) >= current_level_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Start the background writer; subsequent records are queued
+         * @return false if an output could not be opened
+         */
+        bool start_async(const AsyncOptions& options);
+
+        /**
+         * @brief Drain all queued records and stop the background writer
+         */
+        void stop_async();
+
+        /**
+         * @brief Block until every record queued so far has been written
+         */
+        void flush();
+
+        bool is_async() const { return async_running_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Records discarded because a thread's ring was full
+         */
+        uint64_t get_dropped_count() const;
+
+        /**
+         * @brief Parse a level name (TRACE ... FATAL)
+         * @return false if the name is unknown
+         */
+        static bool parse_level(const std::string& name, LogLevel& level);
+
+        /**
+         * @brief Hot path behind the LOG_* macros
+         * @param format String literal; must outlive the logger
+         */
+        template<typename... Args>
+        void log_static(LogLevel level, const char* format, const Args&... args) {
+            logging::RecordBuffer record(level, format, now_ns());
+            (logging::pack(record, args), ...);
+            submit(record);
         }
 
         template<typename... Args>
         void log(LogLevel level, const std::string& format, Args&&... args) {
-            if (level < current_level_) {
+            if (!is_enabled(level)) {
                 return;
             }
 
-            std::string message = format_message(format, std::forward<Args>(args)...);
-            output_message(level, message);
+            // Runtime format strings are rendered right away
+            std::string rendered[sizeof...(Args) > 0 ? sizeof...(Args) : 1];
+            size_t index = 0;
+            ((rendered[index++] = to_text(args)), ...);
+            (void)index;
+            log_static(level, "{}", logging::format_message(format.c_str(), rendered, sizeof...(Args)));
         }
 
         // Convenience methods
@@ -80,72 +282,45 @@ namespace gptp {
         }
 
     private:
-        Logger() : current_level_(LogLevel::INFO) {}
-        
-        LogLevel current_level_;
-
-        std::string get_timestamp() const {
-            auto now = std::chrono::system_clock::now();
-            auto time_t = std::chrono::system_clock::to_time_t(now);
-            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now.time_since_epoch()) % 1000;
-
-            std::stringstream ss;
-            ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-            ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-            return ss.str();
-        }
+        class Backend;
 
-        static std::string level_to_string(LogLevel level) {
-            switch (level) {
-                case LogLevel::TRACE: return "TRACE";
-                case LogLevel::DEBUG: return "DEBUG";
-                case LogLevel::INFO:  return "INFO ";
-                case LogLevel::WARN:  return "WARN ";
-                case LogLevel::ERROR: return "ERROR";
-                case LogLevel::FATAL: return "FATAL";
-                default: return "UNKNOWN";
-            }
-        }
+        Logger();
+        ~Logger();
 
-        template<typename... Args>
-        std::string format_message(const std::string& format, Args&&... args) {
-            // Simple string formatting - in a real implementation you might want
-            // to use fmt library or similar for more advanced formatting
-            std::stringstream ss;
-            format_impl(ss, format, std::forward<Args>(args)...);
-            return ss.str();
-        }
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
 
-        static void format_impl(std::stringstream& ss, const std::string& format) {
-            ss << format;
-        }
+        static int64_t now_ns();
+        void submit(const logging::RecordBuffer& record);
 
-        template<typename T, typename... Args>
-        void format_impl(std::stringstream& ss, const std::string& format, T&& arg, Args&&... args) {
-            size_t pos = format.find("{}");
-            if (pos != std::string::npos) {
-                ss << format.substr(0, pos) << std::forward<T>(arg);
-                format_impl(ss, format.substr(pos + 2), std::forward<Args>(args)...);
-            } else {
-                ss << format << " " << std::forward<T>(arg);
-                format_impl(ss, "", std::forward<Args>(args)...);
-            }
+        template<typename T>
+        static std::string to_text(const T& value) {
+            std::ostringstream stream;
+            stream << value;
+            return stream.str();
         }
 
-        void output_message(LogLevel level, const std::string& message) const {
-            // Thread-safe output (cout is thread-safe for individual operations)
-            std::cout << "[" << get_timestamp() << "] [" << level_to_string(level) 
-                      << "] " << message << std::endl;
-        }
+        std::atomic<int> current_level_;
+        std::atomic<bool> async_running_;
+        Backend* backend_;
     };
 
-    // Global logger macros for convenience
-    #define LOG_TRACE(...) gptp::Logger::instance().trace(__VA_ARGS__)
-    #define LOG_DEBUG(...) gptp::Logger::instance().debug(__VA_ARGS__)
-    #define LOG_INFO(...)  gptp::Logger::instance().info(__VA_ARGS__)
-    #define LOG_WARN(...)  gptp::Logger::instance().warn(__VA_ARGS__)
-    #define LOG_ERROR(...) gptp::Logger::instance().error(__VA_ARGS__)
-    #define LOG_FATAL(...) gptp::Logger::instance().fatal(__VA_ARGS__)
+    // Global logger macros for convenience. Statements below
+    // GPTP_LOG_MIN_LEVEL compile to nothing, arguments included.
+    #define GPTP_LOG_AT(level, ...) \
+        do { \
+            if constexpr (static_cast<int>(level) >= GPTP_LOG_MIN_LEVEL) { \
+                if (gptp::Logger::instance().is_enabled(level)) { \
+                    gptp::Logger::instance().log_static(level, __VA_ARGS__); \
+                } \
+            } \
+        } while (0)
+
+    #define LOG_TRACE(...) GPTP_LOG_AT(gptp::LogLevel::TRACE, __VA_ARGS__)
+    #define LOG_DEBUG(...) GPTP_LOG_AT(gptp::LogLevel::DEBUG, __VA_ARGS__)
+    #define LOG_INFO(...)  GPTP_LOG_AT(gptp::LogLevel::INFO, __VA_ARGS__)
+    #define LOG_WARN(...)  GPTP_LOG_AT(gptp::LogLevel::WARN, __VA_ARGS__)
+    #define LOG_ERROR(...) GPTP_LOG_AT(gptp::LogLevel::ERROR, __VA_ARGS__)
+    #define LOG_FATAL(...) GPTP_LOG_AT(gptp::LogLevel::FATAL, __VA_ARGS__)
 
 } // namespace gptp
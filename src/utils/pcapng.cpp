@@ -0,0 +1,530 @@
+/**
+ * @file pcapng.cpp
+ * @brief pcapng capture files of gPTP frames with nanosecond timestamps
+ */
+
+#include "pcapng.hpp"
+#include "logger.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+namespace gptp {
+namespace capture {
+
+namespace {
+    constexpr uint32_t BLOCK_SECTION_HEADER = 0x0A0D0D0A;
+    constexpr uint32_t BLOCK_INTERFACE = 0x00000001;
+    constexpr uint32_t BLOCK_SIMPLE_PACKET = 0x00000003;
+    constexpr uint32_t BLOCK_ENHANCED_PACKET = 0x00000006;
+    constexpr uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+
+    constexpr uint16_t OPT_END = 0;
+    constexpr uint16_t OPT_SHB_USERAPPL = 4;
+    constexpr uint16_t OPT_IF_NAME = 2;
+    constexpr uint16_t OPT_IF_MACADDR = 6;
+    constexpr uint16_t OPT_IF_TSRESOL = 9;
+    constexpr uint16_t OPT_EPB_FLAGS = 2;
+
+    constexpr uint32_t PCAP_MAGIC_US = 0xA1B2C3D4;
+    constexpr uint32_t PCAP_MAGIC_NS = 0xA1B23C4D;
+
+    constexpr uint32_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+    constexpr uint16_t ETHERTYPE_GPTP = 0x88F7;
+    constexpr uint16_t ETHERTYPE_VLAN = 0x8100;
+    constexpr uint16_t ETHERTYPE_QINQ = 0x88A8;
+
+    size_t padded(size_t length) {
+        return (length + 3) & ~static_cast<size_t>(3);
+    }
+
+    void put16(std::vector<uint8_t>& out, uint16_t value) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(value));
+    }
+
+    void put32(std::vector<uint8_t>& out, uint32_t value) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(value));
+    }
+
+    void put_padded(std::vector<uint8_t>& out, const void* data, size_t length) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + length);
+        out.resize(out.size() + padded(length) - length, 0);
+    }
+
+    void put_option(std::vector<uint8_t>& out, uint16_t code, const void* data, size_t length) {
+        put16(out, code);
+        put16(out, static_cast<uint16_t>(length));
+        put_padded(out, data, length);
+    }
+
+    void begin_block(std::vector<uint8_t>& out, uint32_t type) {
+        out.clear();
+        put32(out, type);
+        put32(out, 0);          // Total length, patched by end_block()
+    }
+
+    void end_block(std::vector<uint8_t>& out) {
+        auto total = static_cast<uint32_t>(out.size() + sizeof(uint32_t));
+        std::memcpy(out.data() + 4, &total, sizeof(total));
+        put32(out, total);
+    }
+
+    int64_t to_nanoseconds(uint64_t units, int64_t units_per_second) {
+        if (units_per_second == 1000000000LL || units_per_second <= 0) {
+            return static_cast<int64_t>(units);
+        }
+        auto per_second = static_cast<uint64_t>(units_per_second);
+        return static_cast<int64_t>((units / per_second) * 1000000000ULL +
+                                    (units % per_second) * 1000000000ULL / per_second);
+    }
+
+    uint32_t swap32(uint32_t value) {
+        return ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) | ((value >> 8) & 0xFF00) | (value >> 24);
+    }
+}
+
+// ============================================================================
+// PcapngWriter
+// ============================================================================
+
+PcapngWriter::PcapngWriter()
+    : file_(nullptr)
+    , file_bytes_(0)
+    , frames_written_(0) {
+}
+
+PcapngWriter::~PcapngWriter() {
+    close();
+}
+
+Result<bool> PcapngWriter::open(const Options& options) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+    if (options_.max_files < 1) {
+        options_.max_files = 1;
+    }
+    if (!open_file()) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    LOG_INFO("Capturing gPTP frames to {}", options_.path);
+    return Result<bool>::success(true);
+}
+
+uint32_t PcapngWriter::add_interface(const std::string& name, const std::array<uint8_t, 6>& mac) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CaptureInterface interface;
+    interface.name = name;
+    interface.mac = mac;
+    interfaces_.push_back(interface);
+    if (file_) {
+        write_interface(interface);
+    }
+    return static_cast<uint32_t>(interfaces_.size() - 1);
+}
+
+bool PcapngWriter::write(uint32_t interface_id, int64_t timestamp_ns, Direction direction,
+                         const uint8_t* data, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_ || interface_id >= interfaces_.size()) {
+        return false;
+    }
+
+    auto timestamp = static_cast<uint64_t>(timestamp_ns < 0 ? 0 : timestamp_ns);
+    begin_block(block_, BLOCK_ENHANCED_PACKET);
+    put32(block_, interface_id);
+    put32(block_, static_cast<uint32_t>(timestamp >> 32));
+    put32(block_, static_cast<uint32_t>(timestamp));
+    put32(block_, static_cast<uint32_t>(length));
+    put32(block_, static_cast<uint32_t>(length));
+    put_padded(block_, data, length);
+    if (direction != Direction::UNKNOWN) {
+        uint32_t flags = static_cast<uint32_t>(direction);
+        put_option(block_, OPT_EPB_FLAGS, &flags, sizeof(flags));
+        put_option(block_, OPT_END, nullptr, 0);
+    }
+    end_block(block_);
+
+    if (options_.file_size_bytes != 0 && file_bytes_ + block_.size() > options_.file_size_bytes) {
+        rotate();
+        if (!file_) {
+            return false;
+        }
+    }
+    if (std::fwrite(block_.data(), 1, block_.size(), file_) != block_.size()) {
+        return false;
+    }
+    file_bytes_ += block_.size();
+    frames_written_++;
+    return true;
+}
+
+bool PcapngWriter::write(uint32_t interface_id, int64_t timestamp_ns, Direction direction,
+                         const GptpPacket& packet) {
+    uint8_t frame[sizeof(EthernetFrame) + 1500];
+    size_t length = sizeof(EthernetFrame) + std::min<size_t>(packet.payload.size(), 1500);
+    std::memcpy(frame, &packet.ethernet, sizeof(EthernetFrame));
+    std::memcpy(frame + sizeof(EthernetFrame), packet.payload.data(), length - sizeof(EthernetFrame));
+    return write(interface_id, timestamp_ns, direction, frame, length);
+}
+
+void PcapngWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        std::fflush(file_);
+    }
+}
+
+void PcapngWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool PcapngWriter::is_open() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_ != nullptr;
+}
+
+uint64_t PcapngWriter::get_frames_written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_written_;
+}
+
+bool PcapngWriter::open_file() {
+    file_ = std::fopen(options_.path.c_str(), "wb");
+    if (!file_) {
+        LOG_ERROR("Failed to create capture file {}: {}", options_.path, std::strerror(errno));
+        return false;
+    }
+    file_bytes_ = 0;
+    if (!write_section_header()) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    for (const auto& interface : interfaces_) {
+        write_interface(interface);
+    }
+    return true;
+}
+
+bool PcapngWriter::write_section_header() {
+    static const char APPLICATION[] = "gptp";
+    begin_block(block_, BLOCK_SECTION_HEADER);
+    put32(block_, BYTE_ORDER_MAGIC);
+    put16(block_, 1);                   // Major version
+    put16(block_, 0);                   // Minor version
+    put32(block_, 0xFFFFFFFF);          // Section length unknown
+    put32(block_, 0xFFFFFFFF);
+    put_option(block_, OPT_SHB_USERAPPL, APPLICATION, sizeof(APPLICATION) - 1);
+    put_option(block_, OPT_END, nullptr, 0);
+    end_block(block_);
+    bool written = std::fwrite(block_.data(), 1, block_.size(), file_) == block_.size();
+    file_bytes_ += block_.size();
+    return written;
+}
+
+bool PcapngWriter::write_interface(const CaptureInterface& interface) {
+    const uint8_t resolution = 9;       // 10^-9 s
+    begin_block(block_, BLOCK_INTERFACE);
+    put16(block_, interface.link_type);
+    put16(block_, 0);
+    put32(block_, 0);                   // No snap length limit
+    put_option(block_, OPT_IF_NAME, interface.name.data(), interface.name.size());
+    put_option(block_, OPT_IF_MACADDR, interface.mac.data(), interface.mac.size());
+    put_option(block_, OPT_IF_TSRESOL, &resolution, sizeof(resolution));
+    put_option(block_, OPT_END, nullptr, 0);
+    end_block(block_);
+    bool written = std::fwrite(block_.data(), 1, block_.size(), file_) == block_.size();
+    file_bytes_ += block_.size();
+    return written;
+}
+
+void PcapngWriter::rotate() {
+    std::fclose(file_);
+    file_ = nullptr;
+
+    const std::string& path = options_.path;
+    if (options_.max_files > 1) {
+        std::remove((path + "." + std::to_string(options_.max_files - 1)).c_str());
+        for (int index = options_.max_files - 2; index >= 1; --index) {
+            std::rename((path + "." + std::to_string(index)).c_str(),
+                        (path + "." + std::to_string(index + 1)).c_str());
+        }
+        std::rename(path.c_str(), (path + ".1").c_str());
+    }
+
+    // The block that triggered the rotation is still in block_
+    std::vector<uint8_t> pending;
+    pending.swap(block_);
+    open_file();
+    block_.swap(pending);
+}
+
+// ============================================================================
+// CaptureReader
+// ============================================================================
+
+CaptureReader::CaptureReader()
+    : file_(nullptr)
+    , pcapng_(true)
+    , swapped_(false)
+    , damaged_(false) {
+}
+
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+Result<bool> CaptureReader::open(const std::string& path) {
+    close();
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    uint8_t header[24];
+    if (std::fread(header, 1, 4, file_) != 4) {
+        close();
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+    uint32_t magic;
+    std::memcpy(&magic, header, sizeof(magic));
+
+    if (magic == BLOCK_SECTION_HEADER) {
+        pcapng_ = true;
+        std::rewind(file_);
+        return Result<bool>::success(true);
+    }
+
+    // Classic pcap: fixed header, one link type for the whole file
+    pcapng_ = false;
+    swapped_ = magic == swap32(PCAP_MAGIC_US) || magic == swap32(PCAP_MAGIC_NS);
+    uint32_t native = swapped_ ? swap32(magic) : magic;
+    if ((native != PCAP_MAGIC_US && native != PCAP_MAGIC_NS) || std::fread(header + 4, 1, 20, file_) != 20) {
+        close();
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+    CaptureInterface interface;
+    interface.name = "pcap";
+    interface.link_type = static_cast<uint16_t>(get32(header + 20));
+    interface.units_per_second = native == PCAP_MAGIC_NS ? 1000000000LL : 1000000LL;
+    interfaces_.push_back(interface);
+    return Result<bool>::success(true);
+}
+
+void CaptureReader::close() {
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    interfaces_.clear();
+    swapped_ = false;
+    damaged_ = false;
+}
+
+bool CaptureReader::next(CapturedFrame& frame) {
+    if (!file_) {
+        return false;
+    }
+    return pcapng_ ? next_pcapng(frame) : next_pcap(frame);
+}
+
+bool CaptureReader::next_pcapng(CapturedFrame& frame) {
+    for (;;) {
+        uint8_t head[8];
+        size_t got = std::fread(head, 1, sizeof(head), file_);
+        if (got == 0) {
+            return false;
+        }
+        if (got != sizeof(head)) {
+            damaged_ = true;
+            return false;
+        }
+
+        uint32_t type;
+        std::memcpy(&type, head, sizeof(type));
+        if (type == BLOCK_SECTION_HEADER) {
+            // The byte-order magic decides how this section, length included, is read
+            uint8_t magic_bytes[4];
+            if (std::fread(magic_bytes, 1, 4, file_) != 4) {
+                damaged_ = true;
+                return false;
+            }
+            uint32_t magic;
+            std::memcpy(&magic, magic_bytes, sizeof(magic));
+            if (magic != BYTE_ORDER_MAGIC && magic != swap32(BYTE_ORDER_MAGIC)) {
+                damaged_ = true;
+                return false;
+            }
+            swapped_ = magic != BYTE_ORDER_MAGIC;
+            interfaces_.clear();
+        } else {
+            type = get32(head);
+        }
+
+        uint32_t total = get32(head + 4);
+        size_t consumed = type == BLOCK_SECTION_HEADER ? 12 : 8;
+        if (total < 12 || total % 4 != 0 || total > MAX_BLOCK_SIZE) {
+            damaged_ = true;
+            return false;
+        }
+        body_.resize(total - consumed);
+        if (std::fread(body_.data(), 1, body_.size(), file_) != body_.size()) {
+            damaged_ = true;
+            return false;
+        }
+
+        switch (type) {
+            case BLOCK_SECTION_HEADER:
+                break;
+            case BLOCK_INTERFACE:
+                read_interface(body_);
+                break;
+            case BLOCK_ENHANCED_PACKET: {
+                if (body_.size() < 24) {
+                    damaged_ = true;
+                    return false;
+                }
+                uint32_t interface_id = get32(body_.data());
+                uint64_t units = (static_cast<uint64_t>(get32(body_.data() + 4)) << 32) | get32(body_.data() + 8);
+                uint32_t captured = get32(body_.data() + 12);
+                if (interface_id >= interfaces_.size() || 20 + padded(captured) + 4 > body_.size()) {
+                    damaged_ = true;
+                    return false;
+                }
+                frame.interface_id = interface_id;
+                frame.timestamp_ns = to_nanoseconds(units, interfaces_[interface_id].units_per_second);
+                frame.direction = Direction::UNKNOWN;
+                frame.data.assign(body_.begin() + 20, body_.begin() + 20 + captured);
+
+                size_t option = 20 + padded(captured);
+                while (option + 4 <= body_.size() - 4) {
+                    uint16_t code = get16(body_.data() + option);
+                    uint16_t length = get16(body_.data() + option + 2);
+                    if (code == OPT_END || option + 4 + padded(length) > body_.size() - 4) {
+                        break;
+                    }
+                    if (code == OPT_EPB_FLAGS && length == 4) {
+                        frame.direction = static_cast<Direction>(get32(body_.data() + option + 4) & 0x3);
+                    }
+                    option += 4 + padded(length);
+                }
+                return true;
+            }
+            case BLOCK_SIMPLE_PACKET: {
+                if (body_.size() < 8 || interfaces_.empty()) {
+                    damaged_ = true;
+                    return false;
+                }
+                uint32_t original = get32(body_.data());
+                size_t captured = std::min<size_t>(original, body_.size() - 8);
+                frame.interface_id = 0;
+                frame.timestamp_ns = 0;
+                frame.direction = Direction::UNKNOWN;
+                frame.data.assign(body_.begin() + 4, body_.begin() + 4 + static_cast<std::ptrdiff_t>(captured));
+                return true;
+            }
+            default:
+                break;              // Name resolution, statistics, custom blocks
+        }
+    }
+}
+
+bool CaptureReader::next_pcap(CapturedFrame& frame) {
+    uint8_t record[16];
+    size_t got = std::fread(record, 1, sizeof(record), file_);
+    if (got == 0) {
+        return false;
+    }
+    uint32_t captured = get32(record + 8);
+    if (got != sizeof(record) || captured > MAX_BLOCK_SIZE) {
+        damaged_ = true;
+        return false;
+    }
+    frame.data.resize(captured);
+    if (std::fread(frame.data.data(), 1, captured, file_) != captured) {
+        damaged_ = true;
+        return false;
+    }
+    int64_t per_second = interfaces_.front().units_per_second;
+    frame.interface_id = 0;
+    frame.timestamp_ns = static_cast<int64_t>(get32(record)) * 1000000000LL +
+                         to_nanoseconds(get32(record + 4), per_second);
+    frame.direction = Direction::UNKNOWN;
+    return true;
+}
+
+void CaptureReader::read_interface(const std::vector<uint8_t>& body) {
+    CaptureInterface interface;
+    interface.units_per_second = 1000000;           // pcapng default resolution
+    if (body.size() < 12) {
+        interfaces_.push_back(interface);
+        return;
+    }
+    interface.link_type = get16(body.data());
+
+    size_t option = 8;
+    while (option + 4 <= body.size() - 4) {
+        uint16_t code = get16(body.data() + option);
+        uint16_t length = get16(body.data() + option + 2);
+        if (code == OPT_END || option + 4 + padded(length) > body.size() - 4) {
+            break;
+        }
+        const uint8_t* value = body.data() + option + 4;
+        if (code == OPT_IF_NAME) {
+            interface.name.assign(reinterpret_cast<const char*>(value), length);
+        } else if (code == OPT_IF_MACADDR && length == 6) {
+            std::memcpy(interface.mac.data(), value, 6);
+        } else if (code == OPT_IF_TSRESOL && length == 1) {
+            uint8_t exponent = value[0] & 0x7F;
+            int64_t base = (value[0] & 0x80) ? 2 : 10;
+            int64_t units = 1;
+            for (uint8_t i = 0; i < exponent && units < 1000000000000000000LL / base; ++i) {
+                units *= base;
+            }
+            interface.units_per_second = units;
+        }
+        option += 4 + padded(length);
+    }
+    if (interface.name.empty()) {
+        interface.name = "if" + std::to_string(interfaces_.size());
+    }
+    interfaces_.push_back(interface);
+}
+
+uint16_t CaptureReader::get16(const uint8_t* p) const {
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return swapped_ ? static_cast<uint16_t>((value << 8) | (value >> 8)) : value;
+}
+
+uint32_t CaptureReader::get32(const uint8_t* p) const {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return swapped_ ? swap32(value) : value;
+}
+
+size_t gptp_payload_offset(const uint8_t* frame, size_t length) {
+    size_t offset = 12;
+    while (offset + 2 <= length) {
+        auto ether_type = static_cast<uint16_t>((frame[offset] << 8) | frame[offset + 1]);
+        if (ether_type == ETHERTYPE_GPTP) {
+            return offset + 2;
+        }
+        if (ether_type != ETHERTYPE_VLAN && ether_type != ETHERTYPE_QINQ) {
+            return 0;
+        }
+        offset += 4;
+    }
+    return 0;
+}
+
+} // namespace capture
+} // namespace gptp
@@ -0,0 +1,167 @@
+/**
+ * @file pcapng.hpp
+ * @brief pcapng capture files of gPTP frames with nanosecond timestamps
+ *
+ * The writer emits one Section Header Block, an Interface Description Block
+ * per port (if_tsresol = 9, so timestamps are nanoseconds) and an Enhanced
+ * Packet Block per frame with its direction in epb_flags. Files rotate like
+ * log files (capture.pcapng, capture.pcapng.1, ...); each one repeats the
+ * interface blocks so it opens on its own in Wireshark.
+ *
+ * The reader takes pcapng of either byte order and classic pcap (micro- or
+ * nanosecond), so tcpdump captures from the field can be replayed as well.
+ */
+
+#pragma once
+
+#include "../../include/gptp_types.hpp"
+#include "../../include/gptp_message_parser.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gptp {
+namespace capture {
+
+constexpr uint16_t LINKTYPE_ETHERNET = 1;
+
+/**
+ * @brief Direction of a frame relative to the capturing host (epb_flags bits 0-1)
+ */
+enum class Direction : uint8_t {
+    UNKNOWN = 0,
+    INBOUND = 1,
+    OUTBOUND = 2
+};
+
+struct CaptureInterface {
+    std::string name;
+    std::array<uint8_t, 6> mac{};
+    uint16_t link_type = LINKTYPE_ETHERNET;
+    int64_t units_per_second = 1000000000LL;   // Timestamp resolution
+};
+
+struct CapturedFrame {
+    uint32_t interface_id = 0;
+    int64_t timestamp_ns = 0;
+    Direction direction = Direction::UNKNOWN;
+    std::vector<uint8_t> data;                  // Link-layer frame, Ethernet header first
+};
+
+/**
+ * @brief Appends frames to size-rotated pcapng files
+ *
+ * Thread-safe: sockets of several ports may record concurrently.
+ */
+class PcapngWriter {
+public:
+    struct Options {
+        std::string path = "gptp-capture.pcapng";
+        size_t file_size_bytes = 0;     // Rotate beyond this size, 0 never rotates
+        int max_files = 4;              // Including the active file
+    };
+
+    PcapngWriter();
+    ~PcapngWriter();
+
+    PcapngWriter(const PcapngWriter&) = delete;
+    PcapngWriter& operator=(const PcapngWriter&) = delete;
+
+    Result<bool> open(const Options& options);
+
+    /**
+     * @brief Describe a new interface
+     * @return Interface id used by write()
+     */
+    uint32_t add_interface(const std::string& name, const std::array<uint8_t, 6>& mac);
+
+    /**
+     * @brief Append one link-layer frame
+     * @return false if the writer is closed or the write failed
+     */
+    bool write(uint32_t interface_id, int64_t timestamp_ns, Direction direction,
+               const uint8_t* data, size_t length);
+
+    /**
+     * @brief Append a gPTP packet as an Ethernet frame
+     */
+    bool write(uint32_t interface_id, int64_t timestamp_ns, Direction direction, const GptpPacket& packet);
+
+    void flush();
+    void close();
+
+    bool is_open() const;
+    uint64_t get_frames_written() const;
+
+private:
+    bool open_file();
+    bool write_section_header();
+    bool write_interface(const CaptureInterface& interface);
+    void rotate();
+
+    mutable std::mutex mutex_;
+    Options options_;
+    std::FILE* file_;
+    size_t file_bytes_;
+    std::vector<CaptureInterface> interfaces_;
+    std::vector<uint8_t> block_;
+    uint64_t frames_written_;
+};
+
+/**
+ * @brief Sequential reader of pcapng and classic pcap files
+ */
+class CaptureReader {
+public:
+    CaptureReader();
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    Result<bool> open(const std::string& path);
+    void close();
+
+    /**
+     * @brief Read the next frame; interface blocks are taken in passing
+     * @return false at the end of the file or on a malformed block
+     */
+    bool next(CapturedFrame& frame);
+
+    /**
+     * @brief Interfaces seen so far; pcapng lists them before their frames
+     */
+    const std::vector<CaptureInterface>& interfaces() const { return interfaces_; }
+
+    /**
+     * @brief True if reading stopped at a malformed or truncated block
+     */
+    bool is_damaged() const { return damaged_; }
+
+private:
+    bool next_pcapng(CapturedFrame& frame);
+    bool next_pcap(CapturedFrame& frame);
+    void read_interface(const std::vector<uint8_t>& body);
+    uint16_t get16(const uint8_t* p) const;
+    uint32_t get32(const uint8_t* p) const;
+
+    std::FILE* file_;
+    bool pcapng_;
+    bool swapped_;
+    bool damaged_;
+    std::vector<CaptureInterface> interfaces_;
+    std::vector<uint8_t> body_;
+};
+
+/**
+ * @brief Offset of the gPTP message in an Ethernet frame, skipping 802.1Q tags
+ * @return 0 if the frame does not carry EtherType 0x88F7
+ */
+size_t gptp_payload_offset(const uint8_t* frame, size_t length);
+
+} // namespace capture
+} // namespace gptp
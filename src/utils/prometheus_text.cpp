@@ -0,0 +1,101 @@
+/**
+ * @file prometheus_text.cpp
+ * @brief Writer for the Prometheus text exposition format
+ */
+
+#include "prometheus_text.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+
+namespace gptp {
+
+namespace {
+    void append_escaped(std::string& out, const std::string& value) {
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+void PrometheusWriter::family(const std::string& name, const std::string& type, const std::string& help) {
+    text_ += "# HELP " + name + " " + help + "\n";
+    text_ += "# TYPE " + name + " " + type + "\n";
+}
+
+void PrometheusWriter::series(const std::string& name, const Labels& labels, const std::string& extra_label,
+                              const std::string& extra_value) {
+    text_ += name;
+    if (labels.empty() && extra_label.empty()) {
+        text_ += ' ';
+        return;
+    }
+    text_ += '{';
+    bool first = true;
+    for (const auto& label : labels) {
+        if (!first) {
+            text_ += ',';
+        }
+        first = false;
+        text_ += label.first + "=\"";
+        append_escaped(text_, label.second);
+        text_ += '"';
+    }
+    if (!extra_label.empty()) {
+        if (!first) {
+            text_ += ',';
+        }
+        text_ += extra_label + "=\"" + extra_value + "\"";
+    }
+    text_ += "} ";
+}
+
+void PrometheusWriter::sample(const std::string& name, const Labels& labels, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.12g", value);
+    series(name, labels, "", "");
+    text_ += buffer;
+    text_ += '\n';
+}
+
+void PrometheusWriter::sample(const std::string& name, const Labels& labels, uint64_t value) {
+    series(name, labels, "", "");
+    text_ += std::to_string(value);
+    text_ += '\n';
+}
+
+void PrometheusWriter::sample(const std::string& name, const Labels& labels, int64_t value) {
+    series(name, labels, "", "");
+    text_ += std::to_string(value);
+    text_ += '\n';
+}
+
+void PrometheusWriter::histogram(const std::string& name, const Labels& labels,
+                                 const LatencyHistogram::Snapshot& snapshot) {
+    // Counts derive from the buckets so _count always matches +Inf
+    uint64_t total = 0;
+    size_t index = 0;
+    for (int64_t bound = 64; bound <= LatencyHistogram::MAX_VALUE_NS; bound *= 2) {
+        while (index < LatencyHistogram::BUCKET_COUNT && LatencyHistogram::bucket_upper_bound(index) < bound) {
+            total += snapshot.buckets[index++];
+        }
+        series(name + "_bucket", labels, "le", std::to_string(bound));
+        text_ += std::to_string(total) + "\n";
+    }
+    while (index < LatencyHistogram::BUCKET_COUNT) {
+        total += snapshot.buckets[index++];
+    }
+    series(name + "_bucket", labels, "le", "+Inf");
+    text_ += std::to_string(total) + "\n";
+    sample(name + "_sum", labels, snapshot.sum_ns);
+    sample(name + "_count", labels, total);
+}
+
+} // namespace gptp
@@ -0,0 +1,48 @@
+/**
+ * @file prometheus_text.hpp
+ * @brief Writer for the Prometheus text exposition format
+ */
+
+#pragma once
+
+#include "latency_histogram.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gptp {
+
+class PrometheusWriter {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    /**
+     * @brief Emit HELP/TYPE for a metric family; call once before its samples
+     * @param type "gauge", "counter" or "histogram"
+     */
+    void family(const std::string& name, const std::string& type, const std::string& help);
+
+    void sample(const std::string& name, const Labels& labels, double value);
+    void sample(const std::string& name, const Labels& labels, uint64_t value);
+    void sample(const std::string& name, const Labels& labels, int64_t value);
+
+    /**
+     * @brief Emit cumulative _bucket/_sum/_count series of a histogram
+     *
+     * Buckets are exported at fixed power-of-two bounds (64 ns .. 2^35 ns)
+     * so series stay small and comparable across scrapes.
+     */
+    void histogram(const std::string& name, const Labels& labels, const LatencyHistogram::Snapshot& snapshot);
+
+    const std::string& str() const { return text_; }
+    void clear() { text_.clear(); }
+
+private:
+    void series(const std::string& name, const Labels& labels, const std::string& extra_label,
+                const std::string& extra_value);
+
+    std::string text_;
+};
+
+} // namespace gptp
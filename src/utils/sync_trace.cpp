@@ -0,0 +1,428 @@
+/**
+ * @file sync_trace.cpp
+ * @brief Compact binary trace of per-sample synchronization data
+ */
+
+#include "sync_trace.hpp"
+#include "logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gptp {
+namespace trace {
+
+namespace {
+    constexpr uint8_t TAG_KIND_MASK = 0x03;
+    constexpr uint8_t TAG_KEYFRAME = 0x04;
+    constexpr uint8_t TAG_LOCKED = 0x08;
+
+    uint32_t state_key(uint16_t port_id, SyncSample::Kind kind) {
+        return (static_cast<uint32_t>(port_id) << 8) | static_cast<uint8_t>(kind);
+    }
+
+    int64_t to_ppt(double rate_ratio) {
+        return std::llround((rate_ratio - 1.0) * 1e12);
+    }
+
+    int64_t to_mppb(double ppb) {
+        return std::llround(ppb * 1000.0);
+    }
+
+    uint8_t* put_varint(uint8_t* out, uint64_t value) {
+        while (value >= 0x80) {
+            *out++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    uint8_t* put_signed(uint8_t* out, int64_t value) {
+        // Zigzag: small magnitudes of either sign become small varints
+        return put_varint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    bool get_varint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+            uint8_t byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool get_signed(const uint8_t*& cursor, const uint8_t* end, int64_t& value) {
+        uint64_t raw;
+        if (!get_varint(cursor, end, raw)) {
+            return false;
+        }
+        value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+        return true;
+    }
+}
+
+// ============================================================================
+// SampleEncoder / SampleDecoder
+// ============================================================================
+
+size_t SampleEncoder::encode(const SyncSample& sample, uint8_t* out) {
+    uint8_t* cursor = out;
+    uint32_t key = state_key(sample.port_id, sample.kind);
+
+    auto it = previous_.find(key);
+    bool keyframe = it == previous_.end();
+    State& previous = keyframe ? previous_[key] : it->second;
+
+    uint8_t tag = static_cast<uint8_t>(sample.kind) & TAG_KIND_MASK;
+    if (keyframe) {
+        tag |= TAG_KEYFRAME;
+    }
+    if (sample.servo_locked) {
+        tag |= TAG_LOCKED;
+    }
+    *cursor++ = tag;
+    cursor = put_varint(cursor, sample.port_id);
+
+    cursor = put_signed(cursor, sample.t1_ns - previous.t1);
+    cursor = put_signed(cursor, sample.t2_ns - sample.t1_ns);
+    if (sample.kind == SyncSample::Kind::PDELAY) {
+        cursor = put_signed(cursor, sample.t3_ns - sample.t2_ns);
+        cursor = put_signed(cursor, sample.t4_ns - sample.t3_ns);
+    } else {
+        cursor = put_signed(cursor, sample.offset_ns - previous.offset);
+    }
+    cursor = put_signed(cursor, sample.path_delay_ns - previous.path_delay);
+
+    int64_t rate_ppt = to_ppt(sample.rate_ratio);
+    cursor = put_signed(cursor, rate_ppt - previous.rate_ppt);
+
+    int64_t servo_mppb = to_mppb(sample.servo_ppb);
+    if (sample.kind == SyncSample::Kind::SYNC) {
+        cursor = put_signed(cursor, servo_mppb - previous.servo_mppb);
+    }
+
+    previous.t1 = sample.t1_ns;
+    previous.offset = sample.offset_ns;
+    previous.path_delay = sample.path_delay_ns;
+    previous.rate_ppt = rate_ppt;
+    previous.servo_mppb = servo_mppb;
+
+    return static_cast<size_t>(cursor - out);
+}
+
+bool SampleDecoder::decode(const uint8_t*& cursor, const uint8_t* end, SyncSample& sample) {
+    if (cursor >= end) {
+        return false;
+    }
+
+    const uint8_t* position = cursor;
+    uint8_t tag = *position++;
+    uint8_t kind = tag & TAG_KIND_MASK;
+    if (kind != static_cast<uint8_t>(SyncSample::Kind::SYNC) &&
+        kind != static_cast<uint8_t>(SyncSample::Kind::PDELAY)) {
+        return false;
+    }
+
+    uint64_t port_id;
+    if (!get_varint(position, end, port_id) || port_id > 0xFFFF) {
+        return false;
+    }
+
+    sample = SyncSample();
+    sample.kind = static_cast<SyncSample::Kind>(kind);
+    sample.port_id = static_cast<uint16_t>(port_id);
+    sample.servo_locked = (tag & TAG_LOCKED) != 0;
+
+    uint32_t key = state_key(sample.port_id, sample.kind);
+    if (tag & TAG_KEYFRAME) {
+        previous_[key] = State();
+    }
+    auto it = previous_.find(key);
+    if (it == previous_.end()) {
+        return false; // Delta record without a preceding keyframe
+    }
+    State& previous = it->second;
+
+    int64_t delta = 0;
+    bool ok = get_signed(position, end, delta);
+    sample.t1_ns = previous.t1 + delta;
+    ok = ok && get_signed(position, end, delta);
+    sample.t2_ns = sample.t1_ns + delta;
+
+    int64_t offset = previous.offset;
+    if (sample.kind == SyncSample::Kind::PDELAY) {
+        ok = ok && get_signed(position, end, delta);
+        sample.t3_ns = sample.t2_ns + delta;
+        ok = ok && get_signed(position, end, delta);
+        sample.t4_ns = sample.t3_ns + delta;
+    } else {
+        ok = ok && get_signed(position, end, delta);
+        offset += delta;
+    }
+
+    ok = ok && get_signed(position, end, delta);
+    int64_t path_delay = previous.path_delay + delta;
+    ok = ok && get_signed(position, end, delta);
+    int64_t rate_ppt = previous.rate_ppt + delta;
+
+    int64_t servo_mppb = previous.servo_mppb;
+    if (sample.kind == SyncSample::Kind::SYNC) {
+        ok = ok && get_signed(position, end, delta);
+        servo_mppb += delta;
+    }
+
+    if (!ok) {
+        return false;
+    }
+
+    sample.offset_ns = offset;
+    sample.path_delay_ns = path_delay;
+    sample.rate_ratio = 1.0 + static_cast<double>(rate_ppt) / 1e12;
+    sample.servo_ppb = static_cast<double>(servo_mppb) / 1000.0;
+
+    previous.t1 = sample.t1_ns;
+    previous.offset = offset;
+    previous.path_delay = path_delay;
+    previous.rate_ppt = rate_ppt;
+    previous.servo_mppb = servo_mppb;
+
+    cursor = position;
+    return true;
+}
+
+#ifndef _WIN32
+
+// ============================================================================
+// TraceWriter
+// ============================================================================
+
+TraceWriter::TraceWriter()
+    : fd_(-1)
+    , map_(nullptr)
+    , header_(nullptr)
+    , offset_(0)
+    , records_written_(0)
+    , bytes_written_(0) {
+}
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+Result<bool> TraceWriter::open(const Options& options) {
+    close();
+    options_ = options;
+    if (options_.file_size_bytes < sizeof(TraceFileHeader) + 4096) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+    if (options_.max_files < 1) {
+        options_.max_files = 1;
+    }
+
+    if (!map_segment()) {
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    LOG_INFO("Tracing synchronization samples to {}", options_.path);
+    return Result<bool>::success(true);
+}
+
+bool TraceWriter::write(const SyncSample& sample) {
+    if (!map_) {
+        return false;
+    }
+
+    if (offset_ + SampleEncoder::MAX_RECORD_SIZE > options_.file_size_bytes) {
+        rotate();
+        if (!map_) {
+            return false;
+        }
+    }
+
+    size_t length = encoder_.encode(sample, map_ + offset_);
+    offset_ += length;
+
+    // Readers of a live file trust used_bytes; publish it after the record
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->used_bytes = offset_ - sizeof(TraceFileHeader);
+    header_->record_count++;
+
+    records_written_++;
+    bytes_written_ += length;
+    return true;
+}
+
+void TraceWriter::close() {
+    unmap_segment();
+}
+
+bool TraceWriter::map_segment() {
+    fd_ = ::open(options_.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        LOG_ERROR("Failed to create trace file {}: {}", options_.path, std::strerror(errno));
+        return false;
+    }
+    // Reserve the blocks up front: records are stored through the mapping,
+    // and a store into a sparse page on a full filesystem raises SIGBUS
+    int error = posix_fallocate(fd_, 0, static_cast<off_t>(options_.file_size_bytes));
+    if (error != 0) {
+        LOG_WARN("Cannot reserve {} bytes for trace file {}: {}; tracing disabled", options_.file_size_bytes,
+                 options_.path, std::strerror(error));
+        ::close(fd_);
+        fd_ = -1;
+        ::unlink(options_.path.c_str());
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, options_.file_size_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Failed to map trace file {}: {}", options_.path, std::strerror(errno));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    map_ = static_cast<uint8_t*>(mapping);
+    header_ = reinterpret_cast<TraceFileHeader*>(map_);
+    std::memset(header_, 0, sizeof(TraceFileHeader));
+    std::memcpy(header_->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header_->version = TRACE_VERSION;
+    header_->header_size = sizeof(TraceFileHeader);
+    header_->created_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    offset_ = sizeof(TraceFileHeader);
+    encoder_.reset();
+    return true;
+}
+
+void TraceWriter::unmap_segment() {
+    if (map_) {
+        munmap(map_, options_.file_size_bytes);
+        map_ = nullptr;
+        header_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        // Drop the unused, pre-allocated tail
+        if (ftruncate(fd_, static_cast<off_t>(offset_)) < 0) {
+            LOG_WARN("Failed to trim trace file {}", options_.path);
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void TraceWriter::rotate() {
+    unmap_segment();
+
+    const std::string& path = options_.path;
+    if (options_.max_files > 1) {
+        std::remove((path + "." + std::to_string(options_.max_files - 1)).c_str());
+        for (int index = options_.max_files - 2; index >= 1; --index) {
+            std::rename((path + "." + std::to_string(index)).c_str(),
+                        (path + "." + std::to_string(index + 1)).c_str());
+        }
+        std::rename(path.c_str(), (path + ".1").c_str());
+    }
+
+    map_segment();
+}
+
+// ============================================================================
+// TraceReader
+// ============================================================================
+
+TraceReader::TraceReader()
+    : fd_(-1)
+    , map_(nullptr)
+    , map_size_(0)
+    , header_(nullptr)
+    , cursor_(nullptr)
+    , end_(nullptr) {
+}
+
+TraceReader::~TraceReader() {
+    close();
+}
+
+Result<bool> TraceReader::open(const std::string& path) {
+    close();
+
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        return Result<bool>::error(ErrorCode::INTERFACE_NOT_FOUND);
+    }
+
+    struct stat info{};
+    if (fstat(fd_, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(TraceFileHeader)) {
+        close();
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    map_size_ = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        map_size_ = 0;
+        close();
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    map_ = static_cast<const uint8_t*>(mapping);
+    madvise(const_cast<uint8_t*>(map_), map_size_, MADV_SEQUENTIAL);
+
+    header_ = reinterpret_cast<const TraceFileHeader*>(map_);
+    if (std::memcmp(header_->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        header_->version != TRACE_VERSION || header_->header_size < sizeof(TraceFileHeader) ||
+        header_->header_size > map_size_) {
+        close();
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    // Header fields are untrusted (torn or truncated file): records never
+    // extend past the mapping, and next() hands the decoder only the bytes
+    // that remain, so a corrupt record ends the stream instead of overrunning
+    size_t header_size = header_->header_size;
+    size_t available = map_size_ - header_size;
+    size_t used = static_cast<size_t>(std::min<uint64_t>(header_->used_bytes, available));
+    cursor_ = map_ + header_size;
+    end_ = cursor_ + used;
+    decoder_.reset();
+    return Result<bool>::success(true);
+}
+
+void TraceReader::close() {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), map_size_);
+        map_ = nullptr;
+        header_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    cursor_ = end_ = nullptr;
+}
+
+bool TraceReader::next(SyncSample& sample) {
+    if (!cursor_ || cursor_ >= end_) {
+        return false;
+    }
+    return decoder_.decode(cursor_, end_, sample);
+}
+
+#endif // !_WIN32
+
+} // namespace trace
+} // namespace gptp
@@ -0,0 +1,191 @@
+/**
+ * @file sync_trace.hpp
+ * @brief Compact binary trace of per-sample synchronization data
+ *
+ * Samples are delta encoded against the previous sample of the same port
+ * and kind and stored as zigzag varints, typically 12-20 bytes per sample.
+ * Trace files are memory-mapped, pre-sized segments that rotate like log
+ * files (trace.bin, trace.bin.1, ...). Every file starts with a keyframe
+ * per port so each one decodes on its own.
+ */
+
+#pragma once
+
+#include "../../include/gptp_types.hpp"
+#include "../../include/sync_sample.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace gptp {
+namespace trace {
+
+constexpr char TRACE_MAGIC[8] = {'G', 'P', 'T', 'P', 'T', 'R', 'C', '1'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+/**
+ * @brief Header at offset 0 of every trace file
+ */
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    int64_t created_unix_ns;
+    uint64_t used_bytes;        // Record bytes following the header
+    uint64_t record_count;
+    uint8_t reserved[24];
+};
+static_assert(sizeof(TraceFileHeader) == 64, "trace header layout");
+
+/**
+ * @brief Delta/varint encoder for SyncSample records
+ *
+ * Record layout: tag byte (kind, keyframe and locked flags), port id, then
+ * zigzag varints of t1 delta, t2-t1, [t3-t2, t4-t3], [offset delta],
+ * path delay delta, rate ratio delta in parts per trillion and
+ * [servo output delta in milli-ppb]. Bracketed fields depend on the kind.
+ */
+class SampleEncoder {
+public:
+    static constexpr size_t MAX_RECORD_SIZE = 2 + 3 + 8 * 10;
+
+    /**
+     * @brief Encode a sample
+     * @param out Buffer of at least MAX_RECORD_SIZE bytes
+     * @return Number of bytes written
+     */
+    size_t encode(const SyncSample& sample, uint8_t* out);
+
+    /**
+     * @brief Forget all history; the next sample of every port is a keyframe
+     */
+    void reset() { previous_.clear(); }
+
+private:
+    struct State {
+        int64_t t1 = 0;
+        int64_t offset = 0;
+        int64_t path_delay = 0;
+        int64_t rate_ppt = 0;
+        int64_t servo_mppb = 0;
+    };
+
+    std::unordered_map<uint32_t, State> previous_;
+};
+
+/**
+ * @brief Decoder matching SampleEncoder
+ */
+class SampleDecoder {
+public:
+    /**
+     * @brief Decode one record and advance the cursor
+     * @return false at the end of data or on a malformed record
+     */
+    bool decode(const uint8_t*& cursor, const uint8_t* end, SyncSample& sample);
+
+    void reset() { previous_.clear(); }
+
+private:
+    struct State {
+        int64_t t1 = 0;
+        int64_t offset = 0;
+        int64_t path_delay = 0;
+        int64_t rate_ppt = 0;
+        int64_t servo_mppb = 0;
+    };
+
+    std::unordered_map<uint32_t, State> previous_;
+};
+
+#ifndef _WIN32
+
+/**
+ * @brief Appends samples to memory-mapped, size-rotated trace files
+ *
+ * Not thread-safe; the pipeline writes from its event loop thread.
+ */
+class TraceWriter {
+public:
+    struct Options {
+        std::string path = "gptp-trace.bin";
+        size_t file_size_bytes = 16 * 1024 * 1024;
+        int max_files = 8;      // Including the active file
+    };
+
+    TraceWriter();
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    Result<bool> open(const Options& options);
+
+    /**
+     * @brief Append one sample
+     * @return false if the writer is not open or a new segment failed
+     */
+    bool write(const SyncSample& sample);
+
+    /**
+     * @brief Trim the active file to its used size and unmap it
+     */
+    void close();
+
+    bool is_open() const { return map_ != nullptr; }
+    uint64_t get_records_written() const { return records_written_; }
+    uint64_t get_bytes_written() const { return bytes_written_; }
+
+private:
+    bool map_segment();
+    void unmap_segment();
+    void rotate();
+
+    Options options_;
+    int fd_;
+    uint8_t* map_;
+    TraceFileHeader* header_;
+    size_t offset_;
+    SampleEncoder encoder_;
+    uint64_t records_written_;
+    uint64_t bytes_written_;
+};
+
+/**
+ * @brief Sequential reader over one memory-mapped trace file
+ */
+class TraceReader {
+public:
+    TraceReader();
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    Result<bool> open(const std::string& path);
+    void close();
+
+    /**
+     * @brief Decode the next sample
+     * @return false at the end of the file
+     */
+    bool next(SyncSample& sample);
+
+    const TraceFileHeader* header() const { return header_; }
+
+private:
+    int fd_;
+    const uint8_t* map_;
+    size_t map_size_;
+    const TraceFileHeader* header_;
+    const uint8_t* cursor_;
+    const uint8_t* end_;
+    SampleDecoder decoder_;
+};
+
+#endif // !_WIN32
+
+} // namespace trace
+} // namespace gptp
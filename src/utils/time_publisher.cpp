@@ -0,0 +1,140 @@
+/**
+ * @file time_publisher.cpp
+ * @brief Writer side of the shared memory time segment
+ */
+
+#include "time_publisher.hpp"
+#include "logger.hpp"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+
+namespace gptp {
+
+// ============================================================================
+// TimePublisher Implementation
+// ============================================================================
+
+TimePublisher::TimePublisher()
+    : segment_(nullptr)
+    , update_count_(0) {
+}
+
+TimePublisher::~TimePublisher() {
+    close();
+}
+
+Result<bool> TimePublisher::open(const std::string& name) {
+    close();
+    if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos) {
+        return Result<bool>::error(ErrorCode::INVALID_PARAMETER);
+    }
+
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create shared memory {}: {}", name, std::strerror(errno));
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    ::fchmod(fd, 0644); // Readable by unprivileged clients regardless of umask
+    if (::ftruncate(fd, sizeof(shm::TimeSegment)) < 0) {
+        LOG_ERROR("Failed to size shared memory {}: {}", name, std::strerror(errno));
+        ::close(fd);
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+    void* mapping = ::mmap(nullptr, sizeof(shm::TimeSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Failed to map shared memory {}: {}", name, std::strerror(errno));
+        return Result<bool>::error(ErrorCode::INITIALIZATION_FAILED);
+    }
+
+    // Readers that survived a previous daemon keep their mapping; the
+    // sequence continues so they see the new data as an update
+    name_ = name;
+    segment_ = static_cast<shm::TimeSegment*>(mapping);
+    uint32_t sequence = segment_->sequence.load(std::memory_order_relaxed) & ~1u;
+    segment_->sequence.store(sequence, std::memory_order_relaxed);
+    segment_->magic = shm::TIME_MAGIC;
+    segment_->version = shm::TIME_VERSION;
+    segment_->data_size = sizeof(shm::TimeData);
+
+    shm::TimeData invalid{};
+    invalid.rate_ratio = 1.0;
+    invalid.phc_index = -1;
+    shm::write_segment(*segment_, invalid);
+
+    LOG_INFO("Publishing gPTP time in shared memory {}", name_);
+    return Result<bool>::success(true);
+}
+
+void TimePublisher::publish(const shm::TimeData& data) {
+    if (!segment_) {
+        return;
+    }
+    shm::TimeData published = data;
+    published.flags |= shm::TIME_VALID;
+    published.update_count = ++update_count_;
+    shm::write_segment(*segment_, published);
+}
+
+void TimePublisher::close() {
+    if (!segment_) {
+        return;
+    }
+    shm::TimeData invalid{};
+    invalid.rate_ratio = 1.0;
+    invalid.phc_index = -1;
+    shm::write_segment(*segment_, invalid);
+
+    ::munmap(segment_, sizeof(shm::TimeSegment));
+    ::shm_unlink(name_.c_str());
+    segment_ = nullptr;
+}
+
+// ============================================================================
+// TimeRateEstimator Implementation
+// ============================================================================
+
+TimeRateEstimator::TimeRateEstimator(int64_t min_baseline_ns)
+    : min_baseline_ns_(min_baseline_ns)
+    , anchor_valid_(false)
+    , anchor_monotonic_ns_(0)
+    , anchor_gptp_ns_(0)
+    , rate_ratio_(1.0) {
+}
+
+double TimeRateEstimator::update(int64_t monotonic_ns, int64_t gptp_ns) {
+    if (!anchor_valid_) {
+        anchor_valid_ = true;
+        anchor_monotonic_ns_ = monotonic_ns;
+        anchor_gptp_ns_ = gptp_ns;
+        return rate_ratio_;
+    }
+
+    int64_t baseline = monotonic_ns - anchor_monotonic_ns_;
+    if (baseline < min_baseline_ns_) {
+        return rate_ratio_;
+    }
+
+    double ratio = static_cast<double>(gptp_ns - anchor_gptp_ns_) / static_cast<double>(baseline);
+    if (ratio < 0.999 || ratio > 1.001) {
+        // More than 1000 ppm apart: a step happened, start over
+        reset();
+        return update(monotonic_ns, gptp_ns);
+    }
+    rate_ratio_ = ratio;
+    anchor_monotonic_ns_ = monotonic_ns;
+    anchor_gptp_ns_ = gptp_ns;
+    return rate_ratio_;
+}
+
+void TimeRateEstimator::reset() {
+    anchor_valid_ = false;
+    rate_ratio_ = 1.0;
+}
+
+} // namespace gptp
+
+#endif // _WIN32
@@ -0,0 +1,91 @@
+/**
+ * @file time_publisher.hpp
+ * @brief Writer side of the shared memory time segment
+ *
+ * See gptp_time_client.hpp for the layout and the reader.
+ */
+
+#pragma once
+
+#include "../../include/gptp_types.hpp"
+#include "../../include/gptp_time_client.hpp"
+
+#include <string>
+
+#ifndef _WIN32
+
+namespace gptp {
+
+/**
+ * @brief Owns the POSIX shared memory segment and publishes into it
+ *
+ * Single writer; not thread-safe. Readers in other processes never block it.
+ */
+class TimePublisher {
+public:
+    TimePublisher();
+    ~TimePublisher();
+
+    TimePublisher(const TimePublisher&) = delete;
+    TimePublisher& operator=(const TimePublisher&) = delete;
+
+    /**
+     * @brief Create (or take over) and map the segment
+     * @param name POSIX shared memory name, e.g. "/gptp-time"
+     * @return Result indicating success or error
+     */
+    Result<bool> open(const std::string& name);
+
+    /**
+     * @brief Publish a new state; TIME_VALID is set and update_count advanced
+     */
+    void publish(const shm::TimeData& data);
+
+    /**
+     * @brief Mark the segment invalid, unmap and unlink it
+     */
+    void close();
+
+    bool is_open() const { return segment_ != nullptr; }
+    uint64_t get_update_count() const { return update_count_; }
+
+private:
+    std::string name_;
+    shm::TimeSegment* segment_;
+    uint64_t update_count_;
+};
+
+/**
+ * @brief Estimates d(gPTP time)/d(CLOCK_MONOTONIC) from successive references
+ *
+ * Each estimate spans at least the configured baseline so cross-timestamp
+ * jitter of a microsecond stays in the low ppb range.
+ */
+class TimeRateEstimator {
+public:
+    explicit TimeRateEstimator(int64_t min_baseline_ns = 4000000000LL);
+
+    /**
+     * @brief Add a (monotonic, gPTP) reference pair
+     * @return Current rate ratio estimate (1.0 until the first baseline elapsed)
+     */
+    double update(int64_t monotonic_ns, int64_t gptp_ns);
+
+    /**
+     * @brief Forget the history, e.g. after the clock was stepped
+     */
+    void reset();
+
+    double get_rate_ratio() const { return rate_ratio_; }
+
+private:
+    int64_t min_baseline_ns_;
+    bool anchor_valid_;
+    int64_t anchor_monotonic_ns_;
+    int64_t anchor_gptp_ns_;
+    double rate_ratio_;
+};
+
+} // namespace gptp
+
+#endif // _WIN32
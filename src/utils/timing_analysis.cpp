@@ -0,0 +1,240 @@
+/**
+ * @file timing_analysis.cpp
+ * @brief MTIE, TDEV and Allan deviation over time error series
+ */
+
+#include "timing_analysis.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+namespace gptp {
+namespace analysis {
+
+namespace {
+    // Output positions per task; sized so a task's input stays in L2
+    constexpr size_t BLOCK_SIZE = 32 * 1024;
+
+    struct Task {
+        size_t window_index;
+        size_t begin;
+        size_t end;
+    };
+
+    /**
+     * Split [0, count(window)) of every window into blocks of at least the
+     * window length, so priming a block never costs more than the block.
+     */
+    std::vector<Task> make_tasks(const std::vector<size_t>& windows,
+                                 const std::function<size_t(size_t)>& count) {
+        std::vector<Task> tasks;
+        for (size_t w = 0; w < windows.size(); ++w) {
+            size_t total = count(windows[w]);
+            size_t block = std::max(BLOCK_SIZE, windows[w]);
+            for (size_t begin = 0; begin < total; begin += block) {
+                tasks.push_back({w, begin, std::min(total, begin + block)});
+            }
+        }
+        return tasks;
+    }
+
+    void run_tasks(unsigned threads, size_t task_count, const std::function<void(size_t)>& work) {
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t task = next.fetch_add(1); task < task_count; task = next.fetch_add(1)) {
+                work(task);
+            }
+        };
+
+        unsigned spawned = static_cast<unsigned>(std::min<size_t>(threads, task_count));
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < spawned; ++i) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Largest max - min over windows [k, k + length) for k in [begin, end),
+     * using monotonic index queues (each index enters and leaves once).
+     */
+    double max_range(const double* x, size_t length, size_t begin, size_t end) {
+        std::vector<size_t> max_queue;
+        std::vector<size_t> min_queue;
+        max_queue.reserve(end - begin + length);
+        min_queue.reserve(end - begin + length);
+        size_t max_head = 0;
+        size_t min_head = 0;
+
+        double result = 0.0;
+        for (size_t i = begin; i < end + length - 1; ++i) {
+            while (max_queue.size() > max_head && x[max_queue.back()] <= x[i]) {
+                max_queue.pop_back();
+            }
+            max_queue.push_back(i);
+            while (min_queue.size() > min_head && x[min_queue.back()] >= x[i]) {
+                min_queue.pop_back();
+            }
+            min_queue.push_back(i);
+
+            if (i + 1 < begin + length) {
+                continue; // First window not complete yet
+            }
+            size_t window_start = i + 1 - length;
+            while (max_queue[max_head] < window_start) {
+                max_head++;
+            }
+            while (min_queue[min_head] < window_start) {
+                min_head++;
+            }
+            result = std::max(result, x[max_queue[max_head]] - x[min_queue[min_head]]);
+        }
+        return result;
+    }
+
+    double second_difference(const double* x, size_t i, size_t n) {
+        return x[i + 2 * n] - 2.0 * x[i + n] + x[i];
+    }
+}
+
+TimingAnalyzer::TimingAnalyzer(unsigned threads)
+    : threads_(threads) {
+    if (threads_ == 0) {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<StabilityPoint> TimingAnalyzer::mtie(const std::vector<double>& x_ns, double tau0_s,
+                                                 const std::vector<size_t>& windows) const {
+    const size_t N = x_ns.size();
+    std::vector<size_t> valid;
+    for (size_t n : windows) {
+        if (n >= 1 && n < N) {
+            valid.push_back(n);
+        }
+    }
+
+    auto tasks = make_tasks(valid, [N](size_t n) { return N - n; });
+    std::vector<double> partial(tasks.size(), 0.0);
+    run_tasks(threads_, tasks.size(), [&](size_t t) {
+        const Task& task = tasks[t];
+        partial[t] = max_range(x_ns.data(), valid[task.window_index] + 1, task.begin, task.end);
+    });
+
+    std::vector<StabilityPoint> points(valid.size());
+    for (size_t w = 0; w < valid.size(); ++w) {
+        points[w].window = valid[w];
+        points[w].tau_s = static_cast<double>(valid[w]) * tau0_s;
+    }
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        auto& point = points[tasks[t].window_index];
+        point.value = std::max(point.value, partial[t]);
+    }
+    return points;
+}
+
+std::vector<StabilityPoint> TimingAnalyzer::tdev(const std::vector<double>& x_ns, double tau0_s,
+                                                 const std::vector<size_t>& windows) const {
+    const size_t N = x_ns.size();
+    std::vector<size_t> valid;
+    for (size_t n : windows) {
+        if (n >= 1 && 3 * n <= N) {
+            valid.push_back(n);
+        }
+    }
+
+    // TVAR(n) = sum_j [sum_{i=j}^{j+n-1} d(i)]^2 / (6 n^2 (N - 3n + 1))
+    auto tasks = make_tasks(valid, [N](size_t n) { return N - 3 * n + 1; });
+    std::vector<double> partial(tasks.size(), 0.0);
+    run_tasks(threads_, tasks.size(), [&](size_t t) {
+        const Task& task = tasks[t];
+        const size_t n = valid[task.window_index];
+        const double* x = x_ns.data();
+
+        double inner = 0.0;
+        for (size_t i = task.begin; i < task.begin + n; ++i) {
+            inner += second_difference(x, i, n);
+        }
+        double sum = inner * inner;
+        for (size_t j = task.begin + 1; j < task.end; ++j) {
+            inner += second_difference(x, j + n - 1, n) - second_difference(x, j - 1, n);
+            sum += inner * inner;
+        }
+        partial[t] = sum;
+    });
+
+    std::vector<StabilityPoint> points(valid.size());
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        points[tasks[t].window_index].value += partial[t];
+    }
+    for (size_t w = 0; w < valid.size(); ++w) {
+        double n = static_cast<double>(valid[w]);
+        double terms = static_cast<double>(N - 3 * valid[w] + 1);
+        points[w].window = valid[w];
+        points[w].tau_s = n * tau0_s;
+        points[w].value = std::sqrt(points[w].value / (6.0 * n * n * terms));
+    }
+    return points;
+}
+
+std::vector<StabilityPoint> TimingAnalyzer::adev(const std::vector<double>& x_ns, double tau0_s,
+                                                 const std::vector<size_t>& windows) const {
+    const size_t N = x_ns.size();
+    std::vector<size_t> valid;
+    for (size_t n : windows) {
+        if (n >= 1 && 2 * n < N) {
+            valid.push_back(n);
+        }
+    }
+
+    // AVAR(tau) = sum_i d(i)^2 / (2 tau^2 (N - 2n)), x in seconds
+    auto tasks = make_tasks(valid, [N](size_t n) { return N - 2 * n; });
+    std::vector<double> partial(tasks.size(), 0.0);
+    run_tasks(threads_, tasks.size(), [&](size_t t) {
+        const Task& task = tasks[t];
+        const size_t n = valid[task.window_index];
+        double sum = 0.0;
+        for (size_t i = task.begin; i < task.end; ++i) {
+            double d = second_difference(x_ns.data(), i, n);
+            sum += d * d;
+        }
+        partial[t] = sum;
+    });
+
+    std::vector<StabilityPoint> points(valid.size());
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        points[tasks[t].window_index].value += partial[t];
+    }
+    for (size_t w = 0; w < valid.size(); ++w) {
+        double tau = static_cast<double>(valid[w]) * tau0_s;
+        double terms = static_cast<double>(N - 2 * valid[w]);
+        points[w].window = valid[w];
+        points[w].tau_s = tau;
+        points[w].value = tau > 0.0 ? std::sqrt(points[w].value / (2.0 * terms)) / (tau * 1e9) : 0.0;
+    }
+    return points;
+}
+
+std::vector<size_t> TimingAnalyzer::log_windows(size_t max_window) {
+    std::vector<size_t> windows;
+    for (size_t decade = 1; decade <= max_window; decade *= 10) {
+        for (size_t step : {1, 2, 5}) {
+            if (decade * step <= max_window) {
+                windows.push_back(decade * step);
+            }
+        }
+        if (decade > max_window / 10) {
+            break;
+        }
+    }
+    return windows;
+}
+
+} // namespace analysis
+} // namespace gptp
@@ -0,0 +1,69 @@
+/**
+ * @file timing_analysis.hpp
+ * @brief MTIE, TDEV and Allan deviation over time error series
+ *
+ * Definitions follow ITU-T G.810 for uniformly sampled time error x(i)
+ * with sampling interval tau0. Every statistic is evaluated for a list of
+ * observation windows n (tau = n * tau0); the work for each window is
+ * split into blocks that run in parallel on a pool of threads.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace gptp {
+namespace analysis {
+
+/**
+ * @brief One point of a stability curve
+ */
+struct StabilityPoint {
+    size_t window = 0;          // Observation window in samples
+    double tau_s = 0.0;         // Observation interval in seconds
+    double value = 0.0;         // ns for MTIE/TDEV, dimensionless for ADEV
+};
+
+/**
+ * @brief Parallel evaluator for the stability statistics
+ */
+class TimingAnalyzer {
+public:
+    /**
+     * @param threads Worker count, 0 uses all hardware threads
+     */
+    explicit TimingAnalyzer(unsigned threads = 0);
+
+    /**
+     * @brief Maximum time interval error, max(x) - min(x) over any window
+     *        of n + 1 consecutive samples
+     */
+    std::vector<StabilityPoint> mtie(const std::vector<double>& x_ns, double tau0_s,
+                                     const std::vector<size_t>& windows) const;
+
+    /**
+     * @brief Time deviation from the second difference of x, in ns
+     */
+    std::vector<StabilityPoint> tdev(const std::vector<double>& x_ns, double tau0_s,
+                                     const std::vector<size_t>& windows) const;
+
+    /**
+     * @brief Overlapping Allan deviation of the fractional frequency
+     */
+    std::vector<StabilityPoint> adev(const std::vector<double>& x_ns, double tau0_s,
+                                     const std::vector<size_t>& windows) const;
+
+    /**
+     * @brief Windows at 1, 2, 5 x 10^k samples up to max_window
+     */
+    static std::vector<size_t> log_windows(size_t max_window);
+
+    unsigned get_thread_count() const { return threads_; }
+
+private:
+    unsigned threads_;
+};
+
+} // namespace analysis
+} // namespace gptp
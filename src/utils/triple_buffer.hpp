@@ -0,0 +1,61 @@
+/**
+ * @file triple_buffer.hpp
+ * @brief Lock-free single-producer/single-consumer latest-value exchange
+ *
+ * The producer fills write_buffer() and calls publish(); the consumer
+ * calls read() and always gets the most recently published complete
+ * value. Neither side ever waits for the other.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace gptp {
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : middle_(1)
+        , back_(0)
+        , front_(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Buffer owned by the producer; may hold an older value
+     */
+    T& write_buffer() { return buffers_[back_]; }
+
+    /**
+     * @brief Hand the write buffer to the consumer
+     */
+    void publish() {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * @brief Latest published value (the initial value before any publish)
+     */
+    const T& read() {
+        if (middle_.load(std::memory_order_relaxed) & FRESH) {
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return buffers_[front_];
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t FRESH = 0x04;
+
+    std::array<T, 3> buffers_;
+    std::atomic<uint8_t> middle_;   // Index of the exchanged buffer plus FRESH flag
+    uint8_t back_;                  // Producer only
+    uint8_t front_;                 // Consumer only
+};
+
+} // namespace gptp
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "platform/adapter_latency.hpp"
+#include "utils/configuration.hpp"
+
+using namespace gptp;
+
+TEST(AdapterLatencyTest, BuiltinEntriesSkippedWhileDriverCompensates) {
+    AdapterLatencyTable table = AdapterLatencyTable::with_defaults();
+
+    std::string applied_by;
+    PhyLatency latency = table.lookup("eth0", "I210", "igb", 1000, &applied_by);
+    EXPECT_TRUE(latency.is_zero());
+    EXPECT_EQ(applied_by, "igb");
+
+    // Same controller under a driver that leaves the timestamps raw
+    latency = table.lookup("eth0", "I210", "vfio-user", 1000, &applied_by);
+    EXPECT_EQ(latency.ingress_ns, 448);
+    EXPECT_EQ(latency.egress_ns, 178);
+    EXPECT_TRUE(applied_by.empty());
+
+    latency = table.lookup("eth1", "I226", "other", 2500);
+    EXPECT_EQ(latency.ingress_ns, 1485);
+    EXPECT_EQ(latency.egress_ns, 1325);
+}
+
+TEST(AdapterLatencyTest, OverridesPreferInterfaceAndExactSpeed) {
+    AdapterLatencyTable table = AdapterLatencyTable::with_defaults();
+    table.set("I219", AdapterLatencyTable::ANY_SPEED, PhyLatency{500, 120});
+    table.set("I219", 100, PhyLatency{2000, 900});
+    table.set("eth2", AdapterLatencyTable::ANY_SPEED, PhyLatency{30, 10});
+
+    PhyLatency latency = table.lookup("eth0", "I219", "e1000e", 1000);
+    EXPECT_EQ(latency.ingress_ns, 500);
+    EXPECT_EQ(latency.egress_ns, 120);
+
+    latency = table.lookup("eth0", "I219", "e1000e", 100);
+    EXPECT_EQ(latency.ingress_ns, 2000);
+
+    latency = table.lookup("eth2", "I219", "e1000e", 100);
+    EXPECT_EQ(latency.ingress_ns, 30);
+    EXPECT_EQ(latency.egress_ns, 10);
+
+    // Configured residuals apply even under a compensating driver
+    table.set("I210", 1000, PhyLatency{12, 8});
+    latency = table.lookup("eth3", "I210", "igb", 1000);
+    EXPECT_EQ(latency.ingress_ns, 12);
+
+    EXPECT_TRUE(table.lookup("eth4", "", "", 1000).is_zero());
+}
+
+TEST(AdapterLatencyTest, ParsesConfiguredOverrides) {
+    Configuration::LatencyOverride latency;
+    ASSERT_TRUE(Configuration::parse_latency_override("igb@1000", "448,-178", latency));
+    EXPECT_EQ(latency.name, "igb");
+    EXPECT_EQ(latency.speed_mbps, 1000u);
+    EXPECT_EQ(latency.ingress_ns, 448);
+    EXPECT_EQ(latency.egress_ns, -178);
+
+    ASSERT_TRUE(Configuration::parse_latency_override("eth0", "10,20", latency));
+    EXPECT_EQ(latency.name, "eth0");
+    EXPECT_EQ(latency.speed_mbps, AdapterLatencyTable::ANY_SPEED);
+
+    EXPECT_FALSE(Configuration::parse_latency_override("igb@", "1,2", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb@1000x", "1,2", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb@-1", "1,2", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb@0", "1,2", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("@1000", "1,2", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb", "12", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb", "12,abc", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb", "12ns,3", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb", ",3", latency));
+    EXPECT_FALSE(Configuration::parse_latency_override("igb", "99999999999999999999,3", latency));
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "clock_source.hpp"
+#include "platform/tsc_clock_source.hpp"
+#include "utils/logger.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+using namespace gptp;
+
+namespace {
+    int64_t kernel_ns(clockid_t clock_id) {
+        struct timespec ts{};
+        clock_gettime(clock_id, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+    }
+
+    class FixedClockSource : public IClockSource {
+    public:
+        int64_t now_realtime_ns() override { return 42; }
+        int64_t now_monotonic_ns() override { return 7; }
+        std::string get_name() const override { return "fixed"; }
+    };
+}
+
+TEST(ClockSourceTest, ProcessSourceCanBeReplacedAndRestored) {
+    EXPECT_EQ(get_clock_source().get_name(), "system");
+    EXPECT_LE(std::llabs(get_clock_source().now_realtime_ns() - kernel_ns(CLOCK_REALTIME)), 1000000);
+
+    FixedClockSource fixed;
+    set_clock_source(&fixed);
+    EXPECT_EQ(get_clock_source().now_realtime_ns(), 42);
+    EXPECT_EQ(get_clock_source().now_monotonic_ns(), 7);
+
+    set_clock_source(nullptr);
+    EXPECT_EQ(get_clock_source().get_name(), "system");
+}
+
+#if defined(__x86_64__)
+TEST(ClockSourceTest, TscTracksKernelClocks) {
+    Logger::instance().set_level(LogLevel::ERROR);
+    auto tsc = TscClockSource::create();
+    if (!tsc) {
+        GTEST_SKIP() << "No invariant TSC";
+    }
+    EXPECT_GT(tsc->get_frequency_hz(), 1e8);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    tsc->recalibrate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Extrapolated 20 ms past the anchor; generous bounds for loaded CI hosts
+    EXPECT_LE(std::llabs(tsc->now_monotonic_ns() - kernel_ns(CLOCK_MONOTONIC)), 50000);
+    EXPECT_LE(std::llabs(tsc->now_realtime_ns() - kernel_ns(CLOCK_REALTIME)), 50000);
+
+    int64_t previous = tsc->now_monotonic_ns();
+    for (int i = 0; i < 1000; ++i) {
+        int64_t now = tsc->now_monotonic_ns();
+        EXPECT_GE(now, previous);
+        previous = now;
+    }
+}
+
+TEST(ClockSourceTest, TscStaysMonotonicAcrossRecalibration) {
+    Logger::instance().set_level(LogLevel::ERROR);
+    auto tsc = TscClockSource::create();
+    if (!tsc) {
+        GTEST_SKIP() << "No invariant TSC";
+    }
+
+    int64_t previous_monotonic = tsc->now_monotonic_ns();
+    int64_t previous_realtime = tsc->now_realtime_ns();
+    for (int round = 0; round < 20; ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        tsc->recalibrate();
+        for (int i = 0; i < 100; ++i) {
+            int64_t monotonic = tsc->now_monotonic_ns();
+            int64_t realtime = tsc->now_realtime_ns();
+            ASSERT_GE(monotonic, previous_monotonic) << "round " << round;
+            ASSERT_GE(realtime, previous_realtime) << "round " << round;
+            previous_monotonic = monotonic;
+            previous_realtime = realtime;
+        }
+    }
+
+    // Slewing still converges on the kernel clocks
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    tsc->recalibrate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_LE(std::llabs(tsc->now_monotonic_ns() - kernel_ns(CLOCK_MONOTONIC)), 50000);
+}
+#endif
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "utils/latency_histogram.hpp"
+#include <thread>
+#include <vector>
+
+using namespace gptp;
+
+TEST(LatencyHistogramTest, BucketsCoverRangeWithBoundedError) {
+    size_t previous_index = 0;
+    for (int64_t value = 0; value < (int64_t{1} << 20); value += 1 + value / 64) {
+        size_t index = LatencyHistogram::bucket_index(value);
+        ASSERT_LT(index, LatencyHistogram::BUCKET_COUNT);
+        EXPECT_GE(index, previous_index);
+        previous_index = index;
+
+        int64_t upper = LatencyHistogram::bucket_upper_bound(index);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / 32 + 1);
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_index(LatencyHistogram::MAX_VALUE_NS), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(LatencyHistogramTest, ReportsPercentilesAndExtremes) {
+    LatencyHistogram histogram;
+    for (int64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value * 1000);
+    }
+    histogram.record(-5);
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1001u);
+    EXPECT_EQ(snapshot.min_ns, 0);
+    EXPECT_EQ(snapshot.max_ns, 1000000);
+    EXPECT_NEAR(static_cast<double>(snapshot.value_at_percentile(50.0)), 500000.0, 500000.0 * 0.04);
+    EXPECT_NEAR(static_cast<double>(snapshot.value_at_percentile(99.0)), 990000.0, 990000.0 * 0.04);
+    EXPECT_EQ(snapshot.value_at_percentile(100.0), 1000000);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.snapshot().count, 0u);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordingLosesNothing) {
+    LatencyHistogram histogram;
+    constexpr int THREADS = 4;
+    constexpr int RECORDS = 20000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            for (int i = 0; i < RECORDS; ++i) {
+                histogram.record(100 * (t + 1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, static_cast<uint64_t>(THREADS * RECORDS));
+    uint64_t bucket_total = 0;
+    for (uint64_t bucket : snapshot.buckets) {
+        bucket_total += bucket;
+    }
+    EXPECT_EQ(bucket_total, snapshot.count);
+    EXPECT_EQ(snapshot.min_ns, 100);
+    EXPECT_EQ(snapshot.max_ns, 400);
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "utils/logger.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gptp;
+
+namespace {
+    std::vector<std::string> read_lines(const std::string& path) {
+        std::vector<std::string> lines;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    bool file_exists(const std::string& path) {
+        std::ifstream file(path);
+        return file.good();
+    }
+}
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = "/tmp/gptp_logger_test_" + std::to_string(
+            std::hash<std::thread::id>()(std::this_thread::get_id())) + ".log";
+        remove_files();
+        Logger::instance().set_level(LogLevel::INFO);
+    }
+
+    void TearDown() override {
+        Logger::instance().stop_async();
+        Logger::instance().set_level(LogLevel::ERROR);
+        remove_files();
+    }
+
+    void remove_files() {
+        std::remove(path_.c_str());
+        for (int i = 1; i < 8; ++i) {
+            std::remove((path_ + "." + std::to_string(i)).c_str());
+        }
+    }
+
+    Logger::AsyncOptions file_options() const {
+        Logger::AsyncOptions options;
+        options.console_output = false;
+        options.file_output = true;
+        options.file_path = path_;
+        return options;
+    }
+
+    std::string path_;
+};
+
+TEST_F(LoggerTest, FormatsPlaceholders) {
+    const std::string args[] = {"1", "two"};
+    EXPECT_EQ(logging::format_message("a={} b={}", args, 2), "a=1 b=two");
+    EXPECT_EQ(logging::format_message("a={} b={}", args, 1), "a=1 b={}");
+    EXPECT_EQ(logging::format_message("none", args, 2), "none 1 two");
+}
+
+TEST_F(LoggerTest, AsyncWritesPackedArguments) {
+    ASSERT_TRUE(Logger::instance().start_async(file_options()));
+
+    std::string name = "eth0";
+    LOG_INFO("port {} on {} offset={}ns ratio={} locked={} c={}", 3, name, -42LL, 1.5, true, 'x');
+    LOG_DEBUG("below the runtime level");
+    Logger::instance().flush();
+
+    auto lines = read_lines(path_);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("[INFO ] port 3 on eth0 offset=-42ns ratio=1.5 locked=true c=x"), std::string::npos);
+}
+
+TEST_F(LoggerTest, KeepsEveryRecordFromConcurrentThreads) {
+    ASSERT_TRUE(Logger::instance().start_async(file_options()));
+
+    constexpr int THREADS = 4;
+    constexpr int RECORDS = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < RECORDS; ++i) {
+                LOG_INFO("thread {} record {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Logger::instance().stop_async();
+
+    auto lines = read_lines(path_);
+    EXPECT_EQ(lines.size() + Logger::instance().get_dropped_count(), static_cast<size_t>(THREADS * RECORDS));
+
+    // Records of one thread stay in order
+    int last_record[THREADS] = {-1, -1, -1, -1};
+    for (const auto& line : lines) {
+        int thread_id = -1;
+        int record = -1;
+        auto pos = line.find("thread ");
+        ASSERT_NE(pos, std::string::npos);
+        ASSERT_EQ(std::sscanf(line.c_str() + pos, "thread %d record %d", &thread_id, &record), 2);
+        EXPECT_GT(record, last_record[thread_id]);
+        last_record[thread_id] = record;
+    }
+}
+
+TEST_F(LoggerTest, RotatesBySize) {
+    auto options = file_options();
+    options.max_file_size_bytes = 2048;
+    options.max_files = 3;
+    ASSERT_TRUE(Logger::instance().start_async(options));
+
+    for (int i = 0; i < 200; ++i) {
+        LOG_INFO("rotation filler line {}", i);
+        if (i % 20 == 0) {
+            Logger::instance().flush();
+        }
+    }
+    Logger::instance().stop_async();
+
+    EXPECT_TRUE(file_exists(path_));
+    EXPECT_TRUE(file_exists(path_ + ".1"));
+    EXPECT_TRUE(file_exists(path_ + ".2"));
+    EXPECT_FALSE(file_exists(path_ + ".3"));
+
+    std::ifstream active(path_, std::ios::ate);
+    EXPECT_LE(static_cast<size_t>(active.tellg()), options.max_file_size_bytes);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "../include/message_serializer.hpp"
+
+using namespace gptp;
+using namespace gptp::serialization;
+
+namespace {
+    ClockIdentity make_identity(uint8_t base) {
+        ClockIdentity identity;
+        for (int i = 0; i < 8; i++) {
+            identity.id[i] = static_cast<uint8_t>(base + i);
+        }
+        return identity;
+    }
+}
+
+TEST(MessageDeserializerTest, SyncRoundTrip) {
+    SyncMessage sync;
+    sync.header.sequenceId = 0x1234;
+    sync.header.flags = 0x0200;
+    sync.header.correctionField = 5LL << 16;
+    sync.header.sourcePortIdentity.clockIdentity = make_identity(0x10);
+    sync.header.sourcePortIdentity.portNumber = 3;
+    sync.originTimestamp = Timestamp(1000, 500);
+
+    auto bytes = MessageSerializer::serialize_sync(sync);
+
+    MessageView view;
+    ASSERT_TRUE(MessageView::parse(bytes.data(), bytes.size(), view));
+    EXPECT_EQ(view.type(), protocol::MessageType::SYNC);
+    EXPECT_EQ(view.header.sequenceId, 0x1234);
+    EXPECT_EQ(view.header.flags, 0x0200);
+
+    SyncMessage decoded;
+    ASSERT_TRUE(MessageDeserializer::deserialize_sync(view, decoded));
+    EXPECT_EQ(decoded.header.correctionField, 5LL << 16);
+    EXPECT_EQ(decoded.header.sourcePortIdentity.portNumber, 3);
+    EXPECT_TRUE(decoded.header.sourcePortIdentity.clockIdentity == make_identity(0x10));
+    EXPECT_EQ(decoded.originTimestamp.get_seconds(), 1000u);
+    EXPECT_EQ(decoded.originTimestamp.nanoseconds, 500u);
+}
+
+TEST(MessageDeserializerTest, AnnounceRoundTrip) {
+    AnnounceMessage announce;
+    announce.grandmasterPriority1 = 100;
+    announce.grandmasterPriority2 = 200;
+    announce.grandmasterClockQuality = 0xF8FE436A;
+    announce.grandmasterIdentity = make_identity(0x40);
+    announce.stepsRemoved = 2;
+
+    auto bytes = MessageSerializer::serialize_announce(announce);
+
+    MessageView view;
+    ASSERT_TRUE(MessageView::parse(bytes.data(), bytes.size(), view));
+
+    AnnounceMessage decoded;
+    ASSERT_TRUE(MessageDeserializer::deserialize_announce(view, decoded));
+    EXPECT_EQ(decoded.grandmasterPriority1, 100);
+    EXPECT_EQ(decoded.grandmasterPriority2, 200);
+    EXPECT_EQ(decoded.grandmasterClockQuality, 0xF8FE436Au);
+    EXPECT_EQ(decoded.stepsRemoved, 2);
+    EXPECT_TRUE(decoded.grandmasterIdentity == make_identity(0x40));
+}
+
+TEST(MessageDeserializerTest, PdelayRespFollowUpRoundTrip) {
+    PdelayRespFollowUpMessage followup;
+    followup.responseOriginTimestamp = Timestamp(42, 999999999);
+    followup.requestingPortIdentity.clockIdentity = make_identity(0x20);
+    followup.requestingPortIdentity.portNumber = 7;
+
+    auto bytes = MessageSerializer::serialize_pdelay_resp_followup(followup);
+    EXPECT_EQ(bytes.size(), MessageSerializer::get_expected_size(protocol::MessageType::PDELAY_RESP_FOLLOW_UP));
+
+    MessageView view;
+    ASSERT_TRUE(MessageView::parse(bytes.data(), bytes.size(), view));
+
+    PdelayRespFollowUpMessage decoded;
+    ASSERT_TRUE(MessageDeserializer::deserialize_pdelay_resp_followup(view, decoded));
+    EXPECT_EQ(decoded.responseOriginTimestamp.get_seconds(), 42u);
+    EXPECT_EQ(decoded.responseOriginTimestamp.nanoseconds, 999999999u);
+    EXPECT_EQ(decoded.requestingPortIdentity.portNumber, 7);
+}
+
+TEST(MessageDeserializerTest, RejectsTruncatedInput) {
+    SyncMessage sync;
+    auto bytes = MessageSerializer::serialize_sync(sync);
+
+    MessageView view;
+    EXPECT_FALSE(MessageView::parse(bytes.data(), MessageView::HEADER_SIZE - 1, view));
+
+    ASSERT_TRUE(MessageView::parse(bytes.data(), bytes.size() - 1, view));
+    SyncMessage decoded;
+    EXPECT_FALSE(MessageDeserializer::deserialize_sync(view, decoded));
+}
+
+TEST(MessageDeserializerTest, RejectsMismatchedType) {
+    SyncMessage sync;
+    auto bytes = MessageSerializer::serialize_sync(sync);
+
+    MessageView view;
+    ASSERT_TRUE(MessageView::parse(bytes.data(), bytes.size(), view));
+    FollowUpMessage followup;
+    EXPECT_FALSE(MessageDeserializer::deserialize_followup(view, followup));
+}
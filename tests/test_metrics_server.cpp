@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "networking/metrics_server.hpp"
+#include "utils/prometheus_text.hpp"
+#include "utils/triple_buffer.hpp"
+#include "utils/logger.hpp"
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace gptp;
+
+namespace {
+    std::string unix_get(const std::string& path, const std::string& request) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0) {
+            ::close(fd);
+            return "";
+        }
+        ::send(fd, request.data(), request.size(), 0);
+
+        std::string response;
+        char buffer[1024];
+        ssize_t received;
+        while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, static_cast<size_t>(received));
+        }
+        ::close(fd);
+        return response;
+    }
+}
+
+TEST(MetricsTest, TripleBufferReturnsLatestPublishedValue) {
+    TripleBuffer<int> buffer;
+    buffer.write_buffer() = 1;
+    buffer.publish();
+    buffer.write_buffer() = 2;
+    buffer.publish();
+    EXPECT_EQ(buffer.read(), 2);
+    EXPECT_EQ(buffer.read(), 2);
+
+    buffer.write_buffer() = 3;
+    buffer.publish();
+    EXPECT_EQ(buffer.read(), 3);
+}
+
+TEST(MetricsTest, TripleBufferNeverTearsUnderConcurrency) {
+    struct Pair {
+        uint64_t a = 0;
+        uint64_t b = 0;
+    };
+    TripleBuffer<Pair> buffer;
+    constexpr uint64_t UPDATES = 200000;
+
+    std::thread producer([&buffer]() {
+        for (uint64_t i = 1; i <= UPDATES; ++i) {
+            Pair& pair = buffer.write_buffer();
+            pair.a = i;
+            pair.b = i * 3;
+            buffer.publish();
+        }
+    });
+
+    uint64_t last = 0;
+    while (last < UPDATES) {
+        const Pair& pair = buffer.read();
+        ASSERT_EQ(pair.b, pair.a * 3);
+        ASSERT_GE(pair.a, last);
+        last = pair.a;
+    }
+    producer.join();
+}
+
+TEST(MetricsTest, PrometheusHistogramIsCumulative) {
+    LatencyHistogram histogram;
+    histogram.record(10);
+    histogram.record(100);
+    histogram.record(1000);
+
+    PrometheusWriter out;
+    out.family("stage_ns", "histogram", "test");
+    out.histogram("stage_ns", {{"port", "1"}}, histogram.snapshot());
+    const std::string& text = out.str();
+
+    EXPECT_NE(text.find("# TYPE stage_ns histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("stage_ns_bucket{port=\"1\",le=\"64\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("stage_ns_bucket{port=\"1\",le=\"128\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("stage_ns_bucket{port=\"1\",le=\"1024\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("stage_ns_bucket{port=\"1\",le=\"+Inf\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("stage_ns_sum{port=\"1\"} 1110\n"), std::string::npos);
+    EXPECT_NE(text.find("stage_ns_count{port=\"1\"} 3\n"), std::string::npos);
+}
+
+TEST(MetricsTest, ServesMetricsOverUnixSocket) {
+    Logger::instance().set_level(LogLevel::ERROR);
+    const std::string path = "/tmp/gptp_metrics_test_" + std::to_string(::getpid()) + ".sock";
+
+    MetricsServer server;
+    MetricsServer::Options options;
+    options.socket_path = path;
+    ASSERT_TRUE(server.start(options, []() { return std::string("gptp_up 1\n"); }).is_success());
+
+    std::string response = unix_get(path, "GET /metrics HTTP/1.0\r\nHost: localhost\r\n\r\n");
+    EXPECT_EQ(response.compare(0, 15, "HTTP/1.0 200 OK"), 0) << response;
+    EXPECT_NE(response.find("\r\n\r\ngptp_up 1\n"), std::string::npos);
+
+    response = unix_get(path, "GET /other HTTP/1.0\r\n\r\n");
+    EXPECT_NE(response.find("404"), std::string::npos);
+    EXPECT_EQ(server.get_scrape_count(), 1u);
+
+    server.stop();
+    EXPECT_NE(::access(path.c_str(), F_OK), 0);
+}
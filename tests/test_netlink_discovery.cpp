@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include "platform/linux_netlink_discovery.hpp"
+#include "platform/linux_link_monitor.hpp"
+#include "utils/logger.hpp"
+
+#ifdef __linux__
+#include <linux/net_tstamp.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+
+using namespace gptp;
+
+class NetlinkDiscoveryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::instance().set_level(LogLevel::ERROR);
+        cache_path_ = "/tmp/gptp_ifcache_test_" + std::to_string(getpid());
+        std::remove(cache_path_.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(cache_path_.c_str());
+    }
+
+    std::string cache_path_;
+};
+
+TEST_F(NetlinkDiscoveryTest, ListsLoopback) {
+    NetlinkInterfaceDiscovery discovery;
+    auto result = discovery.discover();
+    ASSERT_TRUE(result.is_success());
+
+    bool found_loopback = false;
+    for (const auto& link : result.value()) {
+        EXPECT_GT(link.ifindex, 0);
+        EXPECT_FALSE(link.name.empty());
+        EXPECT_TRUE(link.timestamping.valid);
+        if (link.name == "lo") {
+            found_loopback = true;
+        }
+    }
+    EXPECT_TRUE(found_loopback);
+    EXPECT_EQ(discovery.get_last_stats().cached, 0u);
+}
+
+TEST_F(NetlinkDiscoveryTest, SecondRunUsesCache) {
+    NetlinkInterfaceDiscovery first;
+    first.set_cache_path(cache_path_);
+    auto first_result = first.discover();
+    ASSERT_TRUE(first_result.is_success());
+
+    NetlinkInterfaceDiscovery second;
+    second.set_cache_path(cache_path_);
+    auto second_result = second.discover();
+    ASSERT_TRUE(second_result.is_success());
+
+    const auto& stats = second.get_last_stats();
+    EXPECT_EQ(stats.cached, stats.links);
+    EXPECT_EQ(stats.netlink_requests, 1u); // Only the link dump
+    EXPECT_EQ(stats.ioctl_queries, 0u);
+
+    ASSERT_EQ(first_result.value().size(), second_result.value().size());
+    for (size_t i = 0; i < first_result.value().size(); ++i) {
+        const auto& a = first_result.value()[i].timestamping;
+        const auto& b = second_result.value()[i].timestamping;
+        EXPECT_EQ(a.so_timestamping, b.so_timestamping);
+        EXPECT_EQ(a.phc_index, b.phc_index);
+    }
+}
+
+TEST_F(NetlinkDiscoveryTest, IgnoresCacheFromAnotherBoot) {
+    FILE* file = std::fopen(cache_path_.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    std::fprintf(file, "gptp-ifcache 1 not-this-boot\n1 lo 00:00:00:00:00:00 0 0 0 -1\n");
+    std::fclose(file);
+
+    NetlinkInterfaceDiscovery discovery;
+    discovery.set_cache_path(cache_path_);
+    ASSERT_TRUE(discovery.discover().is_success());
+    EXPECT_EQ(discovery.get_last_stats().cached, 0u);
+}
+
+TEST(NetlinkDiscoveryConversionTest, MapsTimestampingBits) {
+    LinkTimestampInfo info;
+    info.so_timestamping = SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RX_HARDWARE |
+                           SOF_TIMESTAMPING_RAW_HARDWARE;
+    info.tx_types = 1u << HWTSTAMP_TX_ON;
+    info.rx_filters = 1u << HWTSTAMP_FILTER_ALL;
+
+    auto caps = NetlinkInterfaceDiscovery::to_capabilities(info);
+    EXPECT_TRUE(caps.hardware_timestamping_supported);
+    EXPECT_FALSE(caps.software_timestamping_supported);
+    EXPECT_TRUE(caps.transmit_timestamping);
+    EXPECT_TRUE(caps.receive_timestamping);
+    EXPECT_TRUE(caps.all_transmit);
+    EXPECT_TRUE(caps.all_receive);
+}
+
+TEST(LinuxLinkMonitorTest, ParsesLinkNotifications) {
+    std::vector<uint8_t> buffer(NLMSG_SPACE(sizeof(struct ifinfomsg) + RTA_SPACE(IFNAMSIZ)) * 2, 0);
+    size_t offset = 0;
+    const uint16_t types[2] = {RTM_NEWLINK, RTM_DELLINK};
+    for (uint16_t type : types) {
+        auto* header = reinterpret_cast<struct nlmsghdr*>(buffer.data() + offset);
+        header->nlmsg_type = type;
+        auto* info = reinterpret_cast<struct ifinfomsg*>(NLMSG_DATA(header));
+        info->ifi_index = 7;
+        info->ifi_flags = IFF_UP | IFF_RUNNING;
+        auto* rta = IFLA_RTA(info);
+        rta->rta_type = IFLA_IFNAME;
+        rta->rta_len = RTA_LENGTH(5);
+        std::memcpy(RTA_DATA(rta), "eth7", 5);
+        header->nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg)) + RTA_ALIGN(rta->rta_len);
+        offset += NLMSG_ALIGN(header->nlmsg_len);
+    }
+
+    std::vector<LinkStateEvent> events;
+    ASSERT_TRUE(LinuxLinkMonitor::parse_messages(buffer.data(), offset, events));
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].ifindex, 7);
+    EXPECT_EQ(events[0].name, "eth7");
+    EXPECT_TRUE(events[0].is_running());
+    EXPECT_TRUE(events[1].removed);
+    EXPECT_FALSE(events[1].is_running());
+
+    // Truncated length field
+    reinterpret_cast<struct nlmsghdr*>(buffer.data())->nlmsg_len = static_cast<uint32_t>(offset + 64);
+    events.clear();
+    EXPECT_FALSE(LinuxLinkMonitor::parse_messages(buffer.data(), offset, events));
+}
+
+TEST(LinuxLinkMonitorTest, ParsesDumpCompletions) {
+    std::vector<uint8_t> buffer(NLMSG_SPACE(sizeof(int)) + NLMSG_SPACE(sizeof(struct nlmsgerr)), 0);
+    auto* done = reinterpret_cast<struct nlmsghdr*>(buffer.data());
+    done->nlmsg_type = NLMSG_DONE;
+    done->nlmsg_seq = 3;
+    done->nlmsg_len = NLMSG_LENGTH(sizeof(int));
+    auto* error = reinterpret_cast<struct nlmsghdr*>(buffer.data() + NLMSG_ALIGN(done->nlmsg_len));
+    error->nlmsg_type = NLMSG_ERROR;
+    error->nlmsg_seq = 4;
+    error->nlmsg_len = NLMSG_LENGTH(sizeof(struct nlmsgerr));
+    reinterpret_cast<struct nlmsgerr*>(NLMSG_DATA(error))->error = -EBUSY;
+
+    std::vector<LinkStateEvent> events;
+    std::vector<NetlinkCompletion> completions;
+    ASSERT_TRUE(LinuxLinkMonitor::parse_messages(buffer.data(), buffer.size(), events, &completions));
+    EXPECT_TRUE(events.empty());
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].sequence, 3u);
+    EXPECT_EQ(completions[0].error, 0);
+    EXPECT_EQ(completions[1].sequence, 4u);
+    EXPECT_EQ(completions[1].error, -EBUSY);
+}
+
+TEST(LinuxLinkMonitorTest, DumpReportsLoopbackRunning) {
+    LinuxLinkMonitor monitor;
+    ASSERT_TRUE(monitor.open().is_success());
+    ASSERT_TRUE(monitor.request_dump().is_success());
+
+    struct pollfd pfd{monitor.get_native_handle(), POLLIN, 0};
+    ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+
+    bool loopback_running = false;
+    monitor.process_events([&](const LinkStateEvent& event) {
+        if (event.name == "lo") {
+            loopback_running = event.is_running();
+        }
+    });
+    EXPECT_TRUE(loopback_running);
+    EXPECT_FALSE(monitor.dump_pending());
+}
+
+TEST(LinuxLinkMonitorTest, RefusedDumpIsRetriedUntilComplete) {
+    LinuxLinkMonitor monitor;
+    ASSERT_TRUE(monitor.open().is_success());
+    // The second request supersedes the first and may be refused with
+    // EBUSY while the first is still running
+    ASSERT_TRUE(monitor.request_dump().is_success());
+    monitor.request_dump();
+
+    bool loopback_seen = false;
+    for (int attempt = 0; attempt < 10 && monitor.dump_pending(); ++attempt) {
+        struct pollfd pfd{monitor.get_native_handle(), POLLIN, 0};
+        if (poll(&pfd, 1, 1000) != 1) {
+            break;
+        }
+        monitor.process_events([&](const LinkStateEvent& event) {
+            loopback_seen = loopback_seen || event.name == "lo";
+        });
+    }
+    EXPECT_FALSE(monitor.dump_pending());
+    EXPECT_TRUE(loopback_seen);
+}
+
+#endif // __linux__
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+#include "gptp_socket.hpp"
+
+using namespace gptp;
+
+TEST(PacketTimestampTest, BestTimestampFollowsSource) {
+    PacketTimestamp timestamp;
+    EXPECT_FALSE(timestamp.is_valid());
+
+    // Hardware mode still carries the kernel software stamp alongside
+    timestamp.hardware_timestamp = std::chrono::nanoseconds(5000);
+    timestamp.software_timestamp = std::chrono::nanoseconds(7000);
+    timestamp.software_timestamp_valid = true;
+    timestamp.source = TimestampSource::HARDWARE;
+    EXPECT_TRUE(timestamp.is_valid());
+    EXPECT_EQ(timestamp.get_best_timestamp().count(), 5000);
+
+    timestamp.source = TimestampSource::KERNEL_SOFTWARE;
+    EXPECT_EQ(timestamp.get_best_timestamp().count(), 7000);
+    timestamp.source = TimestampSource::USERSPACE;
+    EXPECT_EQ(timestamp.get_best_timestamp().count(), 7000);
+}
+
+TEST(PacketTimestampTest, SourceNamesAreMetricLabels) {
+    EXPECT_STREQ(to_string(TimestampSource::NONE), "none");
+    EXPECT_STREQ(to_string(TimestampSource::HARDWARE), "hardware");
+    EXPECT_STREQ(to_string(TimestampSource::KERNEL_SOFTWARE), "kernel_software");
+    EXPECT_STREQ(to_string(TimestampSource::USERSPACE), "userspace");
+}
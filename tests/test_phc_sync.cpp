@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "platform/linux_phc_sync.hpp"
+#include "utils/logger.hpp"
+
+using namespace gptp;
+
+namespace {
+    struct ptp_clock_time make_time(int64_t ns) {
+        struct ptp_clock_time time{};
+        time.sec = ns / 1000000000LL;
+        time.nsec = static_cast<uint32_t>(ns % 1000000000LL);
+        return time;
+    }
+}
+
+TEST(PhcSyncTest, ExtendedPicksNarrowestBracket) {
+    struct ptp_sys_offset_extended result{};
+    result.n_samples = 3;
+    const int64_t sys[3][2] = {{1000000000, 1000004000}, {1000010000, 1000010600}, {1000020000, 1000021000}};
+    for (int i = 0; i < 3; ++i) {
+        result.ts[i][0] = make_time(sys[i][0]);
+        result.ts[i][1] = make_time(sys[i][0] + 37000000000LL + 100);
+        result.ts[i][2] = make_time(sys[i][1]);
+    }
+
+    PhcCrossTimestamp cross = LinuxPhcSystemSync::select_extended(result);
+    EXPECT_EQ(cross.method, PhcCrossTimestamp::Method::EXTENDED);
+    EXPECT_EQ(cross.window_ns, 600);
+    EXPECT_EQ(cross.system_ns, 1000010300);
+    EXPECT_EQ(cross.phc_ns, 1000010000 + 37000000000LL + 100);
+}
+
+TEST(PhcSyncTest, BasicPicksNarrowestInterleavedWindow) {
+    // system, phc, system, phc, system: the second window is narrower
+    struct ptp_sys_offset result{};
+    result.n_samples = 2;
+    result.ts[0] = make_time(5000);
+    result.ts[1] = make_time(7000);
+    result.ts[2] = make_time(9000);
+    result.ts[3] = make_time(9500);
+    result.ts[4] = make_time(10000);
+
+    PhcCrossTimestamp cross = LinuxPhcSystemSync::select_basic(result);
+    EXPECT_EQ(cross.window_ns, 1000);
+    EXPECT_EQ(cross.system_ns, 9500);
+    EXPECT_EQ(cross.phc_ns, 9500);
+}
+
+TEST(PhcSyncTest, OffsetIsSystemMinusUtcCorrectedPhc) {
+    Logger::instance().set_level(LogLevel::ERROR);
+    LinuxPhcSystemSync sync; // Not opened: measures only, never adjusts
+
+    PhcCrossTimestamp cross;
+    cross.phc_ns = 1700000037000000000LL;
+    cross.system_ns = 1700000000000000250LL;
+    EXPECT_EQ(sync.update(cross, std::chrono::steady_clock::now()), 250);
+    EXPECT_EQ(sync.get_last_offset_ns(), 250);
+    EXPECT_FALSE(sync.is_locked());
+}
+
+TEST(PhcSyncTest, PortsAreGroupedByPhc) {
+    // Two I350 ports on /dev/ptp1, one I210 on /dev/ptp0, one port without a PHC
+    auto groups = group_ports_by_phc({{1, 1}, {2, 0}, {3, 1}, {4, -1}});
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[0].phc_index, 1);
+    EXPECT_EQ(groups[0].port_ids, (std::vector<uint16_t>{1, 3}));
+    EXPECT_EQ(groups[1].phc_index, 0);
+    EXPECT_EQ(groups[1].port_ids, (std::vector<uint16_t>{2}));
+    EXPECT_EQ(groups[2].phc_index, -1);
+    EXPECT_EQ(groups[2].port_ids, (std::vector<uint16_t>{4}));
+}
+
+TEST(PhcSyncTest, FollowerUsesNarrowestBracket) {
+    // primary, secondary, primary: the last bracket is the narrowest
+    std::vector<LinuxPhcFollower::Bracket> brackets = {
+        {{1000, 1900, 3000}},
+        {{5000, 5700, 5400}},
+        {{8000, 8250, 8200}},
+    };
+    EXPECT_EQ(LinuxPhcFollower::select_bracket(brackets), 150);
+
+    LinuxPhcFollower follower; // Not opened: measures only, never adjusts
+    EXPECT_EQ(follower.update(-80, std::chrono::steady_clock::now()), -80);
+    EXPECT_EQ(follower.get_last_offset_ns(), -80);
+    EXPECT_FALSE(follower.is_open());
+    EXPECT_FALSE(follower.is_locked());
+}
@@ -0,0 +1,424 @@
+#include <gtest/gtest.h>
+#include "../include/gptp_port_manager.hpp"
+#include "../include/message_serializer.hpp"
+#include "utils/logger.hpp"
+#include "utils/allocation_counter.hpp"
+#include "simulation/virtual_time.hpp"
+#include <deque>
+#include <optional>
+
+using namespace gptp;
+
+namespace {
+    constexpr int64_t PROPAGATION_DELAY_NS = 500;
+    constexpr int64_t TURNAROUND_NS = 1000;
+
+    ClockIdentity make_identity(uint8_t base) {
+        ClockIdentity identity;
+        for (int i = 0; i < 8; i++) {
+            identity.id[i] = static_cast<uint8_t>(base + i);
+        }
+        return identity;
+    }
+
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+
+    /**
+     * Two port managers connected back to back over a wire with a fixed
+     * propagation delay. Frames are queued and delivered in order so no
+     * handler re-enters the sender. With a virtual clock, the managers'
+     * own notion of time follows the link's.
+     */
+    class BackToBackLink {
+    public:
+        struct Frame {
+            int destination;
+            std::vector<uint8_t> payload;
+            int64_t tx_time_ns;
+        };
+
+        explicit BackToBackLink(sim::VirtualClockSource* clock = nullptr)
+            : now_ns_(1000000000000LL)
+            , clock_(clock) {
+            for (int side = 0; side < 2; ++side) {
+                identities_[side] = make_identity(side == 0 ? 0x80 : 0x40);
+                managers_[side] = std::make_unique<GptpPortManager>(identities_[side],
+                    [this, side](uint16_t, const std::vector<uint8_t>& payload) {
+                        ScopedAllocationAllowance wire;     // The queue is not under test
+                        now_ns_ += TURNAROUND_NS; // Every transmission takes time on the wire
+                        last_tx_ns_[side] = now_ns_;
+                        transmitted_[side]++;
+                        if (link_up_) {
+                            queue_.push_back({1 - side, payload, now_ns_});
+                        }
+                    });
+                managers_[side]->set_tx_timestamp_provider([this, side](uint16_t, Timestamp& tx_time) {
+                    if (!tx_timestamps_[side]) {
+                        return false;
+                    }
+                    tx_time = to_timestamp(last_tx_ns_[side]);
+                    return true;
+                });
+            }
+        }
+
+        GptpPortManager& side(int index) { return *managers_[index]; }
+        const ClockIdentity& identity(int index) const { return identities_[index]; }
+
+        void start() {
+            for (auto& manager : managers_) {
+                manager->add_port(1);
+                manager->enable_port(1);
+            }
+        }
+
+        void run_for(std::chrono::milliseconds duration) {
+            auto step = std::chrono::milliseconds(10);
+            for (auto elapsed = std::chrono::milliseconds(0); elapsed < duration; elapsed += step) {
+                now_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(step).count();
+                if (clock_ != nullptr) {
+                    clock_->advance(step);
+                    steady_now_ = steady_now();
+                } else {
+                    steady_now_ += step;
+                }
+                std::optional<ScopedAllocationGuard> guard;
+                if (guard_allocations_) {
+                    guard.emplace();
+                }
+                for (auto& manager : managers_) {
+                    manager->run_periodic_tasks(steady_now_);
+                }
+                deliver_all();
+            }
+        }
+
+        // Egress timestamps stop arriving, as when the driver drops them
+        void set_tx_timestamps(int index, bool available) { tx_timestamps_[index] = available; }
+
+        // Fail every allocation the managers make from here on
+        void guard_allocations(bool enabled) { guard_allocations_ = enabled; }
+
+        size_t parse_failures() const { return parse_failures_; }
+        size_t transmitted(int index) const { return transmitted_[index]; }
+
+        // Carrier loss is seen by both ends of the cable
+        void set_link(bool up) {
+            link_up_ = up;
+            if (!up) {
+                queue_.clear();
+            }
+            for (auto& manager : managers_) {
+                manager->set_link_status(1, up);
+            }
+        }
+
+    private:
+        void deliver_all() {
+            while (!queue_.empty()) {
+                Frame frame = std::move(queue_.front());
+                {
+                    ScopedAllocationAllowance wire;
+                    queue_.pop_front();
+                }
+                ParseResult result = managers_[frame.destination]->process_frame(
+                    1, frame.payload.data(), frame.payload.size(),
+                    to_timestamp(frame.tx_time_ns + PROPAGATION_DELAY_NS));
+                if (result != ParseResult::SUCCESS) {
+                    parse_failures_++;
+                }
+            }
+        }
+
+        ClockIdentity identities_[2];
+        std::unique_ptr<GptpPortManager> managers_[2];
+        int64_t last_tx_ns_[2] = {0, 0};
+        bool tx_timestamps_[2] = {true, true};
+        std::deque<Frame> queue_;
+        int64_t now_ns_;
+        sim::VirtualClockSource* clock_;
+        std::chrono::steady_clock::time_point steady_now_ = steady_now();
+        bool guard_allocations_ = false;
+        size_t parse_failures_ = 0;
+        size_t transmitted_[2] = {0, 0};
+        bool link_up_ = true;
+    };
+
+    class RecordingClockAdjuster : public IClockAdjuster {
+    public:
+        Result<bool> adjust_frequency(double ppb) override {
+            frequency_adjustments++;
+            last_ppb = ppb;
+            return Result<bool>::success(true);
+        }
+        Result<bool> step_clock(std::chrono::nanoseconds) override {
+            steps++;
+            return Result<bool>::success(true);
+        }
+        std::string get_name() const override { return "recording"; }
+
+        int frequency_adjustments = 0;
+        int steps = 0;
+        double last_ppb = 0.0;
+    };
+}
+
+class PortManagerPipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::instance().set_level(LogLevel::ERROR);
+    }
+};
+
+TEST_F(PortManagerPipelineTest, RejectsMalformedFrames) {
+    GptpPortManager manager(make_identity(0x80), [](uint16_t, const std::vector<uint8_t>&) {});
+    manager.add_port(1);
+    manager.enable_port(1);
+
+    std::vector<uint8_t> short_frame(10, 0);
+    EXPECT_EQ(manager.process_frame(1, short_frame.data(), short_frame.size(), Timestamp()),
+              ParseResult::INVALID_LENGTH);
+
+    auto sync = serialization::MessageSerializer::serialize_sync(SyncMessage());
+    sync[1] = 0x01; // versionPTP 1
+    EXPECT_EQ(manager.process_frame(1, sync.data(), sync.size(), Timestamp()),
+              ParseResult::INVALID_VERSION);
+}
+
+TEST_F(PortManagerPipelineTest, PeerDelayExchangeMeasuresLinkDelay) {
+    BackToBackLink link;
+    link.start();
+    link.run_for(std::chrono::milliseconds(1500));
+
+    EXPECT_EQ(link.parse_failures(), 0u);
+    EXPECT_EQ(link.side(0).get_link_delay(1).count(), PROPAGATION_DELAY_NS);
+    EXPECT_EQ(link.side(1).get_link_delay(1).count(), PROPAGATION_DELAY_NS);
+}
+
+TEST_F(PortManagerPipelineTest, BetterRemoteClockMakesPortSlaveAndDrivesServo) {
+    BackToBackLink link;
+    RecordingClockAdjuster adjuster;
+    link.side(0).set_clock_adjuster(&adjuster);
+    link.side(1).set_local_clock_properties(100, ClockQuality(), 248);
+    link.start();
+    link.run_for(std::chrono::seconds(2));
+
+    EXPECT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::SLAVE);
+    EXPECT_EQ(link.side(1).get_port_roles()[1], bmca::PortRole::MASTER);
+    EXPECT_GT(adjuster.frequency_adjustments + adjuster.steps, 0);
+}
+
+TEST_F(PortManagerPipelineTest, ReportsSyncAndPeerDelaySamples) {
+    BackToBackLink link;
+    std::vector<SyncSample> samples;
+    link.side(0).set_sync_sample_callback([&samples](const SyncSample& sample) { samples.push_back(sample); });
+    link.side(1).set_local_clock_properties(100, ClockQuality(), 248);
+    link.start();
+    link.run_for(std::chrono::seconds(2));
+
+    size_t sync_count = 0;
+    size_t pdelay_count = 0;
+    for (const auto& sample : samples) {
+        EXPECT_EQ(sample.port_id, 1);
+        if (sample.kind == SyncSample::Kind::SYNC) {
+            sync_count++;
+            EXPECT_EQ(sample.t2_ns - sample.t1_ns - sample.offset_ns, sample.path_delay_ns);
+        } else {
+            pdelay_count++;
+            EXPECT_EQ(sample.path_delay_ns, PROPAGATION_DELAY_NS);
+            EXPECT_GT(sample.t4_ns, sample.t1_ns);
+        }
+    }
+    EXPECT_GT(sync_count, 0u);
+    EXPECT_GT(pdelay_count, 0u);
+}
+
+TEST_F(PortManagerPipelineTest, LinkDownDisablesPortAndDiscardsMeasurements) {
+    BackToBackLink link;
+    link.side(1).set_local_clock_properties(100, ClockQuality(), 248);
+    link.start();
+    link.run_for(std::chrono::milliseconds(1500));
+    ASSERT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::SLAVE);
+    ASSERT_EQ(link.side(0).get_link_delay(1).count(), PROPAGATION_DELAY_NS);
+
+    link.set_link(false);
+
+    EXPECT_FALSE(link.side(0).is_link_up(1));
+    EXPECT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::DISABLED);
+    EXPECT_EQ(link.side(0).get_link_delay(1).count(), 0);
+    EXPECT_TRUE(link.side(0).get_bmca_decisions().empty());
+
+    // A port without carrier transmits nothing
+    size_t transmitted = link.transmitted(0);
+    link.run_for(std::chrono::seconds(2));
+    EXPECT_EQ(link.transmitted(0), transmitted);
+    EXPECT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::DISABLED);
+}
+
+TEST_F(PortManagerPipelineTest, LinkUpRestartsPeerDelayAndBmcaImmediately) {
+    BackToBackLink link;
+    link.side(1).set_local_clock_properties(100, ClockQuality(), 248);
+    link.start();
+    link.run_for(std::chrono::milliseconds(1000));
+    link.set_link(false);
+    link.run_for(std::chrono::milliseconds(200));
+
+    link.set_link(true);
+
+    // BMCA ran on link up: no announce heard yet, so the port is master
+    EXPECT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::MASTER);
+
+    // Pdelay_Req and Announce go out on the first periodic pass
+    size_t transmitted = link.transmitted(0);
+    link.run_for(std::chrono::milliseconds(10));
+    EXPECT_GE(link.transmitted(0), transmitted + 2);
+
+    link.run_for(std::chrono::milliseconds(1100));
+    EXPECT_EQ(link.side(0).get_link_delay(1).count(), PROPAGATION_DELAY_NS);
+    EXPECT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::SLAVE);
+}
+
+TEST_F(PortManagerPipelineTest, SyncsWithoutFollowUpAreBounded) {
+    BackToBackLink link;
+    link.side(1).set_local_clock_properties(100, ClockQuality(), 248);
+    link.start();
+    link.run_for(std::chrono::milliseconds(1500));
+    ASSERT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::SLAVE);
+    auto missed = link.side(0).get_port_counters(1).followups_missed;
+
+    // A burst of Syncs faster than the Follow_Up timeout, every Follow_Up lost
+    SyncMessage sync;
+    sync.header.messageType = static_cast<uint8_t>(protocol::MessageType::SYNC);
+    sync.header.messageLength = 44;
+    sync.header.flags = 0x0200;
+    sync.header.sourcePortIdentity.clockIdentity = link.identity(1);
+    sync.header.sourcePortIdentity.portNumber = 1;
+    for (uint16_t i = 0; i < 1000; ++i) {
+        sync.header.sequenceId = static_cast<uint16_t>(0x4000 + i);
+        auto frame = serialization::MessageSerializer::serialize_sync(sync);
+        ASSERT_EQ(link.side(0).process_frame(1, frame.data(), frame.size(), to_timestamp(1000000000000LL + i)),
+                  ParseResult::SUCCESS);
+    }
+
+    EXPECT_LE(link.side(0).get_state_sizes().pending_syncs, 4u);
+    EXPECT_GE(link.side(0).get_port_counters(1).followups_missed, missed + 996);
+}
+
+TEST_F(PortManagerPipelineTest, MissingEgressTimestampsSkipFollowUps) {
+    BackToBackLink link;
+    link.side(1).set_local_clock_properties(100, ClockQuality(), 248);
+    link.set_tx_timestamps(1, false);
+    std::vector<SyncSample> samples;
+    link.side(0).set_sync_sample_callback([&samples](const SyncSample& sample) { samples.push_back(sample); });
+    link.start();
+    link.run_for(std::chrono::seconds(2));
+
+    // The master sends Syncs but no Follow_Up with a made-up origin time,
+    // and answers Pdelay_Req without the t3 follow-up
+    ASSERT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::SLAVE);
+    EXPECT_TRUE(samples.empty());
+    EXPECT_GT(link.side(0).get_port_counters(1).followups_missed, 0u);
+    EXPECT_EQ(link.side(0).get_link_delay(1).count(), 0);
+    EXPECT_EQ(link.side(1).get_link_delay(1).count(), 0);
+    EXPECT_GT(link.side(1).get_port_counters(1).tx_timestamps_missing, 0u);
+    EXPECT_EQ(link.side(0).get_port_counters(1).tx_timestamps_missing, 0u);
+
+    // Once timestamps return, the exchanges complete again
+    link.set_tx_timestamps(1, true);
+    link.run_for(std::chrono::seconds(2));
+    EXPECT_FALSE(samples.empty());
+    EXPECT_EQ(link.side(0).get_link_delay(1).count(), PROPAGATION_DELAY_NS);
+}
+
+TEST_F(PortManagerPipelineTest, SlaveMovingToAnotherClockRestartsServo) {
+    // The pipeline swaps the adjuster when the slave port timestamps against
+    // another PHC; what the servo learned about one clock must not be
+    // applied to the other
+    auto feed = [](servo::SynchronizationManager& manager, uint16_t port_id, int seconds, int64_t offset_ns) {
+        SyncMessage sync;
+        sync.originTimestamp.set_seconds(static_cast<uint64_t>(1000 + seconds));
+        FollowUpMessage followup;
+        Timestamp receipt = sync.originTimestamp;
+        receipt.nanoseconds = static_cast<uint32_t>(offset_ns);
+        manager.process_sync_followup(port_id, sync, receipt, followup, std::chrono::nanoseconds(0));
+    };
+
+    RecordingClockAdjuster clock_a;
+    RecordingClockAdjuster clock_b;
+    servo::SynchronizationManager manager;
+    manager.set_clock_adjuster(&clock_a);
+    manager.set_slave_port(1);
+    for (int i = 0; i < 10; ++i) {
+        feed(manager, 1, i, 200000);
+    }
+    ASSERT_EQ(clock_a.steps, 0);
+    double learned_ppb = clock_a.last_ppb;
+
+    // Port 2, on the second clock, becomes slave for a while
+    manager.set_slave_port(2);
+    manager.set_clock_adjuster(&clock_b);
+    feed(manager, 2, 10, 200000);
+    EXPECT_EQ(clock_b.frequency_adjustments, 1);
+
+    // Back to port 1 and the first clock: it starts like a fresh servo
+    manager.set_slave_port(1);
+    manager.set_clock_adjuster(&clock_a);
+    feed(manager, 1, 11, 200000);
+
+    RecordingClockAdjuster fresh_clock;
+    servo::SynchronizationManager fresh;
+    fresh.set_clock_adjuster(&fresh_clock);
+    fresh.set_slave_port(1);
+    feed(fresh, 1, 11, 200000);
+
+    EXPECT_NE(learned_ppb, fresh_clock.last_ppb);
+    EXPECT_DOUBLE_EQ(clock_a.last_ppb, fresh_clock.last_ppb);
+    EXPECT_DOUBLE_EQ(clock_b.last_ppb, fresh_clock.last_ppb);
+}
+
+TEST_F(PortManagerPipelineTest, SteadyStateDoesNotAllocate) {
+    sim::EventScheduler scheduler(1000000000LL);
+    sim::ScopedVirtualTime virtual_time(scheduler);
+    BackToBackLink link(&scheduler.clock());
+    link.side(1).set_local_clock_properties(100, ClockQuality(), 248);
+    link.start();
+
+    // Warm-up fills the servo, peer delay and BMCA state to their bounds
+    link.run_for(std::chrono::seconds(30));
+    ASSERT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::SLAVE);
+    ASSERT_EQ(link.side(1).get_port_roles()[1], bmca::PortRole::MASTER);
+
+    uint64_t violations = allocation_violation_count();
+    auto transmitted = link.transmitted(0) + link.transmitted(1);
+    link.guard_allocations(true);
+    link.run_for(std::chrono::seconds(60));
+    link.guard_allocations(false);
+
+    EXPECT_EQ(allocation_violation_count() - violations, 0u);
+    EXPECT_GT(link.transmitted(0) + link.transmitted(1), transmitted + 500);
+    EXPECT_EQ(link.side(0).get_port_roles()[1], bmca::PortRole::SLAVE);
+    EXPECT_EQ(link.parse_failures(), 0u);
+}
+
+TEST(AllocationGuardTest, CountsOnlyGuardedAllocations) {
+    uint64_t violations = allocation_violation_count();
+    {
+        ScopedAllocationGuard guard;
+        std::vector<int> harness;
+        {
+            ScopedAllocationAllowance allowance;
+            harness.reserve(4);
+        }
+        harness.push_back(1);                   // Within capacity
+        EXPECT_EQ(allocation_violation_count(), violations);
+
+        auto leaked = std::make_unique<int>(1); // Reported with a stack trace
+        EXPECT_EQ(allocation_violation_count(), violations + 1);
+    }
+    auto unguarded = std::make_unique<int>(2);
+    EXPECT_EQ(allocation_violation_count(), violations + 1);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "platform/hwtstamp_filter.hpp"
+#include <cerrno>
+#include <set>
+
+using namespace gptp;
+
+namespace {
+    uint32_t bits(std::initializer_list<int> filters) {
+        uint32_t mask = 0;
+        for (int filter : filters) {
+            mask |= 1u << filter;
+        }
+        return mask;
+    }
+
+    /**
+     * Driver model: advertises rx_filters, rejects some filters with ERANGE
+     * and may widen the one it accepts, as igb does on I210.
+     */
+    class FakeTimestampIoctl : public ITimestampIoctl {
+    public:
+        int ts_info_error = 0;
+        uint32_t rx_filters = 0;
+        std::set<int> rejected;
+        int widen_to = -1;
+        int set_error = 0;
+        std::vector<int> requested;
+
+        int get_ts_info(const std::string&, struct ethtool_ts_info& info) override {
+            info = {};
+            info.rx_filters = rx_filters;
+            return ts_info_error;
+        }
+
+        int set_hwtstamp(const std::string&, struct hwtstamp_config& config) override {
+            requested.push_back(config.rx_filter);
+            if (set_error != 0) {
+                return set_error;
+            }
+            if (rejected.count(config.rx_filter) != 0) {
+                return ERANGE;
+            }
+            EXPECT_EQ(config.tx_type, HWTSTAMP_TX_ON);
+            if (widen_to >= 0) {
+                config.rx_filter = widen_to;
+            }
+            return 0;
+        }
+    };
+}
+
+TEST(RxFilterTest, PrefersLayer2EventFilter) {
+    FakeTimestampIoctl ioctl;
+    ioctl.rx_filters = bits({HWTSTAMP_FILTER_NONE, HWTSTAMP_FILTER_ALL, HWTSTAMP_FILTER_PTP_V2_EVENT,
+                             HWTSTAMP_FILTER_PTP_V2_L2_EVENT, HWTSTAMP_FILTER_PTP_V2_L4_EVENT});
+
+    auto selection = RxFilterSelector::apply(ioctl, "eth0", "I350");
+    ASSERT_TRUE(selection.enabled);
+    EXPECT_EQ(selection.requested_filter, HWTSTAMP_FILTER_PTP_V2_L2_EVENT);
+    EXPECT_EQ(selection.applied_filter, HWTSTAMP_FILTER_PTP_V2_L2_EVENT);
+    EXPECT_EQ(ioctl.requested.size(), 1u);
+}
+
+TEST(RxFilterTest, WidensWhenDriverRejectsFilter) {
+    FakeTimestampIoctl ioctl;
+    ioctl.rx_filters = bits({HWTSTAMP_FILTER_ALL, HWTSTAMP_FILTER_PTP_V2_EVENT, HWTSTAMP_FILTER_PTP_V2_L2_EVENT});
+    ioctl.rejected = {HWTSTAMP_FILTER_PTP_V2_L2_EVENT};
+
+    auto selection = RxFilterSelector::apply(ioctl, "eth0", "");
+    ASSERT_TRUE(selection.enabled);
+    EXPECT_EQ(selection.requested_filter, HWTSTAMP_FILTER_PTP_V2_EVENT);
+    EXPECT_EQ((std::vector<int>{HWTSTAMP_FILTER_PTP_V2_L2_EVENT, HWTSTAMP_FILTER_PTP_V2_EVENT}), ioctl.requested);
+}
+
+TEST(RxFilterTest, ReportsFilterAppliedByDriver) {
+    FakeTimestampIoctl ioctl;
+    ioctl.rx_filters = bits({HWTSTAMP_FILTER_ALL, HWTSTAMP_FILTER_PTP_V2_L2_EVENT});
+    ioctl.widen_to = HWTSTAMP_FILTER_ALL;
+
+    auto selection = RxFilterSelector::apply(ioctl, "eth0", "I210");
+    ASSERT_TRUE(selection.enabled);
+    EXPECT_EQ(selection.requested_filter, HWTSTAMP_FILTER_PTP_V2_L2_EVENT);
+    EXPECT_EQ(selection.applied_filter, HWTSTAMP_FILTER_ALL);
+}
+
+TEST(RxFilterTest, OnlyAllTimestampsEverything) {
+    FakeTimestampIoctl ioctl;
+    ioctl.rx_filters = bits({HWTSTAMP_FILTER_NONE, HWTSTAMP_FILTER_ALL});
+
+    auto selection = RxFilterSelector::apply(ioctl, "eth0", "E810");
+    ASSERT_TRUE(selection.enabled);
+    EXPECT_EQ(selection.applied_filter, HWTSTAMP_FILTER_ALL);
+}
+
+TEST(RxFilterTest, FamilyFillsInMissingDriverReport) {
+    EXPECT_EQ(RxFilterSelector::candidates(0, "I210").front(), HWTSTAMP_FILTER_PTP_V2_L2_EVENT);
+    EXPECT_EQ(RxFilterSelector::candidates(0, "E810"), std::vector<int>{HWTSTAMP_FILTER_ALL});
+    EXPECT_EQ(RxFilterSelector::candidates(0, "").front(), HWTSTAMP_FILTER_PTP_V2_EVENT);
+
+    FakeTimestampIoctl ioctl;
+    ioctl.ts_info_error = EOPNOTSUPP;
+    auto selection = RxFilterSelector::apply(ioctl, "eth0", "I225");
+    ASSERT_TRUE(selection.enabled);
+    EXPECT_EQ(selection.applied_filter, HWTSTAMP_FILTER_PTP_V2_L2_EVENT);
+}
+
+TEST(RxFilterTest, FailsWithoutUsableFilter) {
+    FakeTimestampIoctl ioctl;
+    ioctl.rx_filters = bits({HWTSTAMP_FILTER_NONE, HWTSTAMP_FILTER_PTP_V1_L4_EVENT});
+    auto selection = RxFilterSelector::apply(ioctl, "eth0", "I210");
+    EXPECT_FALSE(selection.enabled);
+    EXPECT_TRUE(ioctl.requested.empty());
+
+    // Permission errors are not retried with wider filters
+    FakeTimestampIoctl denied;
+    denied.rx_filters = bits({HWTSTAMP_FILTER_ALL, HWTSTAMP_FILTER_PTP_V2_L2_EVENT});
+    denied.set_error = EPERM;
+    selection = RxFilterSelector::apply(denied, "eth0", "");
+    EXPECT_FALSE(selection.enabled);
+    EXPECT_EQ(selection.error, EPERM);
+    EXPECT_EQ(denied.requested.size(), 1u);
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "simulation/simulated_network.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t START_NS = 1000000000LL;
+
+    GptpPacket make_packet(uint8_t marker) {
+        GptpPacket packet;
+        packet.payload = {marker};
+        return packet;
+    }
+
+    struct TwoNodes {
+        EventScheduler scheduler{START_NS};
+        ScopedVirtualTime virtual_time{scheduler};
+        SimulatedNetwork network{scheduler, 7};
+        SimulatedNode* master = nullptr;
+        SimulatedNode* slave = nullptr;
+        std::unique_ptr<SimulatedTimeAwareSystem> systems[2];
+
+        TwoNodes(const OscillatorModel& slave_oscillator, const LinkModel& link) {
+            master = &network.add_node("master");
+            slave = &network.add_node("slave", slave_oscillator);
+            systems[0] = std::make_unique<SimulatedTimeAwareSystem>(network, *master);
+            systems[1] = std::make_unique<SimulatedTimeAwareSystem>(network, *slave);
+            systems[0]->add_port("master.eth0");
+            systems[1]->add_port("slave.eth0");
+            network.connect("master.eth0", "slave.eth0", link);
+            systems[0]->port_manager().set_local_clock_properties(100, ClockQuality(), 248);
+            systems[0]->start();
+            systems[1]->start();
+        }
+    };
+}
+
+class SimulatedNetworkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::instance().set_level(LogLevel::ERROR);
+    }
+};
+
+TEST_F(SimulatedNetworkTest, OscillatorRunsAtItsFrequencyAndObeysAdjustments) {
+    EventScheduler scheduler(START_NS);
+    SimulatedNetwork network(scheduler);
+    OscillatorModel oscillator;
+    oscillator.initial_offset_ns = 1000;
+    oscillator.frequency_error_ppb = 20000.0; // 20 ppm fast
+    SimulatedNode& node = network.add_node("node", oscillator);
+
+    EXPECT_EQ(node.offset_from_true_ns(), 1000);
+    scheduler.run_for(std::chrono::seconds(1));
+    EXPECT_EQ(node.offset_from_true_ns(), 21000);
+
+    node.adjust_frequency(-20000.0);
+    node.step_clock(std::chrono::nanoseconds(-21000));
+    scheduler.run_for(std::chrono::seconds(10));
+    EXPECT_EQ(node.offset_from_true_ns(), 0);
+}
+
+TEST_F(SimulatedNetworkTest, LinkDelaysAndTimestampsFrames) {
+    EventScheduler scheduler(START_NS);
+    SimulatedNetwork network(scheduler);
+    SimulatedNode& a = network.add_node("a");
+    OscillatorModel skewed;
+    skewed.initial_offset_ns = 5000;
+    SimulatedNode& b = network.add_node("b", skewed);
+    auto socket_a = network.create_socket(a, "a.eth0");
+    auto socket_b = network.create_socket(b, "b.eth0");
+    ASSERT_TRUE(socket_a->initialize("a.eth0").is_success());
+    ASSERT_TRUE(socket_b->initialize("b.eth0").is_success());
+
+    LinkModel link;
+    link.delay_ns = 800;
+    link.asymmetry_ns = 200;
+    ASSERT_TRUE(network.connect("a.eth0", "b.eth0", link).is_success());
+
+    PacketTimestamp tx;
+    ASSERT_TRUE(socket_a->send_packet(make_packet(1), tx).is_success());
+    EXPECT_EQ(tx.source, TimestampSource::HARDWARE);
+    EXPECT_EQ(socket_b->try_receive_packet().error(), ErrorCode::TIMEOUT); // Still on the wire
+
+    scheduler.run_for(std::chrono::microseconds(10));
+    auto rx = socket_b->try_receive_packet();
+    ASSERT_TRUE(rx.is_success());
+    EXPECT_EQ(rx.value().packet.payload[0], 1);
+    // A->B takes delay + asymmetry/2; B's clock is 5 us ahead
+    EXPECT_EQ(rx.value().timestamp.hardware_timestamp.count() - tx.hardware_timestamp.count(), 900 + 5000);
+
+    ASSERT_TRUE(socket_b->send_packet(make_packet(2), tx).is_success());
+    scheduler.run_for(std::chrono::microseconds(10));
+    rx = socket_a->try_receive_packet();
+    ASSERT_TRUE(rx.is_success());
+    EXPECT_EQ(rx.value().timestamp.hardware_timestamp.count() - tx.hardware_timestamp.count(), 700 - 5000);
+
+    network.set_link_up("a.eth0", false);
+    socket_a->send_packet(make_packet(3), tx);
+    scheduler.run_for(std::chrono::microseconds(10));
+    EXPECT_FALSE(socket_b->try_receive_packet().is_success());
+    EXPECT_EQ(network.get_statistics().frames_lost, 1u);
+}
+
+TEST_F(SimulatedNetworkTest, LossAndReorderingFollowTheLinkModel) {
+    EventScheduler scheduler(START_NS);
+    SimulatedNetwork network(scheduler, 42);
+    auto socket_a = network.create_socket(network.add_node("a"), "a.eth0");
+    auto socket_b = network.create_socket(network.add_node("b"), "b.eth0");
+    socket_a->initialize("a.eth0");
+    socket_b->initialize("b.eth0");
+
+    LinkModel link;
+    link.jitter = JitterDistribution::EXPONENTIAL;
+    link.jitter_ns = 2000;
+    link.loss_probability = 0.1;
+    link.reorder_probability = 0.05;
+    network.connect("a.eth0", "b.eth0", link);
+
+    std::vector<int> received;
+    socket_b->start_async_receive([&received](const ReceivedPacket& packet) {
+        received.push_back(packet.packet.payload[0] | (packet.packet.payload[1] << 8));
+    });
+    for (int i = 0; i < 10000; ++i) {
+        GptpPacket packet;
+        packet.payload = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+        PacketTimestamp tx;
+        socket_a->send_packet(packet, tx);
+        scheduler.run_for(std::chrono::microseconds(100));
+    }
+    scheduler.run_for(std::chrono::seconds(1));
+
+    const auto& stats = network.get_statistics();
+    EXPECT_NEAR(static_cast<double>(stats.frames_lost) / 10000.0, 0.1, 0.02);
+    EXPECT_GT(stats.frames_reordered, 300u);
+    EXPECT_EQ(received.size(), stats.frames_delivered);
+    EXPECT_FALSE(std::is_sorted(received.begin(), received.end()));
+}
+
+TEST_F(SimulatedNetworkTest, SlaveMeasuresTrueOffsetOverSimulatedLink) {
+    OscillatorModel oscillator;
+    oscillator.initial_offset_ns = 50000;
+    oscillator.frequency_error_ppb = 2000.0;
+    oscillator.wander_ppb = 1.0;
+    oscillator.timestamp_resolution_ns = 8;
+    LinkModel link;
+    link.delay_ns = 1200;
+    link.jitter = JitterDistribution::NORMAL;
+    link.jitter_ns = 20;
+    TwoNodes setup(oscillator, link);
+
+    // Every offset the protocol stack measures must match the ground truth
+    size_t samples = 0;
+    int64_t worst_error = 0;
+    setup.systems[1]->port_manager().set_sync_sample_callback([&](const SyncSample& sample) {
+        if (sample.kind != SyncSample::Kind::SYNC) {
+            return;
+        }
+        samples++;
+        int64_t truth = setup.slave->offset_from_true_ns() - setup.master->offset_from_true_ns();
+        worst_error = std::max<int64_t>(worst_error, std::llabs(sample.offset_ns - truth));
+    });
+
+    setup.scheduler.run_for(std::chrono::minutes(2));
+
+    EXPECT_EQ(setup.systems[1]->port_manager().get_port_roles()[1], bmca::PortRole::SLAVE);
+    EXPECT_EQ(setup.systems[0]->port_manager().get_port_roles()[1], bmca::PortRole::MASTER);
+    EXPECT_NEAR(static_cast<double>(setup.systems[1]->port_manager().get_link_delay(1).count()), 1200.0, 100.0);
+    EXPECT_GT(samples, 700u);                      // 8 Syncs per second once BMCA has settled
+    EXPECT_LT(worst_error, 150) << "jitter and timestamp granularity only";
+    EXPECT_NE(setup.slave->get_correction_ppb(), 0.0); // The servo steers the simulated clock
+}
+
+TEST_F(SimulatedNetworkTest, SameSeedReplaysIdentically) {
+    auto run = []() {
+        OscillatorModel oscillator;
+        oscillator.frequency_error_ppb = -8000.0;
+        oscillator.wander_ppb = 5.0;
+        LinkModel link;
+        link.jitter = JitterDistribution::UNIFORM;
+        link.jitter_ns = 100;
+        link.loss_probability = 0.01;
+        TwoNodes setup(oscillator, link);
+        setup.scheduler.run_for(std::chrono::seconds(30));
+        return setup.slave->offset_from_true_ns() - setup.master->offset_from_true_ns();
+    };
+    EXPECT_EQ(run(), run());
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include "utils/sync_trace.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+using namespace gptp;
+using namespace gptp::trace;
+
+namespace {
+    std::vector<SyncSample> make_samples(size_t count) {
+        std::vector<SyncSample> samples;
+        for (size_t i = 0; i < count; ++i) {
+            SyncSample sample;
+            sample.port_id = static_cast<uint16_t>(1 + i % 2);
+            sample.t1_ns = 1700000000000000000LL + static_cast<int64_t>(i / 2) * 125000000LL;
+            if (i % 5 == 4) {
+                sample.kind = SyncSample::Kind::PDELAY;
+                sample.t2_ns = sample.t1_ns + 310;
+                sample.t3_ns = sample.t2_ns + 9000;
+                sample.t4_ns = sample.t3_ns + 290;
+                sample.path_delay_ns = 300 + static_cast<int64_t>(i % 7);
+                sample.rate_ratio = 1.0 + 3e-9;
+            } else {
+                sample.t2_ns = sample.t1_ns + 400 + static_cast<int64_t>(i % 11);
+                sample.offset_ns = (static_cast<int64_t>(i % 13) - 6) * 17;
+                sample.path_delay_ns = 300;
+                sample.rate_ratio = 1.0 - 2.5e-8;
+                sample.servo_ppb = -12.125 + static_cast<double>(i % 3);
+                sample.servo_locked = i > 10;
+            }
+            samples.push_back(sample);
+        }
+        return samples;
+    }
+
+    void expect_equal(const SyncSample& expected, const SyncSample& actual) {
+        EXPECT_EQ(expected.kind, actual.kind);
+        EXPECT_EQ(expected.port_id, actual.port_id);
+        EXPECT_EQ(expected.t1_ns, actual.t1_ns);
+        EXPECT_EQ(expected.t2_ns, actual.t2_ns);
+        EXPECT_EQ(expected.t3_ns, actual.t3_ns);
+        EXPECT_EQ(expected.t4_ns, actual.t4_ns);
+        EXPECT_EQ(expected.offset_ns, actual.offset_ns);
+        EXPECT_EQ(expected.path_delay_ns, actual.path_delay_ns);
+        EXPECT_NEAR(expected.rate_ratio, actual.rate_ratio, 1e-12);
+        EXPECT_NEAR(expected.servo_ppb, actual.servo_ppb, 1e-3);
+        EXPECT_EQ(expected.servo_locked, actual.servo_locked);
+    }
+}
+
+TEST(SyncTraceTest, EncodeDecodeRoundTrip) {
+    auto samples = make_samples(200);
+    std::vector<uint8_t> buffer(samples.size() * SampleEncoder::MAX_RECORD_SIZE);
+
+    SampleEncoder encoder;
+    size_t used = 0;
+    for (const auto& sample : samples) {
+        used += encoder.encode(sample, buffer.data() + used);
+    }
+    // Deltas keep steady-state records small
+    EXPECT_LT(used, samples.size() * 24);
+
+    SampleDecoder decoder;
+    const uint8_t* cursor = buffer.data();
+    const uint8_t* end = buffer.data() + used;
+    for (const auto& expected : samples) {
+        SyncSample actual;
+        ASSERT_TRUE(decoder.decode(cursor, end, actual));
+        expect_equal(expected, actual);
+    }
+    SyncSample extra;
+    EXPECT_FALSE(decoder.decode(cursor, end, extra));
+}
+
+TEST(SyncTraceTest, RejectsDeltaWithoutKeyframe) {
+    auto samples = make_samples(2);
+    uint8_t buffer[2 * SampleEncoder::MAX_RECORD_SIZE];
+
+    SampleEncoder encoder;
+    size_t first = encoder.encode(samples[0], buffer);
+    samples[0].t1_ns += 125000000;
+    size_t second = encoder.encode(samples[0], buffer + first);
+
+    SampleDecoder decoder;
+    const uint8_t* cursor = buffer + first;
+    SyncSample sample;
+    EXPECT_FALSE(decoder.decode(cursor, buffer + first + second, sample));
+}
+
+TEST(SyncTraceTest, WriterRotatesAndSegmentsDecodeIndependently) {
+    const std::string path = "/tmp/gptp_sync_trace_test.bin";
+    auto remove_files = [&]() {
+        std::remove(path.c_str());
+        for (int i = 1; i < 4; ++i) {
+            std::remove((path + "." + std::to_string(i)).c_str());
+        }
+    };
+    remove_files();
+
+    auto samples = make_samples(8000);
+    TraceWriter::Options options;
+    options.path = path;
+    options.file_size_bytes = 16 * 1024;
+    options.max_files = 3;
+
+    TraceWriter writer;
+    ASSERT_TRUE(writer.open(options).is_success());
+    for (const auto& sample : samples) {
+        ASSERT_TRUE(writer.write(sample));
+    }
+    writer.close();
+
+    std::ifstream oldest(path + ".3");
+    EXPECT_FALSE(oldest.good());
+
+    // Newest segments hold the tail of the sample stream, oldest first
+    std::vector<SyncSample> decoded;
+    for (const auto& file : {path + ".2", path + ".1", path}) {
+        TraceReader reader;
+        ASSERT_TRUE(reader.open(file).is_success()) << file;
+        SyncSample sample;
+        uint64_t count = 0;
+        while (reader.next(sample)) {
+            decoded.push_back(sample);
+            count++;
+        }
+        EXPECT_EQ(count, reader.header()->record_count);
+    }
+
+    ASSERT_FALSE(decoded.empty());
+    ASSERT_LT(decoded.size(), samples.size());
+    size_t skipped = samples.size() - decoded.size();
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        expect_equal(samples[skipped + i], decoded[i]);
+    }
+
+    remove_files();
+}
+
+TEST(SyncTraceTest, ReaderBoundsCorruptHeader) {
+    const std::string path = "/tmp/gptp_sync_trace_corrupt.bin";
+    std::remove(path.c_str());
+
+    auto samples = make_samples(50);
+    TraceWriter::Options options;
+    options.path = path;
+    options.file_size_bytes = 16 * 1024;
+    {
+        TraceWriter writer;
+        ASSERT_TRUE(writer.open(options).is_success());
+        for (const auto& sample : samples) {
+            ASSERT_TRUE(writer.write(sample));
+        }
+    }
+
+    auto patch_header = [&](uint32_t header_size, uint64_t used_bytes) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        TraceFileHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        header.header_size = header_size;
+        header.used_bytes = used_bytes;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    };
+
+    // Header claiming to be larger than the file
+    patch_header(0x7FFFFFFF, 0);
+    TraceReader reader;
+    EXPECT_FALSE(reader.open(path).is_success());
+
+    // used_bytes past the end of the file: records are read up to the
+    // mapping and decoding stops at the first byte that is not a record
+    patch_header(sizeof(TraceFileHeader), ~0ULL);
+    ASSERT_TRUE(reader.open(path).is_success());
+    SyncSample sample;
+    size_t count = 0;
+    while (reader.next(sample) && count <= samples.size()) {
+        expect_equal(samples[count], sample);
+        count++;
+    }
+    EXPECT_EQ(count, samples.size());
+    reader.close();
+
+    std::remove(path.c_str());
+}
+
+TEST(SyncTraceTest, WriterFailsCleanlyWhenSpaceCannotBeReserved) {
+    const std::string path = "/tmp/gptp_sync_trace_nospace.bin";
+    std::remove(path.c_str());
+
+    // A file size limit makes the reservation fail as a full filesystem would
+    struct rlimit saved{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+    auto saved_handler = std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit limited = saved;
+    limited.rlim_cur = 8 * 1024;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+
+    TraceWriter::Options options;
+    options.path = path;
+    options.file_size_bytes = 64 * 1024;
+    TraceWriter writer;
+    bool opened = writer.open(options).is_success();
+
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, saved_handler);
+
+    EXPECT_FALSE(opened);
+    EXPECT_FALSE(writer.write(make_samples(1)[0]));
+    std::ifstream file(path);
+    EXPECT_FALSE(file.good());
+}
+
+TEST(SyncTraceTest, EncodingIsWellUnderAMicrosecond) {
+    auto samples = make_samples(1000);
+    std::vector<uint8_t> buffer(SampleEncoder::MAX_RECORD_SIZE);
+    SampleEncoder encoder;
+
+    constexpr int ROUNDS = 200;
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (const auto& sample : samples) {
+            total += encoder.encode(sample, buffer.data());
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double per_sample_ns = std::chrono::duration<double, std::nano>(elapsed).count() / (ROUNDS * samples.size());
+
+    EXPECT_GT(total, 0u);
+    // Generous bound so sanitizer and debug builds pass
+    EXPECT_LT(per_sample_ns, 1000.0);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "gptp_time_client.hpp"
+#include "utils/time_publisher.hpp"
+#include "utils/logger.hpp"
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace gptp;
+
+namespace {
+    std::string segment_name() {
+        return "/gptp-time-test-" + std::to_string(::getpid());
+    }
+}
+
+TEST(TimeShmTest, ClientConvertsMonotonicToGptpTime) {
+    Logger::instance().set_level(LogLevel::ERROR);
+    const std::string name = segment_name();
+
+    TimePublisher publisher;
+    ASSERT_TRUE(publisher.open(name).is_success());
+
+    TimeClient client;
+    ASSERT_TRUE(client.open(name.c_str()));
+    shm::TimeData data;
+    EXPECT_FALSE(client.read(data)); // Nothing published yet
+
+    shm::TimeData published{};
+    published.flags = shm::TIME_SYNCHRONIZED | shm::TIME_SERVO_LOCKED;
+    published.offset_ns = 250;
+    published.rate_ratio = 1.0 + 20e-6;
+    published.monotonic_ref_ns = 1000000000LL;
+    published.gptp_ref_ns = 1700000000000000000LL;
+    published.grandmaster_identity[0] = 0xAA;
+    publisher.publish(published);
+
+    ASSERT_TRUE(client.read(data));
+    EXPECT_EQ(data.flags, shm::TIME_VALID | shm::TIME_SYNCHRONIZED | shm::TIME_SERVO_LOCKED);
+    EXPECT_EQ(data.offset_ns, 250);
+    EXPECT_EQ(data.grandmaster_identity[0], 0xAA);
+    EXPECT_EQ(data.update_count, 1u);
+
+    // One second later at +20 ppm is 20 us more gPTP time
+    int64_t gptp_ns = 0;
+    ASSERT_TRUE(client.to_gptp_ns(2000000000LL, gptp_ns));
+    EXPECT_EQ(gptp_ns, 1700000000000000000LL + 1000000000LL + 20000);
+    EXPECT_EQ(data.to_monotonic_ns(gptp_ns), 2000000000LL);
+
+    // Shutdown invalidates the segment for clients still mapping it
+    publisher.close();
+    EXPECT_FALSE(client.read(data));
+    TimeClient late_client;
+    EXPECT_FALSE(late_client.open(name.c_str()));
+}
+
+TEST(TimeShmTest, SeqlockReadsAreNeverTorn) {
+    Logger::instance().set_level(LogLevel::ERROR);
+    const std::string name = segment_name() + "-torn";
+
+    TimePublisher publisher;
+    ASSERT_TRUE(publisher.open(name).is_success());
+    TimeClient client;
+    ASSERT_TRUE(client.open(name.c_str()));
+
+    constexpr int64_t UPDATES = 200000;
+    std::thread writer([&publisher]() {
+        shm::TimeData data{};
+        data.rate_ratio = 1.0;
+        for (int64_t i = 1; i <= UPDATES; ++i) {
+            data.monotonic_ref_ns = i;
+            data.gptp_ref_ns = i * 7;
+            data.clock_ref_ns = -i;
+            publisher.publish(data);
+        }
+    });
+
+    shm::TimeData data;
+    int64_t last = 0;
+    while (last < UPDATES) {
+        if (!client.read(data)) {
+            continue;
+        }
+        ASSERT_EQ(data.gptp_ref_ns, data.monotonic_ref_ns * 7);
+        ASSERT_EQ(data.clock_ref_ns, -data.monotonic_ref_ns);
+        ASSERT_GE(data.monotonic_ref_ns, last);
+        last = data.monotonic_ref_ns;
+    }
+    writer.join();
+}
+
+TEST(TimeShmTest, RateEstimatorUsesLongBaselineAndRestartsAfterStep) {
+    TimeRateEstimator estimator(4000000000LL);
+    EXPECT_DOUBLE_EQ(estimator.update(0, 0), 1.0);
+    EXPECT_DOUBLE_EQ(estimator.update(1000000000LL, 1000000050LL), 1.0); // Baseline too short
+    EXPECT_NEAR(estimator.update(4000000000LL, 4000000200LL), 1.0 + 50e-9, 1e-12);
+
+    // A one second step restarts the estimate instead of producing 1.25
+    EXPECT_DOUBLE_EQ(estimator.update(8000000000LL, 9000000400LL), 1.0);
+    EXPECT_NEAR(estimator.update(12000000000LL, 13000000600LL), 1.0 + 50e-9, 1e-12);
+}
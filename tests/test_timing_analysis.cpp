@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "utils/timing_analysis.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace gptp::analysis;
+
+namespace {
+    std::vector<double> random_walk(size_t count) {
+        std::mt19937_64 generator(42);
+        std::normal_distribution<double> noise(0.0, 10.0);
+        std::vector<double> x(count);
+        double value = 0.0;
+        for (auto& sample : x) {
+            value += noise(generator);
+            sample = value + noise(generator);
+        }
+        return x;
+    }
+
+    double naive_mtie(const std::vector<double>& x, size_t n) {
+        double result = 0.0;
+        for (size_t k = 0; k + n < x.size(); ++k) {
+            auto range = std::minmax_element(x.begin() + k, x.begin() + k + n + 1);
+            result = std::max(result, *range.second - *range.first);
+        }
+        return result;
+    }
+
+    double naive_tdev(const std::vector<double>& x, size_t n) {
+        const size_t N = x.size();
+        double sum = 0.0;
+        for (size_t j = 0; j + 3 * n <= N; ++j) {
+            double inner = 0.0;
+            for (size_t i = j; i < j + n; ++i) {
+                inner += x[i + 2 * n] - 2.0 * x[i + n] + x[i];
+            }
+            sum += inner * inner;
+        }
+        return std::sqrt(sum / (6.0 * n * n * static_cast<double>(N - 3 * n + 1)));
+    }
+}
+
+TEST(TimingAnalysisTest, LinearDriftHasExactMtieAndZeroDeviation) {
+    std::vector<double> x(1000);
+    for (size_t i = 0; i < x.size(); ++i) {
+        x[i] = 3.0 * static_cast<double>(i);
+    }
+
+    TimingAnalyzer analyzer(4);
+    auto windows = TimingAnalyzer::log_windows(x.size() - 1);
+    auto mtie = analyzer.mtie(x, 0.125, windows);
+    auto tdev = analyzer.tdev(x, 0.125, windows);
+    auto adev = analyzer.adev(x, 0.125, windows);
+
+    ASSERT_EQ(mtie.size(), windows.size());
+    for (const auto& point : mtie) {
+        EXPECT_DOUBLE_EQ(point.value, 3.0 * static_cast<double>(point.window));
+        EXPECT_DOUBLE_EQ(point.tau_s, 0.125 * static_cast<double>(point.window));
+    }
+    for (const auto& point : tdev) {
+        EXPECT_NEAR(point.value, 0.0, 1e-6);
+    }
+    for (const auto& point : adev) {
+        EXPECT_NEAR(point.value, 0.0, 1e-15);
+    }
+}
+
+TEST(TimingAnalysisTest, ParallelBlocksMatchNaiveDefinition) {
+    // Longer than one block so windows are split across tasks
+    auto x = random_walk(100000);
+    std::vector<size_t> windows = {1, 7, 100, 5000, 40000};
+
+    TimingAnalyzer parallel(8);
+    TimingAnalyzer serial(1);
+    auto mtie = parallel.mtie(x, 1.0, windows);
+    auto mtie_serial = serial.mtie(x, 1.0, windows);
+    auto tdev = parallel.tdev(x, 1.0, windows);
+
+    ASSERT_EQ(mtie.size(), windows.size());
+    for (size_t w = 0; w < windows.size(); ++w) {
+        EXPECT_DOUBLE_EQ(mtie[w].value, mtie_serial[w].value);
+        if (windows[w] <= 100) {
+            EXPECT_DOUBLE_EQ(mtie[w].value, naive_mtie(x, windows[w]));
+        }
+    }
+    for (size_t w = 0; w < tdev.size(); ++w) {
+        if (windows[w] <= 100) {
+            EXPECT_NEAR(tdev[w].value, naive_tdev(x, windows[w]), 1e-6 * naive_tdev(x, windows[w]));
+        }
+    }
+}
+
+TEST(TimingAnalysisTest, WhitePhaseNoiseAdevFallsWithTau) {
+    std::mt19937_64 generator(7);
+    std::normal_distribution<double> noise(0.0, 50.0);
+    std::vector<double> x(200000);
+    for (auto& sample : x) {
+        sample = noise(generator);
+    }
+
+    TimingAnalyzer analyzer;
+    auto adev = analyzer.adev(x, 0.125, {1, 10, 100});
+    ASSERT_EQ(adev.size(), 3u);
+    // White PM: ADEV ~ 1/tau
+    EXPECT_NEAR(adev[0].value / adev[1].value, 10.0, 1.0);
+    EXPECT_NEAR(adev[1].value / adev[2].value, 10.0, 1.0);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "simulation/topology.hpp"
+#include "utils/allocation_counter.hpp"
+#include "utils/logger.hpp"
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t START_NS = 1000000000LL;
+
+    size_t count_roles(GptpPortManager& manager, bmca::PortRole wanted) {
+        size_t count = 0;
+        for (const auto& role : manager.get_port_roles()) {
+            if (role.second == wanted) {
+                count++;
+            }
+        }
+        return count;
+    }
+}
+
+class TopologyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::instance().set_level(LogLevel::ERROR);
+    }
+};
+
+TEST_F(TopologyTest, BuildsTheRequestedShapes) {
+    EventScheduler scheduler(START_NS);
+    TopologyOptions options;
+
+    Topology ring(scheduler, options);
+    ring.build(Topology::Kind::RING, 10);
+    EXPECT_EQ(ring.link_count(), 10u);
+    EXPECT_EQ(ring.hop_distances(0)[5], 5u);
+    EXPECT_EQ(ring.hop_distances(0)[9], 1u);
+    EXPECT_EQ(ring.hop_distances(0, 9)[9], SIZE_MAX);
+
+    Topology tree(scheduler, options);
+    tree.build(Topology::Kind::TREE, 13, 3.0);
+    EXPECT_EQ(tree.link_count(), 12u);
+    EXPECT_EQ(tree.hop_distances(0)[12], 2u);
+
+    Topology mesh(scheduler, options);
+    mesh.build(Topology::Kind::RANDOM_MESH, 200, 0.5);
+    EXPECT_EQ(mesh.link_count(), 199u + 100u);
+    for (size_t distance : mesh.hop_distances(0)) {
+        EXPECT_NE(distance, SIZE_MAX);
+    }
+}
+
+// Every hop of a line follows the grandmaster, and the line elects the
+// backup once the grandmaster goes silent
+TEST_F(TopologyTest, LineElectsOneGrandmasterAndRecoversFromItsLoss) {
+    EventScheduler scheduler(START_NS);
+    ScopedVirtualTime virtual_time(scheduler);
+    TopologyOptions options;
+    options.oscillator_spread.frequency_error_ppb = 100.0;
+    Topology line(scheduler, options);
+    line.build(Topology::Kind::CHAIN, 12);
+    line.set_priority1(0, 100);
+    line.set_priority1(1, 110);
+    line.start();
+
+    scheduler.run_for(std::chrono::seconds(30));
+    ClockIdentity grandmaster = line.node(0).get_clock_identity();
+    for (size_t i = 1; i < line.size(); ++i) {
+        auto& manager = line.system(i).port_manager();
+        EXPECT_EQ(count_roles(manager, bmca::PortRole::SLAVE), 1u) << "node " << i;
+        EXPECT_TRUE(manager.get_grandmaster(1).grandmaster_identity == grandmaster) << "node " << i;
+    }
+
+    line.stop_node(0);
+    scheduler.run_for(std::chrono::seconds(60));
+    ClockIdentity backup = line.node(1).get_clock_identity();
+    EXPECT_EQ(count_roles(line.system(1).port_manager(), bmca::PortRole::SLAVE), 0u);
+    for (size_t i = 2; i < line.size(); ++i) {
+        auto& manager = line.system(i).port_manager();
+        EXPECT_EQ(count_roles(manager, bmca::PortRole::SLAVE), 1u) << "node " << i;
+        EXPECT_TRUE(manager.get_grandmaster(1).grandmaster_identity == backup) << "node " << i;
+    }
+}
+
+// An hour of lossy operation leaves memory and protocol state where they
+// were after warm-up; BMCA once leaked its grandmaster on every run
+TEST_F(TopologyTest, SteadyStateHoldsNoMoreMemory) {
+    EventScheduler scheduler(START_NS);
+    ScopedVirtualTime virtual_time(scheduler);
+    TopologyOptions options;
+    options.oscillator_spread.frequency_error_ppb = 100.0;
+    options.link.loss_probability = 0.01;
+    Topology line(scheduler, options);
+    line.build(Topology::Kind::CHAIN, 3);
+    line.set_priority1(0, 100);
+    line.start();
+    scheduler.run_for(std::chrono::minutes(5));
+
+    auto state_size = [&line]() {
+        size_t total = 0;
+        for (size_t i = 0; i < line.size(); ++i) {
+            auto sizes = line.system(i).port_manager().get_state_sizes();
+            total += sizes.pending_syncs + sizes.pdelay_history + sizes.bmca_masters;
+        }
+        return total;
+    };
+    int64_t live = live_allocation_count();
+    size_t state = state_size();
+
+    // Ten minutes is thousands of exchanges per node; gptp-soak runs for days
+    scheduler.run_for(std::chrono::minutes(10));
+
+    EXPECT_LE(live_allocation_count() - live, 32);
+    EXPECT_LE(state_size(), state + 4);
+    for (size_t i = 1; i < line.size(); ++i) {
+        EXPECT_EQ(count_roles(line.system(i).port_manager(), bmca::PortRole::SLAVE), 1u);
+    }
+}
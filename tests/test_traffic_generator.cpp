@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "simulation/simulated_network.hpp"
+#include "simulation/traffic_generator.hpp"
+#include "utils/logger.hpp"
+#include <functional>
+#include <map>
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t START_NS = 1000000000LL;
+
+    // Sends every frame of the generator on time until end_ns
+    void run_generator(EventScheduler& scheduler, TrafficGenerator& generator, int64_t end_ns) {
+        std::function<void()> next = [&]() {
+            if (generator.next_due_ns() < end_ns) {
+                scheduler.schedule_at(generator.next_due_ns(), [&]() {
+                    generator.run_until(scheduler.now_ns());
+                    next();
+                });
+            }
+        };
+        next();
+        scheduler.run_until(end_ns);
+    }
+}
+
+class TrafficGeneratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::instance().set_level(LogLevel::ERROR);
+    }
+};
+
+TEST_F(TrafficGeneratorTest, SendsEachStreamAtItsInterval) {
+    EventScheduler scheduler(START_NS);
+    ScopedVirtualTime virtual_time(scheduler);
+    SimulatedNetwork network(scheduler);
+    auto socket = network.create_socket(network.add_node("loadgen"), "loadgen.p1");
+    auto sink = network.create_socket(network.add_node("sink"), "sink.p1");
+    ASSERT_TRUE(socket->initialize("loadgen.p1").is_success());
+    ASSERT_TRUE(sink->initialize("sink.p1").is_success());
+    ASSERT_TRUE(network.connect("loadgen.p1", "sink.p1").is_success());
+    std::map<uint8_t, uint64_t> received;
+    sink->start_async_receive([&](const ReceivedPacket& packet) {
+        received[packet.packet.payload[0] & 0x0F]++;
+    });
+
+    TrafficProfile profile;
+    profile.identities = 50;
+    profile.sync_log_interval = -7;
+    EXPECT_DOUBLE_EQ(TrafficGenerator::frames_per_second(profile), 50.0 * (2 * 128 + 1 + 1));
+
+    TrafficGenerator generator(*socket, profile, START_NS);
+    run_generator(scheduler, generator, START_NS + 10000000000LL);
+    scheduler.run_for(std::chrono::milliseconds(1));
+
+    // A random phase makes each stream fire once more or less than the interval suggests
+    const auto& statistics = generator.get_statistics();
+    EXPECT_NEAR(static_cast<double>(statistics.sync), 50.0 * 1280, 50.0);
+    EXPECT_EQ(statistics.follow_up, statistics.sync);
+    EXPECT_NEAR(static_cast<double>(statistics.pdelay_req), 500.0, 50.0);
+    EXPECT_NEAR(static_cast<double>(statistics.announce), 500.0, 50.0);
+    EXPECT_EQ(statistics.malformed, 0u);
+    EXPECT_EQ(statistics.send_errors, 0u);
+    EXPECT_EQ(received[0x0], statistics.sync);
+    EXPECT_EQ(received[0x8], statistics.follow_up);
+    EXPECT_EQ(received[0x2], statistics.pdelay_req);
+    EXPECT_EQ(received[0xB], statistics.announce);
+}
+
+TEST_F(TrafficGeneratorTest, OnlyMalformedFramesAreRejected) {
+    EventScheduler scheduler(START_NS);
+    ScopedVirtualTime virtual_time(scheduler);
+    SimulatedNetwork network(scheduler);
+    auto socket = network.create_socket(network.add_node("loadgen"), "loadgen.p1");
+    ASSERT_TRUE(socket->initialize("loadgen.p1").is_success());
+    SimulatedTimeAwareSystem dut(network, network.add_node("dut"));
+    ASSERT_EQ(dut.add_port("dut.p1"), 1);
+    ASSERT_TRUE(network.connect("loadgen.p1", "dut.p1").is_success());
+    dut.start();
+
+    TrafficProfile profile;
+    profile.identities = 200;
+    profile.malformed_fraction = 0.1;
+    TrafficGenerator generator(*socket, profile, START_NS);
+    run_generator(scheduler, generator, START_NS + 10000000000LL);
+    scheduler.run_for(std::chrono::milliseconds(1));
+
+    const auto& statistics = generator.get_statistics();
+    double share = static_cast<double>(statistics.malformed) / static_cast<double>(statistics.total());
+    EXPECT_NEAR(share, 0.1, 0.01);
+    EXPECT_EQ(dut.get_statistics().frames_received, statistics.total());
+    // Some corruptions, such as a wrong transportSpecific, still parse
+    EXPECT_GT(dut.get_statistics().parse_errors, statistics.malformed / 2);
+    EXPECT_LE(dut.get_statistics().parse_errors, statistics.malformed);
+}
+
+// Hundreds of neighbours with worse priorities do not pull the system
+// off its grandmaster
+TEST_F(TrafficGeneratorTest, SystemKeepsItsGrandmasterUnderLoad) {
+    EventScheduler scheduler(START_NS);
+    ScopedVirtualTime virtual_time(scheduler);
+    SimulatedNetwork network(scheduler);
+    SimulatedNode& grandmaster = network.add_node("gm");
+    OscillatorModel oscillator;
+    oscillator.frequency_error_ppb = 100.0;
+    SimulatedNode& node = network.add_node("dut", oscillator);
+    SimulatedTimeAwareSystem gm_system(network, grandmaster);
+    SimulatedTimeAwareSystem dut(network, node);
+    gm_system.add_port("gm.p1");
+    dut.add_port("dut.p1");
+    dut.add_port("dut.p2");
+    auto socket = network.create_socket(network.add_node("loadgen"), "loadgen.p1");
+    ASSERT_TRUE(socket->initialize("loadgen.p1").is_success());
+    uint64_t responses = 0;
+    socket->start_async_receive([&](const ReceivedPacket& packet) {
+        responses += (packet.packet.payload[0] & 0x0F) == 0x3 ? 1 : 0;
+    });
+    network.connect("gm.p1", "dut.p1");
+    network.connect("loadgen.p1", "dut.p2");
+    gm_system.port_manager().set_local_clock_properties(100, ClockQuality(), 248);
+    gm_system.start();
+    dut.start();
+    scheduler.run_for(std::chrono::seconds(60));
+    ASSERT_TRUE(dut.port_manager().get_sync_status(1).synchronized);
+
+    TrafficProfile profile;
+    profile.identities = 300;
+    profile.sync_log_interval = -5;
+    TrafficGenerator generator(*socket, profile, scheduler.now_ns());
+    bool held = true;
+    scheduler.schedule_every(std::chrono::milliseconds(125), [&]() {
+        auto& manager = dut.port_manager();
+        held = held && manager.get_port_roles().at(1) == bmca::PortRole::SLAVE &&
+               manager.get_grandmaster(1).grandmaster_identity == grandmaster.get_clock_identity() &&
+               manager.get_sync_status(1).synchronized;
+    });
+    run_generator(scheduler, generator, scheduler.now_ns() + 30000000000LL);
+
+    EXPECT_TRUE(held);
+    EXPECT_EQ(dut.port_manager().get_port_roles().at(2), bmca::PortRole::MASTER);
+    EXPECT_NEAR(static_cast<double>(generator.get_statistics().total()), 300.0 * 66 * 30, 300.0 * 4);
+    EXPECT_GE(responses, generator.get_statistics().pdelay_req - 1);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "../include/gptp_port_manager.hpp"
+#include "simulation/virtual_time.hpp"
+#include "utils/logger.hpp"
+
+using namespace gptp;
+using namespace gptp::sim;
+
+namespace {
+    constexpr int64_t PROPAGATION_DELAY_NS = 500;
+    constexpr int64_t EGRESS_DELAY_NS = 1000;      // Queue to wire, so t3 follows t2
+
+    ClockIdentity make_identity(uint8_t base) {
+        ClockIdentity identity;
+        for (int i = 0; i < 8; i++) {
+            identity.id[i] = static_cast<uint8_t>(base + i);
+        }
+        return identity;
+    }
+
+    Timestamp to_timestamp(int64_t ns) {
+        Timestamp timestamp;
+        timestamp.from_nanoseconds(std::chrono::nanoseconds(ns));
+        return timestamp;
+    }
+}
+
+TEST(VirtualTimeTest, EventsRunInTimeOrder) {
+    EventScheduler scheduler(1000);
+    std::vector<int> order;
+    scheduler.schedule_at(3000, [&]() { order.push_back(3); });
+    scheduler.schedule_at(2000, [&]() { order.push_back(1); });
+    scheduler.schedule_at(2000, [&]() { order.push_back(2); }); // Tie: scheduling order
+    auto cancelled = scheduler.schedule_at(2500, [&]() { order.push_back(-1); });
+    scheduler.cancel(cancelled);
+
+    EXPECT_EQ(scheduler.pending(), 3u);
+    EXPECT_EQ(scheduler.run_until(2999), 2u);
+    EXPECT_EQ(scheduler.now_ns(), 2999);
+    EXPECT_EQ(scheduler.run_until(10000), 1u);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(scheduler.pending(), 0u);
+}
+
+TEST(VirtualTimeTest, PeriodicEventsRepeatUntilCancelled) {
+    EventScheduler scheduler;
+    int runs = 0;
+    EventScheduler::EventId id = 0;
+    id = scheduler.schedule_every(std::chrono::milliseconds(10), [&]() {
+        if (++runs == 5) {
+            scheduler.cancel(id);
+        }
+    });
+    scheduler.run_for(std::chrono::seconds(1));
+    EXPECT_EQ(runs, 5);
+    EXPECT_EQ(scheduler.now_ns(), 1000000000);
+}
+
+TEST(VirtualTimeTest, ProcessClockFollowsScheduler) {
+    EventScheduler scheduler(5000);
+    {
+        ScopedVirtualTime virtual_time(scheduler);
+        EXPECT_EQ(get_clock_source().get_name(), "virtual");
+        scheduler.run_for(std::chrono::hours(1));
+        EXPECT_EQ(get_clock_source().now_monotonic_ns(), 5000 + 3600000000000LL);
+        EXPECT_EQ(steady_now(), scheduler.now());
+    }
+    EXPECT_EQ(get_clock_source().get_name(), "system");
+}
+
+// Two port managers back to back, driven for a simulated hour; gptp-soak
+// covers days
+TEST(VirtualTimeTest, HourOfProtocolRunsOnVirtualTime) {
+    Logger::instance().set_level(LogLevel::ERROR);
+    EventScheduler scheduler(1000000000LL);
+    ScopedVirtualTime virtual_time(scheduler);
+
+    std::unique_ptr<GptpPortManager> managers[2];
+    size_t transmitted[2] = {0, 0};
+    int64_t last_tx_ns[2] = {0, 0};
+    for (int side = 0; side < 2; ++side) {
+        managers[side] = std::make_unique<GptpPortManager>(make_identity(side == 0 ? 0x80 : 0x40),
+            [&, side](uint16_t, const std::vector<uint8_t>& payload) {
+                transmitted[side]++;
+                last_tx_ns[side] = get_clock_source().now_realtime_ns() + EGRESS_DELAY_NS;
+                int64_t rx_ns = last_tx_ns[side] + PROPAGATION_DELAY_NS;
+                scheduler.schedule_after(std::chrono::nanoseconds(EGRESS_DELAY_NS + PROPAGATION_DELAY_NS),
+                    [&managers, side, payload, rx_ns]() {
+                        managers[1 - side]->process_frame(1, payload.data(), payload.size(), to_timestamp(rx_ns));
+                    });
+            });
+        managers[side]->set_tx_timestamp_provider([&last_tx_ns, side](uint16_t, Timestamp& tx_time) {
+            tx_time = to_timestamp(last_tx_ns[side]);
+            return true;
+        });
+    }
+    managers[1]->set_local_clock_properties(100, ClockQuality(), 248);
+    for (auto& manager : managers) {
+        manager->add_port(1);
+        manager->enable_port(1);
+    }
+    scheduler.schedule_every(std::chrono::milliseconds(125), [&]() {
+        for (auto& manager : managers) {
+            manager->run_periodic_tasks(scheduler.now());
+        }
+    });
+
+    auto started = std::chrono::steady_clock::now();
+    scheduler.run_for(std::chrono::hours(1));
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    EXPECT_EQ(managers[0]->get_port_roles()[1], bmca::PortRole::SLAVE);
+    EXPECT_EQ(managers[1]->get_port_roles()[1], bmca::PortRole::MASTER);
+    EXPECT_EQ(managers[0]->get_link_delay(1).count(), PROPAGATION_DELAY_NS);
+
+    // Sync and Follow_Up every 125 ms, plus one Announce and peer delay per second
+    EXPECT_GE(transmitted[1], 2u * 28600u);
+    EXPECT_LE(transmitted[1], 2u * 28800u + 4u * 3600u + 10u);
+    EXPECT_LT(elapsed, std::chrono::seconds(30));
+}